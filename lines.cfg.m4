@@ -110,6 +110,16 @@ ifdef(`WINDOWS',
 #ReportLog=%llroot%/reporterrs.log
 )dnl
 
+# Directory to keep parsed report programs in (default none)
+ifdef(`WINDOWS',
+#ReportCacheDir:=%llroot%\rptcache
+,
+#ReportCacheDir=%llroot%/rptcache
+)dnl
+
+# Size in kilobytes of record cache shared by read-only processes (default 0, none)
+#SharedRecordCache=65536
+
 # Log file for crashes for llines (default none)
 ifdef(`WINDOWS',
 #CrashLog_llines:=%llroot%\crashes_llines.log
@@ -144,6 +154,17 @@ ifdef(`WINDOWS',
 # Print more detailed call stack for each report error
 #FullReportCallStack=1
 
+# Number of processes dbverify checks data blocks with
+#  (default one per processor; 1 checks all in one process)
+#DbverifyWorkers=4
+
+# Number of threads large sorts (name sorts, report sort) use
+#  (default one per processor; 1 sorts in one thread)
+#SortThreads=4
+
+# Fewest elements each sort thread is given
+#SortParallelMin=20000
+
 # dayfmt,monthfmt,yearfmt,datefmt,erafmt,complexfmt
 # see programmers reference for stddate for these
 # 2,3,0,0,1,1 is GEDCOM style (1 AUG 1945) with complex dates
@@ -231,6 +252,14 @@ ifdef(`WINDOWS',
 # Valid values are 0 through 99.
 # Default is 1.
 
+# Limit the relationship path search of the tandem browse screen (r).
+#RelationPathMaxPersons=100000
+# Stop after reaching this many persons. Default is 0 (no limit).
+#RelationPathMsecs=5000
+# Stop after this many milliseconds of processor time.
+# This sample line is the same as the default if none is given
+# (0 means no limit).
+
 # Disallow persons without name records (legacy 3.0.10 & earlier behavior)
 #RequireNames=1
 # Default is 0 (nameless records allowed)
@@ -59,7 +59,13 @@
  * Latest version: http://www.cl.cam.ac.uk/~mgk25/ucs/wcwidth.c
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <wchar.h>
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "arch.h"
 
 struct interval {
   int first;
@@ -29,16 +29,52 @@
  *=========================================================*/
 
 
+#include <errno.h>
 #include "llstdlib.h"
 #include "btreei.h"
 
+/*********************************************
+ * local types
+ *********************************************/
+
+/*====================================================
+ * LEAFWALK -- state of traverse_leaf_records
+ *==================================================*/
+typedef struct {
+	RKEY lo;
+	RKEY hi;
+	TRAV_LEAF_FUNC leaffunc;
+	TRAV_RECORD_FUNC_BYKEY func;
+	void * param;
+	INT leafdepth; /* depth of data blocks, once known (else 0) */
+	STRING buf;    /* file last read */
+	INT bufsize;
+} LEAFWALK;
+
+/*====================================================
+ * KEYWALK -- state of traverse_leaf_keys
+ *==================================================*/
+typedef struct {
+	RKEY * keys;   /* sorted keys wanted */
+	INT nkeys;
+	INT next;      /* first key not yet passed */
+	TRAV_RECORD_FUNC_BYKEY func;
+	void * param;
+} KEYWALK;
+
 /*********************************************
  * local function prototypes
  *********************************************/
 
 /* alphabetical */
+static BOOLEAN key_leaf(RKEY * lo, RKEY * hi, void * param);
+static BOOLEAN key_record(RKEY rkey, STRING data, INT len, void * param);
+static BOOLEAN leaf_in_range(LEAFWALK * walk, RKEY * lo, RKEY * hi);
+static STRING read_node_file(BTREE btree, FKEY fkey, INT * psize, LEAFWALK * walk);
 static BOOLEAN traverse_block(BTREE btree, BLOCK block, RKEY lo, RKEY hi, TRAV_RECORD_FUNC_BYKEY, void * param);
 static BOOLEAN traverse_index(BTREE btree, INDEX index, RKEY lo, RKEY hi, TRAV_RECORD_FUNC_BYKEY, void * param);
+static BOOLEAN walk_index(BTREE btree, INDEX index, RKEY * lo, RKEY * hi, INT depth, LEAFWALK * walk);
+static BOOLEAN walk_leaf(BTREE btree, BLOCK block, INT size, LEAFWALK * walk);
 
 /*********************************************
  * local function definitions
@@ -180,4 +216,227 @@ traverse_db_rec_rkeys (BTREE btree, RKEY lo, RKEY hi, TRAV_RECORD_FUNC_BYKEY fun
 	ASSERT(index = bmaster(btree));
 	traverse_index(btree, index, lo, hi, func, param);
 }
+/*==============================================
+ * traverse_leaf_records -- traverse a span of records
+ *  reading each data block (leaf) file just once,
+ *  bypassing the index cache for data blocks
+ *  either lo or hi can have 0 as its first character
+ *  leaffunc: [IN]  optional, called with key limits of
+ *                  each leaf (NULL if open-ended); leaf
+ *                  is skipped unread if it returns FALSE
+ * NB: This covers all records, including DELE records.
+ * callback must not write to database
+ *============================================*/
+void
+traverse_leaf_records (BTREE btree, RKEY lo, RKEY hi, TRAV_LEAF_FUNC leaffunc
+	, TRAV_RECORD_FUNC_BYKEY func, void * param)
+{
+	INDEX index;
+	LEAFWALK walk;
+	ASSERT(index = bmaster(btree));
+	walk.lo = lo;
+	walk.hi = hi;
+	walk.leaffunc = leaffunc;
+	walk.func = func;
+	walk.param = param;
+	walk.leafdepth = 0;
+	walk.buf = NULL;
+	walk.bufsize = 0;
+	if (ixtype(index) == BTINDEXTYPE) {
+		walk_index(btree, index, NULL, NULL, 0, &walk);
+	} else {
+		INT size=0;
+		STRING data = read_node_file(btree, ixself(index), &size, &walk);
+		walk_leaf(btree, (BLOCK)data, size, &walk);
+	}
+	if (walk.buf)
+		stdfree(walk.buf);
+}
+/*====================================================
+ * walk_index -- traverse_leaf_records below one index
+ *  lo & hi are key limits of index (NULL if open-ended)
+ *==================================================*/
+static BOOLEAN
+walk_index (BTREE btree, INDEX index, RKEY * lo, RKEY * hi, INT depth, LEAFWALK * walk)
+{
+	INT i, n = nkeys(index);
+	for (i = 0; i <= n; i++) {
+		RKEY * lox = (i==0 ? lo : &rkeys(index, i));
+		RKEY * hix = (i==n ? hi : &rkeys(index, i+1));
+		STRING data;
+		INT size=0;
+		BOOLEAN rc;
+		if (!leaf_in_range(walk, lox, hix))
+			continue;
+		/* once depth of leaves is known, skip them before reading */
+		if (walk->leafdepth == depth+1 && walk->leaffunc
+			&& !(*walk->leaffunc)(lox, hix, walk->param))
+			continue;
+		data = read_node_file(btree, fkeys(index, i), &size, walk);
+		if (ixtype((INDEX)data) == BTINDEXTYPE) {
+			/* copy, as walk buffer is reused below */
+			INDEX child = (INDEX)stdalloc(BUFLEN);
+			memcpy(child, data, BUFLEN);
+			rc = walk_index(btree, child, lox, hix, depth+1, walk);
+			stdfree(child);
+		} else {
+			if (!walk->leafdepth) {
+				walk->leafdepth = depth+1;
+				if (walk->leaffunc && !(*walk->leaffunc)(lox, hix, walk->param))
+					continue;
+			}
+			rc = walk_leaf(btree, (BLOCK)data, size, walk);
+		}
+		if (!rc)
+			return FALSE;
+	}
+	return TRUE;
+}
+/*====================================================
+ * walk_leaf -- pass records of one leaf to callback
+ *  block: [IN]  whole file of leaf (header & records)
+ *==================================================*/
+static BOOLEAN
+walk_leaf (BTREE btree, BLOCK block, INT size, LEAFWALK * walk)
+{
+	INT i, n = nkeys(block);
+	STRING records = (STRING)block + BUFLEN;
+	for (i = 0; i < n; i++) {
+		INT32 off = offs(block, i);
+		INT len = lens(block, i);
+		BOOLEAN rc;
+		char save;
+		if (walk->lo.r_rkey[0] && ll_strncmp(walk->lo.r_rkey, rkeys(block, i).r_rkey, 8) >= 0)
+			continue;
+		if (walk->hi.r_rkey[0] && ll_strncmp(walk->hi.r_rkey, rkeys(block, i).r_rkey, 8) < 0)
+			continue;
+		if (off < 0 || len < 0 || BUFLEN + off + len > size) {
+			char msg[MAXPATHLEN+64];
+			snprintf(msg, sizeof(msg)
+				, "Bad offset or len for record (rkey=%s) in blockfile %s%c%s"
+				, rkey2str(rkeys(block, i)), bbasedir(btree), LLCHRDIRSEPARATOR
+				, fkey2path(ixself(block)));
+			FATAL2(msg);
+		}
+		/* zero terminate record in place for callback */
+		save = records[off + len];
+		records[off + len] = 0;
+		rc = (*walk->func)(rkeys(block, i), records + off, len, walk->param);
+		records[off + len] = save;
+		if (!rc)
+			return FALSE;
+	}
+	return TRUE;
+}
+/*====================================================
+ * leaf_in_range -- may node with these key limits
+ *  hold records in span of traverse_leaf_records ?
+ *  keys of node are >= lo and < hi
+ *==================================================*/
+static BOOLEAN
+leaf_in_range (LEAFWALK * walk, RKEY * lo, RKEY * hi)
+{
+	if (walk->lo.r_rkey[0] && hi && ll_strncmp(hi->r_rkey, walk->lo.r_rkey, 8) <= 0)
+		return FALSE;
+	if (walk->hi.r_rkey[0] && lo && ll_strncmp(lo->r_rkey, walk->hi.r_rkey, 8) > 0)
+		return FALSE;
+	return TRUE;
+}
+/*====================================================
+ * read_node_file -- read whole file of index or leaf
+ *  into walk buffer (one byte spare, for terminator)
+ *==================================================*/
+static STRING
+read_node_file (BTREE btree, FKEY fkey, INT * psize, LEAFWALK * walk)
+{
+	char scratch[MAXPATHLEN];
+	FILE *fd=NULL;
+	long size=0;
 
+	snprintf(scratch, sizeof(scratch)
+		, "%s%c%s"
+		, bbasedir(btree), LLCHRDIRSEPARATOR, fkey2path(fkey));
+	if (!(fd = fopen(scratch, LLREADBINARY))) {
+		char msg[sizeof(scratch)+64];
+		snprintf(msg, sizeof(msg)
+			, _("Failed (errno=%d) to open blockfile: %s"), errno, scratch);
+		FATAL2(msg);
+	}
+	if (fseek(fd, 0, SEEK_END) || (size = ftell(fd)) < BUFLEN
+		|| fseek(fd, 0, SEEK_SET)) {
+		char msg[sizeof(scratch)+64];
+		snprintf(msg, sizeof(msg), "Bad size for blockfile: %s", scratch);
+		FATAL2(msg);
+	}
+	if (size + 1 > walk->bufsize) {
+		if (walk->buf)
+			stdfree(walk->buf);
+		walk->bufsize = size + 1;
+		walk->buf = (STRING)stdalloc(walk->bufsize);
+	}
+	if (fread(walk->buf, size, 1, fd) != 1) {
+		char msg[sizeof(scratch)+64];
+		snprintf(msg, sizeof(msg), "Read failed for blockfile: %s", scratch);
+		FATAL2(msg);
+	}
+	fclose(fd); /* readonly */
+	walk->buf[size] = 0;
+	*psize = size;
+	return walk->buf;
+}
+/*==============================================
+ * traverse_leaf_keys -- traverse records with given keys
+ *  reading only the data blocks (leaves) that hold them,
+ *  each just once (see traverse_leaf_records)
+ *  keys:  [IN]  keys wanted, in ascending order
+ *  func is called (in key order) for each key found
+ * callback must not write to database
+ *============================================*/
+void
+traverse_leaf_keys (BTREE btree, RKEY * keys, INT nkeys
+	, TRAV_RECORD_FUNC_BYKEY func, void * param)
+{
+	KEYWALK walk;
+	RKEY lo;
+	if (!nkeys) return;
+	walk.keys = keys;
+	walk.nkeys = nkeys;
+	walk.next = 0;
+	walk.func = func;
+	walk.param = param;
+	lo.r_rkey[0] = 0;
+	traverse_leaf_records(btree, lo, keys[nkeys-1], &key_leaf, &key_record, &walk);
+}
+/*====================================================
+ * key_leaf -- Does leaf hold any key of traverse_leaf_keys ?
+ *  leaves come in key order, so keys are consumed
+ *==================================================*/
+static BOOLEAN
+key_leaf (RKEY * lo, RKEY * hi, void * param)
+{
+	KEYWALK * walk = (KEYWALK *)param;
+	while (lo && walk->next < walk->nkeys
+		&& ll_strncmp(walk->keys[walk->next].r_rkey, lo->r_rkey, 8) < 0)
+		++walk->next;
+	if (walk->next >= walk->nkeys)
+		return FALSE;
+	return !hi || ll_strncmp(walk->keys[walk->next].r_rkey, hi->r_rkey, 8) < 0;
+}
+/*====================================================
+ * key_record -- Pass record on if its key is wanted
+ *==================================================*/
+static BOOLEAN
+key_record (RKEY rkey, STRING data, INT len, void * param)
+{
+	KEYWALK * walk = (KEYWALK *)param;
+	INT cmp = 1;
+	while (walk->next < walk->nkeys
+		&& (cmp = ll_strncmp(walk->keys[walk->next].r_rkey, rkey.r_rkey, 8)) < 0)
+		++walk->next;
+	if (walk->next >= walk->nkeys)
+		return FALSE;
+	if (cmp)
+		return TRUE;
+	++walk->next;
+	return (*walk->func)(rkey, data, len, walk->param);
+}
@@ -42,6 +42,16 @@ STRING
 rkey2str (RKEY rkey)
 {
 	static char rbuf[RKEYLEN+1];
+	return rkey2str_r(rkey, rbuf);
+}
+/*=========================================
+ * rkey2str_r -- Convert record key to STRING, in caller's buffer
+ *  rbuf: [OUT] buffer of RKEYLEN+1 chars
+ *  returns pointer into rbuf
+ *=======================================*/
+STRING
+rkey2str_r (RKEY rkey, STRING rbuf)
+{
 	INT i;
 	for (i = 0; i < RKEYLEN; i++)
 		rbuf[i] = rkey.r_rkey[i];
@@ -0,0 +1,501 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * bulkmerge.c -- Merge many pairs of duplicate persons at once
+ *  Each pair names a person to drop and one to keep. The pairs
+ *  are checked together (a drop may be the keep of another pair,
+ *  so chains resolve to the person finally kept), then every
+ *  person kept, family relinked, name record and refn record is
+ *  written once, and the xrefs file once at the end.
+ *  Unlike merge_two_indis (merge.c) there is no editing: the
+ *  person kept gets the union of the lines of all merged into it.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "table.h"
+#include "translat.h"
+#include "gedcom.h"
+#include "zstr.h"
+#include "bulkmerge.h"
+
+/*********************************************
+ * external/imported variables
+ *********************************************/
+
+extern STRING qSronlym, qSnopmrg, qSnoxmrg;
+extern STRING qSbmrgok, qSbmrgdry, qSbmrgnok, qSbmrgkey, qSbmrgtwc, qSbmrglop;
+extern STRING qSbmrgsum, qSbmrgsmd;
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* one (drop, keep) pair of the request */
+struct tag_mergepair {
+	INT seq;          /* position in request */
+	STRING drop;      /* key of person to remove */
+	STRING keep;      /* key of person to merge into */
+	CNSTRING final;   /* keep at end of chain of pairs */
+	CNSTRING error;   /* why pair is not merged, or NULL */
+	BOOLEAN mapped;   /* drop -> keep is in keymap */
+};
+typedef struct tag_mergepair *MERGEPAIR;
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+static NODE append_nodes(NODE list, NODE more);
+static CNSTRING chain_end(CNSTRING key, TABLE keymap, INT count);
+static BOOLEAN check_spouse_sexes(MERGEPAIR pairs, INT count, TABLE spousesex);
+static int cmp_by_final(const void * el1, const void * el2);
+static STRING key_of(CNSTRING key);
+static void merge_group(MERGEPAIR * group, INT n, LIST names, LIST refns);
+static NODE merge_repeated_links(NODE list);
+static BOOLEAN relink_fam(CNSTRING fkey, TABLE finals);
+static NODE relink_nodes(NODE list, TABLE finals, BOOLEAN * pchanged);
+static void report_line(BULKMERGE_REPORT func, void * param, ZSTR zline);
+
+/*********************************************
+ * local function definitions
+ * body of module
+ *********************************************/
+
+/*===================================================
+ * bulk_merge_indis -- Merge each person to drop into the
+ *  person to keep, for many pairs at once
+ *  count:  [IN]  number of pairs
+ *  drops:  [IN]  keys of persons to remove (eg "I12" or "@I12@")
+ *  keeps:  [IN]  keys of persons to merge them into
+ *  dryrun: [IN]  check & report, but change nothing
+ *  func:   [IN]  called with each line of report (may be NULL)
+ * A pair is refused (and reported) if either person does not
+ *  exist, they are the same, its person to drop is already in an
+ *  earlier pair, its pairs form a loop, or it would join parents
+ *  of different sexes; the other pairs are still merged.
+ * returns number of persons merged (or that would be)
+ *=================================================*/
+INT
+bulk_merge_indis (INT count, CNSTRING * drops, CNSTRING * keeps
+	, BOOLEAN dryrun, BULKMERGE_REPORT func, void * param)
+{
+	struct tag_mergepair * pairs = 0;
+	MERGEPAIR * order = 0;
+	TABLE keymap = create_table_str();    /* drop -> keep */
+	TABLE finals = create_table_str();    /* drop -> final keep */
+	TABLE spousesex = create_table_int(); /* sex of persons with FAMS */
+	TABLE famtab = create_table_int();    /* families to relink */
+	TABLE keeptab = create_table_int();
+	LIST names = create_list2(LISTDOFREE);
+	LIST refns = create_list2(LISTDOFREE);
+	ZSTR zline = zs_new();
+	INT i, j, n, merged=0, nfams=0;
+	BOOLEAN changed;
+
+	if (readonly && !dryrun) {
+		zs_sets(zline, _(qSronlym));
+		report_line(func, param, zline);
+		goto end_bulk_merge;
+	}
+	if (count > 0)
+		pairs = (struct tag_mergepair *)stdalloc(count*sizeof(pairs[0]));
+
+	/* check pairs one at a time */
+	for (i = 0; i < count; i++) {
+		MERGEPAIR pair = &pairs[i];
+		NODE indi;
+		pair->seq = i;
+		pair->drop = key_of(drops[i]);
+		pair->keep = key_of(keeps[i]);
+		pair->final = 0;
+		pair->error = 0;
+		pair->mapped = FALSE;
+		if (pair->drop[0] != 'I' || pair->keep[0] != 'I'
+			|| !qkey_to_indi(pair->drop) || !qkey_to_indi(pair->keep)) {
+			pair->error = _(qSbmrgkey);
+			continue;
+		}
+		if (eqstr(pair->drop, pair->keep)) {
+			pair->error = _(qSnopmrg);
+			continue;
+		}
+		if (in_table(keymap, pair->drop)) {
+			pair->error = _(qSbmrgtwc);
+			continue;
+		}
+		insert_table_str(keymap, pair->drop, pair->keep);
+		pair->mapped = TRUE;
+		for (j = 0; j < 2; j++) {
+			CNSTRING key = j ? pair->keep : pair->drop;
+			indi = qkey_to_indi(key);
+			if (FAMS(indi) && !in_table(spousesex, key))
+				insert_table_int(spousesex, key, SEX(indi));
+		}
+	}
+
+	/* check pairs together, until none more are refused */
+	do {
+		changed = FALSE;
+		for (i = 0; i < count; i++) {
+			MERGEPAIR pair = &pairs[i];
+			if (pair->error) continue;
+			if (!(pair->final = chain_end(pair->keep, keymap, count))) {
+				pair->error = _(qSbmrglop);
+				changed = TRUE;
+			}
+		}
+		if (!changed)
+			changed = check_spouse_sexes(pairs, count, spousesex);
+		/* chains now end at persons of refused pairs */
+		for (i = 0; changed && i < count; i++) {
+			if (pairs[i].error && pairs[i].mapped) {
+				delete_table_element(keymap, pairs[i].drop);
+				pairs[i].mapped = FALSE;
+			}
+		}
+	} while (changed);
+
+	/* report pairs, in order requested */
+	n = 0;
+	if (count > 0)
+		order = (MERGEPAIR *)stdalloc(count*sizeof(order[0]));
+	for (i = 0; i < count; i++) {
+		MERGEPAIR pair = &pairs[i];
+		if (pair->error) {
+			zs_setf(zline, _(qSbmrgnok), pair->drop, pair->keep, pair->error);
+		} else {
+			zs_setf(zline, dryrun ? _(qSbmrgdry) : _(qSbmrgok)
+				, pair->drop, pair->final);
+			insert_table_str(finals, pair->drop, pair->final);
+			if (!in_table(keeptab, pair->final))
+				insert_table_int(keeptab, pair->final, 1);
+			order[n++] = pair;
+		}
+		report_line(func, param, zline);
+	}
+	merged = n;
+
+	/* families of persons dropped, which must be relinked */
+	for (i = 0; i < n; i++) {
+		NODE indi = qkey_to_indi(order[i]->drop), node;
+		for (node = nchild(indi); node; node = nsibling(node)) {
+			if ((eqstr(ntag(node), "FAMC") || eqstr(ntag(node), "FAMS"))
+				&& rmvat(nval(node)) && !in_table(famtab, rmvat(nval(node))))
+				insert_table_int(famtab, rmvat(nval(node)), 1);
+		}
+	}
+	nfams = get_table_count(famtab);
+
+	if (!dryrun && n) {
+		TABLE_ITER tabit=0;
+		CNSTRING fkey=0;
+		INT ival;
+
+		begin_xref_batch();
+
+		/* persons kept, each written once with all merged into it */
+		qsort(order, n, sizeof(order[0]), cmp_by_final);
+		for (i = 0; i < n; i = j) {
+			for (j = i+1; j < n && eqstr(order[j]->final, order[i]->final); j++)
+				;
+			merge_group(&order[i], j-i, names, refns);
+		}
+
+		/* families, each written once */
+		nfams = 0;
+		tabit = begin_table_iter(famtab);
+		while (next_table_int(tabit, &fkey, &ival)) {
+			if (relink_fam(fkey, finals))
+				++nfams;
+		}
+		end_table_iter(&tabit);
+
+		/* name & refn records, each written once */
+		rekey_names(names, finals);
+		rekey_refns(refns, finals);
+
+		/* persons dropped */
+		for (i = 0; i < n; i++) {
+			remove_indi_cache(order[i]->drop);
+			remove_from_browse_lists(order[i]->drop);
+			del_in_dbase(order[i]->drop);
+		}
+
+		end_xref_batch();
+
+		/* sanity check lineage links */
+		tabit = begin_table_iter(keeptab);
+		while (next_table_int(tabit, &fkey, &ival))
+			check_indi_lineage_links(key_to_indi(fkey));
+		end_table_iter(&tabit);
+	}
+
+	zs_setf(zline, dryrun ? _(qSbmrgsmd) : _(qSbmrgsum)
+		, (int)merged, (int)get_table_count(keeptab), (int)nfams);
+	report_line(func, param, zline);
+
+end_bulk_merge:
+	for (i = 0; pairs && i < count; i++) {
+		stdfree(pairs[i].drop);
+		stdfree(pairs[i].keep);
+	}
+	if (pairs) stdfree(pairs);
+	if (order) stdfree(order);
+	destroy_table(keymap);
+	destroy_table(finals);
+	destroy_table(spousesex);
+	destroy_table(famtab);
+	destroy_table(keeptab);
+	destroy_list(names);
+	destroy_list(refns);
+	zs_free(&zline);
+	return merged;
+}
+/*===================================================
+ * key_of -- Copy of key without any surrounding @'s
+ *=================================================*/
+static STRING
+key_of (CNSTRING key)
+{
+	CNSTRING bare = (key && key[0] == '@') ? rmvat(key) : key;
+	return strsave(bare ? bare : "");
+}
+/*===================================================
+ * chain_end -- Follow pairs from key to person kept
+ *  returns NULL if the chain loops
+ *=================================================*/
+static CNSTRING
+chain_end (CNSTRING key, TABLE keymap, INT count)
+{
+	CNSTRING next;
+	INT steps = 0;
+	while ((next = valueof_str(keymap, key))) {
+		if (++steps > count)
+			return NULL;
+		key = next;
+	}
+	return key;
+}
+/*===================================================
+ * check_spouse_sexes -- Refuse pairs that would make one
+ *  person of parents of different sexes
+ *  spousesex: [IN]  sex of each person with FAMS lines
+ * returns TRUE if any pair was refused
+ *=================================================*/
+static BOOLEAN
+check_spouse_sexes (MERGEPAIR pairs, INT count, TABLE spousesex)
+{
+	TABLE groupsex = create_table_int(); /* final keep -> sex */
+	BOOLEAN there, refused = FALSE;
+	INT i, sex;
+
+	for (i = 0; i < count; i++) {
+		MERGEPAIR pair = &pairs[i];
+		if (pair->error) continue;
+		sex = valueofbool_int(spousesex, pair->final, &there);
+		if (there && !in_table(groupsex, pair->final))
+			insert_table_int(groupsex, pair->final, sex);
+	}
+	for (i = 0; i < count; i++) {
+		MERGEPAIR pair = &pairs[i];
+		INT gsex;
+		if (pair->error) continue;
+		sex = valueofbool_int(spousesex, pair->drop, &there);
+		if (!there) continue;
+		gsex = valueofbool_int(groupsex, pair->final, &there);
+		if (!there) {
+			insert_table_int(groupsex, pair->final, sex);
+		} else if (gsex != sex) {
+			pair->error = _(qSnoxmrg);
+			refused = TRUE;
+		}
+	}
+	destroy_table(groupsex);
+	return refused;
+}
+/*===================================================
+ * cmp_by_final -- Order pairs by person kept, then request
+ *=================================================*/
+static int
+cmp_by_final (const void * el1, const void * el2)
+{
+	MERGEPAIR pair1 = *(const MERGEPAIR *)el1;
+	MERGEPAIR pair2 = *(const MERGEPAIR *)el2;
+	int rtn = strcmp(pair1->final, pair2->final);
+	if (rtn) return rtn;
+	return (pair1->seq > pair2->seq) - (pair1->seq < pair2->seq);
+}
+/*===================================================
+ * merge_group -- Merge persons dropped into the person kept
+ *  group: [IN]  pairs with the same final keep
+ *  names: [I/O] names of persons dropped are added
+ *  refns: [I/O] refns of persons dropped are added
+ * Lines of the person kept come first, then new lines of each
+ *  person dropped in order; a SEX line is taken from a person
+ *  dropped only if the person kept has none. FAMC & FAMS lines
+ *  to a family already linked are merged into the first such
+ *  line, keeping the lines under them (PEDI, NOTE, SOUR ...).
+ *=================================================*/
+static void
+merge_group (MERGEPAIR * group, INT n, LIST names, LIST refns)
+{
+	NODE name=0, refn=0, sex=0, body=0, famc=0, fams=0;
+	NODE name2, refn2, sex2, body2, famc2, fams2;
+	NODE indi, node;
+	INT i;
+
+	for (i = 0; i < n; i++) {
+		indi = copy_nodes(key_to_indi(group[i]->drop), TRUE, FALSE);
+		split_indi_old(indi, &name2, &refn2, &sex2, &body2, &famc2, &fams2);
+		free_node(indi, "merge_group");
+		for (node = name2; node; node = nsibling(node))
+			if (nval(node)) enqueue_list(names, strsave(nval(node)));
+		for (node = refn2; node; node = nsibling(node))
+			if (nval(node)) enqueue_list(refns, strsave(nval(node)));
+		name = union_nodes(name2, name, TRUE, FALSE);
+		refn = union_nodes(refn2, refn, TRUE, FALSE);
+		body = union_nodes(body2, body, TRUE, FALSE);
+		famc = append_nodes(famc, famc2);
+		fams = append_nodes(fams, fams2);
+		if (!sex)
+			sex = sex2;
+		else
+			free_nodes(sex2);
+	}
+
+	/* no record is read from here until person kept is written */
+	indi = key_to_indi(group[0]->final);
+	split_indi_old(indi, &name2, &refn2, &sex2, &body2, &famc2, &fams2);
+	name2 = union_nodes(name, name2, TRUE, FALSE);
+	refn2 = union_nodes(refn, refn2, TRUE, FALSE);
+	body2 = union_nodes(body, body2, TRUE, FALSE);
+	famc2 = merge_repeated_links(append_nodes(famc2, famc));
+	fams2 = merge_repeated_links(append_nodes(fams2, fams));
+	if (!sex2)
+		sex2 = sex;
+	else
+		free_nodes(sex);
+	join_indi(indi, name2, refn2, sex2, body2, famc2, fams2);
+	/* lines from persons dropped still name their copies as parent */
+	for (node = nchild(indi); node; node = nsibling(node))
+		nparent(node) = indi;
+	indi_to_dbase(indi);
+	rename_from_browse_lists(rmvat(nxref(indi)));
+}
+/*===================================================
+ * relink_fam -- Point family's links to persons dropped
+ *  at the persons kept, and write it if changed
+ *  finals: [IN]  drop key -> final keep key
+ *=================================================*/
+static BOOLEAN
+relink_fam (CNSTRING fkey, TABLE finals)
+{
+	NODE fam = qkey_to_fam(fkey);
+	NODE fref, husb, wife, chil, rest;
+	BOOLEAN changed = FALSE;
+
+	if (!fam) return FALSE;
+	split_fam(fam, &fref, &husb, &wife, &chil, &rest);
+	husb = relink_nodes(husb, finals, &changed);
+	wife = relink_nodes(wife, finals, &changed);
+	chil = relink_nodes(chil, finals, &changed);
+	join_fam(fam, fref, husb, wife, chil, rest);
+	if (changed)
+		fam_to_dbase(fam);
+	return changed;
+}
+/*===================================================
+ * relink_nodes -- Point list of links at persons kept,
+ *  merging any link that then repeats an earlier one
+ *=================================================*/
+static NODE
+relink_nodes (NODE list, TABLE finals, BOOLEAN * pchanged)
+{
+	NODE node;
+	for (node = list; node; node = nsibling(node)) {
+		CNSTRING key = rmvat(nval(node));
+		CNSTRING final = key ? valueof_str(finals, key) : NULL;
+		if (final) {
+			ZSTR zxref = zs_newf("@%s@", final);
+			set_node_val(node, zs_str(zxref));
+			zs_free(&zxref);
+			*pchanged = TRUE;
+		}
+	}
+	return merge_repeated_links(list);
+}
+/*===================================================
+ * merge_repeated_links -- Drop each line of list whose value
+ *  repeats that of an earlier line, moving the lines under
+ *  it to the earlier one (union, so none are lost or doubled)
+ *=================================================*/
+static NODE
+merge_repeated_links (NODE list)
+{
+	NODE node, prev, first, next, kid;
+	for (prev = NULL, node = list; node; node = next) {
+		next = nsibling(node);
+		for (first = list; first != node; first = nsibling(first)) {
+			if (eqstr_ex(nval(first), nval(node)))
+				break;
+		}
+		if (first == node) {
+			prev = node;
+			continue;
+		}
+		if (nchild(node)) {
+			nchild(first) = union_nodes(nchild(node), nchild(first), TRUE, FALSE);
+			nchild(node) = NULL;
+			for (kid = nchild(first); kid; kid = nsibling(kid))
+				nparent(kid) = first;
+		}
+		nsibling(prev) = next;
+		nsibling(node) = NULL;
+		free_nodes(node);
+	}
+	return list;
+}
+/*===================================================
+ * append_nodes -- Append list of nodes to end of another
+ *=================================================*/
+static NODE
+append_nodes (NODE list, NODE more)
+{
+	NODE last = list;
+	if (!list) return more;
+	while (nsibling(last))
+		last = nsibling(last);
+	nsibling(last) = more;
+	return list;
+}
+/*===================================================
+ * report_line -- Pass line of report to caller
+ *=================================================*/
+static void
+report_line (BULKMERGE_REPORT func, void * param, ZSTR zline)
+{
+	if (func)
+		(*func)(zs_str(zline), param);
+}
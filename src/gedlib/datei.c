@@ -277,6 +277,8 @@ static void
 clear_lang (void)
 {
 	INT i,j;
+	/* parsed dates may hold old month names */
+	clear_date_cache();
 	/* clear complex pics */
 	for (i=0; i<ECMPLX_END; ++i) {
 		for (j=0; j<6; ++j) {
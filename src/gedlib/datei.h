@@ -18,6 +18,7 @@ struct tag_gdateval {
 	INT subtype;
 	INT valid; /* -1=bad syntax, 0=freeform, 1=perfect GEDCOM date */
 	STRING text; /* copy of original */
+	INT refcnt; /* held by date cache and callers of extract_date */
 };
 /* typedef struct tag_gdateval *GDATEVAL; */ /* in date.h */
 
@@ -81,6 +82,7 @@ extern TABLE keywordtbl;
 extern BOOLEAN lang_changed;
 
 
+void clear_date_cache(void);
 void initialize_if_needed(void);
 
 
@@ -0,0 +1,382 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * dateindex.c -- Sortable date ranges of events, with persistent index
+ *  Every level 1 event of a person or family with a DATE line
+ *  below it (eg, "1 BIRT" / "2 DATE 3 MAR 1852") is held as the
+ *  range of date keys it may denote, sorted by tag and date, so
+ *  date queries are a range scan rather than a parse of each
+ *  record. As with famgraph, an index file ("dateindex" in the
+ *  database directory, see idxfile.c) is mapped into memory when
+ *  the database is opened, records stored since are parsed from
+ *  their raw bytes, and the file is rewritten when a writable
+ *  database is closed.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "gedcom.h"
+#include "date.h"
+#include "datei.h"
+#include "idxfile.h"
+#include "dateindex.h"
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/*
+ One dated event (an entry of IDXENTRY_WORDS). The record is its
+ key number times two, plus one for a family. The tag is packed
+ (see idxfile_pack_tag), so entries sort by tag first.
+*/
+struct tag_dientry {
+	INT32 tag;
+	INT32 lo;            /* earliest date key event may have */
+	INT32 hi;            /* latest date key event may have */
+	INT32 rec;
+};
+#define DIE_REC 3
+
+/*
+ Index file, as an array of native INT32:
+   header (DIH_SIZE words, the common ones first)
+   entries (header[DIH_COUNT] of them), sorted by tag, lo, hi & rec
+*/
+enum { DIH_COUNT = IXH_COMMON, DIH_SIZE };
+#define DI_MAGIC   0x49444c4c /* "LLDI" */
+#define DI_VERSION 3
+
+/* years beyond this are not indexed (keeps keys within INT32) */
+#define DI_MAXYEAR 99999
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static int cmp_entries(const void * el1, const void * el2);
+static BOOLEAN date_bounds(GDATEVAL gdv, INT32 * plo, INT32 * phi);
+static INT32 gdate_key(struct tag_gdate * gd, BOOLEAN upper);
+static BOOLEAN load_index(void);
+static void parse_dates(INT32 rec, CNSTRING raw, INT len, struct tag_idxlist * list);
+static BOOLEAN report_entry(const struct tag_dientry * die, DATEINDEX_FUNC func, void * param);
+static BOOLEAN write_index(FILE * fp, INT32 * header);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+static struct tag_idxentries diindex = {
+	{ "dateindex", DI_MAGIC, DI_VERSION, DIH_SIZE, 0, 0, 0, FALSE, FALSE, FALSE }
+	, DIE_REC, parse_dates, cmp_entries
+	, 0, 0, FALSE, FALSE, 0, { 0, 0, 0 }
+};
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * gdate_key -- Sortable key of one date
+ *  upper: [IN]  fill in unknown month & day as late as possible ?
+ * returns 0 if year is unknown
+ *===============================================*/
+static INT32
+gdate_key (struct tag_gdate * gd, BOOLEAN upper)
+{
+	INT year = gd->year.val, month = gd->month.val, day = gd->day.val;
+	if (year == BAD_YEAR || year < 0 || year > DI_MAXYEAR)
+		return 0;
+	if (month < 1 || month > 12) {
+		month = upper ? 12 : 1;
+		day = 0;
+	}
+	if (day < 1 || day > 31)
+		day = upper ? 31 : 1;
+	if (gd->eratime == GDV_BC)
+		year = -year;
+	return (INT32)(year * 10000 + month * 100 + day);
+}
+/*=================================================
+ * date_bounds -- Range of date keys a parsed date may denote
+ *  Approximate dates (ABT, EST, CAL) count as the date itself.
+ *  Open ends (BEF, AFT, FROM, TO) reach DATEKEY_MIN or MAX.
+ *  Only Gregorian & Julian dates are keyed (Julian as written).
+ * returns FALSE if date has no usable year
+ *===============================================*/
+static BOOLEAN
+date_bounds (GDATEVAL gdv, INT32 * plo, INT32 * phi)
+{
+	INT32 lo, hi, hi2;
+	INT cal = gdv->date1.calendar;
+	if (gdv->valid == GDV_V_INVALID || gdv->valid == GDV_V_PHRASE)
+		return FALSE;
+	if (cal && cal != GDV_GREGORIAN && cal != GDV_JULIAN)
+		return FALSE;
+	lo = gdate_key(&gdv->date1, FALSE);
+	hi = gdate_key(&gdv->date1, TRUE);
+	if (!lo)
+		return FALSE;
+	if (gdv->type == GDV_RANGE) {
+		if (gdv->subtype == GDVR_BEF)
+			lo = DATEKEY_MIN;
+		else
+			hi = DATEKEY_MAX;
+	} else if (gdv->type == GDV_PERIOD) {
+		if (gdv->subtype == GDVP_TO)
+			lo = DATEKEY_MIN;
+		else
+			hi = DATEKEY_MAX;
+	}
+	if ((gdv->type == GDV_RANGE && gdv->subtype == GDVR_BET_AND)
+		|| (gdv->type == GDV_PERIOD && gdv->subtype == GDVP_FROM_TO)) {
+		cal = gdv->date2.calendar;
+		hi2 = gdate_key(&gdv->date2, TRUE);
+		if (hi2 && hi2 >= lo && (!cal || cal == GDV_GREGORIAN || cal == GDV_JULIAN))
+			hi = hi2;
+	}
+	*plo = lo;
+	*phi = hi;
+	return TRUE;
+}
+/*=================================================
+ * dateindex_date_range -- Range of date keys of a GEDCOM date
+ *  date: [IN]  date value (eg, "BET 1850 AND 1860")
+ *  plo:  [OUT] earliest date key
+ *  phi:  [OUT] latest date key
+ * returns FALSE if date has no usable year
+ *===============================================*/
+BOOLEAN
+dateindex_date_range (CNSTRING date, INT32 * plo, INT32 * phi)
+{
+	GDATEVAL gdv;
+	BOOLEAN ok;
+	if (!date || !date[0])
+		return FALSE;
+	gdv = extract_date((STRING)date);
+	ok = date_bounds(gdv, plo, phi);
+	free_gdateval(gdv);
+	return ok;
+}
+/*=================================================
+ * parse_dates -- Extract dated events from raw record text
+ *  Looks for a level 2 DATE line under each level 1 line
+ *  (only the first DATE of each event is used)
+ *===============================================*/
+static void
+parse_dates (INT32 rec, CNSTRING raw, INT len, struct tag_idxlist * list)
+{
+	CNSTRING end = raw + len;
+	CNSTRING p = raw;
+	INT32 tag = 0;
+	char date[MAXLINELEN+1];
+	struct tag_dientry die;
+	while (p < end) {
+		CNSTRING eol = memchr(p, '\n', end - p);
+		CNSTRING val;
+		INT n;
+		if (!eol) eol = end;
+		if (eol - p > 2 && p[0] == '1' && p[1] == ' ') {
+			for (val = p + 2; val < eol && *val != ' '; ++val)
+				;
+			tag = idxfile_pack_tag(p + 2, val - (p + 2));
+		} else if (tag && eol - p > 7 && !strncmp(p, "2 DATE ", 7)) {
+			n = eol - (p + 7);
+			if (n > MAXLINELEN) n = MAXLINELEN;
+			memcpy(date, p + 7, n);
+			while (n > 0 && (date[n-1] == '\r' || date[n-1] == ' '))
+				--n;
+			date[n] = 0;
+			if (dateindex_date_range(date, &die.lo, &die.hi)) {
+				die.tag = tag;
+				die.rec = rec;
+				idxfile_add_entry(list, (const INT32 *)&die);
+			}
+			tag = 0;
+		}
+		p = eol + 1;
+	}
+}
+/*=================================================
+ * cmp_entries -- Order entries by tag, lo, hi & rec
+ *===============================================*/
+static int
+cmp_entries (const void * el1, const void * el2)
+{
+	const struct tag_dientry * die1 = (const struct tag_dientry *)el1;
+	const struct tag_dientry * die2 = (const struct tag_dientry *)el2;
+	if (die1->tag != die2->tag)
+		return die1->tag < die2->tag ? -1 : 1;
+	if (die1->lo != die2->lo)
+		return die1->lo < die2->lo ? -1 : 1;
+	if (die1->hi != die2->hi)
+		return die1->hi < die2->hi ? -1 : 1;
+	if (die1->rec != die2->rec)
+		return die1->rec < die2->rec ? -1 : 1;
+	return 0;
+}
+/*=================================================
+ * dateindex_record_stored -- Note that a record was written
+ *  (or deleted) so queries follow the write at once
+ *  key: [IN]  key of record stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+void
+dateindex_record_stored (CNSTRING key, CNSTRING rec, INT len)
+{
+	idxfile_record_stored(&diindex, key, rec, len);
+}
+/*=================================================
+ * report_entry -- Pass one entry to caller's function
+ *===============================================*/
+static BOOLEAN
+report_entry (const struct tag_dientry * die, DATEINDEX_FUNC func, void * param)
+{
+	char ntype = (die->rec & 1) ? 'F' : 'I';
+	return (*func)(ntype, die->rec / 2, die->lo, die->hi, param);
+}
+/*=================================================
+ * dateindex_find -- Find events dated within a range
+ *  tag:  [IN]  event tag (eg, "BIRT"), NULL or "" for any;
+ *              tags longer than IDXFILE_MAXTAG are not
+ *              indexed, so none are found (see dateindex_tag_ok)
+ *  from: [IN]  earliest date key wanted
+ *  to:   [IN]  latest date key wanted
+ *  func: [IN]  called for each event whose whole range of
+ *              dates lies between from and to
+ * Events are found in date order, except those of records
+ * stored during this session, which come last.
+ *===============================================*/
+void
+dateindex_find (CNSTRING tag, INT32 from, INT32 to
+	, DATEINDEX_FUNC func, void * param)
+{
+	const struct tag_dientry * entries;
+	const struct tag_dientry * newlist;
+	INT32 ptag = 0;
+	INT i, lo, hi;
+	if (tag && tag[0] && !(ptag = idxfile_pack_tag(tag, strlen(tag))))
+		return;
+	if (!diindex.loaded)
+		idxfile_build_entries(&diindex);
+	entries = (const struct tag_dientry *)diindex.entries;
+	newlist = (const struct tag_dientry *)diindex.newlist.words;
+	lo = 0;
+	hi = diindex.count;
+	if (ptag) {
+		/* binary search for first entry not before (ptag, from) */
+		while (lo < hi) {
+			INT mid = (lo + hi) / 2;
+			const struct tag_dientry * die = &entries[mid];
+			if (die->tag < ptag || (die->tag == ptag && die->lo < from))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+	}
+	for (i=lo; i<diindex.count; ++i) {
+		const struct tag_dientry * die = &entries[i];
+		if (ptag && (die->tag != ptag || die->lo > to))
+			break;
+		if (die->lo < from || die->hi > to
+			|| idxfile_entry_changed(&diindex, (const INT32 *)die))
+			continue;
+		if (!report_entry(die, func, param))
+			return;
+	}
+	for (i=0; i<diindex.newlist.count; ++i) {
+		const struct tag_dientry * die = &newlist[i];
+		if ((ptag && die->tag != ptag) || die->lo < from || die->hi > to)
+			continue;
+		if (!report_entry(die, func, param))
+			return;
+	}
+}
+/*=================================================
+ * dateindex_tag_ok -- Can events of this tag be found ?
+ *  (NULL or "" for any is fine)
+ *===============================================*/
+BOOLEAN
+dateindex_tag_ok (CNSTRING tag)
+{
+	return !tag || strlen(tag) <= IDXFILE_MAXTAG;
+}
+/*=================================================
+ * dateindex_open -- Load index file of database just opened
+ *  Called after xrefs file is open
+ *===============================================*/
+void
+dateindex_open (void)
+{
+	if (diindex.file.path) return;
+	if (idxfile_open(&diindex.file) && !load_index())
+		idxfile_unload(&diindex.file);
+}
+/*=================================================
+ * load_index -- Check rest of index file (after common header)
+ *  returns FALSE if damaged
+ *===============================================*/
+static BOOLEAN
+load_index (void)
+{
+	INT32 * base = diindex.file.base;
+	INT32 count = base[DIH_COUNT];
+	if (count < 0 || DIH_SIZE + count * IDXENTRY_WORDS != diindex.file.words)
+		return FALSE;
+	diindex.entries = base + DIH_SIZE;
+	diindex.count = count;
+	diindex.loaded = TRUE;
+	return TRUE;
+}
+/*=================================================
+ * write_index -- Write all entries to a new index file
+ *===============================================*/
+static BOOLEAN
+write_index (FILE * fp, INT32 * header)
+{
+	struct tag_idxlist all;
+	BOOLEAN ok;
+	idxfile_merge_entries(&diindex, &all);
+	header[DIH_COUNT] = all.count;
+	ok = fwrite(header, sizeof(INT32), DIH_SIZE, fp) == DIH_SIZE
+		&& fwrite(all.words, IDXENTRY_WORDS * sizeof(INT32), all.count, fp)
+			== (size_t)all.count;
+	if (all.words)
+		stdfree(all.words);
+	return ok;
+}
+/*=================================================
+ * dateindex_close -- Free all entries
+ *  Called when database is closed (before xrefs file)
+ *  Writes a fresh index file if database was changed
+ *  or had none.
+ *===============================================*/
+void
+dateindex_close (void)
+{
+	BOOLEAN replace = idxfile_write(&diindex.file, write_index);
+	idxfile_free_entries(&diindex);
+	idxfile_close(&diindex.file, replace);
+}
@@ -68,6 +68,7 @@ static BOOLEAN is_valid_day(struct tag_gdate * pdate, struct tag_dnum day);
 static BOOLEAN is_valid_month(struct tag_gdate * pdate, struct tag_dnum month);
 static void mark_freeform(GDATEVAL gdv);
 static void mark_invalid(GDATEVAL gdv);
+static GDATEVAL parse_date(STRING str);
 static void set_date_string(STRING);
 
 /*********************************************
@@ -76,6 +77,15 @@ static void set_date_string(STRING);
 
 static STRING sstr, sstr_start;
 
+/*
+ Parsed dates most recently asked for, keyed by their text (a
+ direct-mapped cache: each text has one slot, and a new text
+ evicts the old one). The cache holds a reference to each, and
+ callers get another, so the values must not be modified.
+*/
+#define DATECACHE_SIZE 1024 /* power of 2 */
+static GDATEVAL datecache[DATECACHE_SIZE];
+
 /*********************************************
  * local & exported function definitions
  * body of module
@@ -104,10 +114,55 @@ mark_freeform (GDATEVAL gdv)
 /*=====================================================
  * extract_date -- Extract date from free format string
  *  str:  [IN]  date to parse
- * returns new date_val
+ * returns date_val, which is shared with the date cache
+ *  (caller must not modify it, and must free_gdateval it)
  *===================================================*/
 GDATEVAL
 extract_date (STRING str)
+{
+	unsigned long h = 2166136261UL;
+	CNSTRING p;
+	GDATEVAL gdv, *slot;
+	if (!str || !str[0])
+		return parse_date(str);
+	/* may reload language, which empties cache */
+	initialize_if_needed();
+	for (p = str; *p; ++p)
+		h = ((h ^ (uchar)*p) * 16777619UL) & 0xffffffffUL;
+	slot = &datecache[h & (DATECACHE_SIZE-1)];
+	if (*slot && eqstr((*slot)->text, str)) {
+		++(*slot)->refcnt;
+		return *slot;
+	}
+	gdv = parse_date(str);
+	if (*slot)
+		free_gdateval(*slot);
+	*slot = gdv;
+	++gdv->refcnt;
+	return gdv;
+}
+/*=====================================================
+ * clear_date_cache -- Drop all parsed dates from cache
+ *  (those still held by callers are freed when released)
+ *===================================================*/
+void
+clear_date_cache (void)
+{
+	INT i;
+	for (i=0; i<DATECACHE_SIZE; ++i) {
+		if (datecache[i]) {
+			free_gdateval(datecache[i]);
+			datecache[i] = 0;
+		}
+	}
+}
+/*=====================================================
+ * parse_date -- Parse free format date string
+ *  str:  [IN]  date to parse
+ * returns new date_val
+ *===================================================*/
+static GDATEVAL
+parse_date (STRING str)
 {
 	/* we accumulate numbers to figure when we finish a
 	date (with a full period or range, we may finish the
@@ -496,6 +551,7 @@ create_gdateval (void)
 	gdv->date1.year.val = BAD_YEAR;
 	gdv->date2.year.val = BAD_YEAR;
 	gdv->valid = GDV_V_GOOD;
+	gdv->refcnt = 1;
 	return gdv;
 
 }
@@ -511,13 +567,15 @@ free_gdate (struct tag_gdate * gdate)
 	clear_dnum(&gdate->day);
 }
 /*===============================================
- * free_gdateval -- Delete existing GEDCOM date_val
+ * free_gdateval -- Release GEDCOM date_val, deleting
+ *  it when neither date cache nor caller holds it
  * Created: 2001/12/28 (Perry Rapp)
  *=============================================*/
 void
 free_gdateval (GDATEVAL gdv)
 {
 	if (!gdv) return;
+	if (--gdv->refcnt > 0) return;
 	free_gdate(&gdv->date1);
 	free_gdate(&gdv->date2);
 	if (gdv->text)
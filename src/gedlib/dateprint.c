@@ -120,7 +120,9 @@ do_zformat_date (STRING str, INT dfmt, INT mfmt,
 		gdv = extract_date(str);
 		if (gdv->valid == GDV_V_PHRASE) {
 			/* GEDCOM date phrases (parenthesized) shown "as is" */
-			return zs_news(gdv->text);
+			zs_sets(zstr, gdv->text);
+			free_gdateval(gdv);
+			return zstr;
 		}
 		format_day(gdv->date1.day, dfmt, daystr);
 		smo = format_month(gdv->date1.calendar, gdv->date1.month, mfmt);
@@ -139,7 +141,10 @@ do_zformat_date (STRING str, INT dfmt, INT mfmt,
 		gdv = extract_date(str);
 		if (gdv->valid == GDV_V_PHRASE) {
 			/* GEDCOM date phrases (parenthesized) shown "as is" */
-			return zs_news(gdv->text);
+			zs_sets(zstr, gdv->text);
+			zs_free(&zstr2);
+			free_gdateval(gdv);
+			return zstr;
 		}
 		format_day(gdv->date1.day, dfmt, daystr);
 		smo = format_month(gdv->date1.calendar, gdv->date1.month, mfmt);
@@ -0,0 +1,565 @@
+/* 
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * famgraph.c -- Compact family graph, with persistent index
+ *  Holds, per record number, the FAMC & FAMS links of persons
+ *  and the HUSB, WIFE & CHIL links of families.
+ *  An index file ("famgraph" in the database directory, see
+ *  idxfile.c) is mapped into memory when the database is opened,
+ *  so walking the graph needs neither NODE trees nor btree reads.
+ *  Records stored since the index was written are parsed straight
+ *  from their raw bytes, and the index is rewritten when a
+ *  writable database is closed.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "gedcom.h"
+#include "idxfile.h"
+#include "famgraph.h"
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/*
+ Each loaded record has one block of INT32:
+   [count of list 0][count of list 1][count of list 2][links...]
+ Persons use lists FGL_FAMC & FGL_FAMS (list 2 is empty),
+ families use FGL_HUSB, FGL_WIFE & FGL_CHIL.
+ A block is either stdalloc'd, or points into the index file.
+ A NULL entry means not yet loaded, and absent_links means
+ there is no such (live) record.
+*/
+struct tag_fgtype {
+	char ntype;          /* 'I' or 'F' */
+	INT32 **adj;         /* adjacency blocks indexed by key number */
+	INT max;             /* allocated size of adj */
+	const INT32 *disk;   /* offsets of blocks in index file */
+	INT disk_max;        /* number of offsets in index file */
+};
+
+/*
+ Index file, as an array of native INT32:
+   header (FGH_SIZE words, the common ones first)
+   person offsets (header[IXH_IMAX] words, indexed by key number)
+   family offsets (header[IXH_FMAX] words, indexed by key number)
+   blocks, as above
+ An offset is counted in words from start of file, and 0 means
+ no such record.
+*/
+enum { FGH_WORDS = IXH_COMMON, FGH_SIZE };
+#define FG_MAGIC   0x47464c4c /* "LLFG" */
+#define FG_VERSION 2
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static INT32 assign_offsets(struct tag_fgtype * fgt, INT32 max, INT32 * offs, INT32 words);
+static INT block_size(const INT32 * links);
+static INT32 * disk_block(INT32 offset);
+static void free_block(INT32 * links);
+static INT32 * get_links(struct tag_fgtype * fgt, INT keynum);
+static void grow_adj(struct tag_fgtype * fgt, INT keynum);
+static INT link_list_of_tag(char ntype, CNSTRING tag, INT taglen, char *ptype);
+static INT32 * load_links(struct tag_fgtype * fgt, INT keynum);
+static BOOLEAN load_index(void);
+static struct tag_fgtype * parse_key(CNSTRING key, INT * pkeynum);
+static INT32 * parse_links(char ntype, CNSTRING raw, INT len);
+static INT32 parse_pointer(CNSTRING val, CNSTRING end, char ptype);
+static INT32 * record_links(struct tag_fgtype * fgt, INT keynum, CNSTRING rec, INT len);
+static void term_fgtype(struct tag_fgtype * fgt);
+static void unload_index(void);
+static BOOLEAN write_blocks(FILE * fp, struct tag_fgtype * fgt, INT32 max);
+static BOOLEAN write_index(FILE * fp, INT32 * header);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+static INT32 absent_links[FGL_NUMLISTS] = { 0, 0, 0 };
+static struct tag_fgtype fgindis = { 'I', 0, 0, 0, 0 };
+static struct tag_fgtype fgfams = { 'F', 0, 0, 0, 0 };
+static struct tag_idxfile fgfile = { "famgraph", FG_MAGIC, FG_VERSION, FGH_SIZE
+	, 0, 0, 0, FALSE, FALSE, FALSE };
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * famgraph_indi_links -- Get one link list of a person
+ *  ikeynum: [IN]  person key number (eg, 43 for I43)
+ *  list:    [IN]  FGL_FAMC or FGL_FAMS
+ *  plinks:  [OUT] family key numbers (owned by graph)
+ * returns number of links
+ *===============================================*/
+INT
+famgraph_indi_links (INT ikeynum, INT list, const INT32 ** plinks)
+{
+	INT32 * links = get_links(&fgindis, ikeynum);
+	INT i, offset = FGL_NUMLISTS;
+	ASSERT(list == FGL_FAMC || list == FGL_FAMS);
+	for (i=0; i<list; ++i)
+		offset += links[i];
+	*plinks = links + offset;
+	return links[list];
+}
+/*=================================================
+ * famgraph_fam_links -- Get one link list of a family
+ *  fkeynum: [IN]  family key number (eg, 12 for F12)
+ *  list:    [IN]  FGL_HUSB, FGL_WIFE or FGL_CHIL
+ *  plinks:  [OUT] person key numbers (owned by graph)
+ * returns number of links
+ *===============================================*/
+INT
+famgraph_fam_links (INT fkeynum, INT list, const INT32 ** plinks)
+{
+	INT32 * links = get_links(&fgfams, fkeynum);
+	INT i, offset = FGL_NUMLISTS;
+	ASSERT(list >= FGL_HUSB && list <= FGL_CHIL);
+	for (i=0; i<list; ++i)
+		offset += links[i];
+	*plinks = links + offset;
+	return links[list];
+}
+/*=================================================
+ * famgraph_indi_exists -- Is there a live person with this number ?
+ *===============================================*/
+BOOLEAN
+famgraph_indi_exists (INT ikeynum)
+{
+	return get_links(&fgindis, ikeynum) != absent_links;
+}
+/*=================================================
+ * famgraph_fam_exists -- Is there a live family with this number ?
+ *===============================================*/
+BOOLEAN
+famgraph_fam_exists (INT fkeynum)
+{
+	return get_links(&fgfams, fkeynum) != absent_links;
+}
+/*=================================================
+ * grow_adj -- Make room in adj for keynum
+ *===============================================*/
+static void
+grow_adj (struct tag_fgtype * fgt, INT keynum)
+{
+	INT newmax = fgt->max ? fgt->max : 1024;
+	INT32 ** adj;
+	if (keynum < fgt->max)
+		return;
+	while (newmax <= keynum)
+		newmax <<= 1;
+	adj = (INT32 **)stdalloc(newmax * sizeof(adj[0]));
+	memset(adj, 0, newmax * sizeof(adj[0]));
+	if (fgt->adj) {
+		memcpy(adj, fgt->adj, fgt->max * sizeof(adj[0]));
+		stdfree(fgt->adj);
+	}
+	fgt->adj = adj;
+	fgt->max = newmax;
+}
+/*=================================================
+ * get_links -- Find (loading if needed) adjacency of one record
+ *  Uses index file if it has a valid entry, else raw record
+ *===============================================*/
+static INT32 *
+get_links (struct tag_fgtype * fgt, INT keynum)
+{
+	if (keynum <= 0 || keynum > MAXKEYNUMBER)
+		return absent_links;
+	grow_adj(fgt, keynum);
+	if (fgt->adj[keynum])
+		return fgt->adj[keynum];
+	if (keynum < fgt->disk_max)
+		fgt->adj[keynum] = disk_block(fgt->disk[keynum]);
+	if (!fgt->adj[keynum])
+		fgt->adj[keynum] = load_links(fgt, keynum);
+	return fgt->adj[keynum];
+}
+/*=================================================
+ * load_links -- Read adjacency of one record from btree
+ *===============================================*/
+static INT32 *
+load_links (struct tag_fgtype * fgt, INT keynum)
+{
+	char key[MAXKEYWIDTH+2];
+	STRING raw=0;
+	INT len=0;
+	INT32 * links = absent_links;
+	snprintf(key, sizeof(key), "%c" FMT_INT, fgt->ntype, keynum);
+	raw = retrieve_raw_record(key, &len);
+	if (raw) {
+		links = parse_links(fgt->ntype, raw, len);
+		stdfree(raw);
+	}
+	return links;
+}
+/*=================================================
+ * disk_block -- Find block in index file
+ *  returns NULL if offset does not lead to a sane block
+ *===============================================*/
+static INT32 *
+disk_block (INT32 offset)
+{
+	INT32 * links;
+	INT i;
+	if (!offset)
+		return absent_links;
+	if (offset < FGH_SIZE || offset > fgfile.words - FGL_NUMLISTS)
+		return NULL;
+	links = fgfile.base + offset;
+	for (i=0; i<FGL_NUMLISTS; ++i) {
+		if (links[i] < 0 || links[i] > fgfile.words)
+			return NULL;
+	}
+	if (offset + block_size(links) > fgfile.words)
+		return NULL;
+	return links;
+}
+/*=================================================
+ * block_size -- Number of INT32 in an adjacency block
+ *===============================================*/
+static INT
+block_size (const INT32 * links)
+{
+	return FGL_NUMLISTS + links[0] + links[1] + links[2];
+}
+/*=================================================
+ * free_block -- Free adjacency block, if it is ours
+ *===============================================*/
+static void
+free_block (INT32 * links)
+{
+	if (!links || links == absent_links)
+		return;
+	if (fgfile.base && links >= fgfile.base
+		&& links < fgfile.base + fgfile.words)
+		return;
+	stdfree(links);
+}
+/*=================================================
+ * link_list_of_tag -- Which link list does a level 1 tag feed ?
+ *  ptype: [OUT] type of record the pointer must reference
+ * returns -1 if tag is not a link
+ *===============================================*/
+static INT
+link_list_of_tag (char ntype, CNSTRING tag, INT taglen, char *ptype)
+{
+	if (taglen != 4)
+		return -1;
+	if (ntype == 'I') {
+		*ptype = 'F';
+		if (!strncmp(tag, "FAMC", 4)) return FGL_FAMC;
+		if (!strncmp(tag, "FAMS", 4)) return FGL_FAMS;
+	} else {
+		*ptype = 'I';
+		if (!strncmp(tag, "HUSB", 4)) return FGL_HUSB;
+		if (!strncmp(tag, "WIFE", 4)) return FGL_WIFE;
+		if (!strncmp(tag, "CHIL", 4)) return FGL_CHIL;
+	}
+	return -1;
+}
+/*=================================================
+ * parse_pointer -- Parse "@F12@" style value
+ *  returns key number, or 0 if not a pointer of type ptype
+ *===============================================*/
+static INT32
+parse_pointer (CNSTRING val, CNSTRING end, char ptype)
+{
+	INT32 keynum = 0;
+	if (end - val < 4 || val[0] != '@' || val[1] != ptype)
+		return 0;
+	for (val += 2; val < end && *val >= '0' && *val <= '9'; ++val) {
+		keynum = keynum * 10 + (*val - '0');
+		if (keynum > MAXKEYNUMBER)
+			return 0;
+	}
+	if (val >= end || *val != '@')
+		return 0;
+	return keynum;
+}
+/*=================================================
+ * parse_links -- Extract link lists from raw record text
+ *  Only level 1 lines are examined, eg "1 FAMC @F12@"
+ *  Two passes: count links, then fill them in record order
+ *===============================================*/
+static INT32 *
+parse_links (char ntype, CNSTRING raw, INT len)
+{
+	INT counts[FGL_NUMLISTS];
+	INT fill[FGL_NUMLISTS];
+	INT32 * links = 0;
+	CNSTRING end = raw + len;
+	INT pass, i, total;
+	memset(counts, 0, sizeof(counts));
+	for (pass=0; pass<2; ++pass) {
+		CNSTRING p = raw;
+		while (p < end) {
+			CNSTRING eol = memchr(p, '\n', end - p);
+			CNSTRING tag, val;
+			INT list;
+			char ptype=0;
+			INT32 keynum;
+			if (!eol) eol = end;
+			if (eol - p > 2 && p[0] == '1' && p[1] == ' ') {
+				tag = p + 2;
+				for (val = tag; val < eol && *val != ' '; ++val)
+					;
+				list = link_list_of_tag(ntype, tag, val - tag, &ptype);
+				if (list >= 0 && val < eol) {
+					keynum = parse_pointer(val + 1, eol, ptype);
+					if (keynum) {
+						if (pass == 0)
+							++counts[list];
+						else
+							links[fill[list]++] = keynum;
+					}
+				}
+			}
+			p = eol + 1;
+		}
+		if (pass == 0) {
+			total = FGL_NUMLISTS;
+			for (i=0; i<FGL_NUMLISTS; ++i) {
+				fill[i] = total;
+				total += counts[i];
+			}
+			links = (INT32 *)stdalloc(total * sizeof(links[0]));
+			for (i=0; i<FGL_NUMLISTS; ++i)
+				links[i] = counts[i];
+		}
+	}
+	return links;
+}
+/*=================================================
+ * parse_key -- Find graph & key number for "I12" style key
+ *  returns NULL if not a person or family key
+ *===============================================*/
+static struct tag_fgtype *
+parse_key (CNSTRING key, INT * pkeynum)
+{
+	INT32 code = idxfile_rec_code(key);
+	if (!code)
+		return NULL;
+	*pkeynum = code / 2;
+	return (code & 1) ? &fgfams : &fgindis;
+}
+/*=================================================
+ * famgraph_record_stored -- Note that a record was written
+ *  (or deleted) so the graph follows the write at once
+ *  key: [IN]  key of record stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+void
+famgraph_record_stored (CNSTRING key, CNSTRING rec, INT len)
+{
+	INT keynum=0;
+	struct tag_fgtype * fgt = parse_key(key, &keynum);
+	if (!fgt) return;
+	idxfile_mark_dirty(&fgfile);
+	grow_adj(fgt, keynum);
+	free_block(fgt->adj[keynum]);
+	fgt->adj[keynum] = record_links(fgt, keynum, rec, len);
+}
+/*=================================================
+ * record_links -- Adjacency of record as stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+static INT32 *
+record_links (struct tag_fgtype * fgt, INT keynum, CNSTRING rec, INT len)
+{
+	if (!rec)
+		return load_links(fgt, keynum);
+	if (len == 5 && !strncmp(rec, "DELE\n", 5))
+		return absent_links;
+	return parse_links(fgt->ntype, rec, len);
+}
+/*=================================================
+ * famgraph_open -- Load index file of database just opened
+ *  Called after xrefs file is open
+ *===============================================*/
+void
+famgraph_open (void)
+{
+	if (fgfile.path) return;
+	if (idxfile_open(&fgfile) && !load_index())
+		unload_index();
+}
+/*=================================================
+ * load_index -- Check rest of index file (after common header)
+ *  returns FALSE if damaged
+ *===============================================*/
+static BOOLEAN
+load_index (void)
+{
+	INT32 * base = fgfile.base;
+	INT32 imax = base[IXH_IMAX], fmax = base[IXH_FMAX];
+	if (base[FGH_WORDS] != fgfile.words
+		|| imax < 0 || fmax < 0 || FGH_SIZE + imax + fmax > fgfile.words)
+		return FALSE;
+	fgindis.disk = base + FGH_SIZE;
+	fgindis.disk_max = imax;
+	fgfams.disk = base + FGH_SIZE + imax;
+	fgfams.disk_max = fmax;
+	return TRUE;
+}
+/*=================================================
+ * unload_index -- Release index file contents
+ *===============================================*/
+static void
+unload_index (void)
+{
+	idxfile_unload(&fgfile);
+	fgindis.disk = fgfams.disk = 0;
+	fgindis.disk_max = fgfams.disk_max = 0;
+}
+/*=================================================
+ * assign_offsets -- Lay out blocks of one record type
+ *  offs:  [OUT] offset of each record's block (0 if none)
+ *  words: [IN]  first free offset
+ * returns first free offset after these blocks
+ *===============================================*/
+static INT32
+assign_offsets (struct tag_fgtype * fgt, INT32 max, INT32 * offs, INT32 words)
+{
+	INT keynum;
+	if (max > 0)
+		offs[0] = 0;
+	for (keynum=1; keynum<max; ++keynum) {
+		INT32 * links = get_links(fgt, keynum);
+		if (links == absent_links) {
+			offs[keynum] = 0;
+		} else {
+			offs[keynum] = words;
+			words += block_size(links);
+		}
+	}
+	return words;
+}
+/*=================================================
+ * write_blocks -- Write blocks of one record type, in key order
+ *===============================================*/
+static BOOLEAN
+write_blocks (FILE * fp, struct tag_fgtype * fgt, INT32 max)
+{
+	INT keynum;
+	for (keynum=1; keynum<max; ++keynum) {
+		INT32 * links = get_links(fgt, keynum);
+		INT size = block_size(links);
+		if (links == absent_links)
+			continue;
+		if (fwrite(links, sizeof(INT32), size, fp) != (size_t)size)
+			return FALSE;
+	}
+	return TRUE;
+}
+/*=================================================
+ * write_index -- Write whole graph to a new index file
+ *  Entries not yet in memory come from the old index file,
+ *  or (if there was none) from the records themselves.
+ *===============================================*/
+static BOOLEAN
+write_index (FILE * fp, INT32 * header)
+{
+	INT32 imax = header[IXH_IMAX], fmax = header[IXH_FMAX];
+	INT32 * offs = (INT32 *)stdalloc((imax + fmax + 1) * sizeof(INT32));
+	INT32 words = FGH_SIZE + imax + fmax;
+	BOOLEAN ok;
+
+	words = assign_offsets(&fgindis, imax, offs, words);
+	words = assign_offsets(&fgfams, fmax, offs + imax, words);
+	header[FGH_WORDS] = words;
+	ok = fwrite(header, sizeof(INT32), FGH_SIZE, fp) == FGH_SIZE
+		&& fwrite(offs, sizeof(INT32), imax + fmax, fp) == (size_t)(imax + fmax)
+		&& write_blocks(fp, &fgindis, imax)
+		&& write_blocks(fp, &fgfams, fmax);
+	stdfree(offs);
+	return ok;
+}
+/*=================================================
+ * famgraph_index_loaded -- Is a current index file in use ?
+ *===============================================*/
+BOOLEAN
+famgraph_index_loaded (void)
+{
+	return fgfile.base && !fgfile.dirty;
+}
+/*=================================================
+ * famgraph_index_matches -- Does index file agree with record ?
+ *  key: [IN]  person or family key, live or not
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *  (used by dbverify)
+ *===============================================*/
+BOOLEAN
+famgraph_index_matches (CNSTRING key, CNSTRING rec, INT len)
+{
+	INT keynum=0;
+	struct tag_fgtype * fgt = parse_key(key, &keynum);
+	INT32 * indexed, * actual;
+	BOOLEAN same;
+	if (!fgt) return TRUE;
+	indexed = (keynum < fgt->disk_max) ? disk_block(fgt->disk[keynum]) : absent_links;
+	if (!indexed)
+		return FALSE;
+	actual = record_links(fgt, keynum, rec, len);
+	same = (block_size(indexed) == block_size(actual))
+		&& !memcmp(indexed, actual, block_size(actual) * sizeof(INT32));
+	free_block(actual);
+	return same;
+}
+/*=================================================
+ * term_fgtype -- Free all adjacency of one record type
+ *===============================================*/
+static void
+term_fgtype (struct tag_fgtype * fgt)
+{
+	INT i;
+	for (i=0; i<fgt->max; ++i)
+		free_block(fgt->adj[i]);
+	if (fgt->adj)
+		stdfree(fgt->adj);
+	fgt->adj = 0;
+	fgt->max = 0;
+}
+/*=================================================
+ * famgraph_close -- Free the whole graph
+ *  Called when database is closed (before xrefs file)
+ *  Writes a fresh index file if database was changed
+ *  or had none.
+ *===============================================*/
+void
+famgraph_close (void)
+{
+	BOOLEAN replace = idxfile_write(&fgfile, write_index);
+	term_fgtype(&fgindis);
+	term_fgtype(&fgfams);
+	unload_index();
+	idxfile_close(&fgfile, replace);
+}
@@ -10,34 +10,46 @@
  * Copyright(c) 2000-2001 by Perry Rapp; all rights reserved
  * This is a complete rewrite of the original gen_gedcom
  *   Created: 2000/10
+ * The closure holds only key numbers (a bitset per record type),
+ * and records are streamed raw from the btree a leaf block at a
+ * time, both to find their pointers and to output them, so no
+ * NODE trees are built and the record cache is not touched.
  *==============================================================*/
 
 #include "sys_inc.h"
 #include <string.h>
 #include "llstdlib.h"
-#include "table.h"
+#include "btree.h"
 #include "gedcom.h"
 #include "indiseq.h"
+#include "bitset.h"
+#include "famgraph.h"
 #include "interp.h"	/* for poutput */
 #include "gengedc.h"
 
+extern BTREE BTR;
+
 /*********************************************
  * local types
  *********************************************/
 
 /*======================================================
  * CLOSURE -- holds data used to make output consistent 
- * as nodes are output, they are tested, and put on closure list
- * if required - at the end, the closure list is processed
+ * records are put in closure (by key number) as found,
+ * and in strong mode also on the pending list, whose
+ * records are read in turn for pointers to more records
+ * at the end, all records in closure are output
  * (GENGENDCOM_WEAK does not accumulate closure list, but
   * modifies values being output instead)
  *====================================================*/
 typedef struct closure_s
 { 
 	int gengedcl;
-	TABLE tab; /* table of nodes in seq */
-	INDISEQ seq; /* (top-level) nodes to process */
-	INDISEQ outseq; /* (top-level) nodes to output */
+	BITSET keys[5]; /* key numbers in closure, by type (see closure_types) */
+	RKEY * pending; /* records to process (strong mode) */
+	INT npending;
+	INT maxpending;
+	BOOLEAN * eflg; /* set if output fails */
 	/* filter criteria would be added here */
 } CLOSURE;
 
@@ -49,80 +61,92 @@ typedef struct closure_s
  * local function prototypes
  *********************************************/
 
-static BOOLEAN closure_has_key(CLOSURE * closure, STRING key);
-static void closure_add_key(CLOSURE * closure, CNSTRING key, STRING tag);
-static void closure_add_output_node (CLOSURE * closure, NODE node);
+static BOOLEAN closure_has_key(CLOSURE * closure, char ktype, INT keynum);
+static void closure_add_key(CLOSURE * closure, char ktype, INT32 keynum);
 static void closure_init(CLOSURE * closure, int gengedcl);
 static void closure_free(CLOSURE * closure);
-static void closure_wipe_processlist(CLOSURE * closure);
+static BITSET closure_keyset(CLOSURE * closure, char ktype);
 static BOOLEAN closure_is_original(CLOSURE * closure);
 static BOOLEAN closure_is_strong(CLOSURE * closure);
 static BOOLEAN closure_is_dump(CLOSURE * closure);
+static void closure_process_pending(CLOSURE * closure);
+static int cmp_rkeys(const void * el1, const void * el2);
+static void count_family(BITSET once, BITSET twice, INT fkeynum);
+static CNSTRING next_record_line(CNSTRING p, CNSTRING end, STRING line, INT maxlen);
+static BOOLEAN parse_line(STRING line, INT *plev, STRING *pxref, STRING *ptag, STRING *pval);
 static void process_node_value(CLOSURE * closure, STRING v);
-static void output_any_node(CLOSURE * closure, NODE node, STRING toptag, INT lvl, BOOLEAN *eflg);
-static void output_top_node(CLOSURE * closure, NODE node, BOOLEAN *eflg);
-static void process_any_node(CLOSURE * closure, NODE node);
+static BOOLEAN output_line(CLOSURE * closure, STRING toptag, INT lvl
+	, STRING xref, STRING tag, STRING v);
+static BOOLEAN output_record(RKEY rkey, STRING data, INT len, void * param);
+static BOOLEAN process_record(RKEY rkey, STRING data, INT len, void * param);
 
 
 /*********************************************
  * local variables
  *********************************************/
 
+/* record types, in canonical (output) order */
+static const char closure_types[] = "IFSEX";
+
 /*********************************************
  * local function definitions
  * body of module
  *********************************************/
 
+/*======================================================
+ * closure_keyset -- bitset of closure for a record type
+ * returns NULL for other types
+ *====================================================*/
+static BITSET
+closure_keyset (CLOSURE * closure, char ktype)
+{
+	CNSTRING p = ktype ? strchr(closure_types, ktype) : NULL;
+	return p ? closure->keys[p - closure_types] : NULL;
+}
 /*======================================================
  * closure_has_key -- does closure have this key ?
- * the table stores all the keys we have
- * regardless of their status:
- *    in the seq list meaning to-process
- *    not in our lists if in-process (client uses temp list)
- *    in the output list
+ * the bitsets hold all the keys we have
+ * regardless of their status (pending or processed)
  *====================================================*/
 static BOOLEAN
-closure_has_key (CLOSURE * closure, STRING key)
+closure_has_key (CLOSURE * closure, char ktype, INT keynum)
 {
-	return in_table(closure->tab, key);
+	BITSET keys = closure_keyset(closure, ktype);
+	return keys && keynum > 0 && bitset_test(keys, keynum);
 }
 /*======================================================
- * closure_add_key -- add a (top-level) node to the closure
- * we store the key (eg, "I1") and also the tag (eg, "INDI")
- * We give seq a new alloc of the key (tab makes its own)
- * neither gets an alloc of the tag
+ * closure_add_key -- add a (top-level) record to the closure
+ * eg, ktype='I' & keynum=1 for I1
+ * in strong mode, it is also put on the pending list,
+ * to be read for pointers to other records
  *====================================================*/
 static void
-closure_add_key (CLOSURE * closure, CNSTRING key, STRING tag)
+closure_add_key (CLOSURE * closure, char ktype, INT32 keynum)
 {
-	if (in_table(closure->tab, key)) return;
+	BITSET keys = closure_keyset(closure, ktype);
+	char key[MAXKEYWIDTH+4]; /* room for any INT32 */
+
+	if (!keys || keynum <= 0 || bitset_test(keys, keynum))
+		return;
 
 	/* filter for invalid pointers */
-	if (!key_to_type(key, TRUE))
+	snprintf(key, sizeof(key), "%c" FMT_INT32, ktype, keynum);
+	if (!is_key_in_use(key))
 		return;
 
-	/* we'll store the tag as the value 
-	 during gengedcom, all append_indiseqs alloc their own keys & vals (tags) */
-	append_indiseq_sval(closure->seq, strsave(key), NULL, strsave(tag),
-	    TRUE, TRUE);
-	/* generic tables handle their own allocation of keys & values */
-	/* we don't use the value at all, only the fact that the
-	key is present */
-	insert_table_int(closure->tab, key, 1);
-}
-/*======================================================
- * closure_add_output_node -- add a (top-level) node to the output list
- * the node should come from the processing list originally, and
- * therefore already be in the table
- *====================================================*/
-static void
-closure_add_output_node (CLOSURE * closure, NODE node)
-{
-	STRING key=rmvat(nxref(node));
-	STRING tag=ntag(node);
-	/* during gengedcom, all append_indiseqs alloc their own keys & vals (tags) */
-	append_indiseq_sval(closure->outseq, strsave(key), NULL, strsave(tag),
-	    TRUE, TRUE);
+	bitset_set(keys, keynum);
+	if (!closure_is_strong(closure))
+		return;
+	if (closure->npending == closure->maxpending) {
+		RKEY * old = closure->pending;
+		closure->maxpending = closure->maxpending ? 2*closure->maxpending : 256;
+		closure->pending = (RKEY *)stdalloc(closure->maxpending * sizeof(RKEY));
+		if (old) {
+			memcpy(closure->pending, old, closure->npending * sizeof(RKEY));
+			stdfree(old);
+		}
+	}
+	closure->pending[closure->npending++] = str2rkey(key);
 }
 /*======================================================
  * closure_init -- allocate everything in closure
@@ -130,9 +154,12 @@ closure_add_output_node (CLOSURE * closure, NODE node)
 static void
 closure_init (CLOSURE * closure, int gengedcl)
 {
-	closure->tab = create_table_int();
-	closure->seq = create_indiseq_sval();
-	closure->outseq = create_indiseq_sval();
+	memset(closure, 0, sizeof(*closure));
+	closure->keys[0] = create_bitset(xref_max_indis()+1);
+	closure->keys[1] = create_bitset(xref_max_fams()+1);
+	closure->keys[2] = create_bitset(xref_max_sours()+1);
+	closure->keys[3] = create_bitset(xref_max_evens()+1);
+	closure->keys[4] = create_bitset(xref_max_othrs()+1);
 	closure->gengedcl = gengedcl;
 }
 /*======================================================
@@ -141,22 +168,35 @@ closure_init (CLOSURE * closure, int gengedcl)
 static void
 closure_free (CLOSURE * closure)
 {
-	/* during gengedcom, all indiseqs alloc their own keys & vals */
-	remove_indiseq(closure->seq);
-	closure->seq=NULL;
-	remove_indiseq(closure->outseq);
-	closure->outseq=NULL;
-	destroy_table(closure->tab);
-	closure->tab=NULL;
+	INT i;
+	for (i = 0; i < ARRSIZE(closure->keys); ++i) {
+		destroy_bitset(closure->keys[i]);
+		closure->keys[i] = NULL;
+	}
+	if (closure->pending)
+		stdfree(closure->pending);
+	closure->pending = NULL;
+	closure->npending = closure->maxpending = 0;
 }
 /*======================================================
- * closure_wipe_processlist -- empty the "to-process" list
+ * closure_process_pending -- read pending records for
+ * pointers, until no new records turn up
+ * each round reads the records found by the last one,
+ * in key order, so each data block is read once a round
  *====================================================*/
 static void
-closure_wipe_processlist (CLOSURE * closure)
+closure_process_pending (CLOSURE * closure)
 {
-	remove_indiseq(closure->seq);
-	closure->seq = create_indiseq_sval();
+	while (closure->npending) {
+		/* take the list, as processing adds to a new one */
+		RKEY * keys = closure->pending;
+		INT nkeys = closure->npending;
+		closure->pending = NULL;
+		closure->npending = closure->maxpending = 0;
+		qsort(keys, nkeys, sizeof(RKEY), cmp_rkeys);
+		traverse_leaf_keys(BTR, keys, nkeys, &process_record, closure);
+		stdfree(keys);
+	}
 }
 /*======================================================
  * closure_is_original -- is the closure in original mode ?
@@ -190,6 +230,12 @@ closure_is_dump (CLOSURE * closure)
 	return closure->gengedcl==GENGEDCOM_WEAK_DUMP
 		|| closure->gengedcl==GENGEDCOM_STRONG_DUMP;
 }
+/* qsort comparator for closure_process_pending */
+static int
+cmp_rkeys (const void * el1, const void * el2)
+{
+	return cmpkeys((const RKEY *)el1, (const RKEY *)el2);
+}
 
 /*============================================================
  * is_valid_key - verify that key points to a valid lifelines
@@ -224,32 +270,104 @@ process_node_value (CLOSURE * closure, STRING v)
 	{
 		if (v[0]=='@' && v[1] && v[2])
 		{
-			int skeynum;
-			char skeybuff[MAXKEYWIDTH+1];
-			skeynum = atoi(&v[2]);
-			snprintf(skeybuff, sizeof(skeybuff), "%c%d", v[1], skeynum);
-			if (v[1]=='S')
-				closure_add_key(closure, skeybuff, "SOUR");
-			else if (v[1]=='E')
-				closure_add_key(closure, skeybuff, "EVEN");
-			else if (v[1]=='X')
-				closure_add_key(closure, skeybuff, "XXXX");
+			if (v[1]=='S' || v[1]=='E' || v[1]=='X')
+				closure_add_key(closure, v[1], atoi(&v[2]));
 		}
 	}
 }
+/*============================================================
+ * parse_line -- split one GEDCOM line of a raw record
+ *  (as buffer_to_line does), in place
+ * returns FALSE if line is blank or malformed
+ *==========================================================*/
+static BOOLEAN
+parse_line (STRING p, INT *plev, STRING *pxref, STRING *ptag, STRING *pval)
+{
+	INT lev;
+	*pxref = *ptag = *pval = 0;
+	striptrail(p);
+	skipws(&p);
+	if (chartype((uchar)*p) != DIGIT)
+		return FALSE;
+	lev = (uchar)*p++ - (uchar)'0';
+	while (chartype((uchar)*p) == DIGIT)
+		lev = lev*10 + (uchar)*p++ - (uchar)'0';
+	*plev = lev;
+	skipws(&p);
+	if (*p == '@') {
+		*pxref = p++;
+		while (*p && *p != '@') p++;
+		if (!*p) return FALSE;
+		p++;
+		if (!iswhite((uchar)*p)) return FALSE;
+		*p++ = 0;
+		skipws(&p);
+	}
+	if (!*p)
+		return FALSE;
+	*ptag = p++;
+	while (!iswhite((uchar)*p) && *p != 0) p++;
+	if (*p == 0) return TRUE;
+	*p++ = 0;
+	skipws(&p);
+	*pval = p;
+	return TRUE;
+}
+/*============================================================
+ * next_record_line -- copy next line of raw record into buffer
+ *  returns position after line, or NULL at end of record
+ *==========================================================*/
+static CNSTRING
+next_record_line (CNSTRING p, CNSTRING end, STRING line, INT maxlen)
+{
+	CNSTRING q;
+	INT len;
+	if (p >= end)
+		return NULL;
+	q = memchr(p, '\n', end - p);
+	if (!q) q = end;
+	len = q - p;
+	if (len > maxlen) len = maxlen;
+	memcpy(line, p, len);
+	line[len] = 0;
+	return q + 1;
+}
+/*============================================================
+ * process_record -- read pending record for pointers
+ *  (callback of traverse_leaf_keys)
+ *==========================================================*/
+static BOOLEAN
+process_record (HINT_PARAM_UNUSED RKEY rkey, STRING data, INT len, void * param)
+{
+	CLOSURE * closure = (CLOSURE *)param;
+	char line[MAXLINELEN+1];
+	CNSTRING p = data, end = data + len;
+	if (!data || eqstr(data, "DELE\n"))
+		return TRUE;
+	while ((p = next_record_line(p, end, line, MAXLINELEN))) {
+		INT lvl;
+		STRING xref, tag, v;
+		CNSTRING w;
+		if (!parse_line(line, &lvl, &xref, &tag, &v))
+			continue;
+		if (v && (w=strchr(v, '@')) && is_valid_key(w))
+			process_node_value(closure, v);
+	}
+	return TRUE;
+}
 /*==============================================
- * output_any_node -- send a node out
+ * output_line -- send a line of a record out
  * this is the only path to output for gengedcom
  * this filters for dumping & trimming options
+ * returns FALSE if line (and so its subtree) is dumped
  *============================================*/
-static void
-output_any_node (CLOSURE * closure, NODE node, STRING toptag
-	, INT lvl, BOOLEAN *eflg)
+static BOOLEAN
+output_line (CLOSURE * closure, STRING toptag, INT lvl
+	, STRING xref, STRING tag, STRING v)
 {
-	char newval[MAXGEDNAMELEN]; /* for modified values */
-	STRING v,pv;
+	char newval[MAXLINELEN+1]; /* for modified values */
+	STRING pv;
 	BOOLEAN dump, trimmed, insidepointer;
-	v=nval(node);
 	dump=0;
 	trimmed=0;
 	insidepointer=0;
@@ -269,12 +387,12 @@ output_any_node (CLOSURE * closure, NODE node, STRING toptag
 				{ /* original only suppressed family linking pointers */
 					if (eqstr(toptag, "INDI"))
 					{
-						if (eqstr(ntag(node),"FAMC")||eqstr(ntag(node),"FAMS"))
+						if (eqstr(tag,"FAMC")||eqstr(tag,"FAMS"))
 							ispointer=1;
 					}
 					else
 					{
-						if (eqstr(ntag(node),"CHILD")||eqstr(ntag(node),"HUSB")||eqstr(ntag(node),"WIFE"))
+						if (eqstr(tag,"CHILD")||eqstr(tag,"HUSB")||eqstr(tag,"WIFE"))
 							ispointer=1;
 					}
 				}
@@ -283,11 +401,7 @@ output_any_node (CLOSURE * closure, NODE node, STRING toptag
 			}
 			if (ispointer)
 			{
-				int skeynum;
-				char skeybuff[MAXKEYWIDTH+1];
-				skeynum = atoi(&v[2]);
-				snprintf(skeybuff, sizeof(skeybuff), "%c%d", v[1], skeynum);
-				if (!closure_has_key(closure, skeybuff))
+				if (!closure_has_key(closure, v[1], atoi(&v[2])))
 				{
 					if (closure_is_dump(closure))
 					{
@@ -328,12 +442,12 @@ output_any_node (CLOSURE * closure, NODE node, STRING toptag
 		snprintf(pq, buflen, FMT_INT, lvl);
 		buflen -= strlen(pq);
 		pq += strlen(pq);
-		if (nxref(node)) {
-			snprintf(pq, buflen, " %s", nxref(node));
+		if (xref) {
+			snprintf(pq, buflen, " %s", xref);
 			buflen -= strlen(pq);
 			pq += strlen(pq);
 		}
-		snprintf(pq, buflen, " %s", ntag(node));
+		snprintf(pq, buflen, " %s", tag);
 		buflen -= strlen(pq);
 		pq += strlen(pq);
 		if (newval[0])
@@ -343,53 +457,60 @@ output_any_node (CLOSURE * closure, NODE node, STRING toptag
 			buflen--;
 			pq++;
 			strncpy(pq, newval, buflen);
+			scratch[sizeof(scratch)-1] = 0;
 			buflen -= strlen(pq);
 			pq += strlen(pq);
 		}
 		snprintf(pq, buflen, "\n");
-		poutput(scratch, eflg);
-		if (*eflg)
-			return;
-		
-		if (nchild(node)) {
-			output_any_node(closure, nchild(node), toptag, lvl+1, eflg);
-			if (*eflg)
-				return;
-			}
+		poutput(scratch, closure->eflg);
 	}
-
-	if (nsibling(node))
-		output_any_node(closure, nsibling(node), toptag, lvl, eflg);
+	return !dump;
 }
 /*===================================================
- * output_top_node -- put a node onto the output list
+ * output_record -- send a record of the closure out
+ *  (callback of traverse_leaf_keys)
+ * lines below a dumped line are dumped with it
  *=================================================*/
-static void
-output_top_node (CLOSURE * closure, NODE node, BOOLEAN *eflg)
+static BOOLEAN
+output_record (HINT_PARAM_UNUSED RKEY rkey, STRING data, INT len, void * param)
 {
-	output_any_node(closure, node, ntag(node), 0, eflg);
+	CLOSURE * closure = (CLOSURE *)param;
+	char line[MAXLINELEN+1];
+	char toptag[MAXLINELEN+1];
+	CNSTRING p = data, end = data + len;
+	INT dumplvl = -1; /* level of dumped line, while skipping its subtree */
+	if (!data || eqstr(data, "DELE\n"))
+		return TRUE;
+	toptag[0] = 0;
+	while ((p = next_record_line(p, end, line, MAXLINELEN))) {
+		INT lvl;
+		STRING xref, tag, v;
+		if (!parse_line(line, &lvl, &xref, &tag, &v))
+			continue;
+		if (dumplvl >= 0) {
+			if (lvl > dumplvl)
+				continue;
+			dumplvl = -1;
+		}
+		if (!lvl)
+			llstrncpy(toptag, tag, sizeof(toptag), uu8);
+		if (!output_line(closure, toptag, lvl, xref, tag, v))
+			dumplvl = lvl;
+		if (*closure->eflg)
+			return FALSE;
+	}
+	return TRUE;
 }
-/*========================================
- * process_any_node -- filter for pointers
- *=======================================*/
+/*=============================================================
+ * count_family -- count one person's link to a family
+ *  once:  [I/O] families linked once so far
+ *  twice: [I/O] families linked more than once
+ *===========================================================*/
 static void
-process_any_node (CLOSURE * closure, NODE node)
+count_family (BITSET once, BITSET twice, INT fkeynum)
 {
-	STRING v;
-	CNSTRING w;
-	v = nval(node);
-
-	if (!closure_is_strong(closure))
-		return;
-
-	if (v && (w=strchr(v, '@')) && is_valid_key(w))
-		process_node_value(closure, v);
-
-	if (nchild(node))
-		process_any_node(closure, nchild(node));
-
-	if (nsibling(node))
-		process_any_node(closure, nsibling(node));
+	if (!bitset_set(once, fkeynum))
+		bitset_set(twice, fkeynum);
 }
 /*===================================================================
  * gen_gedcom -- Generate GEDCOM file from sequence; only persons in
@@ -407,87 +528,68 @@ process_any_node (CLOSURE * closure, NODE node)
 void
 gen_gedcom (INDISEQ seq, int gengedcl, BOOLEAN * eflg)
 {
-	INT num1=0;
-	NODE indi=0, famc=0;
-	NODE node=0;
 	CLOSURE closure;
-	INDISEQ tempseq=0;
-	TABLE famstab=0; /* all families referenced - value is #references */
+	BITSET famsonce=0, famstwice=0; /* families referenced */
+	CNSTRING t;
+	INT32 i;
 	if (!seq) return;
 
 	closure_init(&closure, gengedcl);
+	closure.eflg = eflg;
 
 	/* must load closure with all indis first
 	 for succeeding logic to pick out what families to include */
 	FORINDISEQ(seq, el, num)
-		closure_add_key(&closure, element_skey(el), "INDI");
+		CNSTRING key = element_skey(el);
+		if (key[0] == 'I')
+			closure_add_key(&closure, 'I', atoi(key+1));
 	ENDINDISEQ
 	/* now go thru all indis and figure out which
-	families to keep */
+	families to keep (first parent family, and all spouse families) */
 
-	famstab = create_table_int();
+	famsonce = create_bitset(xref_max_fams()+1);
+	famstwice = create_bitset(xref_max_fams()+1);
 	FORINDISEQ(seq, el, num)
-		indi = key_to_indi(element_skey(el));
-		famc = indi_to_famc(indi);
-		if (famc)
-			increment_table_int(famstab, fam_to_key(famc));
-		FORFAMS(indi, fam, num1)
-			increment_table_int(famstab, fam_to_key(fam));
-		ENDFAMS
+		CNSTRING key = element_skey(el);
+		INT ikeynum = (key[0] == 'I') ? atoi(key+1) : 0;
+		const INT32 * fams;
+		INT nfams;
+		if (ikeynum <= 0 || !famgraph_indi_exists(ikeynum))
+			continue;
+		if (famgraph_indi_links(ikeynum, FGL_FAMC, &fams))
+			count_family(famsonce, famstwice, fams[0]);
+		nfams = famgraph_indi_links(ikeynum, FGL_FAMS, &fams);
+		for (i = 0; i < nfams; ++i)
+			count_family(famsonce, famstwice, fams[i]);
 	ENDINDISEQ
 
-	/* add all families in table with #refs>1 to closure */
-	if (TRUE) {
-		TABLE_ITER tabit = begin_table_iter(famstab);
-		CNSTRING key=0;
-		INT count=0;
-		while (next_table_int(tabit, &key, &count)) {
-			if (count > 1) {
-				closure_add_key(&closure, key, "FAM");
-			}
-		}
-		end_table_iter(&tabit);
-		destroy_table(famstab);
-		famstab=0;
+	/* add all families with #refs>1 to closure */
+	for (i = 1; i < BSMax(famstwice); ++i) {
+		if (bitset_test(famstwice, i))
+			closure_add_key(&closure, 'F', i);
 	}
+	destroy_bitset(famsonce);
+	destroy_bitset(famstwice);
 
-	/* now we have to process every node, including new
+	/* now we have to process every record, including new
 	 ones that get added during processing */
-	while (length_indiseq(closure.seq))
-	{
-		CNSTRING sval=0, skey=0;
-		tempseq = create_indiseq_sval();
-		/* move all from to-process list to
-		temporary processing list, because the
-		processing will add stuff to the to-process list */
-		FORINDISEQ(closure.seq, el, num)
-			sval = element_sval(el);
-			skey = element_skey(el);
-			/* during gengedcom, all append_indiseqs alloc their own keys & vals (tags) */
-			append_indiseq_sval(tempseq, strsave(skey), NULL, strsave(sval),
-				 TRUE, TRUE);
-		ENDINDISEQ
-		/* clear to-process list */
-		closure_wipe_processlist(&closure);
-		/* cycle thru temp processing list & process each */
-		FORINDISEQ(tempseq, el, num)
-			skey = element_skey(el);
-			/* tag was stored in the value */
-			node = key_to_type(skey, FALSE);
-			process_any_node(&closure, node);
-			closure_add_output_node(&closure, node);
-		ENDINDISEQ
-		remove_indiseq(tempseq);
-		tempseq=NULL;
-	}
-	canonkeysort_indiseq(closure.outseq);
-	FORINDISEQ(closure.outseq, el, num)
-		node = key_to_type(element_skey(el), FALSE);
-		output_top_node(&closure, node, eflg);
-		if (*eflg) {
-			closure_free(&closure);
-			return;
+	closure_process_pending(&closure);
+
+	/* output by type, in canonical order */
+	for (t = closure_types; *t && !*eflg; ++t) {
+		BITSET keys = closure_keyset(&closure, *t);
+		RKEY * rkeys = (RKEY *)stdalloc((bitset_count(keys)+1) * sizeof(RKEY));
+		INT nkeys = 0;
+		for (i = 1; nkeys < bitset_count(keys); ++i) {
+			if (bitset_test(keys, i)) {
+				char key[MAXKEYWIDTH+4]; /* room for any INT32 */
+				snprintf(key, sizeof(key), "%c" FMT_INT32, *t, i);
+				rkeys[nkeys++] = str2rkey(key);
+			}
 		}
-	ENDINDISEQ
+		/* key numbers ascend, and so do their btree keys */
+		traverse_leaf_keys(BTR, rkeys, nkeys, &output_record, &closure);
+		stdfree(rkeys);
+	}
 	closure_free(&closure);
 }
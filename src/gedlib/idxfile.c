@@ -0,0 +1,444 @@
+/* 
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * idxfile.c -- Index files kept beside a database
+ *  A flat file of INT32 in the database directory, mapped into
+ *  memory when the database is opened, flagged stale on disk
+ *  at the first change, and rewritten (to a new file, renamed
+ *  over the old) when a writable database is closed. Used by
+ *  famgraph, dateindex & placeindex; the latter two also share
+ *  the handling of their sorted event entries here.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "btree.h"
+#include "gedcom.h"
+#include "idxfile.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <fcntl.h>
+#define IDXFILE_MMAP
+#endif
+
+extern BTREE BTR;
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* state of build_entries traversal */
+struct tag_idxbuild {
+	IDXENTRIES ie;
+	struct tag_idxlist list;
+};
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static BOOLEAN build_record(RKEY rkey, STRING data, INT len, void * param);
+static void database_stamp(INT32 * pkeyid, INT32 * pfkey);
+static BOOLEAN load_file(IDXFILE idx);
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * database_stamp -- Identify the database files
+ *  pkeyid: [OUT] inode of keyfile, which is new when the
+ *                database is created anew or restored
+ *  pfkey:  [OUT] next btree file key, which grows as blocks
+ *                are split (even by programs not keeping
+ *                these indexes)
+ *===============================================*/
+static void
+database_stamp (INT32 * pkeyid, INT32 * pfkey)
+{
+	char path[MAXPATHLEN];
+	struct stat sbuf;
+	*pkeyid = 0;
+	snprintf(path, sizeof(path), "%s/key", BTR->b_basedir);
+	if (!stat(path, &sbuf))
+		*pkeyid = (INT32)((sbuf.st_ino ^ ((sbuf.st_ino >> 16) >> 16)) & 0xffffffff);
+	*pfkey = bkfile(BTR).k_fkey;
+}
+/*=================================================
+ * idxfile_open -- Load index file of database just opened
+ *  Called after xrefs file is open (and not again before
+ *  idxfile_close)
+ *  returns FALSE if missing, stale or damaged (as far as the
+ *  common header shows); caller checks the rest of the file,
+ *  and calls idxfile_unload if it too is unusable
+ *===============================================*/
+BOOLEAN
+idxfile_open (IDXFILE idx)
+{
+	char path[MAXPATHLEN];
+	snprintf(path, sizeof(path), "%s/%s", BTR->b_basedir, idx->name);
+	idx->path = strsave(path);
+	idx->writable = (bwrite(BTR) > 0);
+	idx->dirty = FALSE;
+	if (load_file(idx))
+		return TRUE;
+	idxfile_unload(idx);
+	return FALSE;
+}
+/*=================================================
+ * load_file -- Read or map index file, and check common header
+ *===============================================*/
+static BOOLEAN
+load_file (IDXFILE idx)
+{
+	INT32 keyid, fkey;
+	INT32 * base;
+#ifdef IDXFILE_MMAP
+	struct stat sbuf;
+	void * map;
+	int fd = open(idx->path, O_RDONLY);
+	if (fd < 0)
+		return FALSE;
+	if (fstat(fd, &sbuf) || sbuf.st_size < (off_t)(idx->hdrsize * sizeof(INT32))
+		|| sbuf.st_size % sizeof(INT32)) {
+		close(fd);
+		return FALSE;
+	}
+	map = mmap(NULL, sbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return FALSE;
+	idx->base = (INT32 *)map;
+	idx->words = sbuf.st_size / sizeof(INT32);
+	idx->mapped = TRUE;
+#else
+	long size;
+	FILE * fp = fopen(idx->path, LLREADBINARY);
+	if (!fp)
+		return FALSE;
+	if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < (long)(idx->hdrsize * sizeof(INT32))
+		|| size % sizeof(INT32) || fseek(fp, 0, SEEK_SET)) {
+		fclose(fp);
+		return FALSE;
+	}
+	idx->base = (INT32 *)stdalloc(size);
+	idx->words = size / sizeof(INT32);
+	idx->mapped = FALSE;
+	if (fread(idx->base, sizeof(INT32), idx->words, fp) != (size_t)idx->words) {
+		fclose(fp);
+		return FALSE;
+	}
+	fclose(fp);
+#endif
+	base = idx->base;
+	database_stamp(&keyid, &fkey);
+	return base[IXH_MAGIC] == idx->magic && base[IXH_VERSION] == idx->version
+		&& base[IXH_STATE] == IX_CLEAN
+		&& base[IXH_IMAX] == xref_max_indis()
+		&& base[IXH_FMAX] == xref_max_fams()
+		&& base[IXH_KEYID] == keyid && base[IXH_FKEY] == fkey;
+}
+/*=================================================
+ * idxfile_unload -- Release index file contents
+ *===============================================*/
+void
+idxfile_unload (IDXFILE idx)
+{
+	if (idx->base) {
+#ifdef IDXFILE_MMAP
+		if (idx->mapped)
+			munmap((void *)idx->base, idx->words * sizeof(INT32));
+		else
+#endif
+			stdfree(idx->base);
+	}
+	idx->base = 0;
+	idx->words = 0;
+	idx->mapped = FALSE;
+}
+/*=================================================
+ * idxfile_mark_dirty -- Flag index file as stale, on first change
+ *===============================================*/
+void
+idxfile_mark_dirty (IDXFILE idx)
+{
+	FILE * fp;
+	INT32 state = IX_DIRTY;
+	if (idx->dirty) return;
+	idx->dirty = TRUE;
+	if (!idx->path || !idx->base || !idx->writable) return;
+	if (!(fp = fopen(idx->path, LLREADBINARYUPDATE))) return;
+	if (fseek(fp, IXH_STATE * sizeof(INT32), SEEK_SET) == 0)
+		fwrite(&state, sizeof(state), 1, fp);
+	fclose(fp);
+}
+/*=================================================
+ * idxfile_write -- Write a fresh index file (as path.tmp),
+ *  if database was changed or had none
+ *  func: [IN]  writes whole file, header first
+ *  Called when database is closed, before anything is freed
+ * returns TRUE if idxfile_close is to put it in place
+ *===============================================*/
+BOOLEAN
+idxfile_write (IDXFILE idx, IDXFILE_WRITE func)
+{
+	char tmppath[MAXPATHLEN];
+	INT32 * header;
+	BOOLEAN ok;
+	FILE * fp;
+	if (!idx->path || !idx->writable || (!idx->dirty && idx->base))
+		return FALSE;
+	snprintf(tmppath, sizeof(tmppath), "%s.tmp", idx->path);
+	if (!(fp = fopen(tmppath, LLWRITEBINARY)))
+		return FALSE;
+	header = (INT32 *)stdalloc(idx->hdrsize * sizeof(INT32));
+	memset(header, 0, idx->hdrsize * sizeof(INT32));
+	header[IXH_MAGIC] = idx->magic;
+	header[IXH_VERSION] = idx->version;
+	header[IXH_STATE] = IX_CLEAN;
+	header[IXH_IMAX] = xref_max_indis();
+	header[IXH_FMAX] = xref_max_fams();
+	database_stamp(&header[IXH_KEYID], &header[IXH_FKEY]);
+	ok = (*func)(fp, header);
+	if (fclose(fp))
+		ok = FALSE;
+	if (!ok)
+		unlink(tmppath);
+	stdfree(header);
+	return ok;
+}
+/*=================================================
+ * idxfile_close -- Release index file of database being closed
+ *  replace: [IN]  put file written by idxfile_write in place ?
+ *  (after contents are released, as a mapped file may not be
+ *  replaced on every system)
+ *===============================================*/
+void
+idxfile_close (IDXFILE idx, BOOLEAN replace)
+{
+	char tmppath[MAXPATHLEN];
+	idxfile_unload(idx);
+	if (replace && idx->path) {
+		snprintf(tmppath, sizeof(tmppath), "%s.tmp", idx->path);
+		unlink(idx->path);
+		if (rename(tmppath, idx->path))
+			unlink(tmppath);
+	}
+	strfree(&idx->path);
+	idx->writable = idx->dirty = FALSE;
+}
+/*=================================================
+ * idxfile_pack_tag -- Pack tag of up to IDXFILE_MAXTAG (4)
+ *  characters into a word, big-endian (eg, "BIRT" is
+ *  0x42495254), so entries sort by tag
+ *  returns 0 if tag is empty or too long
+ *===============================================*/
+INT32
+idxfile_pack_tag (CNSTRING tag, INT taglen)
+{
+	unsigned long packed = 0;
+	INT i;
+	if (taglen < 1 || taglen > IDXFILE_MAXTAG)
+		return 0;
+	for (i=0; i<IDXFILE_MAXTAG; ++i) {
+		packed <<= 8;
+		if (i < taglen)
+			packed |= (unsigned char)tag[i] & 0x7f;
+	}
+	return (INT32)packed;
+}
+/*=================================================
+ * idxfile_rec_code -- Record code for "I12" style key
+ *  (key number times two, plus one for a family)
+ *  returns 0 if not a person or family key
+ *===============================================*/
+INT32
+idxfile_rec_code (CNSTRING key)
+{
+	INT keynum;
+	if (!key || (key[0] != 'I' && key[0] != 'F'))
+		return 0;
+	keynum = atoi(key+1);
+	if (keynum <= 0 || keynum > MAXKEYNUMBER)
+		return 0;
+	return (INT32)(keynum * 2 + (key[0] == 'F' ? 1 : 0));
+}
+/*=================================================
+ * idxfile_add_entry -- Append one entry to a growable list
+ *===============================================*/
+void
+idxfile_add_entry (struct tag_idxlist * list, const INT32 * entry)
+{
+	if (list->count == list->max) {
+		INT32 * old = list->words;
+		list->max = list->max ? 2*list->max : 256;
+		list->words = (INT32 *)stdalloc(list->max * IDXENTRY_WORDS * sizeof(INT32));
+		if (old) {
+			memcpy(list->words, old, list->count * IDXENTRY_WORDS * sizeof(INT32));
+			stdfree(old);
+		}
+	}
+	memcpy(list->words + list->count * IDXENTRY_WORDS, entry
+		, IDXENTRY_WORDS * sizeof(INT32));
+	++list->count;
+}
+/*=================================================
+ * build_record -- Add entries of one record (btree traversal)
+ *===============================================*/
+static BOOLEAN
+build_record (RKEY rkey, STRING data, INT len, void * param)
+{
+	struct tag_idxbuild * build = (struct tag_idxbuild *)param;
+	char key[MAXKEYWIDTH+1];
+	INT32 rec;
+	CNSTRING p;
+	strcpy(key, rkey2str(rkey));
+	for (p = key+1; *p; ++p) {
+		if (chartype((uchar)*p) != DIGIT)
+			return TRUE;
+	}
+	if (!(rec = idxfile_rec_code(key)))
+		return TRUE;
+	if (!data || len <= 0 || (len == 5 && !strncmp(data, "DELE\n", 5)))
+		return TRUE;
+	(*build->ie->parse)(rec, data, len, &build->list);
+	return TRUE;
+}
+/*=================================================
+ * idxfile_build_entries -- Load entries from the records
+ *  themselves (when there is no usable index file)
+ *  Reading every leaf once covers records stored so far,
+ *  so any pending changes are dropped.
+ *===============================================*/
+void
+idxfile_build_entries (IDXENTRIES ie)
+{
+	struct tag_idxbuild build;
+	RKEY lo, hi;
+	memset(&build, 0, sizeof(build));
+	build.ie = ie;
+	lo.r_rkey[0] = hi.r_rkey[0] = 0;
+	traverse_leaf_records(BTR, lo, hi, NULL, &build_record, &build);
+	if (build.list.count)
+		qsort(build.list.words, build.list.count
+			, IDXENTRY_WORDS * sizeof(INT32), ie->cmp);
+	ie->entries = build.list.words;
+	ie->count = build.list.count;
+	ie->built = TRUE;
+	ie->loaded = TRUE;
+	if (ie->changed)
+		bitset_clear_all(ie->changed);
+	ie->newlist.count = 0;
+}
+/*=================================================
+ * idxfile_record_stored -- Note that a record was written
+ *  (or deleted) so queries follow the write at once
+ *  key: [IN]  key of record stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+void
+idxfile_record_stored (IDXENTRIES ie, CNSTRING key, CNSTRING rec, INT len)
+{
+	INT32 code = idxfile_rec_code(key);
+	INT32 * words = ie->newlist.words;
+	STRING raw = 0;
+	INT i, j;
+	if (!code) return;
+	idxfile_mark_dirty(&ie->file);
+	if (!ie->loaded)
+		return; /* not loaded yet, so will be read as stored */
+	if (!ie->changed)
+		ie->changed = create_bitset(1024);
+	bitset_set(ie->changed, code);
+	for (i=j=0; i<ie->newlist.count; ++i) {
+		if (words[i*IDXENTRY_WORDS + ie->recword] != code) {
+			if (i != j)
+				memcpy(words + j*IDXENTRY_WORDS, words + i*IDXENTRY_WORDS
+					, IDXENTRY_WORDS * sizeof(INT32));
+			++j;
+		}
+	}
+	ie->newlist.count = j;
+	if (!rec) {
+		raw = retrieve_raw_record(key, &len);
+		rec = raw;
+	}
+	if (rec && !(len == 5 && !strncmp(rec, "DELE\n", 5)))
+		(*ie->parse)(code, rec, len, &ie->newlist);
+	if (raw)
+		stdfree(raw);
+}
+/*=================================================
+ * idxfile_entry_changed -- Has entry's record been stored
+ *  since entries were loaded ?
+ *===============================================*/
+BOOLEAN
+idxfile_entry_changed (IDXENTRIES ie, const INT32 * entry)
+{
+	return ie->changed && bitset_test(ie->changed, entry[ie->recword]);
+}
+/*=================================================
+ * idxfile_merge_entries -- Current entries, sorted
+ *  all: [OUT] unchanged entries (from the index file, or if
+ *             there was none, from the records themselves)
+ *             and those of records stored since
+ *===============================================*/
+void
+idxfile_merge_entries (IDXENTRIES ie, struct tag_idxlist * all)
+{
+	INT i;
+	if (!ie->loaded)
+		idxfile_build_entries(ie);
+	memset(all, 0, sizeof(*all));
+	for (i=0; i<ie->count; ++i) {
+		const INT32 * entry = ie->entries + i*IDXENTRY_WORDS;
+		if (!idxfile_entry_changed(ie, entry))
+			idxfile_add_entry(all, entry);
+	}
+	for (i=0; i<ie->newlist.count; ++i)
+		idxfile_add_entry(all, ie->newlist.words + i*IDXENTRY_WORDS);
+	if (all->count)
+		qsort(all->words, all->count, IDXENTRY_WORDS * sizeof(INT32), ie->cmp);
+}
+/*=================================================
+ * idxfile_free_entries -- Free all entries
+ *  Called when database is closed, after idxfile_write
+ *===============================================*/
+void
+idxfile_free_entries (IDXENTRIES ie)
+{
+	if (ie->built && ie->entries)
+		stdfree((void *)ie->entries);
+	ie->entries = 0;
+	ie->count = 0;
+	ie->loaded = ie->built = FALSE;
+	if (ie->newlist.words)
+		stdfree(ie->newlist.words);
+	memset(&ie->newlist, 0, sizeof(ie->newlist));
+	destroy_bitset(ie->changed);
+	ie->changed = 0;
+}
@@ -43,6 +43,17 @@
 #include "indiseq.h"
 #include "gedcomi.h"
 #include "mystring.h" /* lat1_xx */
+#include "bitset.h"
+#include "famgraph.h"
+#include "dateindex.h"
+#include "placeindex.h"
+#include "lloptions.h"
+#if defined(HAVE_PTHREAD_H) && defined(HAVE_PTHREAD_CREATE)
+#include <pthread.h>
+#define SORT_THREADS
+#endif
+
+#define MAX_SORT_THREADS 64
 
 /*
 	indiseqs are typed as to value
@@ -67,13 +78,6 @@
  * local enums
  *********************************************/
 
-/*====================
- * indiseq print types
- *==================*/
-#define ISPRN_NORMALSEQ 0
-#define ISPRN_FAMSEQ 1
-#define ISPRN_SPOUSESEQ 2
-
 /*********************************************
  * local types
  *********************************************/
@@ -89,6 +93,9 @@ struct tag_sortel {
 	UNION s_val;	/* any value */
 	STRING s_prn;	/* menu print string */
 	INT s_pri;	/* key as integer (exc valuesort_indiseq puts values here) */
+	INT s_prnlen;	/* width s_prn was formatted for */
+	INT s_prnuse;	/* last use of s_prn (0 if preprinted, & kept) */
+	INT s_prnver;	/* record_version of key when s_prn formatted */
 };
 /* typedef struct tag_sortel *SORTEL; */ /* in indiseq.h */
 #define skey(s) ((s)->s_key)
@@ -96,6 +103,39 @@ struct tag_sortel {
 #define sval(s) ((s)->s_val)
 #define sprn(s) ((s)->s_prn)
 #define spri(s) ((s)->s_pri)
+#define sprnlen(s) ((s)->s_prnlen)
+#define sprnuse(s) ((s)->s_prnuse)
+#define sprnver(s) ((s)->s_prnver)
+
+/*
+  Print lines of long sequences are formatted as they are shown,
+  and the most recently used of them kept with their elements;
+  when more than PRNCACHE_MAX are kept, all but the newest
+  PRNCACHE_KEEP are dropped
+*/
+#define PRNCACHE_MAX 512
+#define PRNCACHE_KEEP 256
+
+struct tag_closure_queue;
+
+/* element with collation key, for sortkey_sort */
+struct tag_keyed_el {
+	SORTEL el;
+	CNSTRING key;
+	INT keyoff;
+	INT keylen;
+};
+/* append sort key of element to zkey, FALSE if no key */
+typedef BOOLEAN (*SORTKEY_FNC)(SORTEL el, ZSTR zkey);
+/* part of a merge_sort, done by one thread */
+struct tag_sort_run {
+	SORTEL *data;
+	SORTEL *tmp;
+	INT lo, mid, hi;
+	ELCMPFNC cmp;
+	VPTR param;
+	void (*fnc)(struct tag_sort_run *);
+};
 
 /*********************************************
  * local function prototypes
@@ -105,24 +145,51 @@ struct tag_sortel {
 static void append_all_tags(INDISEQ, NODE, STRING tagname, BOOLEAN recurse, BOOLEAN nonptrs);
 static void append_indiseq_impl(INDISEQ seq, STRING key, 
 	CNSTRING name, UNION val, BOOLEAN sure, BOOLEAN alloc);
+static CNSTRING cached_print_el(INDISEQ seq, INT i, INT len, RFMT rfmt);
 static void calc_indiseq_name_el(INDISEQ seq, INT index);
 static INT canonkey_compare(SORTEL el1, SORTEL el2, VPTR param);
 static INT canonkey_order(char c);
 static void check_indiseq_valtype(INDISEQ seq, INT valtype);
+static BOOLEAN closure_add(INDISEQ result, INDISEQ seq, BITSET done
+	, struct tag_closure_queue * queue, INT32 ikeynum, INT32 gen
+	, SEQ_CLOSURE_VISIT_FNC visit, VPTR param);
+static void closure_seed(INDISEQ seq, struct tag_closure_queue * queue);
 static UNION copyval(INDISEQ seq, UNION uval);
+static INT count_sort_runs(INT len);
 static INDISEQ create_indiseq_impl(INT valtype, INDISEQ_VALUE_FNCTABLE fnctable);
 static void delete_el(INDISEQ seq, SORTEL el);
 static void deleteval(INDISEQ seq, UNION uval);
+static BOOLEAN dequeue_closure(struct tag_closure_queue * queue, INT32 * pkeynum, INT32 * pgen);
+static void drop_print_el(INDISEQ seq, SORTEL el);
 static INDISEQ dupseq(INDISEQ seq);
+static void enqueue_closure(struct tag_closure_queue * queue, INT32 keynum, INT32 gen);
+static BOOLEAN event_date_add(char ntype, INT keynum, INT32 lo, INT32 hi, void * param);
+static INT event_persons(char ntype, INT keynum, INT32 ikeys[2]);
 static STRING get_print_el(INDISEQ, INT i, INT len, RFMT rfmt);
+static void init_closure_queue(struct tag_closure_queue * queue);
 static BOOLEAN is_locale_current(INDISEQ seq);
 static INT key_compare(SORTEL el1, SORTEL el2, VPTR param);
+static INT keyed_compare(SORTEL el1, SORTEL el2, VPTR param);
+static void merge(SORTEL *data, SORTEL *tmp, INT lo, INT mid, INT hi, ELCMPFNC cmp, VPTR param);
+static void merge_run(struct tag_sort_run * run);
+static void msort(SORTEL *data, SORTEL *tmp, INT lo, INT hi, ELCMPFNC cmp, VPTR param);
 static INT name_compare(SORTEL el1, SORTEL el2, VPTR param);
-static void llqsort2(SORTEL *data, ELCMPFNC cmp, VPTR param, INT a, INT b);
-static void partition2(SORTEL *arr, ELCMPFNC cmp, VPTR param, INT a, INT b, INT *pi, INT *pj);
+static BOOLEAN name_sortkey(SORTEL el, ZSTR zkey);
+static void parallel_merge_sort(struct tag_sort_run * proto, INT len, INT nruns);
+static BOOLEAN place_add(char ntype, INT keynum, INT32 place, void * param);
+static BOOLEAN print_el_current(SORTEL el, INT len);
 static STRING qkey_to_name(STRING key);
+static void run_sort_runs(struct tag_sort_run * runs, INT nruns, void (*fnc)(struct tag_sort_run *));
+static void sort_run(struct tag_sort_run * run);
+#ifdef SORT_THREADS
+static void * sort_thread(void * arg);
+#endif
+static BOOLEAN sortkey_sort(INDISEQ seq, SORTKEY_FNC keyfnc);
+static void term_closure_queue(struct tag_closure_queue * queue);
+static void trim_print_els(INDISEQ seq);
 static void update_locale(INDISEQ seq);
 static INT value_compare(SORTEL el1, SORTEL el2, VPTR param);
+static BOOLEAN value_sortkey(SORTEL el, ZSTR zkey);
 
 /*********************************************
  * local variables
@@ -430,6 +497,7 @@ append_indiseq_impl (INDISEQ seq, STRING key, CNSTRING name, UNION val
 	sval(el) = val;
 	spri(el) = 0;
 	sprn(el) = NULL;
+	sprnuse(el) = 0;
 	if ((n = ISize(seq)) >= IMax(seq))  {
 		m = 3*n;
 		new = (SORTEL *) stdalloc(m*sizeof(SORTEL));
@@ -532,10 +600,7 @@ delete_el (INDISEQ seq, SORTEL el)
 		stdfree(snam(el));
 		snam(el)=NULL;
 	}
-	if (sprn(el)) {
-		stdfree(sprn(el));
-		sprn(el)=NULL;
-	}
+	drop_print_el(seq, el);
 	deleteval(seq, sval(el));
 	if (IValtype(seq) == ISVAL_INT)
 		sval(el).i = 0;
@@ -729,7 +794,7 @@ value_compare (SORTEL el1, SORTEL el2, VPTR param)
 			if (str2)
 				rel = 1;
 		} else {
-			rel = strcoll(str1, str2);
+			rel = cmpstrloc(str1, str2);
 		}
 	} else if (valtype == ISVAL_PTR) {
 		VPTR ptr1=sval(el1).w, ptr2=sval(el2).w;
@@ -741,6 +806,90 @@ value_compare (SORTEL el1, SORTEL el2, VPTR param)
 		rel = canonkey_compare(el1, el2, param);
 	return rel;
 }
+/*==================================
+ * name_sortkey -- Sort key of name, ordered as name_compare
+ *================================*/
+static BOOLEAN
+name_sortkey (SORTEL el, ZSTR zkey)
+{
+	/* elements without names sort last */
+	if (!snam(el)) {
+		ll_sortkey_num(zkey, 1);
+		return TRUE;
+	}
+	ll_sortkey_num(zkey, 0);
+	return namesortkey(snam(el), zkey);
+}
+/*===================================================
+ * value_sortkey -- Sort key of string value, ordered as value_compare
+ *=================================================*/
+static BOOLEAN
+value_sortkey (SORTEL el, ZSTR zkey)
+{
+	STRING str = sval(el).w;
+	/* elements without values sort last */
+	if (!str) {
+		ll_sortkey_num(zkey, 1);
+		return TRUE;
+	}
+	ll_sortkey_num(zkey, 0);
+	return ll_sortkey(str, zkey);
+}
+/*===================================================
+ * keyed_compare -- Compare elements by collation key
+ *  then in canonical key order
+ *  (sorts pointers to keyed els, & is safe to call from threads)
+ *=================================================*/
+static INT
+keyed_compare (SORTEL el1, SORTEL el2, HINT_PARAM_UNUSED VPTR param)
+{
+	const struct tag_keyed_el * kel1 = (const struct tag_keyed_el *)el1;
+	const struct tag_keyed_el * kel2 = (const struct tag_keyed_el *)el2;
+	INT rel = ll_sortkeycmp(kel1->key, kel1->keylen, kel2->key, kel2->keylen);
+	if (!rel)
+		rel = canonkey_compare(kel1->el, kel2->el, NULL);
+	return rel;
+}
+/*===================================================
+ * sortkey_sort -- Sort sequence on collation keys
+ *  builds each element's key once, and sorts on the keys,
+ *  rather than collating both strings on every comparison
+ *  returns FALSE (with seq unchanged) if collation has no keys
+ *=================================================*/
+static BOOLEAN
+sortkey_sort (INDISEQ seq, SORTKEY_FNC keyfnc)
+{
+	INT i, n = ISize(seq);
+	struct tag_keyed_el * keyed;
+	SORTEL * ptrs;
+	ZSTR zkeys;
+	BOOLEAN ok = TRUE;
+	if (n < 2)
+		return TRUE;
+	keyed = (struct tag_keyed_el *)stdalloc(n * sizeof(keyed[0]));
+	ptrs = (SORTEL *)stdalloc(n * sizeof(ptrs[0]));
+	zkeys = zs_newn(n * 32);
+	for (i=0; i<n && ok; ++i) {
+		keyed[i].el = IData(seq)[i];
+		keyed[i].keyoff = zs_len(zkeys);
+		ok = (*keyfnc)(keyed[i].el, zkeys);
+		keyed[i].keylen = zs_len(zkeys) - keyed[i].keyoff;
+	}
+	if (ok) {
+		/* keys are final now that zkeys is done growing */
+		for (i=0; i<n; ++i)
+			keyed[i].key = zs_str(zkeys) + keyed[i].keyoff;
+		for (i=0; i<n; ++i)
+			ptrs[i] = (SORTEL)&keyed[i];
+		merge_sort(ptrs, n, keyed_compare, NULL, TRUE);
+		for (i=0; i<n; ++i)
+			IData(seq)[i] = ((struct tag_keyed_el *)ptrs[i])->el;
+	}
+	zs_free(&zkeys);
+	stdfree(ptrs);
+	stdfree(keyed);
+	return ok;
+}
 /*==========================================
  * namesort_indiseq -- Sort sequence by name
  *========================================*/
@@ -752,7 +901,8 @@ namesort_indiseq (INDISEQ seq)
 	FORINDISEQ(seq, el, num)
 		spri(el) = atoi(skey(el) + 1);
 	ENDINDISEQ
-	partition_sort(IData(seq), ISize(seq), name_compare, seq);
+	if (!sortkey_sort(seq, name_sortkey))
+		partition_sort(IData(seq), ISize(seq), name_compare, seq);
 	IFlags(seq) &= ~ALLSORTS;
 	IFlags(seq) |= NAMESORT;
 	update_locale(seq);
@@ -822,13 +972,15 @@ void
 valuesort_indiseq (INDISEQ seq, HINT_PARAM_UNUSED BOOLEAN *eflg)
 {
 	if ((IFlags(seq) & VALUESORT) && is_locale_current(seq)) return;
-	partition_sort(IData(seq), ISize(seq), value_compare, seq);
+	if (IValtype(seq) != ISVAL_STR || !sortkey_sort(seq, value_sortkey))
+		partition_sort(IData(seq), ISize(seq), value_compare, seq);
 	IFlags(seq) &= ~ALLSORTS;
 	IFlags(seq) |= VALUESORT;
 	update_locale(seq);
 }
 /*=========================================
- * partition_sort -- Partition (quick) sort
+ * partition_sort -- Sort array of els
+ *  (formerly a quicksort, now merge_sort, so it is stable)
  *=======================================*/
 /*
  *  data:  [I/O] array of els to sort
@@ -839,95 +991,205 @@ valuesort_indiseq (INDISEQ seq, HINT_PARAM_UNUSED BOOLEAN *eflg)
 void
 partition_sort (SORTEL *data, INT len, ELCMPFNC cmp, VPTR param)
 {
-	llqsort2(data, cmp, param, 0, len-1);
-}
-/*======================================
- * llqsort2 -- Nonrecursive quicksort
- *  median of three pivot
- *====================================*/
-/*======================================
- * partition2 -- Median of three pivot
- *  *pi is set to position of pivot
- *  *pj is set to index of highest item before *pi not equal to pivot
- *  (that is, anything between *pj and *pi has value of pivot)
- *====================================*/
-#define CMP(qa, qb) ((*cmp)(qa, qb, param))
+	merge_sort(data, len, cmp, param, FALSE);
+}
+/*=========================================
+ * merge_sort -- Stable merge sort, using threads for large arrays
+ *  data:     [I/O] array of els to sort
+ *  len:      [IN]  size of data
+ *  cmp:      [IN]  callback to compare two elements
+ *  param:    [IN]  opaque parameter for callback
+ *  parallel: [IN]  may cmp be called from several threads at once ?
+ *                  (only if it just compares prebuilt keys)
+ * Parallel sorts split data into one run per thread (SortThreads
+ * option, default one per processor), each at least SortParallelMin
+ * els long, sort the runs at once, then merge them pairwise.
+ *=======================================*/
+void
+merge_sort (SORTEL *data, INT len, ELCMPFNC cmp, VPTR param, BOOLEAN parallel)
+{
+	struct tag_sort_run run;
+	SORTEL *tmp;
+	INT nruns = 1;
+	if (len < 2)
+		return;
+	tmp = (SORTEL *)stdalloc(len * sizeof(tmp[0]));
+	if (parallel)
+		nruns = count_sort_runs(len);
+	run.data = data;
+	run.tmp = tmp;
+	run.cmp = cmp;
+	run.param = param;
+	if (nruns > 1) {
+		parallel_merge_sort(&run, len, nruns);
+	} else {
+		run.lo = 0;
+		run.mid = run.hi = len;
+		sort_run(&run);
+	}
+	stdfree(tmp);
+}
+/*=========================================
+ * count_sort_runs -- Into how many runs to split a parallel sort
+ *=======================================*/
+static INT
+#ifdef SORT_THREADS
+count_sort_runs (INT len)
+#else
+count_sort_runs (HINT_PARAM_UNUSED INT len)
+#endif
+{
+	INT n = 1;
+#ifdef SORT_THREADS
+	INT minrun = getlloptint("SortParallelMin", 20000);
+	n = getlloptint("SortThreads", 0);
+#ifdef _SC_NPROCESSORS_ONLN
+	if (n <= 0)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (n > MAX_SORT_THREADS)
+		n = MAX_SORT_THREADS;
+	if (minrun < 1)
+		minrun = 1;
+	if (n > len / minrun)
+		n = len / minrun;
+	if (n < 1)
+		n = 1;
+#endif
+	return n;
+}
+/*=========================================
+ * parallel_merge_sort -- Sort runs in threads, then merge them
+ *  pairwise, also in threads, until one run is left
+ *=======================================*/
 static void
-partition2 (SORTEL *arr, ELCMPFNC cmp, VPTR param, INT a, INT b, INT *pi, INT *pj)
+parallel_merge_sort (struct tag_sort_run * proto, INT len, INT nruns)
 {
-	INT i, j, c;
-	SORTEL pivot=0, t;
-
-	/* sort left, middle, and right items */
-	c = ((unsigned)a + (unsigned)b)/2;
-
-	if (CMP(arr[a],arr[c]) > 0) {
-		t = arr[a]; arr[a] = arr[c]; arr[c] = t;
+	struct tag_sort_run runs[MAX_SORT_THREADS];
+	INT i, n;
+	for (i=0; i<nruns; ++i) {
+		runs[i] = *proto;
+		runs[i].lo = (INT)((double)len * i / nruns);
+		runs[i].mid = runs[i].hi = (INT)((double)len * (i+1) / nruns);
 	}
-	if (CMP(arr[a],arr[b]) > 0) {
-		t = arr[a]; arr[a] = arr[b]; arr[b] = t;
+	run_sort_runs(runs, nruns, sort_run);
+	/* merge neighbouring runs, halving their number each pass */
+	for (n=nruns; n>1; n=(n+1)/2) {
+		INT npairs = n/2;
+		for (i=0; i<npairs; ++i) {
+			runs[i].lo = runs[2*i].lo;
+			runs[i].mid = runs[2*i].hi;
+			runs[i].hi = runs[2*i+1].hi;
+		}
+		run_sort_runs(runs, npairs, merge_run);
+		if (n % 2) {
+			/* odd run out is carried to next pass as is */
+			runs[npairs] = runs[n-1];
+			runs[npairs].mid = runs[npairs].hi;
+		}
 	}
-	if (CMP(arr[c],arr[b]) > 0) {
-		t = arr[c]; arr[c] = arr[b]; arr[b] = t;
+}
+/*=========================================
+ * run_sort_runs -- Apply fnc to each run, each in own thread
+ *  (if a thread cannot be started, its run is done here)
+ *=======================================*/
+static void
+run_sort_runs (struct tag_sort_run * runs, INT nruns, void (*fnc)(struct tag_sort_run *))
+{
+	INT i;
+#ifdef SORT_THREADS
+	pthread_t threads[MAX_SORT_THREADS];
+	BOOLEAN started[MAX_SORT_THREADS];
+	for (i=1; i<nruns; ++i) {
+		runs[i].fnc = fnc;
+		started[i] = !pthread_create(&threads[i], NULL, sort_thread, &runs[i]);
+		if (!started[i])
+			(*fnc)(&runs[i]);
 	}
-
-	/* tuck the pivot, at arr[c], away */
-	pivot = arr[c]; arr[c] = arr[b-1]; arr[b-1] = pivot;
-	i = a; j = b-1;
-
-	/* swap up & down interval to actually partition it */
-	while (1) {
-		/* shrink interval from bottom while elements below pivot */
-		while (CMP(arr[++i], pivot) < 0)
-			;
-		/* shrink interval from top while elements above pivot */
-		while (CMP(arr[--j], pivot) > 0)
-			;
-		if (j < i) break;
-		/* have out-of-place elements that stopped climb & descent */
-		t = arr[i]; arr[i] = arr[j]; arr[j] = t;
+	if (nruns > 0)
+		(*fnc)(&runs[0]);
+	for (i=1; i<nruns; ++i) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
 	}
-
-	/* put pivot into final resting place */
-	pivot = arr[i]; arr[i] = arr[b-1]; arr[b-1] = pivot;
-
-	/* give caller the partition info */
-	*pi = i; *pj = j;
+#else
+	for (i=0; i<nruns; ++i)
+		(*fnc)(&runs[i]);
+#endif
+}
+#ifdef SORT_THREADS
+/*=========================================
+ * sort_thread -- Thread start routine for run_sort_runs
+ *=======================================*/
+static void *
+sort_thread (void * arg)
+{
+	struct tag_sort_run * run = (struct tag_sort_run *)arg;
+	(*run->fnc)(run);
+	return NULL;
 }
+#endif
+/*=========================================
+ * sort_run -- Sort data[lo..hi) of run
+ *  (uses same part of tmp)
+ *=======================================*/
 static void
-llqsort2 (SORTEL *data, ELCMPFNC cmp, VPTR param, INT a, INT b)
+sort_run (struct tag_sort_run * run)
 {
-	INT stack[64];
-	INT i, j, top;
-
-	top = 0;
-
-	while (1) {
-		while (b > a+1) {
-			partition2(data, cmp, param, a, b, &i, &j);
-			/* loop to simulate tail recursion on smaller interval */
-			if (j-a > b-i) {
-				/* (i+1,b) is shorter interval than (a,j) */
-				/* do (i+1, b) now, and push (a,j) */
-				stack[top++] = a; stack[top++] = j;
-				a=i+1;
-			} else {
-				/* (a,j) is shorter interval than (i+1,b) */
-				/* do (a,j) now, and push (i+1,b) */
-				stack[top++] = i+1; stack[top++] = b;
-				b = j;
-			}
-		}
-		if (b > a) {
-			/* swap data[a] and data[b] if needed */
-			if (CMP(data[a], data[b])>0) {
-				SORTEL t = data[a]; data[a] = data[b]; data[b] = t;
-			}
+	msort(run->data, run->tmp, run->lo, run->hi, run->cmp, run->param);
+}
+/*=========================================
+ * merge_run -- Merge sorted data[lo..mid) & data[mid..hi) of run
+ *=======================================*/
+static void
+merge_run (struct tag_sort_run * run)
+{
+	merge(run->data, run->tmp, run->lo, run->mid, run->hi, run->cmp, run->param);
+}
+/*=========================================
+ * msort -- Recursive merge sort of data[lo..hi)
+ *  short ranges are done by insertion sort
+ *=======================================*/
+#define CMP(qa, qb) ((*cmp)(qa, qb, param))
+static void
+msort (SORTEL *data, SORTEL *tmp, INT lo, INT hi, ELCMPFNC cmp, VPTR param)
+{
+	INT mid;
+	if (hi - lo <= 16) {
+		INT i, j;
+		for (i=lo+1; i<hi; ++i) {
+			SORTEL t = data[i];
+			for (j=i; j>lo && CMP(data[j-1], t) > 0; --j)
+				data[j] = data[j-1];
+			data[j] = t;
 		}
-		if (top == 0) break;
-		/* pop & do whatever is on top of our stack */
-		b = stack[--top]; a = stack[--top];
+		return;
+	}
+	mid = lo + (hi - lo)/2;
+	msort(data, tmp, lo, mid, cmp, param);
+	msort(data, tmp, mid, hi, cmp, param);
+	merge(data, tmp, lo, mid, hi, cmp, param);
+}
+/*=========================================
+ * merge -- Merge sorted data[lo..mid) & data[mid..hi)
+ *  equal els keep their order (left run first)
+ *=======================================*/
+static void
+merge (SORTEL *data, SORTEL *tmp, INT lo, INT mid, INT hi, ELCMPFNC cmp, VPTR param)
+{
+	INT i=lo, j=mid, k=lo;
+	if (mid <= lo || mid >= hi || CMP(data[mid-1], data[mid]) <= 0)
+		return; /* already in order */
+	while (i < mid && j < hi) {
+		if (CMP(data[j], data[i]) < 0)
+			tmp[k++] = data[j++];
+		else
+			tmp[k++] = data[i++];
 	}
+	while (i < mid)
+		tmp[k++] = data[i++];
+	/* rest of right run is already in place */
+	memcpy(&data[lo], &tmp[lo], (k - lo) * sizeof(data[0]));
 }
 /*==================================================================
  * unique_indiseq -- Remove identical (key, name) els from sequence
@@ -1512,126 +1774,310 @@ sibling_indiseq (INDISEQ seq, BOOLEAN close)
 	remove_indiseq(fseq);
 	return sseq;
 }
+/*=========================================================
+ * Closure queue -- FIFO of (person key number, generation)
+ *  used by ancestor_indiseq & descendent_indiseq
+ *=======================================================*/
+struct tag_closure_queue {
+	INT32 *keys;
+	INT32 *gens;
+	INT head;  /* next to dequeue */
+	INT tail;  /* next free slot */
+	INT max;   /* allocated size */
+};
+static void
+init_closure_queue (struct tag_closure_queue * queue)
+{
+	queue->max = 64;
+	queue->keys = (INT32 *)stdalloc(queue->max * sizeof(queue->keys[0]));
+	queue->gens = (INT32 *)stdalloc(queue->max * sizeof(queue->gens[0]));
+	queue->head = queue->tail = 0;
+}
+static void
+term_closure_queue (struct tag_closure_queue * queue)
+{
+	stdfree(queue->keys);
+	stdfree(queue->gens);
+	queue->keys = queue->gens = 0;
+}
+static void
+enqueue_closure (struct tag_closure_queue * queue, INT32 keynum, INT32 gen)
+{
+	if (queue->tail == queue->max) {
+		/* slide consumed part out, or grow */
+		INT n = queue->tail - queue->head;
+		if (queue->head < queue->max/2) {
+			INT32 * keys, * gens;
+			queue->max *= 2;
+			keys = (INT32 *)stdalloc(queue->max * sizeof(keys[0]));
+			gens = (INT32 *)stdalloc(queue->max * sizeof(gens[0]));
+			memcpy(keys, queue->keys + queue->head, n * sizeof(keys[0]));
+			memcpy(gens, queue->gens + queue->head, n * sizeof(gens[0]));
+			stdfree(queue->keys);
+			stdfree(queue->gens);
+			queue->keys = keys;
+			queue->gens = gens;
+		} else {
+			memmove(queue->keys, queue->keys + queue->head, n * sizeof(queue->keys[0]));
+			memmove(queue->gens, queue->gens + queue->head, n * sizeof(queue->gens[0]));
+		}
+		queue->head = 0;
+		queue->tail = n;
+	}
+	queue->keys[queue->tail] = keynum;
+	queue->gens[queue->tail] = gen;
+	++queue->tail;
+}
+static BOOLEAN
+dequeue_closure (struct tag_closure_queue * queue, INT32 * pkeynum, INT32 * pgen)
+{
+	if (queue->head == queue->tail)
+		return FALSE;
+	*pkeynum = queue->keys[queue->head];
+	*pgen = queue->gens[queue->head];
+	++queue->head;
+	return TRUE;
+}
+/*=========================================================
+ * closure_seed -- Queue all persons of seq as generation 0
+ *=======================================================*/
+static void
+closure_seed (INDISEQ seq, struct tag_closure_queue * queue)
+{
+	FORINDISEQ(seq, el, num)
+		STRING key = skey(el);
+		if (key[0] == 'I' && atoi(key+1) > 0)
+			enqueue_closure(queue, atoi(key+1), 0);
+	ENDINDISEQ
+}
+/*=========================================================
+ * closure_add -- Add one person found by a closure
+ *  Skips dangling pointers and people already added
+ *  result: [I/O] sequence being built
+ *  seq:    [IN]  original sequence (for value functions)
+ *  done:   [I/O] people already added
+ * returns FALSE if visitor asked to stop
+ *=======================================================*/
+static BOOLEAN
+closure_add (INDISEQ result, INDISEQ seq, BITSET done
+	, struct tag_closure_queue * queue, INT32 ikeynum, INT32 gen
+	, SEQ_CLOSURE_VISIT_FNC visit, VPTR param)
+{
+	char key[MAXKEYWIDTH+2];
+	UNION uval;
+	if (bitset_test(done, ikeynum) || !famgraph_indi_exists(ikeynum))
+		return TRUE;
+	bitset_set(done, ikeynum);
+	snprintf(key, sizeof(key), "I" FMT_INT32, ikeynum);
+	uval = creategenval(seq, gen);
+	append_indiseq_pval(result, key, NULL, uval.w, TRUE);
+	enqueue_closure(queue, ikeynum, gen);
+	if (visit)
+		return (*visit)(key, gen, param);
+	return TRUE;
+}
 /*=========================================================
  * ancestor_indiseq -- Create ancestor sequence of sequence
  *  values are created with the generation number
  *  (via value function table)
+ *  maxgen: [IN]  stop after this many generations (0 = all)
+ *  visit:  [IN]  optional callback for each person added,
+ *                returning FALSE ends the closure early
+ *  param:  [IN]  passed to visit
+ * Works on the family graph (famgraph.c), so no person or
+ * family node trees are loaded.
  *=======================================================*/
 INDISEQ
-ancestor_indiseq (INDISEQ seq)
+ancestor_indiseq (INDISEQ seq, INT maxgen, SEQ_CLOSURE_VISIT_FNC visit
+	, VPTR param)
 {
-	/* table lists people already listed (values unused) */
-	TABLE tab;
-	LIST anclist, genlist;
+	/* people already listed */
+	BITSET done=0;
+	struct tag_closure_queue queue;
 	INDISEQ anc=0;
-	NODE indi=0;
-	STRING key, pkey;
-	INTPTR gen=0;
-	INT fnum=0, snum=0;
-	UNION uval;
+	INT32 ikeynum=0, gen=0;
+	BOOLEAN keepgoing=TRUE;
 	if (!seq) return NULL;
-		/* table of people already added */
-	tab = create_table_vptr();
-		/* paired processing list - see comments in descendant_indiseq code */
-	anclist = create_list();
-	genlist = create_list();
+	done = create_bitset(xref_max_indis()+1);
+	init_closure_queue(&queue);
 	anc = create_indiseq_impl(IValtype(seq), IValfnctbl(seq));
-	FORINDISEQ(seq, el, num)
-		enqueue_list(anclist, (VPTR)skey(el));
-		enqueue_list(genlist, (VPTR)gen);
-	ENDINDISEQ
-	while (!is_empty_list(anclist)) {
-		key = (STRING) dequeue_list(anclist);
-		gen = (INTPTR)dequeue_list(genlist) + 1;
-		indi = key_to_indi(key);
-
-		FORFAMCS(indi, fam, fath, moth, fnum)
-			FORFAMSPOUSES(fam, spouse, snum)
-				if (spouse && !in_table(tab, pkey = indi_to_key(spouse))) {
-						/* copy key for list, others make their own copies */
-					uval = creategenval(seq, gen);
-					append_indiseq_pval(anc, pkey, NULL, uval.w, TRUE);
-					enqueue_list(anclist, (VPTR)strsave(pkey));
-					enqueue_list(genlist, (VPTR)gen);
-					insert_table_ptr(tab, pkey, 0);
+	closure_seed(seq, &queue);
+	while (keepgoing && dequeue_closure(&queue, &ikeynum, &gen)) {
+		const INT32 *famcs, *parents;
+		INT nfamcs, nparents, i, j, list;
+		if (maxgen > 0 && gen >= maxgen)
+			continue;
+		++gen;
+		nfamcs = famgraph_indi_links(ikeynum, FGL_FAMC, &famcs);
+		for (i = 0; keepgoing && i < nfamcs; ++i) {
+			for (list = FGL_HUSB; keepgoing && list <= FGL_WIFE; ++list) {
+				nparents = famgraph_fam_links(famcs[i], list, &parents);
+				for (j = 0; keepgoing && j < nparents; ++j) {
+					keepgoing = closure_add(anc, seq, done, &queue
+						, parents[j], gen, visit, param);
 				}
-			ENDFAMSPOUSES
-		ENDFAMCS
+			}
+		}
 	}
-	destroy_table(tab);
-	destroy_empty_list(anclist);
-	destroy_empty_list(genlist);
+	term_closure_queue(&queue);
+	destroy_bitset(done);
 	return anc;
 }
 /*=============================================================
- * descendant_indiseq -- Create descendant sequence of sequence
+ * descendent_indiseq -- Create descendant sequence of sequence
  *  values are created with the generation number
  *  (passed to create_value callback)
+ *  maxgen, visit & param as for ancestor_indiseq
  *===========================================================*/
 INDISEQ
-descendent_indiseq (INDISEQ seq)
-{
-	INTPTR gen = 0;
-	/* itab lists people already entered, ftab families
-	(values in both are unused) */
-	TABLE itab, ftab;
-	LIST deslist, genlist;
-	INDISEQ des;
-	NODE indi;
-	STRING key, dkey, fkey;
-	UNION uval;
+descendent_indiseq (INDISEQ seq, INT maxgen, SEQ_CLOSURE_VISIT_FNC visit
+	, VPTR param)
+{
+	/* people already added, and families already processed */
+	BITSET done=0, famsdone=0;
+	struct tag_closure_queue queue;
+	INDISEQ des=0;
+	INT32 ikeynum=0, gen=0;
+	BOOLEAN keepgoing=TRUE;
 	if (!seq) return NULL;
-		/* itab = people already added, value irrelevant */
-	itab = create_table_vptr();
-		/* ftab = families already added (processed), value irrelevant */
-	ftab = create_table_vptr();
-		/*
-		deslist & genlist are paired - 
-		dequeue the person from deslist & the generation
-		from genlist, for one person to be processed
-		(added to result & all children added to processing list)
-		(deslist does not own its strings)
-		*/
-	deslist = create_list();
-	genlist = create_list();
-		/* result indiseq */
+	done = create_bitset(xref_max_indis()+1);
+	famsdone = create_bitset(xref_max_fams()+1);
+	init_closure_queue(&queue);
 	des = create_indiseq_impl(IValtype(seq), IValfnctbl(seq));
-		/* add everyone from original seq to processing list */
-	FORINDISEQ(seq, el, num)
-		enqueue_list(deslist, (VPTR)skey(el));
-		enqueue_list(genlist, (VPTR)gen);
-	ENDINDISEQ
-		/* loop until processing list is empty */
-	while (!is_empty_list(deslist)) {
-		INT num1, num2;
-		key = (STRING) dequeue_list(deslist);
-		gen = (INTPTR)dequeue_list(genlist) + 1;
-		indi = key_to_indi(key);
-		FORFAMS(indi, fam, num1)
-				/* skip families already processed */
-			if (in_table(ftab, fkey = fam_to_key(fam)))
+	closure_seed(seq, &queue);
+	while (keepgoing && dequeue_closure(&queue, &ikeynum, &gen)) {
+		const INT32 *famss, *children;
+		INT nfamss, nchildren, i, j;
+		if (maxgen > 0 && gen >= maxgen)
+			continue;
+		++gen;
+		nfamss = famgraph_indi_links(ikeynum, FGL_FAMS, &famss);
+		for (i = 0; keepgoing && i < nfamss; ++i) {
+			if (!bitset_set(famsdone, famss[i]))
 				continue;
-			insert_table_ptr(ftab, fkey, 0);
-			FORCHILDRENx(fam, child, num2)
-					/* only do people not processed */
-				if (!in_table(itab,
-				    dkey = indi_to_key(child))) {
-						/* copy key for list, others make their own copies */
-					uval = creategenval(seq, gen);
-						/* add person to output */
-					append_indiseq_pval(des, strsave(dkey), NULL, uval.w, TRUE);
-						/* also want descendants, so add person to processing list */
-					enqueue_list(deslist, (VPTR)strsave(dkey));
-					enqueue_list(genlist, (VPTR)gen);
-					insert_table_ptr(itab, dkey, 0);
-				}
-			ENDCHILDRENx
-		ENDFAMS
+			nchildren = famgraph_fam_links(famss[i], FGL_CHIL, &children);
+			for (j = 0; keepgoing && j < nchildren; ++j) {
+				keepgoing = closure_add(des, seq, done, &queue
+					, children[j], gen, visit, param);
+			}
+		}
 	}
-	destroy_table(itab);
-	destroy_table(ftab);
+	term_closure_queue(&queue);
+	destroy_bitset(done);
+	destroy_bitset(famsdone);
 	return des;
 }
+/*=========================================================
+ * Event search -- state of event_date_indiseq & place_indiseq
+ *=======================================================*/
+struct tag_event_date_find {
+	INDISEQ seq;
+	BITSET done;  /* persons already added */
+};
+/*=============================================================
+ * event_date_indiseq -- Create sequence of persons with an
+ *  event dated within a range (from the date index)
+ *  tag:  [IN]  event tag (eg, "BIRT"), NULL or "" for any
+ *  from: [IN]  earliest date key wanted
+ *  to:   [IN]  latest date key wanted
+ *  values are the earliest date key of each person's first
+ *  event found; family events count for husband and wife
+ *===========================================================*/
+INDISEQ
+event_date_indiseq (CNSTRING tag, INT32 from, INT32 to)
+{
+	struct tag_event_date_find find;
+	find.seq = create_indiseq_ival();
+	find.done = create_bitset(xref_max_indis()+1);
+	dateindex_find(tag, from, to, &event_date_add, &find);
+	destroy_bitset(find.done);
+	return find.seq;
+}
+/*=============================================================
+ * event_date_add -- Add person(s) of one event found by
+ *  event_date_indiseq (dateindex_find callback)
+ *===========================================================*/
+static BOOLEAN
+event_date_add (char ntype, INT keynum, INT32 lo, HINT_PARAM_UNUSED INT32 hi
+	, void * param)
+{
+	struct tag_event_date_find * find = (struct tag_event_date_find *)param;
+	INT32 ikeys[2];
+	INT n, i;
+	char key[MAXKEYWIDTH+2];
+	n = event_persons(ntype, keynum, ikeys);
+	for (i=0; i<n; ++i) {
+		if (!bitset_set(find->done, ikeys[i]))
+			continue;
+		snprintf(key, sizeof(key), "I" FMT_INT32, ikeys[i]);
+		append_indiseq_ival(find->seq, key, NULL, lo, TRUE, FALSE);
+	}
+	return TRUE;
+}
+/*=============================================================
+ * event_persons -- Persons an event belongs to
+ *  the person, or the husband & wife of a family
+ *  ikeys: [OUT] person key numbers
+ *  returns number of persons
+ *===========================================================*/
+static INT
+event_persons (char ntype, INT keynum, INT32 ikeys[2])
+{
+	const INT32 * spouses;
+	INT n=0, list;
+	if (ntype == 'I') {
+		ikeys[n++] = keynum;
+		return n;
+	}
+	for (list = FGL_HUSB; list <= FGL_WIFE; ++list) {
+		if (famgraph_fam_links(keynum, list, &spouses) > 0)
+			ikeys[n++] = spouses[0];
+	}
+	return n;
+}
+/*=============================================================
+ * place_indiseq -- Create sequence of persons with an event
+ *  at (or within) a place (from the place index)
+ *  place: [IN]  place, most specific part first (eg,
+ *               "Bristol, Gloucestershire")
+ *  tag:   [IN]  event tag (eg, "BIRT"), NULL or "" for any
+ *  values are the full place name of each person's first
+ *  event found; family events count for husband and wife
+ *===========================================================*/
+INDISEQ
+place_indiseq (CNSTRING place, CNSTRING tag)
+{
+	struct tag_event_date_find find;
+	find.seq = create_indiseq_sval();
+	find.done = create_bitset(xref_max_indis()+1);
+	placeindex_find(place, tag, &place_add, &find);
+	destroy_bitset(find.done);
+	return find.seq;
+}
+/*=============================================================
+ * place_add -- Add person(s) of one event found by
+ *  place_indiseq (placeindex_find callback)
+ *===========================================================*/
+static BOOLEAN
+place_add (char ntype, INT keynum, INT32 place, void * param)
+{
+	struct tag_event_date_find * find = (struct tag_event_date_find *)param;
+	INT32 ikeys[2];
+	INT n, i;
+	char key[MAXKEYWIDTH+2];
+	n = event_persons(ntype, keynum, ikeys);
+	for (i=0; i<n; ++i) {
+		ZSTR zname;
+		if (!bitset_set(find->done, ikeys[i]))
+			continue;
+		snprintf(key, sizeof(key), "I" FMT_INT32, ikeys[i]);
+		zname = placeindex_place_name(place);
+		append_indiseq_sval(find->seq, key, NULL, strsave(zs_str(zname))
+			, TRUE, FALSE);
+		zs_free(&zname);
+	}
+	return TRUE;
+}
 /*========================================================
  * spouse_indiseq -- Create spouses sequence of a sequence
  *======================================================*/
@@ -1729,6 +2175,30 @@ spouseseq_print_el (INDISEQ seq, INT i, INT len, RFMT rfmt)
 	str = indi_to_list_string(indi, fam, len, rfmt, TRUE);
 	return str;
 }
+/*==========================================
+ * relpathseq_print_el -- Format a print line of
+ *  relationship path (see relpath.c)
+ * assume values are relation to previous person
+ *========================================*/
+static STRING
+relpathseq_print_el (INDISEQ seq, INT i, INT len, RFMT rfmt)
+{
+	CNSTRING label = element_sval(IData(seq)[i]);
+	CNSTRING key = element_skey(IData(seq)[i]);
+	ZSTR zstr = zs_newn(len);
+	STRING str;
+	if (label && label[0]) {
+		zs_sets(zstr, _(label));
+		zs_apps(zstr, ": ");
+	}
+	len = (len > (INT)zs_len(zstr) + 1) ? len - zs_len(zstr) : 1;
+	str = generic_to_list_string(NULL, (STRING)key, len, ", ", rfmt, TRUE);
+	zs_apps(zstr, str);
+	stdfree(str);
+	str = strsave(zs_str(zstr));
+	zs_free(&zstr);
+	return str;
+}
 /*==========================================
  * famseq_print_el -- Format a print line of
  *  sequence of families
@@ -1783,6 +2253,7 @@ get_print_el (INDISEQ seq, INT i, INT len, RFMT rfmt)
 	switch(IPrntype(seq)) {
 	case ISPRN_FAMSEQ: str = famseq_print_el(seq, i, len, rfmt); break;
 	case ISPRN_SPOUSESEQ: str = spouseseq_print_el(seq, i, len, rfmt); break;
+	case ISPRN_RELPATHSEQ: str = relpathseq_print_el(seq, i, len, rfmt); break;
 	default: str = generic_print_el(seq, i, len, rfmt); break;
 	}
 	return str;
@@ -1800,26 +2271,100 @@ get_print_el (INDISEQ seq, INT i, INT len, RFMT rfmt)
 void
 print_indiseq_element (INDISEQ seq, INT i, STRING buf, INT len, RFMT rfmt)
 {
-	STRING str, ptr=buf;
-	BOOLEAN alloc=FALSE;
+	STRING ptr=buf;
 	buf[0]='\0';
-	str = sprn(IData(seq)[i]);
-	if (!str) {
-		/*
-		 If not precomputed, make print string on-the-fly .
-		 This is used for long seqs, when we don't want to keep
-		 all these strings in memory all the time.
-		 *
-		 Note: The print_el functions return a strsave'd string.
-		 It would be more efficient not to strsave. This requires
-		 changing indi_to_list_string, etc.
-		*/
-		str = get_print_el(seq, i, len-1, rfmt);
-		alloc=TRUE;
+	/*
+	 If not precomputed, make print string on-the-fly, and keep
+	 it only while it is among the most recently shown.
+	 This is used for long seqs, when we don't want to keep
+	 all these strings in memory all the time.
+	*/
+	llstrcatn(&ptr, cached_print_el(seq, i, len-1, rfmt), &len);
+}
+/*================================================
+ * preprint_indiseq_element -- Make sure print line of
+ *  an element is formatted (eg, while waiting for user)
+ *  seq:  [in] indiseq of interest
+ *  i:    [in] index of desired element
+ *  len:  [in] buffer length later given print_indiseq_element
+ *  rfmt: [in] reformatting info
+ * returns TRUE if it had to be formatted now
+ *==============================================*/
+BOOLEAN
+preprint_indiseq_element (INDISEQ seq, INT i, INT len, RFMT rfmt)
+{
+	SORTEL el;
+	if (i < 0 || i >= ISize(seq))
+		return FALSE;
+	el = IData(seq)[i];
+	if (print_el_current(el, len-1))
+		return FALSE;
+	cached_print_el(seq, i, len-1, rfmt);
+	return TRUE;
+}
+/*================================================
+ * print_el_current -- Is print line of element
+ *  usable for given width ?
+ *==============================================*/
+static BOOLEAN
+print_el_current (SORTEL el, INT len)
+{
+	if (!sprn(el))
+		return FALSE;
+	if (sprnuse(el) && sprnlen(el) != len)
+		return FALSE;
+	return sprnver(el) == record_version(skey(el));
+}
+/*================================================
+ * cached_print_el -- Print line of element, formatted
+ *  now unless it already was (for same width, and
+ *  record unchanged since)
+ *  returns string belonging to element
+ *==============================================*/
+static CNSTRING
+cached_print_el (INDISEQ seq, INT i, INT len, RFMT rfmt)
+{
+	SORTEL el = IData(seq)[i];
+	if (print_el_current(el, len)) {
+		if (sprnuse(el))
+			sprnuse(el) = ++IPrnclock(seq);
+		return sprn(el);
 	}
-	llstrcatn(&ptr, str, &len);
-	if (alloc)
-		stdfree(str);
+	drop_print_el(seq, el);
+	sprn(el) = get_print_el(seq, i, len, rfmt);
+	sprnlen(el) = len;
+	sprnver(el) = record_version(skey(el));
+	sprnuse(el) = ++IPrnclock(seq);
+	if (++IPrncount(seq) > PRNCACHE_MAX)
+		trim_print_els(seq);
+	return sprn(el);
+}
+/*================================================
+ * drop_print_el -- Free print line of element
+ *==============================================*/
+static void
+drop_print_el (INDISEQ seq, SORTEL el)
+{
+	if (!sprn(el))
+		return;
+	stdfree(sprn(el));
+	sprn(el) = NULL;
+	if (sprnuse(el))
+		--IPrncount(seq);
+	sprnuse(el) = 0;
+}
+/*================================================
+ * trim_print_els -- Free all but the most recently
+ *  used print lines formatted on demand
+ *==============================================*/
+static void
+trim_print_els (INDISEQ seq)
+{
+	INT oldest = IPrnclock(seq) - PRNCACHE_KEEP;
+	FORINDISEQ(seq, el, num)
+		if (sprnuse(el) && sprnuse(el) <= oldest)
+			drop_print_el(seq, el);
+	ENDINDISEQ
 }
 /*=====================================================
  * preprint_indiseq -- Preformat print lines of indiseq
@@ -1831,7 +2376,10 @@ void
 preprint_indiseq (INDISEQ seq, INT len, RFMT rfmt)
 {
 	FORINDISEQ(seq, el, num)
+		drop_print_el(seq, el);
 		sprn(el) = get_print_el(seq, num, len, rfmt);
+		sprnlen(el) = len;
+		sprnver(el) = record_version(skey(el));
 	ENDINDISEQ
 }
 /*==============================================================
@@ -1846,11 +2394,15 @@ refn_to_indiseq (STRING ukey, INT letr, INT sort)
 
 	if (!ukey || *ukey == 0) return NULL;
 	get_refns(ukey, &num, &keys, letr);
-	if (num == 0) return NULL;
+	if (num == 0) {
+		free_refns(num, keys);
+		return NULL;
+	}
 	seq = create_indiseq_null();
 	for (i = 0; i < num; i++) {
 		append_indiseq_null(seq, keys[i], NULL, FALSE, FALSE);
 	}
+	free_refns(num, keys);
 	if (sort == NAMESORT)
 		namesort_indiseq(seq);
 	else
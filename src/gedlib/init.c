@@ -47,6 +47,11 @@
 #include "charprops.h"
 #include "xlat.h"
 #include "dbcontext.h"
+#include "dateindex.h"
+#include "placeindex.h"
+#include "tagindex.h"
+#include "famgraph.h"
+#include "reccache.h"
 
 /*********************************************
  * global/exported variables
@@ -194,6 +199,11 @@ init_lifelines_postdb (void)
 	init_browse_lists();
 	if (!openxref(readonly))
 		return FALSE;
+	famgraph_open();
+	dateindex_open();
+	placeindex_open();
+	tagindex_open();
+	reccache_open();
 
 	transl_load_xlats();
 
@@ -31,9 +31,75 @@
 #include "llstdlib.h"
 #include "gedcom.h"
 #include "btree.h"
+#include "dateindex.h"
+#include "placeindex.h"
+#include "tagindex.h"
+#include "famgraph.h"
+#include "reccache.h"
 
 extern BTREE BTR;
 
+/* change counters for records, shared by hash of key, so a
+collision only makes a caller think a record changed */
+#define RECVERSION_SLOTS 4096
+
+/* alphabetical */
+static INT recversion_slot(CNSTRING key);
+
+static INT recversion[RECVERSION_SLOTS];
+static INT dbversion = 0;
+
+/*=================================================
+ * record_version -- Change counter of a record
+ *  key:  [IN] key of record (eg, "I543")
+ * Value changes whenever the record is stored or deleted,
+ * so callers may keep anything derived from a record
+ * for as long as its version (and those of any records
+ * it drew on) stays the same
+ *===============================================*/
+INT
+record_version (CNSTRING key)
+{
+	return recversion[recversion_slot(key)];
+}
+/*=================================================
+ * database_version -- Change counter of all records
+ * Value changes whenever any record is stored or deleted
+ *===============================================*/
+INT
+database_version (void)
+{
+	return dbversion;
+}
+/*=================================================
+ * record_versions_reset -- Invalidate all versions
+ *  (when a database is closed)
+ *===============================================*/
+void
+record_versions_reset (void)
+{
+	INT i;
+	for (i=0; i<RECVERSION_SLOTS; ++i)
+		++recversion[i];
+	++dbversion;
+}
+/*=================================================
+ * recversion_slot -- Slot of change counter for key
+ *  (ignores any padding, so "    I543" matches "I543")
+ *===============================================*/
+static INT
+recversion_slot (CNSTRING key)
+{
+	unsigned int hash = 0;
+	if (!key)
+		return 0;
+	for ( ; *key; ++key) {
+		if (*key != ' ')
+			hash = hash*31 + (uchar)*key;
+	}
+	return (INT)(hash % RECVERSION_SLOTS);
+}
+
 /*=================================================
  * retrieve_raw_record -- Retrieve record string from database
  *  key:  [IN] key of desired record (eg, "    I543")
@@ -42,8 +108,14 @@ extern BTREE BTR;
 STRING
 retrieve_raw_record (CNSTRING key, INT *plen)
 {
-	RKEY rkey = str2rkey(key);
-	return bt_getrecord(BTR, &rkey, plen);
+	RKEY rkey;
+	STRING rawrec;
+	if ((rawrec = reccache_get(key, plen)))
+		return rawrec;
+	rkey = str2rkey(key);
+	if ((rawrec = bt_getrecord(BTR, &rkey, plen)))
+		reccache_put(key, rawrec, *plen);
+	return rawrec;
 }
 /*=========================================
  * store_record -- Store record in database
@@ -54,7 +126,18 @@ retrieve_raw_record (CNSTRING key, INT *plen)
 BOOLEAN
 store_record (CNSTRING key, STRING rec, INT len)
 {
-	return bt_addrecord (BTR, str2rkey(key), rec, len);
+	BOOLEAN rtn;
+	tagindex_record_storing(key);
+	rtn = bt_addrecord(BTR, str2rkey(key), rec, len);
+	++recversion[recversion_slot(key)];
+	++dbversion;
+	if (rtn) {
+		famgraph_record_stored(key, rec, len);
+		dateindex_record_stored(key, rec, len);
+		placeindex_record_stored(key, rec, len);
+		tagindex_record_stored(key, rec, len);
+	}
+	return rtn;
 }
 /*=========================================
  * retrieve_to_file -- Retrieve record to file
@@ -94,7 +177,18 @@ store_file (STRING key, STRING file)
 BOOLEAN
 store_text_file_to_db (STRING key, CNSTRING file, TRANSLFNC transfnc)
 {
-	return addtextfile(BTR, str2rkey(key), file, transfnc);
+	BOOLEAN rtn;
+	tagindex_record_storing(key);
+	rtn = addtextfile(BTR, str2rkey(key), file, transfnc);
+	++recversion[recversion_slot(key)];
+	++dbversion;
+	if (rtn) {
+		famgraph_record_stored(key, NULL, 0);
+		dateindex_record_stored(key, NULL, 0);
+		placeindex_record_stored(key, NULL, 0);
+		tagindex_record_stored(key, NULL, 0);
+	}
+	return rtn;
 }
 /*===================================================
  * traverse_db_key_keys -- traverse a span of records
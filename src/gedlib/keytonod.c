@@ -768,6 +768,41 @@ key_to_cacheel (CACHE cache, CNSTRING key, STRING tag, INT reportmode)
 	}
 	return cel;
 }
+/*===============================================================
+ * prefetch_record -- Load record into cache ahead of need
+ *  key:  [IN]  key of record (any type)
+ * Leaves the recency of an already cached record alone, and does
+ * not load if that would require evicting a locked entry.
+ * Quiet: missing records are neither reported nor listed.
+ * Returns root node while it remains cached, else NULL
+ *=============================================================*/
+NODE
+prefetch_record (CNSTRING key)
+{
+	CACHE cache=0;
+	CACHEEL cel=0;
+	INT badkeys = listbadkeys;
+	if (!key || !key[0]) return NULL;
+	switch(key[0]) {
+		case 'I': cache = indicache; break;
+		case 'F': cache = famcache; break;
+		case 'S': cache = sourcache; break;
+		case 'E': cache = evencache; break;
+		default: cache = othrcache; break;
+	}
+	if (!cache) return NULL;
+	if ((cel = (CACHEEL) valueof_ptr(cacdata(cache), key)))
+		return cnode(cel);
+	if (!cacfree(cache)) {
+		for (cel = caclastdir(cache); cel && cclock(cel); cel = cprev(cel)) {
+		}
+		if (!cel) return NULL;
+	}
+	listbadkeys = 0;
+	cel = key_to_cacheel(cache, key, NULL, TRUE);
+	listbadkeys = badkeys;
+	return cel ? cnode(cel) : NULL;
+}
 /*===============================================================
  * key_to_node -- Return tree from key; add to cache if not there
  * asserts if failure
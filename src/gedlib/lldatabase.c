@@ -17,6 +17,12 @@
 #include "btree.h"
 #include "vtable.h"
 #include "dbcontext.h"
+#include "dateindex.h"
+#include "placeindex.h"
+#include "tagindex.h"
+#include "famgraph.h"
+#include "reccache.h"
+#include "indiseq.h"
 
 
 /*********************************************
@@ -94,6 +100,13 @@ void lldb_close (LLDATABASE *plldb)
 		placabbvs = NULL;
 	}
 	free_caches();
+	famgraph_close();
+	dateindex_close();
+	placeindex_close();
+	tagindex_close();
+	reccache_close();
+	record_versions_reset();
+	term_relation_path();
 	check_node_leaks();
 	term_node_allocator();
 	check_record_leaks();
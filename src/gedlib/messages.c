@@ -205,6 +205,8 @@ ZST qSidsps1      = N_("Identify a spouse/parent for the new family.");
 ZST qSidsps2      = N_("Identify the second spouse/parent, if known.");
 ZST qStwohsb      = N_("Both families must have husbands/fathers.");
 ZST qStwowif      = N_("Both families must have wives/mothers.");
+ZST qSnorelp      = N_("These persons are not related.");
+ZST qSrelpbgt     = N_("No relationship found within the search limits.");
 
 ZST qSids2fm      = N_("Identify spouse/parent in second family, if known.");
 ZST qSidc2fm      = N_("Identify child in second family.");
@@ -225,6 +227,15 @@ ZST qSnopmrg      = N_("A person cannot be merged with him/herself.");
 ZST qSnofmrg      = N_("A family cannot be merged with itself.");
 ZST qSnoqmrg      = N_("Two persons with different parents cannot be merged.");
 ZST qSnoxmrg      = N_("Two parents of different sexes cannot be merged.");
+ZST qSbmrgok      = N_("%s merged into %s");
+ZST qSbmrgdry     = N_("%s would be merged into %s");
+ZST qSbmrgnok     = N_("%s not merged into %s: %s");
+ZST qSbmrgkey     = N_("No such person.");
+ZST qSbmrgtwc     = N_("This person is already to be merged.");
+ZST qSbmrglop     = N_("These merges form a loop.");
+ZST qSbmrgsum     = N_("%d persons merged into %d; %d families updated.");
+ZST qSbmrgsmd     = N_("%d persons would be merged into %d; %d families would be updated.");
+ZST qSbmrglen     = N_("mergeindis: the two lists must be of the same length");
 ZST qSdhusb       = N_("The families have different fathers/husbands; cannot merge.");
 ZST qSdwife       = N_("The families have different wives/mothers; cannot merge.");
 ZST qSidpdel      = N_("Who do you want to remove from the database?");
@@ -560,8 +571,10 @@ ZST qSmn_sea_ttl  = N_("How would you like to find a record?");
 /* &&end search menu, begin scan status strings */
 ZST qSsts_sca_ful = N_("Performing full name scan");
 ZST qSsts_sca_fra = N_("Performing name fragment scan");
+ZST qSsts_sca_pla = N_("Performing place search");
 ZST qSsts_sca_ref = N_("Performing refn scan");
 ZST qSsts_sca_src = N_("Performing source scan");
+ZST qSsts_sca_tag = N_("Performing tag scan");
 ZST qSsts_sca_non = N_("No records found in scan");
 
 /* &&complex date strings (A=abbrev, B=full)*/
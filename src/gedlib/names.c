@@ -50,26 +50,35 @@ extern BTREE BTR;
  * local function prototypes
  *********************************************/
 
+struct tag_namerec;
 static void add_namekey(const RKEY * rkeyname, CNSTRING name, const RKEY * rkeyid);
+static void allocnamerec(struct tag_namerec * nr);
 static void cmpsqueeze(CNSTRING, STRING);
 static BOOLEAN dupcheck(TABLE tab, CNSTRING str);
 static BOOLEAN exactmatch(CNSTRING, CNSTRING);
 static void find_indis_worker(CNSTRING name, uchar finitial, CNSTRING sdex, TABLE donetab, LIST list);
 static void flush_name_cache(void);
+static void freenamerec(struct tag_namerec * nr);
 static INT getfinitial(CNSTRING);
-static void getnamerec(const RKEY * rkey);
+static void getnamerec(struct tag_namerec * nr, const RKEY * rkey);
 static CNSTRING getsurname_impl(CNSTRING name);
+static CNSTRING getsurname_r(CNSTRING name, STRING buffer);
+static CNSTRING getsxsurname_r(CNSTRING name, STRING buffer);
 static STRING name_surfirst(STRING);
 static void name_to_parts(CNSTRING, STRING*);
+static void parsenamerec(struct tag_namerec * nr, const RKEY * rkey, CNSTRING p);
 /* static void name2rkey(CNSTRING, RKEY *); */
 static CNSTRING nextpiece(CNSTRING);
 static STRING parts_to_name(STRING*);
 static BOOLEAN piecematch(STRING, STRING);
+static void reallocnamerec(struct tag_namerec * nr);
+static BOOLEAN rekey_namerec(struct tag_namerec * nr, TABLE keymap);
 static void remove_namekey(const RKEY * rkeyname, CNSTRING name, const RKEY * rkeyid);
 /* static void rkey_cpy(const RKEY * src, RKEY * dest);*/
 BOOLEAN rkey_eq(const RKEY * rkey1, const RKEY * rkey2);
 static void soundex2rkey(char finitial, CNSTRING sdex, RKEY * rkey);
 static void squeeze(CNSTRING, STRING);
+static void storenamerec(struct tag_namerec * nr, INT extra);
 static STRING upsurname(STRING);
 
 /*********************************************
@@ -92,35 +101,37 @@ static STRING upsurname(STRING);
  *   nnames STRING names  - char buffer where the names are stored
  *			    based on char offsets
  *-------------------------------------------------------------------
- * internal format -- At any time there can be only one name record
- *   stored internally; the data is stored in global data structures
+ * internal format -- A name record read from the database is held
+ *   in a NAMEREC; lookups use one of their own (on the stack), so
+ *   they share no state, and updates use the module's namerec
  *-------------------------------------------------------------------
- *   RKEY    NRkey   - RKEY of the current name record
- *   STRING  NRrec   - current name record
- *   INT     NRsize  - size of current name record
- *   INT32   NRmax   - max allocation size of internal arrays
- *   INT32   NRcount - number of entries in current name record
- *   RKEY   *NRkeys  - RKEYs of the INDI records with the names
- *   INT32  *NRoffs  - char offsets to names in current name record
- *   CNSTRING *NRnames - name values from INDI records that the
+ *   RKEY    key     - RKEY of the name record
+ *   STRING  rec     - raw name record
+ *   INT     size    - size of raw name record
+ *   INT     max     - max allocation size of arrays below
+ *   INT32   count   - number of entries in name record
+ *   RKEY   *keys    - RKEYs of the INDI records with the names
+ *   INT32  *offs    - char offsets to names in raw name record
+ *   CNSTRING *names - name values from INDI records that the
  *			  index is based upon
  *-------------------------------------------------------------------
- * When a name record is used to match a search name, the internal
- *   structures are modified to remove all entries that don't match
- *   the name; in addition, other global data structures are used
+ * When a name record is used to match a search name, its arrays
+ *   are modified to remove all entries that don't match the name
  *=================================================================*/
 
-/* Current name record - raw */
-static RKEY    NRkey;
-static STRING  NRrec = NULL;
-static INT     NRsize;
+typedef struct tag_namerec {
+	RKEY     key;
+	STRING   rec;
+	INT      size;
+	INT      max;
+	INT32    count;
+	INT32   *offs;
+	RKEY    *keys;
+	CNSTRING *names;
+} NAMEREC;
 
-/* Current name record - parsed */
-static INT     NRmax = 0;
-static INT32   NRcount;
-static INT32  *NRoffs;
-static RKEY   *NRkeys;
-static CNSTRING *NRnames;
+/* Name record being updated */
+static NAMEREC namerec;
 
 
 /*********************************************
@@ -129,115 +140,164 @@ static CNSTRING *NRnames;
  *********************************************/
 
 /*====================================================
- * allocnamerec -- Allocate internal name record
+ * allocnamerec -- Allocate arrays of name record
  *==================================================*/
 static void
-allocnamerec(void)
+allocnamerec (NAMEREC * nr)
 {
-	ASSERT(NRmax);
-	NRkeys = (RKEY *) stdalloc((NRmax)*sizeof(RKEY));
-	NRoffs = (INT32 *) stdalloc((NRmax)*sizeof(INT32));
-	NRnames = (CNSTRING *) stdalloc((NRmax)*sizeof(STRING));
+	ASSERT(nr->max);
+	nr->keys = (RKEY *) stdalloc((nr->max)*sizeof(RKEY));
+	nr->offs = (INT32 *) stdalloc((nr->max)*sizeof(INT32));
+	nr->names = (CNSTRING *) stdalloc((nr->max)*sizeof(STRING));
 }
 
 /*====================================================
- * freenamerec -- Free internal name record
+ * freenamerec -- Free name record
  *==================================================*/
 static void
-freenamerec(void)
+freenamerec (NAMEREC * nr)
 {
-	stdfree(NRkeys);
-	NRkeys = NULL;
-	stdfree(NRoffs);
-	NRoffs = NULL;
-	stdfree((STRING)NRnames);
-	NRnames = NULL;
-	NRmax = 0;
+	strfree(&nr->rec);
+	if (nr->max) {
+		stdfree(nr->keys);
+		stdfree(nr->offs);
+		stdfree((STRING)nr->names);
+	}
+	nr->keys = NULL;
+	nr->offs = NULL;
+	nr->names = NULL;
+	nr->max = 0;
+	nr->count = 0;
 }
 
 /*====================================================
- * reallocnamerec -- Reallocate internal name record
+ * reallocnamerec -- Reallocate arrays of name record
  *==================================================*/
 static void
-reallocnamerec(void)
+reallocnamerec (NAMEREC * nr)
 {
-	if (NRmax != 0) {
-		freenamerec();
+	if (nr->max != 0) {
+		stdfree(nr->keys);
+		stdfree(nr->offs);
+		stdfree((STRING)nr->names);
 	}
-	NRmax = NRcount + 10;
-	allocnamerec();
+	nr->max = nr->count + 10;
+	allocnamerec(nr);
 }
 
 /*====================================================
- * parsenamerec -- Store name rec in file buffers
+ * parsenamerec -- Parse raw name record into arrays
+ *  p: [IN]  raw record (names point into it)
  *==================================================*/
 static void
-parsenamerec (const RKEY * rkey, CNSTRING p)
+parsenamerec (NAMEREC * nr, const RKEY * rkey, CNSTRING p)
 {
 	INT i;
 
-	ASSERT(NRcount < 1000000); /* 1000000 names in a given slot ? */
-
 	/* update name record key */
-	memcpy(&NRkey, rkey, sizeof(*rkey));
+	memcpy(&nr->key, rkey, sizeof(*rkey));
 
 	/* copy record count */
-	memcpy (&NRcount, p, sizeof(NRcount));
-	p += sizeof(NRcount);
+	memcpy (&nr->count, p, sizeof(nr->count));
+	p += sizeof(nr->count);
+
+	ASSERT(nr->count < 1000000); /* 1000000 names in a given slot ? */
 
 	/* reallocate backing storage if needed */
-	if (NRcount >= NRmax - 1) {
-		reallocnamerec();
+	if (nr->count >= nr->max - 1) {
+		reallocnamerec(nr);
 	}
 
 	/* copy keys */
-	for (i = 0; i < NRcount; i++) {
-		memcpy(&NRkeys[i], p, sizeof(NRkeys[i]));
-		p += sizeof(NRkeys[i]);
+	for (i = 0; i < nr->count; i++) {
+		memcpy(&nr->keys[i], p, sizeof(nr->keys[i]));
+		p += sizeof(nr->keys[i]);
 	}
 
 	/* copy offsets */
-	for (i = 0; i < NRcount; i++) {
-		memcpy(&NRoffs[i], p, sizeof(NRoffs[i]));
-		p += sizeof(NRoffs[i]);
+	for (i = 0; i < nr->count; i++) {
+		memcpy(&nr->offs[i], p, sizeof(nr->offs[i]));
+		p += sizeof(nr->offs[i]);
 	}
 
 	/* copy names */
-	for (i = 0; i < NRcount; i++)
-		NRnames[i] = p + NRoffs[i];
+	for (i = 0; i < nr->count; i++)
+		nr->names[i] = p + nr->offs[i];
 }
 /*====================================================
- * getnamerec -- Read name record and store in file buffers
+ * getnamerec -- Read name record and parse it
  *==================================================*/
 static void
-getnamerec (const RKEY * rkey)
+getnamerec (NAMEREC * nr, const RKEY * rkey)
 {
 	STRING p;
-/* TODO: enable this cache (but must add code to flush it
-across database reloads
-
-	if (NRrec && eqrkey(rkey, &NRKEY))
-		return NRcount>0;
-*/
 	/* update name record key */
-	memcpy(&NRkey, rkey, sizeof(*rkey));
+	memcpy(&nr->key, rkey, sizeof(*rkey));
 
 	/* free existing record storage */
-	strfree(&NRrec);
+	strfree(&nr->rec);
 
 	/* get record by key */
-	p = NRrec = bt_getrecord(BTR, rkey, &NRsize);
-	if (!NRrec) {
-		NRcount = 0;
-		if (NRmax == 0) {
-			NRmax = 10;
-			allocnamerec();
+	p = nr->rec = bt_getrecord(BTR, rkey, &nr->size);
+	if (!nr->rec) {
+		nr->count = 0;
+		if (nr->max == 0) {
+			nr->max = 10;
+			allocnamerec(nr);
 		}
 		return;
 	}
 
 	/* parse name record */
-	parsenamerec(rkey, p);
+	parsenamerec(nr, rkey, p);
+}
+/*====================================================
+ * storenamerec -- Write name record from its arrays
+ *  extra: [IN]  bytes needed beyond size of raw record
+ *==================================================*/
+static void
+storenamerec (NAMEREC * nr, INT extra)
+{
+	INT i, len;
+	INT32 off;
+	STRING p, rec;
+
+	/* allocate new record */
+	p = rec = (STRING) stdalloc(nr->size + extra);
+	len = off = 0;
+
+	/* copy record count */
+	memcpy(p, &nr->count, sizeof(nr->count));
+	p += sizeof(nr->count);
+	len += sizeof(nr->count);
+
+	/* copy keys */
+	for (i = 0; i < nr->count; i++) {
+		memcpy(p, &nr->keys[i], sizeof(nr->keys[i]));
+		p += sizeof(nr->keys[i]);
+		len += sizeof(nr->keys[i]);
+	}
+
+	/* recompute offsets */
+	ASSERT(sizeof(off) == sizeof(*nr->offs));
+	for (i = 0; i < nr->count; i++) {
+		memcpy(p, &off, sizeof(off));
+		p += sizeof(off);
+		len += sizeof(off);
+		off += strlen(nr->names[i]) + 1;
+	}
+
+	/* copy names */
+	for (i = 0; i < nr->count; i++) {
+		INT namelen = strlen(nr->names[i]) + 1;
+		memcpy(p, nr->names[i], namelen);
+		p += namelen;
+		len += namelen;
+	}
+
+	/* update record in btree, free record storage */
+	bt_addrecord(BTR, nr->key, rec, len);
+	stdfree(rec);
 }
 /*============================================
  * name2rkey - Convert name to name record key
@@ -337,12 +397,23 @@ name_hi (void)
 static CNSTRING
 getsurname_impl (CNSTRING name)
 {
-	INT c;
 	static char buffer[3][MAXLINELEN+1];
 	static INT dex = 0;
-	STRING p, surname;
 	if (++dex > 2) dex = 0;
-	p = surname = buffer[dex];
+	return getsurname_r(name, buffer[dex]);
+}
+/*======================================================
+ * getsurname_r -- Find surname, in caller's buffer
+ *  name:    [in]  full name to search for surname
+ *  buffer:  [out] buffer of MAXLINELEN+1 chars
+ * returns buffer, or 0 if no surname
+ *====================================================*/
+static CNSTRING
+getsurname_r (CNSTRING name, STRING buffer)
+{
+	INT c;
+	STRING p, surname;
+	p = surname = buffer;
 	/* find beginning of surname (look for first NAMESEP) */
 	while ((c = (uchar)*name++) && c != NAMESEP)
 		;
@@ -367,12 +438,23 @@ getsurname_impl (CNSTRING name)
 CNSTRING
 getsxsurname (CNSTRING name)        /* GEDCOM name */
 {
-	CNSTRING surnm = getsurname_impl(name);
+	static char buffer[3][MAXLINELEN+1];
+	static INT dex = 0;
+	if (++dex > 2) dex = 0;
+	return getsxsurname_r(name, buffer[dex]);
+}
+/*=============================
+ * getsxsurname_r -- Return surname for soundex, in caller's buffer
+ *  buffer: [out] buffer of MAXLINELEN+1 chars
+ *===========================*/
+static CNSTRING
+getsxsurname_r (CNSTRING name, STRING buffer)
+{
+	CNSTRING surnm = getsurname_r(name, buffer);
 	/* screen out missing surnames, or ones beginning with puncutation */
 	if (!surnm || (isascii(surnm[0]) && !isletter(surnm[0])))
 		return (STRING) "____";
 	return surnm;
-
 }
 /*=============================
  * getasurname -- Return a surname 
@@ -450,64 +532,26 @@ add_name (CNSTRING name, CNSTRING key)
 static void
 add_namekey (const RKEY * rkeyname, CNSTRING name, const RKEY * rkeyid)
 {
-	INT i, len, recsize;
-	INT32 off;
-	STRING p, rec;
+	INT i;
 
 	/* load up local name record buffers */
-	getnamerec(rkeyname);
+	getnamerec(&namerec, rkeyname);
 
 	/* check if name already present in name record */
-	for (i = 0; i < NRcount; i++) {
-		if (rkey_eq(rkeyid, &NRkeys[i]) &&
-		    eqstr(name, NRnames[i]))
+	for (i = 0; i < namerec.count; i++) {
+		if (rkey_eq(rkeyid, &namerec.keys[i]) &&
+		    eqstr(name, namerec.names[i]))
 			return;
 	}
 
 	/* update directory */
-	NRkeys[NRcount] = *rkeyid;
-	NRnames[NRcount] = name;
+	namerec.keys[namerec.count] = *rkeyid;
+	namerec.names[namerec.count] = name;
 
 	/* increase record count */
-	NRcount++;
-
-	/* allocate new record */
-	recsize = sizeof(RKEY) + sizeof(INT32) + strlen(name) + 10;
-	p = rec = (STRING) stdalloc(NRsize + recsize);
-	len = off = 0;
-
-	/* copy record count */
-	memcpy(p, &NRcount, sizeof(NRcount));
-	p += sizeof(NRcount);
-	len += sizeof(NRcount);
-
-	/* copy keys */
-	for (i = 0; i < NRcount; i++) {
-		memcpy(p, &NRkeys[i], sizeof(NRkeys[i]));
-		p += sizeof(NRkeys[i]);
-		len += sizeof(NRkeys[i]);
-	}
-
-	/* recompute offsets */
-	ASSERT(sizeof(off) == sizeof(*NRoffs));
-	for (i = 0; i < NRcount; i++) {
-		memcpy(p, &off, sizeof(off));
-		p += sizeof(off);
-		len += sizeof(off);
-		off += strlen(NRnames[i]) + 1;
-	}
-
-	/* copy names */
-	for (i = 0; i < NRcount; i++) {
-		INT namelen = strlen(NRnames[i]) + 1;
-		memcpy(p, NRnames[i], namelen);
-		p += namelen;
-		len += namelen;
-	}
+	namerec.count++;
 
-	/* update record in btree, free record storage */
-	bt_addrecord(BTR, NRkey, rec, len);
-	stdfree(rec);
+	storenamerec(&namerec, sizeof(RKEY) + sizeof(INT32) + strlen(name) + 10);
 
 	/* flush cache as name record has changed */
 	flush_name_cache();
@@ -553,18 +597,16 @@ remove_name (STRING name, CNSTRING key)
 static void
 remove_namekey (const RKEY * rkeyname, CNSTRING name, const RKEY * rkeyid)
 {
-	INT i, len;
-	INT32 off;
-	STRING p, rec;
+	INT i;
 	BOOLEAN found = FALSE;
 
 	/* load up local name record buffers */
-	getnamerec(rkeyname);
+	getnamerec(&namerec, rkeyname);
 
 	/* check if name already present in name record */
-	for (i = 0; i < NRcount; i++) {
-		if (rkey_eq(rkeyid, &NRkeys[i]) &&
-			eqstr(name, NRnames[i])) {
+	for (i = 0; i < namerec.count; i++) {
+		if (rkey_eq(rkeyid, &namerec.keys[i]) &&
+			eqstr(name, namerec.names[i])) {
 			found = TRUE;
 			break;
 		}
@@ -572,54 +614,109 @@ remove_namekey (const RKEY * rkeyname, CNSTRING name, const RKEY * rkeyid)
 	if (!found) return;
 
 	/* update directory */
-	for ( ; i < NRcount-1; i++) {
-		NRkeys[i] = NRkeys[i+1];
-		NRnames[i] = NRnames[i+1];
+	for ( ; i < namerec.count-1; i++) {
+		namerec.keys[i] = namerec.keys[i+1];
+		namerec.names[i] = namerec.names[i+1];
 	}
 
 	/* decrease record count */
-	NRcount--;
+	namerec.count--;
 
-	/* allocate new record */
-	p = rec = (STRING) stdalloc(NRsize);
-	len = off = 0;
+	storenamerec(&namerec, 0);
 
-	/* copy record count */
-	memcpy(p, &NRcount, sizeof(NRcount));
-	p += sizeof(NRcount);
-	len += sizeof(NRcount);
+	/* flush cache as name record has changed */
+	flush_name_cache();
+}
+/*=============================================
+ * rekey_names -- Move name entries to other persons
+ *  names:  [IN]  names whose entries may move
+ *  keymap: [IN]  old INDI key -> new INDI key
+ * Each name record holding any of the names is read
+ * and written once, however many entries change in it;
+ * entries made identical by the move are dropped
+ *===========================================*/
+void
+rekey_names (LIST names, TABLE keymap)
+{
+	TABLE donetab = create_table_int();
+	TABLE_ITER tabit=0;
+	CNSTRING rkeystr=0;
+	INT i, ival;
+	RKEY rkeyname;
 
-	/* copy keys */
-	for (i = 0; i < NRcount; i++) {
-		memcpy(p, &NRkeys[i], sizeof(NRkeys[i]));
-		p += sizeof(NRkeys[i]);
-		len += sizeof(NRkeys[i]);
+	/* collect name records the names are indexed in */
+	FORLIST(names, el)
+		CNSTRING name = (CNSTRING)el;
+		char finitial = getfinitial(name);
+		STRING surname = strsave(getsxsurname(name));
+		for (i=0; i<soundex_count(); ++i) {
+			CNSTRING sdex = soundex_get(i, surname);
+			soundex2rkey(finitial, sdex, &rkeyname);
+			dupcheck(donetab, rkey2str(rkeyname));
+		}
+		strfree(&surname);
+	ENDLIST
+
+	tabit = begin_table_iter(donetab);
+	while (next_table_int(tabit, &rkeystr, &ival)) {
+		rkeyname = str2rkey(rkeystr);
+		getnamerec(&namerec, &rkeyname);
+		if (rekey_namerec(&namerec, keymap))
+			storenamerec(&namerec, 0);
 	}
+	end_table_iter(&tabit);
+	destroy_table(donetab);
 
-	/* recompute offsets */
-	ASSERT(sizeof(off) == sizeof(*NRoffs));
-	off = 0;
-	for (i = 0; i < NRcount; i++) {
-		memcpy(p, &off, sizeof(off));
-		p += sizeof(off);
-		len += sizeof(off);
-		off += strlen(NRnames[i]) + 1;
+	/* flush cache as name records have changed */
+	flush_name_cache();
+}
+/*=============================================
+ * rekey_namerec -- Move entries of name record to new keys
+ *  keymap: [IN]  old INDI key -> new INDI key
+ * returns TRUE if record changed
+ *===========================================*/
+static BOOLEAN
+rekey_namerec (NAMEREC * nr, TABLE keymap)
+{
+	char rbuf[RKEYLEN+1];
+	INT * moved = 0;
+	char * gone = 0;
+	INT i, j, n=0;
+
+	for (i = 0; i < nr->count; i++) {
+		STRING newkey = valueof_str(keymap, rkey2str_r(nr->keys[i], rbuf));
+		if (!newkey) continue;
+		if (!moved) {
+			moved = (INT *)stdalloc(nr->count*sizeof(INT));
+			gone = (char *)stdalloc(nr->count);
+			memset(gone, 0, nr->count);
+		}
+		nr->keys[i] = str2rkey(newkey);
+		moved[n++] = i;
 	}
-
-	/* copy names */
-	for (i = 0; i < NRcount; i++) {
-		INT namelen = strlen(NRnames[i]) + 1;
-		memcpy(p, NRnames[i], namelen);
-		p += namelen;
-		len += namelen;
+	if (!n) return FALSE;
+
+	/* a moved entry may duplicate one already there */
+	while (n--) {
+		i = moved[n];
+		for (j = 0; j < nr->count; j++) {
+			if (j != i && !gone[j] && rkey_eq(&nr->keys[i], &nr->keys[j])
+				&& eqstr(nr->names[i], nr->names[j])) {
+				gone[i] = 1;
+				break;
+			}
+		}
 	}
-
-	/* update record in btree, free record storage */
-	bt_addrecord(BTR, NRkey, rec, len);
-	stdfree(rec);
-
-	/* flush cache as name record has changed */
-	flush_name_cache();
+	for (i = j = 0; i < nr->count; i++) {
+		if (gone[i]) continue;
+		nr->keys[j] = nr->keys[i];
+		nr->names[j] = nr->names[i];
+		j++;
+	}
+	nr->count = j;
+	stdfree(moved);
+	stdfree(gone);
+	return TRUE;
 }
 /*=========================================================
  * exactmatch -- Check if first name is contained in second
@@ -721,8 +818,9 @@ find_indis_by_name (CNSTRING name)
 {
 	INT i;
 	RECORD rec;
+	char buffer[MAXLINELEN+1], sdexbuf[SOUNDEX_BUFLEN];
 	uchar finitial = getfinitial(name);
-	STRING surname = strsave(getsxsurname(name));
+	STRING surname = strsave(getsxsurname_r(name, buffer));
 	TABLE donetab = create_table_int();
 	LIST list = create_list2(LISTDOFREE);
 
@@ -736,7 +834,7 @@ find_indis_by_name (CNSTRING name)
 	}
 
 	for (i=0; i<soundex_count(); ++i) 	{
-		CNSTRING sdex = soundex_get(i, surname);
+		CNSTRING sdex = soundex_get_r(i, surname, sdexbuf);
 		if (name[0] == '*') {
 			INT c;
 			INT lastchar = 255;
@@ -774,38 +872,37 @@ find_indis_worker (CNSTRING name, uchar finitial, CNSTRING sdex, TABLE donetab,
 {
 	INT i, n;
 	RKEY rkeyname;
-	CNSTRING rkeystr;
+	char rkeystr[RKEYLEN+1];
+	NAMEREC nr;
 
 	soundex2rkey(finitial, sdex, &rkeyname);
 	/* rkeyname is where names with this soundex/finitial are stored */
 	/* check if we've already done this entry */
-	rkeystr = rkey2str(rkeyname);
-	if (dupcheck(donetab, rkeystr)) {
+	if (dupcheck(donetab, rkey2str_r(rkeyname, rkeystr))) {
 		return;
 	}
 	
 	/* load names from record specified (by rkeyname) */
-	getnamerec(&rkeyname);
-	if (!NRcount) {
-		return;
-	}
+	memset(&nr, 0, sizeof(nr));
+	getnamerec(&nr, &rkeyname);
 
 	/* Compare user's name against all names in name record; the name
 	record data structures are modified */
 	n = 0;
-	for (i = 0; i < NRcount; i++) {
-		if (exactmatch(name, NRnames[i])) {
+	for (i = 0; i < nr.count; i++) {
+		if (exactmatch(name, nr.names[i])) {
 			if (i != n) {
-				NRnames[n] = NRnames[i];
-				NRkeys[n] = NRkeys[i];
+				nr.names[n] = nr.names[i];
+				nr.keys[n] = nr.keys[i];
 			}
 			n++;
 		}
 	}
-	NRcount = n;
-	for (i = 0; i < NRcount; i++) {
-		enqueue_list(list, strsave(rkey2str(NRkeys[i])));
+	nr.count = n;
+	for (i = 0; i < nr.count; i++) {
+		enqueue_list(list, strsave(rkey2str_r(nr.keys[i], rkeystr)));
 	}
+	freenamerec(&nr);
 }
 /*====================================================
  * dupcheck -- Return true if string already present
@@ -851,6 +948,26 @@ namecmp (STRING name1, STRING name2)
 	if (*p2) return -1;
 	return 0;
 }
+/*====================================
+ * namesortkey -- Append sort key of GEDCOM name to zkey
+ * keys compared with ll_sortkeycmp order names as namecmp does
+ * returns FALSE if collation has no sort keys (see ll_sortkey)
+ *==================================*/
+BOOLEAN
+namesortkey (CNSTRING name, ZSTR zkey)
+{
+	char sur[MAXLINELEN+1], sqz[MAXGEDNAMELEN];
+	STRING p = sqz;
+	if (!ll_sortkey(getsxsurname_r(name, sur), zkey))
+		return FALSE;
+	ll_sortkey_num(zkey, getfinitial(name));
+	cmpsqueeze(name, p);
+	while (*p) {
+		ll_sortkey(p, zkey);
+		p += strlen(p) + 1;
+	}
+	return TRUE;
+}
 /*===========================================================
  * cmpsqueeze -- Squeeze GEDCOM name to superstring of givens
  *  in:  [in] input string
@@ -1225,7 +1342,7 @@ name_to_list (CNSTRING name, INT *plen, INT *psind)
 }
 /*====================================================
  * traverse_names -- traverse names in db
- *  delegates to traverse_db_rec_rkeys
+ *  delegates to traverse_leaf_records
  *   passing callback function: traverse_name_callback
  *   and using local data in a TRAV_NAME_PARAM
  *   (newset is true every time it is a callback for a new name)
@@ -1234,19 +1351,22 @@ typedef struct
 {
 	TRAV_NAMES_FUNC func;
 	void * param;
+	NAMEREC nr;
 } TRAV_NAME_PARAM;
 /* see above */
 static BOOLEAN
 traverse_name_callback (RKEY rkey, STRING data, HINT_PARAM_UNUSED INT len, void *param)
 {
 	TRAV_NAME_PARAM *tparam = (TRAV_NAME_PARAM *)param;
+	NAMEREC *nr = &tparam->nr;
+	char rkeystr[RKEYLEN+1];
 	INT i;
 
-	parsenamerec(&rkey, data);
+	parsenamerec(nr, &rkey, data);
 
-	for (i=0; i<NRcount; i++)
+	for (i=0; i<nr->count; i++)
 	{
-		if (!tparam->func(rkey2str(NRkeys[i]), NRnames[i], !i, tparam->param))
+		if (!tparam->func(rkey2str_r(nr->keys[i], rkeystr), nr->names[i], !i, tparam->param))
 			return FALSE;
 	}
 	return TRUE;
@@ -1256,9 +1376,34 @@ void
 traverse_names (TRAV_NAMES_FUNC func, void *param)
 {
 	TRAV_NAME_PARAM tparam;
+	memset(&tparam, 0, sizeof(tparam));
+	tparam.param = param;
+	tparam.func = func;
+	traverse_leaf_records(BTR, name_lo(), name_hi(), NULL, &traverse_name_callback, &tparam);
+	freenamerec(&tparam.nr);
+}
+/*====================================================
+ * traverse_name_record -- traverse names in one name record
+ *  already read from db (eg, by dbverify)
+ *  rkey: [IN]  btree key of record (RKEYLEN chars)
+ *  data: [IN]  raw record
+ * returns FALSE if rkey is not that of a name record
+ *==================================================*/
+BOOLEAN
+traverse_name_record (CNSTRING rkey, STRING data, TRAV_NAMES_FUNC func, void *param)
+{
+	TRAV_NAME_PARAM tparam;
+	RKEY rkey1, lo = name_lo(), hi = name_hi();
+	memcpy(rkey1.r_rkey, rkey, RKEYLEN);
+	if (ll_strncmp(lo.r_rkey, rkey1.r_rkey, RKEYLEN) >= 0
+		|| ll_strncmp(hi.r_rkey, rkey1.r_rkey, RKEYLEN) < 0)
+		return FALSE;
+	memset(&tparam, 0, sizeof(tparam));
 	tparam.param = param;
 	tparam.func = func;
-	traverse_db_rec_rkeys(BTR, name_lo(), name_hi(), &traverse_name_callback, &tparam);
+	traverse_name_callback(rkey1, data, 0, &tparam);
+	freenamerec(&tparam.nr);
+	return TRUE;
 }
 /*====================================================
  * flush_name_cache -- Clear any cached name records
@@ -1266,15 +1411,12 @@ traverse_names (TRAV_NAMES_FUNC func, void *param)
 static
 void flush_name_cache(void)
 {
-	if (NRrec) {
-		strfree(&NRrec);
-	}
+	strfree(&namerec.rec);
 }
 /*====================================================
  * term_namerec -- Free memory for parsing name records
  *==================================================*/
 void term_namerec(void)
 {
-	strfree(&NRrec);
-	freenamerec();
+	freenamerec(&namerec);
 }
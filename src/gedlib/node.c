@@ -14,6 +14,7 @@
  *   3.0.3 - 16 Jan 96
  *===========================================================*/
 
+#include <stddef.h>	/* offsetof */
 #include "llstdlib.h"
 #include "table.h"
 #include "translat.h"
@@ -46,6 +47,12 @@ extern STRING qSrerbln, qSrernwt, qSrerilv, qSrerwlv, qSunsupunix, qSunsupuniv;
 typedef struct blck *NDALLOC;
 struct blck { NDALLOC next; };
 
+/* xref & value of a node are counted strings, shared by
+   copies of the node and replaced (never altered) on change */
+struct tag_nodestr { INT ns_refcnt; char ns_text[1]; };
+#define NODESTR_OFFSET offsetof(struct tag_nodestr, ns_text)
+#define to_nodestr(s) ((struct tag_nodestr *)((s) - NODESTR_OFFSET))
+
 /*********************************************
  * local enums & defines
  *********************************************/
@@ -62,7 +69,10 @@ static STRING fixup(STRING str);
 static STRING fixtag (STRING tag);
 static RECORD indi_to_prev_sib_impl(NODE indi);
 static void node_destructor(VTABLE *obj);
+static void node_strfree(STRING str);
 static INT node_strlen(INT levl, NODE node);
+static STRING node_strsave(CNSTRING str);
+static STRING node_strshare(STRING str);
 
 /*********************************************
  * unused local function prototypes
@@ -108,7 +118,63 @@ static STRING
 fixup (STRING str)
 {
 	if (!str || *str == 0) return NULL;
-	return strsave(str);
+	return node_strsave(str);
+}
+/*==============================
+ * node_strsave -- New counted string for a node
+ *============================*/
+static STRING
+node_strsave (CNSTRING str)
+{
+	size_t len = strlen(str);
+	struct tag_nodestr * ns = (struct tag_nodestr *)stdalloc(NODESTR_OFFSET + len + 1);
+	ns->ns_refcnt = 1;
+	memcpy(ns->ns_text, str, len + 1);
+	return ns->ns_text;
+}
+/*==============================
+ * node_strshare -- Another reference to counted string
+ *============================*/
+static STRING
+node_strshare (STRING str)
+{
+	if (str)
+		++to_nodestr(str)->ns_refcnt;
+	return str;
+}
+/*==============================
+ * node_strfree -- Drop reference to counted string
+ *============================*/
+static void
+node_strfree (STRING str)
+{
+	struct tag_nodestr * ns;
+	if (!str) return;
+	ns = to_nodestr(str);
+	if (--ns->ns_refcnt == 0)
+		stdfree(ns);
+}
+/*==============================
+ * set_node_val -- Give new value to node
+ *  val:  [IN]  new value (copied), or NULL
+ *============================*/
+void
+set_node_val (NODE node, CNSTRING val)
+{
+	STRING old = nval(node);
+	nval(node) = val ? node_strsave(val) : NULL;
+	node_strfree(old);
+}
+/*==============================
+ * set_node_xref -- Give new xref to node
+ *  xref:  [IN]  new xref (copied), or NULL
+ *============================*/
+void
+set_node_xref (NODE node, CNSTRING xref)
+{
+	STRING old = nxref(node);
+	nxref(node) = xref ? node_strsave(xref) : NULL;
+	node_strfree(old);
 }
 /*=============================
  * fixtag -- Keep tags in table
@@ -202,8 +268,8 @@ alloc_node_int (HINT_PARAM_UNUSED char* msg, HINT_PARAM_UNUSED char* file, HINT_
 void
 free_node_int (NODE node, HINT_PARAM_UNUSED char *msg, HINT_PARAM_UNUSED char *file, HINT_PARAM_UNUSED int line)
 {
-	if (nxref(node)) stdfree(nxref(node));
-	if (nval(node)) stdfree(nval(node));
+	node_strfree(nxref(node));
+	node_strfree(nval(node));
 
 	/*
 	tag is pointer into shared tagtable
@@ -954,11 +1020,17 @@ all_digits (STRING s)
 #endif /* UNUSED_CODE */
 /*=======================
  * copy_node -- Copy node
+ *  The copy shares xref & value strings with node
  *=====================*/
 NODE
 copy_node (NODE node)
 {
-	return create_node(nxref(node), ntag(node), nval(node), NULL);
+	NODE newn = alloc_node("copy_node");
+	memset(newn, 0, sizeof(*newn));
+	nxref(newn) = node_strshare(nxref(node));
+	ntag(newn) = ntag(node); /* already in tagtable */
+	nval(newn) = node_strshare(nval(node));
+	return newn;
 }
 /*========================
  * copy_node_subtree -- Copy tree
@@ -27,6 +27,9 @@
 
 INT flineno = 0;
 
+/* size of buffer for message from buffer_to_line */
+#define LINEMSGLEN (MAXLINELEN+40)
+
 /*********************************************
  * external/imported variables
  *********************************************/
@@ -39,13 +42,13 @@ extern STRING qSrerbln, qSrernwt, qSrerilv, qSrerwlv, qSunsupunix, qSunsupuniv;
  *********************************************/
 
 /* alphabetical */
-static BOOLEAN buffer_to_line(STRING p, INT *plev, STRING *pxref
-	, STRING *ptag, STRING *pval, STRING *pmsg);
+static BOOLEAN buffer_to_line(STRING p, INT lineno, INT *plev, STRING *pxref
+	, STRING *ptag, STRING *pval, STRING *pmsg, STRING msgbuf);
 static NODE do_first_fp_to_node(FILE *fp, BOOLEAN list, XLAT tt
 	, STRING *pmsg, BOOLEAN *peof);
 static void prefix_file(FILE *fp, XLAT tt);
-static BOOLEAN string_to_line(STRING *ps, INT *plev, STRING *pxref, 
-	STRING *ptag, STRING *pval, STRING *pmsg);
+static BOOLEAN string_to_line(STRING *ps, INT lineno, INT *plev, STRING *pxref, 
+	STRING *ptag, STRING *pval, STRING *pmsg, STRING msgbuf);
 static STRING swrite_node(INT levl, NODE node, STRING p);
 static STRING swrite_nodes(INT levl, NODE node, STRING p);
 static BOOLEAN should_write_bom(void);
@@ -73,6 +76,7 @@ file_to_line (FILE *fp,
 {
 	static char in[MAXLINELEN+2];
 	static char out[MAXLINELEN+2];
+	static char scratch[LINEMSGLEN];
 	char *p = in;
 	*pmsg = NULL;
 	while (TRUE) {
@@ -85,21 +89,23 @@ file_to_line (FILE *fp,
 		}
 		if (!allwhite(p)) break;
 	}
-	return buffer_to_line(p, plev, pxref, ptag, pval, pmsg);
+	return buffer_to_line(p, flineno, plev, pxref, ptag, pval, pmsg, scratch);
 }
 /*==============================================
  * string_to_line -- Get GEDCOM line from string
  *
  * STRING *ps:    [I/O] string ptr - advanced to next (& 0 inserted)
+ * INT lineno:    [IN]  line number, for messages
  * INT *plev:     [OUT] level ptr
  * STRING *pxref: [OUT] cross-ref ptr
  * STRING *ptag:  [OUT] tag ptr
  * STRING *pval:  [OUT] value ptr
  * STRING *pmsg:  [OUT] error msg ptr
+ * STRING msgbuf: [OUT] buffer of LINEMSGLEN for error msg
  *============================================*/
 static BOOLEAN
-string_to_line (STRING *ps, INT *plev, STRING *pxref, STRING *ptag
-	, STRING *pval, STRING *pmsg)
+string_to_line (STRING *ps, INT lineno, INT *plev, STRING *pxref, STRING *ptag
+	, STRING *pval, STRING *pmsg, STRING msgbuf)
 {
 	STRING s0, s;
 	*pmsg = NULL;
@@ -112,43 +118,44 @@ string_to_line (STRING *ps, INT *plev, STRING *pxref, STRING *ptag
 		*s = 0;
 		*ps = s + 1;
 	}
-	return buffer_to_line(s0, plev, pxref, ptag, pval, pmsg);
+	return buffer_to_line(s0, lineno, plev, pxref, ptag, pval, pmsg, msgbuf);
 }
 /*================================================================
  * buffer_to_line -- Get GEDCOM line from buffer with <= 1 newline
  *
  *  p:      [in]  buffer
+ *  lineno: [in]  line number, for messages
  *  plev:   [out] level number
  *  pxref:  [out] xref
  *  ptag:   [out] tag
  *  pval:   [out] value
- *  pmsg:   [out] error msg (in static buffer)
+ *  pmsg:   [out] error msg (in msgbuf)
+ *  msgbuf: [out] caller's buffer of LINEMSGLEN chars
  *==============================================================*/
 static BOOLEAN
-buffer_to_line (STRING p, INT *plev, STRING *pxref
-	, STRING *ptag, STRING *pval, STRING *pmsg)
+buffer_to_line (STRING p, INT lineno, INT *plev, STRING *pxref
+	, STRING *ptag, STRING *pval, STRING *pmsg, STRING msgbuf)
 {
 	INT lev;
-	static char scratch[MAXLINELEN+40];
 
 	*pmsg = *pxref = *pval = 0;
 	if (!p || *p == 0) {
-		snprintf(scratch, sizeof(scratch), _(qSreremp), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSreremp), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	striptrail(p);
 	if (strlen(p) > MAXLINELEN) {
-		snprintf(scratch, sizeof(scratch), _(qSrerlng), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrerlng), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 
 /* Get level number */
 	skipws(&p);
 	if (chartype((uchar)*p) != DIGIT) {
-		snprintf(scratch, sizeof(scratch), _(qSrernlv), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrernlv), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	lev = (uchar)*p++ - (uchar)'0';
@@ -159,27 +166,27 @@ buffer_to_line (STRING p, INT *plev, STRING *pxref
 /* Get cross reference, if there */
 	skipws(&p);
 	if (*p == 0) {
-		snprintf(scratch, sizeof(scratch), _(qSrerinc), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrerinc), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	if (*p != '@') goto gettag;
 	*pxref = p++;
 	if (*p == '@') {
-		snprintf(scratch, sizeof(scratch), _(qSrerbln), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrerbln), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	while (*p != '@') p++;
 	p++;
 	if (*p == 0) {
-		snprintf(scratch, sizeof(scratch), _(qSrerinc), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrerinc), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	if (!iswhite((uchar)*p)) {
-		snprintf(scratch, sizeof(scratch), _(qSrernwt), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrernwt), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	*p++ = 0;
@@ -188,8 +195,8 @@ buffer_to_line (STRING p, INT *plev, STRING *pxref
 gettag:
 	skipws(&p);
 	if (*p == 0) {
-		snprintf(scratch, sizeof(scratch), _(qSrerinc), flineno);
-		*pmsg = scratch;
+		snprintf(msgbuf, LINEMSGLEN, _(qSrerinc), lineno);
+		*pmsg = msgbuf;
 		return ERROR;
 	}
 	*ptag = p++;
@@ -472,12 +479,13 @@ string_to_node (STRING str)
 	INT curlev;
 	NODE root=NULL, node, curnode;
 	STRING msg;
-	flineno = 0;
-	if (!string_to_line(&str, &lev, &xref, &tag, &val, &msg))
+	char msgbuf[LINEMSGLEN];
+	INT lineno = 1;
+	if (!string_to_line(&str, lineno, &lev, &xref, &tag, &val, &msg, msgbuf))
 		goto string_to_node_fail;
 	lev0 = curlev = lev;
 	root = curnode = create_node(xref, tag, val, NULL);
-	while (string_to_line(&str, &lev, &xref, &tag, &val, &msg)) {
+	while (string_to_line(&str, ++lineno, &lev, &xref, &tag, &val, &msg, msgbuf)) {
 		if (lev == curlev) {
 			node = create_node(xref, tag, val, nparent(curnode));
 			nsibling(curnode) = node;
@@ -490,7 +498,7 @@ string_to_node (STRING str)
 		} else if (lev < curlev) {
 			if (lev < lev0) {
 				llwprintf("Error: line " FMT_INT ": illegal level",
-				    flineno);
+				    lineno);
 				goto string_to_node_fail;
 			}
 			while (lev < curlev) {
@@ -501,7 +509,7 @@ string_to_node (STRING str)
 			nsibling(curnode) = node;
 			curnode = node;
 		} else {
-			llwprintf("Error: line " FMT_INT ": illegal level", flineno);
+			llwprintf("Error: line " FMT_INT ": illegal level", lineno);
 			goto string_to_node_fail;
 		}
 	}
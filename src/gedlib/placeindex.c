@@ -0,0 +1,631 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * placeindex.c -- Place dictionary & hierarchy, with persistent index
+ *  Each distinct place is interned once, as its own name plus the
+ *  place it lies in, so "Bristol, Gloucestershire, England" is
+ *  three places, each the parent of the one before. Every level 1
+ *  event of a person or family with a PLAC line below it is
+ *  indexed under its place and all that place's parents, so all
+ *  events in a county are one range of the (sorted) index.
+ *  As with famgraph, an index file ("placeindex" in the database
+ *  directory, see idxfile.c) is mapped into memory when the
+ *  database is opened, records stored since are parsed from
+ *  their raw bytes, and the file is rewritten when a writable
+ *  database is closed.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "gedcom.h"
+#include "zstr.h"
+#include "idxfile.h"
+#include "placeindex.h"
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* one interned place */
+struct tag_piplace {
+	INT32 parent;        /* place it lies in, or -1 */
+	INT32 name;          /* offset of its name in name pool */
+};
+
+/*
+ One event (an entry of IDXENTRY_WORDS), under one of the places
+ it lies in. The record is its key number times two, plus one for
+ a family. The tag is packed (see idxfile_pack_tag).
+*/
+struct tag_pientry {
+	INT32 place;         /* place (or parent place) indexed under */
+	INT32 rec;
+	INT32 tag;
+	INT32 leaf;          /* event's own place */
+};
+#define PIE_REC 1
+
+/*
+ Index file, as an array of native INT32:
+   header (PIH_SIZE words, the common ones first)
+   places (header[PIH_PLACES] pairs of parent & name offset)
+   name pool (header[PIH_POOL] words of NUL terminated names)
+   entries (header[PIH_COUNT] of them), sorted by place, rec, tag & leaf
+ A place's parent always precedes it.
+*/
+enum { PIH_PLACES = IXH_COMMON, PIH_POOL, PIH_COUNT, PIH_SIZE };
+#define PI_MAGIC   0x49504c4c /* "LLPI" */
+#define PI_VERSION 2
+
+/* most levels of place kept (deeper ones are dropped) */
+#define PI_MAXLEVELS 16
+
+/* split place (query or PLAC value) */
+struct tag_piparts {
+	INT count;
+	CNSTRING part[PI_MAXLEVELS];  /* most specific first */
+	INT len[PI_MAXLEVELS];
+};
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static int cmp_entries(const void * el1, const void * el2);
+static void find_places(CNSTRING place, BITSET found);
+static void free_places(void);
+static void grow_hash(void);
+static unsigned long hash_place(INT32 parent, CNSTRING name, INT len);
+static INT32 intern_place(INT32 parent, CNSTRING name, INT len);
+static BOOLEAN load_index(void);
+static BOOLEAN name_matches(CNSTRING name, CNSTRING part, INT len);
+static void parse_places(INT32 rec, CNSTRING raw, INT len, struct tag_idxlist * list);
+static BOOLEAN place_matches(INT32 place, struct tag_piparts * parts);
+static BOOLEAN report_entry(const struct tag_pientry * pie, PLACEINDEX_FUNC func, void * param);
+static void split_place(CNSTRING place, CNSTRING end, struct tag_piparts * parts);
+static BOOLEAN write_index(FILE * fp, INT32 * header);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+/* place dictionary (copied from file, so it can grow) */
+static struct tag_piplace * piplaces = 0;
+static INT32 piplacecount = 0;
+static INT32 piplacemax = 0;
+static char * pipool = 0;
+static INT32 pipoolsize = 0;
+static INT32 pipoolmax = 0;
+static INT32 * pihash = 0;          /* open addressed, place+1 (0 empty) */
+static INT32 pihashsize = 0;        /* power of 2 */
+/* entries (loaded with the dictionary) */
+static struct tag_idxentries piindex = {
+	{ "placeindex", PI_MAGIC, PI_VERSION, PIH_SIZE, 0, 0, 0, FALSE, FALSE, FALSE }
+	, PIE_REC, parse_places, cmp_entries
+	, 0, 0, FALSE, FALSE, 0, { 0, 0, 0 }
+};
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * name_matches -- Compare place name with part of a place
+ *  Case of ASCII letters is ignored
+ *===============================================*/
+static BOOLEAN
+name_matches (CNSTRING name, CNSTRING part, INT len)
+{
+	INT i;
+	for (i=0; i<len; ++i) {
+		if (!name[i] || ll_tolower((uchar)name[i]) != ll_tolower((uchar)part[i]))
+			return FALSE;
+	}
+	return !name[len];
+}
+/*=================================================
+ * hash_place -- Hash of place name within parent
+ *===============================================*/
+static unsigned long
+hash_place (INT32 parent, CNSTRING name, INT len)
+{
+	unsigned long h = 2166136261UL ^ (unsigned long)(parent + 1);
+	INT i;
+	for (i=0; i<len; ++i)
+		h = ((h ^ (uchar)ll_tolower((uchar)name[i])) * 16777619UL) & 0xffffffffUL;
+	return h;
+}
+/*=================================================
+ * grow_hash -- Double hash of places, and rehash them all
+ *===============================================*/
+static void
+grow_hash (void)
+{
+	INT32 i;
+	if (pihash)
+		stdfree(pihash);
+	pihashsize = pihashsize ? 2*pihashsize : 1024;
+	pihash = (INT32 *)stdalloc(pihashsize * sizeof(pihash[0]));
+	memset(pihash, 0, pihashsize * sizeof(pihash[0]));
+	for (i=0; i<piplacecount; ++i) {
+		CNSTRING name = pipool + piplaces[i].name;
+		unsigned long h = hash_place(piplaces[i].parent, name, strlen(name));
+		while (pihash[h & (pihashsize-1)])
+			++h;
+		pihash[h & (pihashsize-1)] = i + 1;
+	}
+}
+/*=================================================
+ * intern_place -- Find (or add) place of this name in parent
+ *  parent: [IN]  place it lies in, or -1
+ *  name:   [IN]  name (not NUL terminated)
+ *  len:    [IN]  length of name
+ * returns place number
+ *===============================================*/
+static INT32
+intern_place (INT32 parent, CNSTRING name, INT len)
+{
+	unsigned long h;
+	INT32 place;
+	struct tag_piplace * pip;
+	if (2 * (piplacecount + 1) > pihashsize)
+		grow_hash();
+	for (h = hash_place(parent, name, len); pihash[h & (pihashsize-1)]; ++h) {
+		place = pihash[h & (pihashsize-1)] - 1;
+		if (piplaces[place].parent == parent
+			&& name_matches(pipool + piplaces[place].name, name, len))
+			return place;
+	}
+	/* new place */
+	if (piplacecount == piplacemax) {
+		struct tag_piplace * old = piplaces;
+		piplacemax = piplacemax ? 2*piplacemax : 256;
+		piplaces = (struct tag_piplace *)stdalloc(piplacemax * sizeof(*pip));
+		if (old) {
+			memcpy(piplaces, old, piplacecount * sizeof(*pip));
+			stdfree(old);
+		}
+	}
+	if (pipoolsize + len + 1 > pipoolmax) {
+		char * old = pipool;
+		while (pipoolsize + len + 1 > pipoolmax)
+			pipoolmax = pipoolmax ? 2*pipoolmax : 4096;
+		pipool = (char *)stdalloc(pipoolmax);
+		if (old) {
+			memcpy(pipool, old, pipoolsize);
+			stdfree(old);
+		}
+	}
+	place = piplacecount++;
+	pip = &piplaces[place];
+	pip->parent = parent;
+	pip->name = pipoolsize;
+	memcpy(pipool + pipoolsize, name, len);
+	pipool[pipoolsize + len] = 0;
+	pipoolsize += len + 1;
+	pihash[h & (pihashsize-1)] = place + 1;
+	return place;
+}
+/*=================================================
+ * split_place -- Split place at commas, trimming blanks
+ *  Empty parts are skipped, as are parts beyond PI_MAXLEVELS
+ *  (counting from the most general).
+ *===============================================*/
+static void
+split_place (CNSTRING place, CNSTRING end, struct tag_piparts * parts)
+{
+	CNSTRING all[PI_MAXLEVELS*4];
+	INT lens[PI_MAXLEVELS*4];
+	INT n=0, i, skip;
+	CNSTRING p = place;
+	while (p < end && n < ARRSIZE(all)) {
+		CNSTRING comma = memchr(p, ',', end - p);
+		CNSTRING q, r;
+		if (!comma) comma = end;
+		for (q = p; q < comma && iswhite((uchar)*q); ++q)
+			;
+		for (r = comma; r > q && iswhite((uchar)r[-1]); --r)
+			;
+		if (r > q) {
+			all[n] = q;
+			lens[n++] = r - q;
+		}
+		p = comma + 1;
+	}
+	skip = (n > PI_MAXLEVELS) ? n - PI_MAXLEVELS : 0;
+	parts->count = n - skip;
+	for (i=0; i<parts->count; ++i) {
+		parts->part[i] = all[skip + i];
+		parts->len[i] = lens[skip + i];
+	}
+}
+/*=================================================
+ * parse_places -- Extract events with places from raw record text
+ *  Looks for a level 2 PLAC line under each level 1 line
+ *  (only the first PLAC of each event is used)
+ *===============================================*/
+static void
+parse_places (INT32 rec, CNSTRING raw, INT len, struct tag_idxlist * list)
+{
+	CNSTRING end = raw + len;
+	CNSTRING p = raw;
+	INT32 tag = 0;
+	struct tag_pientry pie;
+	while (p < end) {
+		CNSTRING eol = memchr(p, '\n', end - p);
+		CNSTRING val;
+		if (!eol) eol = end;
+		if (eol - p > 2 && p[0] == '1' && p[1] == ' ') {
+			for (val = p + 2; val < eol && *val != ' '; ++val)
+				;
+			tag = idxfile_pack_tag(p + 2, val - (p + 2));
+		} else if (tag && eol - p > 7 && !strncmp(p, "2 PLAC ", 7)) {
+			struct tag_piparts parts;
+			INT32 place = -1;
+			INT i;
+			split_place(p + 7, eol, &parts);
+			for (i=parts.count-1; i>=0; --i)
+				place = intern_place(place, parts.part[i], parts.len[i]);
+			/* under its own place, and each place that holds it */
+			pie.rec = rec;
+			pie.tag = tag;
+			pie.leaf = place;
+			for ( ; place >= 0; place = piplaces[place].parent) {
+				pie.place = place;
+				idxfile_add_entry(list, (const INT32 *)&pie);
+			}
+			tag = 0;
+		}
+		p = eol + 1;
+	}
+}
+/*=================================================
+ * cmp_entries -- Order entries by place, rec, tag & leaf
+ *===============================================*/
+static int
+cmp_entries (const void * el1, const void * el2)
+{
+	const struct tag_pientry * pie1 = (const struct tag_pientry *)el1;
+	const struct tag_pientry * pie2 = (const struct tag_pientry *)el2;
+	if (pie1->place != pie2->place)
+		return pie1->place < pie2->place ? -1 : 1;
+	if (pie1->rec != pie2->rec)
+		return pie1->rec < pie2->rec ? -1 : 1;
+	if (pie1->tag != pie2->tag)
+		return pie1->tag < pie2->tag ? -1 : 1;
+	if (pie1->leaf != pie2->leaf)
+		return pie1->leaf < pie2->leaf ? -1 : 1;
+	return 0;
+}
+/*=================================================
+ * placeindex_record_stored -- Note that a record was written
+ *  (or deleted) so queries follow the write at once
+ *  key: [IN]  key of record stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+void
+placeindex_record_stored (CNSTRING key, CNSTRING rec, INT len)
+{
+	idxfile_record_stored(&piindex, key, rec, len);
+}
+/*=================================================
+ * report_entry -- Pass one entry to caller's function
+ *===============================================*/
+static BOOLEAN
+report_entry (const struct tag_pientry * pie, PLACEINDEX_FUNC func, void * param)
+{
+	char ntype = (pie->rec & 1) ? 'F' : 'I';
+	return (*func)(ntype, pie->rec / 2, pie->leaf, param);
+}
+/*=================================================
+ * place_matches -- Is place named by parts (from its own
+ *  name upward) ? Places above the last part may be anything.
+ *===============================================*/
+static BOOLEAN
+place_matches (INT32 place, struct tag_piparts * parts)
+{
+	INT i;
+	for (i=0; i<parts->count; ++i) {
+		if (place < 0
+			|| !name_matches(pipool + piplaces[place].name, parts->part[i], parts->len[i]))
+			return FALSE;
+		place = piplaces[place].parent;
+	}
+	return TRUE;
+}
+/*=================================================
+ * find_places -- Find all places a query names
+ *  eg, "Bristol" or "Bristol, Gloucestershire" both match
+ *  the place of "Bristol, Gloucestershire, England"
+ *  found: [I/O] set of place numbers found
+ *===============================================*/
+static void
+find_places (CNSTRING place, BITSET found)
+{
+	struct tag_piparts parts;
+	INT32 i;
+	split_place(place, place + strlen(place), &parts);
+	if (!parts.count)
+		return;
+	for (i=0; i<piplacecount; ++i) {
+		if (place_matches(i, &parts))
+			bitset_set(found, i);
+	}
+}
+/*=================================================
+ * placeindex_find -- Find events at (or within) a place
+ *  place: [IN]  place, most specific part first, as in PLAC
+ *               values; need not go up to the country
+ *  tag:   [IN]  event tag (eg, "BIRT"), NULL or "" for any
+ *  func:  [IN]  called for each event at a place named, or
+ *               at any place within one
+ * An event is reported once for each place named that holds
+ * it. Events of records stored during this session come last.
+ *===============================================*/
+void
+placeindex_find (CNSTRING place, CNSTRING tag
+	, PLACEINDEX_FUNC func, void * param)
+{
+	const struct tag_pientry * entries;
+	const struct tag_pientry * newlist;
+	BITSET found;
+	INT32 ptag = 0, pl;
+	INT i, lo, hi;
+	if (tag && tag[0] && !(ptag = idxfile_pack_tag(tag, strlen(tag))))
+		return;
+	if (!place)
+		return;
+	if (!piindex.loaded)
+		idxfile_build_entries(&piindex);
+	entries = (const struct tag_pientry *)piindex.entries;
+	newlist = (const struct tag_pientry *)piindex.newlist.words;
+	found = create_bitset(piplacecount+1);
+	find_places(place, found);
+	for (pl=0; pl<piplacecount && BSCount(found); ++pl) {
+		if (!bitset_test(found, pl))
+			continue;
+		/* binary search for first entry of place */
+		lo = 0;
+		hi = piindex.count;
+		while (lo < hi) {
+			INT mid = (lo + hi) / 2;
+			if (entries[mid].place < pl)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		for (i=lo; i<piindex.count && entries[i].place == pl; ++i) {
+			const struct tag_pientry * pie = &entries[i];
+			if ((ptag && pie->tag != ptag)
+				|| idxfile_entry_changed(&piindex, (const INT32 *)pie))
+				continue;
+			if (!report_entry(pie, func, param))
+				goto done;
+		}
+	}
+	for (i=0; i<piindex.newlist.count; ++i) {
+		const struct tag_pientry * pie = &newlist[i];
+		if (!bitset_test(found, pie->place) || (ptag && pie->tag != ptag))
+			continue;
+		if (!report_entry(pie, func, param))
+			goto done;
+	}
+done:
+	destroy_bitset(found);
+}
+/*=================================================
+ * placeindex_subplaces -- Find places directly within a place
+ *  place: [IN]  place, as for placeindex_find ("" for
+ *               places not within any other)
+ *  func:  [IN]  called for each place found
+ * Places no longer used by any record may be included,
+ * until the index is next written.
+ *===============================================*/
+void
+placeindex_subplaces (CNSTRING place
+	, PLACEINDEX_PLACE_FUNC func, void * param)
+{
+	BITSET found;
+	INT32 pl, parent;
+	BOOLEAN top = !place || !place[0];
+	if (!piindex.loaded)
+		idxfile_build_entries(&piindex);
+	found = create_bitset(piplacecount+1);
+	if (!top)
+		find_places(place, found);
+	for (pl=0; pl<piplacecount; ++pl) {
+		parent = piplaces[pl].parent;
+		if (top ? parent >= 0 : (parent < 0 || !bitset_test(found, parent)))
+			continue;
+		if (!(*func)(pl, param))
+			break;
+	}
+	destroy_bitset(found);
+}
+/*=================================================
+ * placeindex_place_name -- Full name of a place
+ *  eg, "Bristol, Gloucestershire, England"
+ * returns new ZSTR
+ *===============================================*/
+ZSTR
+placeindex_place_name (INT32 place)
+{
+	ZSTR zstr = zs_new();
+	for ( ; place >= 0 && place < piplacecount; place = piplaces[place].parent) {
+		if (zs_len(zstr))
+			zs_apps(zstr, ", ");
+		zs_apps(zstr, pipool + piplaces[place].name);
+	}
+	return zstr;
+}
+/*=================================================
+ * placeindex_open -- Load index file of database just opened
+ *  Called after xrefs file is open
+ *===============================================*/
+void
+placeindex_open (void)
+{
+	if (piindex.file.path) return;
+	if (idxfile_open(&piindex.file) && !load_index())
+		idxfile_unload(&piindex.file);
+}
+/*=================================================
+ * load_index -- Check rest of index file (after common header)
+ *  Copies the place dictionary, so it can grow
+ *  returns FALSE if damaged
+ *===============================================*/
+static BOOLEAN
+load_index (void)
+{
+	INT32 * base = piindex.file.base;
+	INT32 nplaces, poolwords, count, i;
+	const INT32 * places;
+	const char * pool;
+	nplaces = base[PIH_PLACES];
+	poolwords = base[PIH_POOL];
+	count = base[PIH_COUNT];
+	if (nplaces < 0 || poolwords < 0 || count < 0
+		|| (INT)PIH_SIZE + 2*(INT)nplaces + poolwords + (INT)count * IDXENTRY_WORDS
+			!= piindex.file.words)
+		return FALSE;
+	places = base + PIH_SIZE;
+	pool = (const char *)(places + 2*nplaces);
+	/* check dictionary before trusting it */
+	if (poolwords && pool[poolwords * sizeof(INT32) - 1])
+		return FALSE;
+	for (i=0; i<nplaces; ++i) {
+		if (places[2*i] < -1 || places[2*i] >= i || places[2*i+1] < 0
+			|| places[2*i+1] >= poolwords * (INT32)sizeof(INT32))
+			return FALSE;
+	}
+	piplacemax = nplaces ? nplaces : 1;
+	piplaces = (struct tag_piplace *)stdalloc(piplacemax * sizeof(piplaces[0]));
+	for (i=0; i<nplaces; ++i) {
+		piplaces[i].parent = places[2*i];
+		piplaces[i].name = places[2*i+1];
+	}
+	piplacecount = nplaces;
+	pipoolmax = poolwords * sizeof(INT32) + 1;
+	pipool = (char *)stdalloc(pipoolmax);
+	memcpy(pipool, pool, poolwords * sizeof(INT32));
+	pipoolsize = poolwords * sizeof(INT32);
+	grow_hash();
+	while (2 * piplacecount > pihashsize)
+		grow_hash();
+	piindex.entries = (const INT32 *)(pool + poolwords * sizeof(INT32));
+	piindex.count = count;
+	piindex.loaded = TRUE;
+	return TRUE;
+}
+/*=================================================
+ * free_places -- Free the place dictionary
+ *===============================================*/
+static void
+free_places (void)
+{
+	if (piplaces)
+		stdfree(piplaces);
+	if (pipool)
+		stdfree(pipool);
+	if (pihash)
+		stdfree(pihash);
+	piplaces = 0;
+	pipool = 0;
+	pihash = 0;
+	piplacecount = piplacemax = pipoolsize = pipoolmax = pihashsize = 0;
+}
+/*=================================================
+ * write_index -- Write dictionary & entries to a new index file
+ *  Places no longer used are dropped, and the rest renumbered
+ *  (in the same order, so parents still come first).
+ *===============================================*/
+static BOOLEAN
+write_index (FILE * fp, INT32 * header)
+{
+	struct tag_idxlist all;
+	struct tag_pientry * list;
+	INT32 * newnum = 0, * places = 0;
+	char * pool = 0;
+	INT32 nplaces = 0, poolsize = 0, poolwords, pl;
+	BOOLEAN ok;
+	INT i;
+
+	idxfile_merge_entries(&piindex, &all);
+	list = (struct tag_pientry *)all.words;
+	/* every place used holds an entry of its own */
+	newnum = (INT32 *)stdalloc((piplacecount + 1) * sizeof(INT32));
+	for (pl=0; pl<piplacecount; ++pl)
+		newnum[pl] = -1;
+	for (i=0; i<all.count; ++i)
+		newnum[list[i].place] = 0;
+	places = (INT32 *)stdalloc((2 * piplacecount + 1) * sizeof(INT32));
+	pool = (char *)stdalloc(pipoolsize + sizeof(INT32));
+	for (pl=0; pl<piplacecount; ++pl) {
+		CNSTRING name = pipool + piplaces[pl].name;
+		INT32 parent = piplaces[pl].parent;
+		if (newnum[pl] < 0)
+			continue;
+		newnum[pl] = nplaces;
+		places[2*nplaces] = (parent < 0) ? -1 : newnum[parent];
+		places[2*nplaces+1] = poolsize;
+		strcpy(pool + poolsize, name);
+		poolsize += strlen(name) + 1;
+		++nplaces;
+	}
+	poolwords = (poolsize + sizeof(INT32) - 1) / sizeof(INT32);
+	memset(pool + poolsize, 0, poolwords * sizeof(INT32) - poolsize);
+	for (i=0; i<all.count; ++i) {
+		list[i].place = newnum[list[i].place];
+		list[i].leaf = newnum[list[i].leaf];
+	}
+	/* renumbering keeps places in order, so entries stay sorted */
+	header[PIH_PLACES] = nplaces;
+	header[PIH_POOL] = poolwords;
+	header[PIH_COUNT] = all.count;
+	ok = fwrite(header, sizeof(INT32), PIH_SIZE, fp) == PIH_SIZE
+		&& fwrite(places, sizeof(INT32), 2*nplaces, fp) == (size_t)(2*nplaces)
+		&& fwrite(pool, sizeof(INT32), poolwords, fp) == (size_t)poolwords
+		&& fwrite(list, sizeof(list[0]), all.count, fp) == (size_t)all.count;
+	stdfree(newnum);
+	stdfree(places);
+	stdfree(pool);
+	if (all.words)
+		stdfree(all.words);
+	return ok;
+}
+/*=================================================
+ * placeindex_close -- Free dictionary & all entries
+ *  Called when database is closed (before xrefs file)
+ *  Writes a fresh index file if database was changed
+ *  or had none.
+ *===============================================*/
+void
+placeindex_close (void)
+{
+	BOOLEAN replace = idxfile_write(&piindex.file, write_index);
+	idxfile_free_entries(&piindex);
+	free_places();
+	idxfile_close(&piindex.file, replace);
+}
@@ -0,0 +1,428 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * rawscan.c -- Scan raw records of database for tag values
+ *  Records are streamed a leaf block at a time straight from
+ *  the btree, and their GEDCOM lines parsed in place, so a
+ *  scan neither builds NODE trees nor touches the record cache.
+ *  Patterns are fpattern patterns, compiled with a literal
+ *  (the longest run of plain ASCII characters every match must
+ *  contain), which is searched for first in each whole record.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "btree.h"
+#include "gedcom.h"
+#include "fpattern.h"
+#include "rawscan.h"
+
+extern BTREE BTR;
+
+/*********************************************
+ * local types
+ *********************************************/
+
+struct tag_scanpattern {
+	STRING pattern;
+	INT litlen;          /* 0 if no literal prefilter */
+	uchar literal[64];   /* lowercase */
+	INT skip[256];       /* Horspool shift table */
+};
+
+/* deepest tag path handled, starting at level 0 */
+#define MAXTAGPATH 16
+
+typedef struct {
+	INT npath;
+	char path[MAXTAGPATH][32]; /* tags, "*" matching any */
+} TAGPATH;
+
+typedef struct {
+	CNSTRING rtypes;
+	TAGPATH tagpath;
+	BOOLEAN conts;
+	SCANPATTERN scanpat;
+	RAWSCAN_FUNC func;
+	void * param;
+	RKEY * wanted;       /* sorted keys of records, if a subset of types */
+	INT nwanted;
+	STRING vbuf;         /* scratch copy of a value */
+	INT vbufsize;
+} RAWSCAN;
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+static int cmp_rkeys(const void * el1, const void * el2);
+static BOOLEAN find_literal(SCANPATTERN scanpat, CNSTRING text, INT len);
+static INT fold(INT c);
+static void load_wanted(RAWSCAN * scan);
+static void parse_tagpath(CNSTRING tagpath, TAGPATH * tp);
+static BOOLEAN rawscan_record(RKEY rkey, STRING data, INT len, void * param);
+static BOOLEAN value_differs(CNSTRING val, INT len, void * param);
+static BOOLEAN walk_record(const TAGPATH * tp, BOOLEAN conts, CNSTRING data, INT len
+	, RAWSCAN_VALUE_FUNC visit, void * param);
+
+/*********************************************
+ * local function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * create_scan_pattern -- Compile fpattern pattern
+ *  returns NULL if pattern is invalid
+ *===============================================*/
+SCANPATTERN
+create_scan_pattern (CNSTRING pattern)
+{
+	SCANPATTERN scanpat;
+	CNSTRING p, run=0;
+	INT runlen=0, i;
+	if (!pattern || !fpattern_isvalid(pattern))
+		return NULL;
+	scanpat = (SCANPATTERN)stdalloc(sizeof(*scanpat));
+	memset(scanpat, 0, sizeof(*scanpat));
+	scanpat->pattern = strsave(pattern);
+	/* negation may come anywhere, and sets could hold anything */
+	if (strchr(pattern, FPAT_NOT))
+		return scanpat;
+	for (p = pattern; *p && *p != FPAT_SET_L; ++p) {
+		uchar c = (uchar)*p;
+		if (c >= 0x80 || c == FPAT_ANY || c == FPAT_CLOS || c == FPAT_CLOSP
+			|| c == FPAT_DEL || c == FPAT_DEL2 || c == FPAT_QUOTE2) {
+			runlen = 0;
+			/* do not try to second guess quoted characters */
+			if ((c == FPAT_QUOTE || c == FPAT_QUOTE2) && p[1])
+				++p;
+			continue;
+		}
+		if (!runlen++)
+			run = p;
+		if (runlen > scanpat->litlen && runlen <= (INT)sizeof(scanpat->literal)) {
+			scanpat->litlen = runlen;
+			for (i = 0; i < runlen; ++i)
+				scanpat->literal[i] = (uchar)fold((uchar)run[i]);
+		}
+	}
+	for (i = 0; i < 256; ++i)
+		scanpat->skip[i] = scanpat->litlen;
+	for (i = 0; i < scanpat->litlen - 1; ++i)
+		scanpat->skip[scanpat->literal[i]] = scanpat->litlen - 1 - i;
+	return scanpat;
+}
+/*=================================================
+ * destroy_scan_pattern -- Free compiled pattern
+ *===============================================*/
+void
+destroy_scan_pattern (SCANPATTERN scanpat)
+{
+	if (!scanpat) return;
+	strfree(&scanpat->pattern);
+	stdfree(scanpat);
+}
+/*=================================================
+ * scan_pattern_match -- Does whole text match pattern ?
+ *===============================================*/
+BOOLEAN
+scan_pattern_match (SCANPATTERN scanpat, CNSTRING text)
+{
+	if (!text)
+		return FALSE;
+	if (!find_literal(scanpat, text, strlen(text)))
+		return FALSE;
+	return fpattern_matchn(scanpat->pattern, text);
+}
+/*=================================================
+ * fold -- Lowercase ASCII letter
+ *  (other characters are never part of a literal)
+ *===============================================*/
+static INT
+fold (INT c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + 'a' - 'A' : c;
+}
+/*=================================================
+ * find_literal -- Does text contain literal of pattern ?
+ *  (Horspool search, ignoring ASCII case)
+ *===============================================*/
+static BOOLEAN
+find_literal (SCANPATTERN scanpat, CNSTRING text, INT len)
+{
+	INT m = scanpat->litlen, i, j;
+	const uchar * lit = scanpat->literal;
+	const uchar * t = (const uchar *)text;
+	if (!m)
+		return TRUE;
+	for (i = 0; i + m <= len; i += scanpat->skip[fold(t[i + m - 1])]) {
+		for (j = m - 1; j >= 0 && fold(t[i + j]) == lit[j]; --j)
+			;
+		if (j < 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+/*=================================================
+ * rawscan_tagpath_isvalid -- Check tag path syntax
+ *  eg, "SOUR.TITL" or "*.NOTE"
+ *===============================================*/
+BOOLEAN
+rawscan_tagpath_isvalid (CNSTRING tagpath)
+{
+	INT n=1, len=0;
+	if (!tagpath || !tagpath[0])
+		return FALSE;
+	for ( ; *tagpath; ++tagpath) {
+		if (*tagpath == '.') {
+			if (!len || ++n > MAXTAGPATH)
+				return FALSE;
+			len = 0;
+		} else if (iswhite((uchar)*tagpath) || ++len > 31) {
+			return FALSE;
+		}
+	}
+	return len > 0;
+}
+/*=================================================
+ * rawscan_records -- Find records with value matching pattern
+ *  rtypes:  [IN]  record types to scan (eg, "S"), NULL for all
+ *  tagpath: [IN]  tags from level 0 down, separated by dots,
+ *                  "*" matching any tag (eg, "SOUR.TITL", "*.NOTE")
+ *  conts:   [IN]  also match CONC & CONT lines below tag path ?
+ *  scanpat: [IN]  pattern each line value must match
+ *  func:    [IN]  called once for each matching record
+ * Record cache is neither consulted nor filled.
+ *===============================================*/
+void
+rawscan_records (CNSTRING rtypes, CNSTRING tagpath, BOOLEAN conts
+	, SCANPATTERN scanpat, RAWSCAN_FUNC func, void * param)
+{
+	RAWSCAN scan;
+	RKEY lo, hi;
+	ASSERT(rawscan_tagpath_isvalid(tagpath));
+	memset(&scan, 0, sizeof(scan));
+	scan.rtypes = (rtypes && rtypes[0]) ? rtypes : "IFSEX";
+	parse_tagpath(tagpath, &scan.tagpath);
+	scan.conts = conts;
+	scan.scanpat = scanpat;
+	scan.func = func;
+	scan.param = param;
+	load_wanted(&scan);
+	if (scan.wanted) {
+		traverse_leaf_keys(BTR, scan.wanted, scan.nwanted, &rawscan_record, &scan);
+	} else {
+		lo.r_rkey[0] = hi.r_rkey[0] = 0;
+		traverse_leaf_records(BTR, lo, hi, NULL, &rawscan_record, &scan);
+	}
+	if (scan.wanted)
+		stdfree(scan.wanted);
+	if (scan.vbuf)
+		stdfree(scan.vbuf);
+}
+/*=================================================
+ * rawscan_values -- Pass each value on tag path of one
+ *  raw record to caller's function
+ *  tagpath: [IN]  as for rawscan_records
+ *  data:    [IN]  raw record (need not be NUL terminated)
+ *  func:    [IN]  called with each nonempty line value (not
+ *                 NUL terminated), trimmed; return FALSE to stop
+ *===============================================*/
+void
+rawscan_values (CNSTRING tagpath, CNSTRING data, INT len
+	, RAWSCAN_VALUE_FUNC func, void * param)
+{
+	TAGPATH tp;
+	ASSERT(rawscan_tagpath_isvalid(tagpath));
+	parse_tagpath(tagpath, &tp);
+	walk_record(&tp, FALSE, data, len, func, param);
+}
+/*=================================================
+ * parse_tagpath -- Split (valid) tag path into tags
+ *===============================================*/
+static void
+parse_tagpath (CNSTRING tagpath, TAGPATH * tp)
+{
+	CNSTRING p;
+	INT len=0;
+	tp->npath = 0;
+	for (p = tagpath; ; ++p) {
+		if (*p == '.' || !*p) {
+			tp->path[tp->npath++][len] = 0;
+			len = 0;
+			if (!*p) break;
+		} else {
+			tp->path[tp->npath][len++] = *p;
+		}
+	}
+}
+/*=================================================
+ * load_wanted -- Collect sorted keys of records, when
+ *  only some types are scanned, so only leaves holding
+ *  them need be read
+ *===============================================*/
+static void
+load_wanted (RAWSCAN * scan)
+{
+	CNSTRING t;
+	INT max=0;
+	if (strlen(scan->rtypes) >= 5)
+		return;
+	for (t = scan->rtypes; *t; ++t) {
+		INT i = 0;
+		if (!strchr("IFSEX", *t))
+			continue;
+		while ((i = xref_next(*t, i))) {
+			char key[MAXKEYWIDTH+1];
+			if (scan->nwanted == max) {
+				RKEY * old = scan->wanted;
+				max = max ? 2*max : 256;
+				scan->wanted = (RKEY *)stdalloc(max * sizeof(RKEY));
+				if (old) {
+					memcpy(scan->wanted, old, scan->nwanted * sizeof(RKEY));
+					stdfree(old);
+				}
+			}
+			snprintf(key, sizeof(key), "%c" FMT_INT, *t, i);
+			scan->wanted[scan->nwanted++] = str2rkey(key);
+		}
+	}
+	if (!scan->wanted)
+		scan->wanted = (RKEY *)stdalloc(sizeof(RKEY));
+	qsort(scan->wanted, scan->nwanted, sizeof(RKEY), cmp_rkeys);
+}
+/* see above */
+static int
+cmp_rkeys (const void * el1, const void * el2)
+{
+	return cmpkeys((const RKEY *)el1, (const RKEY *)el2);
+}
+/*=================================================
+ * rawscan_record -- Check one record of leaf
+ *===============================================*/
+static BOOLEAN
+rawscan_record (RKEY rkey, STRING data, INT len, void * param)
+{
+	RAWSCAN * scan = (RAWSCAN *)param;
+	char key[MAXKEYWIDTH+1];
+	CNSTRING p = rkey2str(rkey);
+	/* only records (not names, refns, or other btree entries) */
+	if (!strchr(scan->rtypes, p[0]) || !p[1])
+		return TRUE;
+	for (++p; *p; ++p) {
+		if (chartype((uchar)*p) != DIGIT)
+			return TRUE;
+	}
+	if (!data || !len || !strcmp(data, "DELE\n"))
+		return TRUE;
+	if (!find_literal(scan->scanpat, data, len))
+		return TRUE;
+	/* a value matched if the walk was stopped */
+	if (walk_record(&scan->tagpath, scan->conts, data, len, &value_differs, scan))
+		return TRUE;
+	strcpy(key, rkey2str(rkey));
+	return (*scan->func)(key, scan->param);
+}
+/*=================================================
+ * walk_record -- Parse GEDCOM lines of record
+ *  (as buffer_to_line does) visiting tag path values
+ *  conts: [IN]  also visit CONC & CONT lines below tag path ?
+ *  returns FALSE if visit stopped the walk
+ *===============================================*/
+static BOOLEAN
+walk_record (const TAGPATH * tp, BOOLEAN conts, CNSTRING data, INT len
+	, RAWSCAN_VALUE_FUNC visit, void * param)
+{
+	BOOLEAN onpath[MAXTAGPATH];
+	CNSTRING p = data, end = data + len;
+	INT contlevel = -1; /* level of last line on full tag path */
+	memset(onpath, 0, sizeof(onpath));
+	while (p < end) {
+		CNSTRING q = memchr(p, '\n', end - p), tag, val;
+		INT level=0, taglen;
+		if (!q) q = end;
+		while (p < q && iswhite((uchar)*p)) ++p;
+		if (p == q || chartype((uchar)*p) != DIGIT) {
+			p = q + 1;
+			continue;
+		}
+		while (p < q && chartype((uchar)*p) == DIGIT)
+			level = level*10 + (*p++ - '0');
+		while (p < q && iswhite((uchar)*p)) ++p;
+		if (p < q && *p == '@') {
+			for (++p; p < q && *p != '@'; ++p)
+				;
+			if (p < q) ++p;
+			while (p < q && iswhite((uchar)*p)) ++p;
+		}
+		for (tag = p; p < q && !iswhite((uchar)*p); ++p)
+			;
+		taglen = p - tag;
+		while (p < q && iswhite((uchar)*p)) ++p;
+		val = p;
+		p = q + 1;
+		while (q > val && iswhite((uchar)q[-1])) --q;
+
+		if (contlevel >= 0) {
+			if (level == contlevel + 1 && taglen == 4
+				&& (!strncmp(tag, "CONC", 4) || !strncmp(tag, "CONT", 4))) {
+				if (q > val && !(*visit)(val, q - val, param))
+					return FALSE;
+				continue;
+			}
+			contlevel = -1;
+		}
+		if (level >= tp->npath)
+			continue;
+		onpath[level] = (level == 0 || onpath[level-1])
+			&& ((tp->path[level][0] == '*' && !tp->path[level][1])
+			|| ((INT)strlen(tp->path[level]) == taglen
+			&& !strncmp(tp->path[level], tag, taglen)));
+		if (level == tp->npath - 1 && onpath[level]) {
+			if (q > val && !(*visit)(val, q - val, param))
+				return FALSE;
+			if (conts)
+				contlevel = level;
+		}
+	}
+	return TRUE;
+}
+/*=================================================
+ * value_differs -- Does (nonempty) line value fail to match ?
+ *  (walk_record callback, so walk stops at a match)
+ *===============================================*/
+static BOOLEAN
+value_differs (CNSTRING val, INT len, void * param)
+{
+	RAWSCAN * scan = (RAWSCAN *)param;
+	if (len + 1 > scan->vbufsize) {
+		if (scan->vbuf)
+			stdfree(scan->vbuf);
+		scan->vbufsize = len + 64;
+		scan->vbuf = (STRING)stdalloc(scan->vbufsize);
+	}
+	memcpy(scan->vbuf, val, len);
+	scan->vbuf[len] = 0;
+	return !fpattern_matchn(scan->scanpat->pattern, scan->vbuf);
+}
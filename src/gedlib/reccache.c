@@ -0,0 +1,395 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * reccache.c -- Raw record cache shared by read-only processes
+ *  When the SharedRecordCache option is set, processes that open
+ *  a database read-only map one file ("reccache" in the database
+ *  directory) and keep the raw bytes of every record they read
+ *  in it, so other such processes (eg, several llexec -r runs
+ *  at once) find those records without reading the btree.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "btree.h"
+#include "gedcom.h"
+#include "lloptions.h"
+#include "reccache.h"
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <errno.h>
+#define RECCACHE_MMAP
+#endif
+
+extern BTREE BTR;
+
+#ifdef RECCACHE_MMAP
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/*
+ Cache file:
+   header (RCH_SIZE native INT32)
+   slots (header[RCH_SLOTS] of them, a power of 2)
+   arena (header[RCH_ARENA] bytes of record data)
+ A slot is free while the last byte of its key is 0 (real keys
+ are padded on the left). Records are only ever added, by one
+ process at a time holding an fcntl lock on the file, and the key
+ of a slot is stored after its offset & length, so lookups take
+ no lock. Once the slots are 3/4 full or the arena is full,
+ nothing more is added.
+ Opening the database for writing removes the file, and the
+ header holds the modification time of the database directory
+ (which changes whenever a record is stored), so a cache from
+ before any change is discarded.
+*/
+enum { RCH_MAGIC, RCH_VERSION, RCH_SLOTS, RCH_ARENA, RCH_USED, RCH_COUNT
+	, RCH_STAMPLO, RCH_STAMPHI, RCH_SIZE };
+#define RC_MAGIC   0x53524c4c /* "LLRS" */
+#define RC_VERSION 1
+#define RC_MAXKBYTES (1024*1024)
+#define RC_MINSLOTS 1024
+
+struct tag_rcslot {
+	char key[RKEYLEN];
+	INT32 off;   /* offset of record in arena */
+	INT32 len;   /* length of record */
+};
+
+#if defined(__GNUC__)
+#define RC_BARRIER() __sync_synchronize()
+#else
+#define RC_BARRIER()
+#endif
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static BOOLEAN attach_cache(CNSTRING path, INT kbytes);
+static void detach_cache(void);
+static struct tag_rcslot * find_slot(const RKEY * rkey);
+static BOOLEAN get_stamp(INT32 * plo, INT32 * phi);
+static BOOLEAN init_cache(INT kbytes);
+static BOOLEAN lock_cache(BOOLEAN lock);
+static BOOLEAN map_cache(void);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+static int rcfd = -1;            /* open cache file */
+static char * rcbase = 0;        /* mapped cache file */
+static size_t rcsize = 0;        /* size of rcbase */
+static INT32 * rchdr = 0;        /* header, in rcbase */
+static struct tag_rcslot * rcslots = 0;
+static char * rcarena = 0;
+static BOOLEAN rcfull = FALSE;   /* seen cache full, stop adding */
+
+#endif /* RECCACHE_MMAP */
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * reccache_open -- Attach shared cache of database just opened
+ *  A writable database discards any cache instead.
+ *===============================================*/
+void
+reccache_open (void)
+{
+#ifdef RECCACHE_MMAP
+	char path[MAXPATHLEN];
+	INT kbytes;
+	if (rcbase || !BTR) return;
+	snprintf(path, sizeof(path), "%s/reccache", BTR->b_basedir);
+	if (bwrite(BTR)) {
+		unlink(path);
+		return;
+	}
+	kbytes = getlloptint("SharedRecordCache", 0);
+	if (kbytes <= 0) return;
+	if (kbytes > RC_MAXKBYTES)
+		kbytes = RC_MAXKBYTES;
+	if (!attach_cache(path, kbytes))
+		detach_cache();
+#endif
+}
+/*=================================================
+ * reccache_close -- Detach shared cache
+ *  Called when database is closed
+ *===============================================*/
+void
+reccache_close (void)
+{
+#ifdef RECCACHE_MMAP
+	detach_cache();
+#endif
+}
+/*=================================================
+ * reccache_get -- Copy of record from shared cache
+ *  key:  [IN]  key of record (eg, "I543")
+ *  plen: [OUT] length of record returned
+ * returns stdalloc'd record, or NULL if not cached
+ *===============================================*/
+STRING
+reccache_get (CNSTRING key, INT *plen)
+{
+#ifdef RECCACHE_MMAP
+	RKEY rkey;
+	struct tag_rcslot * slot;
+	INT32 off, len;
+	STRING rec;
+	if (!rcbase) return NULL;
+	rkey = str2rkey(key);
+	if (!(slot = find_slot(&rkey)) || !slot->key[RKEYLEN-1])
+		return NULL;
+	off = slot->off;
+	len = slot->len;
+	if (off < 0 || len <= 0 || off > rchdr[RCH_ARENA] - len)
+		return NULL;
+	rec = (STRING)stdalloc(len + 1);
+	memcpy(rec, rcarena + off, len);
+	rec[len] = 0;
+	*plen = len;
+	return rec;
+#else
+	return NULL;
+#endif
+}
+/*=================================================
+ * reccache_put -- Add record just read from btree to shared cache
+ *  key:  [IN]  key of record (eg, "I543")
+ *  rec:  [IN]  raw record
+ *  len:  [IN]  length of rec
+ *===============================================*/
+void
+reccache_put (CNSTRING key, CNSTRING rec, INT len)
+{
+#ifdef RECCACHE_MMAP
+	RKEY rkey;
+	struct tag_rcslot * slot;
+	INT32 used;
+	if (!rcbase || rcfull || len <= 0) return;
+	rkey = str2rkey(key);
+	if (!lock_cache(TRUE)) return;
+	used = rchdr[RCH_USED];
+	slot = find_slot(&rkey);
+	if (slot && !slot->key[RKEYLEN-1]) {
+		if (rchdr[RCH_COUNT] >= rchdr[RCH_SLOTS] / 4 * 3
+			|| len > rchdr[RCH_ARENA] - used) {
+			rcfull = TRUE;
+		} else {
+			memcpy(rcarena + used, rec, len);
+			slot->off = used;
+			slot->len = len;
+			RC_BARRIER();
+			memcpy(slot->key, rkey.r_rkey, RKEYLEN);
+			rchdr[RCH_USED] = used + len;
+			++rchdr[RCH_COUNT];
+		}
+	}
+	lock_cache(FALSE);
+#endif
+}
+
+#ifdef RECCACHE_MMAP
+/*=================================================
+ * find_slot -- Find slot holding key, or free slot for it
+ *  returns NULL if table is full (without key)
+ *===============================================*/
+static struct tag_rcslot *
+find_slot (const RKEY * rkey)
+{
+	INT32 mask = rchdr[RCH_SLOTS] - 1;
+	INT32 i, n;
+	unsigned long hash = 2166136261UL;
+	for (i=0; i<RKEYLEN; ++i) {
+		hash ^= (uchar)rkey->r_rkey[i];
+		hash = (hash * 16777619UL) & 0xffffffffUL;
+	}
+	for (n=0, i=(INT32)(hash & mask); n<=mask; ++n, i=(i+1) & mask) {
+		struct tag_rcslot * slot = &rcslots[i];
+		if (!slot->key[RKEYLEN-1])
+			return slot;
+		if (!memcmp(slot->key, rkey->r_rkey, RKEYLEN)) {
+			RC_BARRIER();
+			return slot;
+		}
+	}
+	return NULL;
+}
+/*=================================================
+ * attach_cache -- Open (creating if need be) and map cache file
+ *  A cache file that is stale or damaged is replaced.
+ *===============================================*/
+static BOOLEAN
+attach_cache (CNSTRING path, INT kbytes)
+{
+	INT tries;
+	for (tries=0; tries<3; ++tries) {
+		struct stat fdbuf, pathbuf;
+		INT32 lo, hi;
+		if ((rcfd = open(path, O_RDWR|O_CREAT, 0666)) < 0)
+			return FALSE;
+		if (!lock_cache(TRUE))
+			return FALSE;
+		/* another process may have replaced the file before we locked it */
+		if (fstat(rcfd, &fdbuf) || stat(path, &pathbuf)
+			|| fdbuf.st_ino != pathbuf.st_ino) {
+			detach_cache();
+			continue;
+		}
+		if (fdbuf.st_size == 0) {
+			if (!init_cache(kbytes))
+				return FALSE;
+		} else {
+			rcsize = fdbuf.st_size;
+			if (!map_cache() || !get_stamp(&lo, &hi)
+				|| rchdr[RCH_STAMPLO] != lo || rchdr[RCH_STAMPHI] != hi) {
+				unlink(path);
+				detach_cache();
+				continue;
+			}
+		}
+		lock_cache(FALSE);
+		return TRUE;
+	}
+	return FALSE;
+}
+/*=================================================
+ * init_cache -- Size and map new (empty) cache file
+ *===============================================*/
+static BOOLEAN
+init_cache (INT kbytes)
+{
+	INT32 arena = kbytes * 1024;
+	INT32 slots = RC_MINSLOTS;
+	while (slots < arena / 64)
+		slots *= 2;
+	rcsize = RCH_SIZE * sizeof(INT32) + slots * sizeof(struct tag_rcslot) + arena;
+	if (ftruncate(rcfd, rcsize))
+		return FALSE;
+	rcbase = (char *)mmap(NULL, rcsize, PROT_READ|PROT_WRITE, MAP_SHARED, rcfd, 0);
+	if (rcbase == MAP_FAILED) {
+		rcbase = 0;
+		return FALSE;
+	}
+	rchdr = (INT32 *)rcbase;
+	rchdr[RCH_VERSION] = RC_VERSION;
+	rchdr[RCH_SLOTS] = slots;
+	rchdr[RCH_ARENA] = arena;
+	rchdr[RCH_USED] = 0;
+	rchdr[RCH_COUNT] = 0;
+	if (!get_stamp(&rchdr[RCH_STAMPLO], &rchdr[RCH_STAMPHI]))
+		return FALSE;
+	rchdr[RCH_MAGIC] = RC_MAGIC;
+	return map_cache();
+}
+/*=================================================
+ * map_cache -- Map cache file of size rcsize, and check its header
+ *===============================================*/
+static BOOLEAN
+map_cache (void)
+{
+	size_t slotbytes;
+	if (!rcbase) {
+		if (rcsize < RCH_SIZE * sizeof(INT32))
+			return FALSE;
+		rcbase = (char *)mmap(NULL, rcsize, PROT_READ|PROT_WRITE, MAP_SHARED, rcfd, 0);
+		if (rcbase == MAP_FAILED) {
+			rcbase = 0;
+			return FALSE;
+		}
+		rchdr = (INT32 *)rcbase;
+	}
+	if (rchdr[RCH_MAGIC] != RC_MAGIC || rchdr[RCH_VERSION] != RC_VERSION
+		|| rchdr[RCH_SLOTS] < 1 || (rchdr[RCH_SLOTS] & (rchdr[RCH_SLOTS]-1))
+		|| rchdr[RCH_ARENA] < 0 || rchdr[RCH_USED] < 0
+		|| rchdr[RCH_USED] > rchdr[RCH_ARENA])
+		return FALSE;
+	slotbytes = rchdr[RCH_SLOTS] * sizeof(struct tag_rcslot);
+	if (rcsize != RCH_SIZE * sizeof(INT32) + slotbytes + rchdr[RCH_ARENA])
+		return FALSE;
+	rcslots = (struct tag_rcslot *)(rcbase + RCH_SIZE * sizeof(INT32));
+	rcarena = rcbase + RCH_SIZE * sizeof(INT32) + slotbytes;
+	return TRUE;
+}
+/*=================================================
+ * detach_cache -- Unmap and close cache file
+ *===============================================*/
+static void
+detach_cache (void)
+{
+	if (rcbase)
+		munmap(rcbase, rcsize);
+	if (rcfd >= 0)
+		close(rcfd);
+	rcfd = -1;
+	rcbase = 0;
+	rcsize = 0;
+	rchdr = 0;
+	rcslots = 0;
+	rcarena = 0;
+	rcfull = FALSE;
+}
+/*=================================================
+ * get_stamp -- Modification time of database directory
+ *===============================================*/
+static BOOLEAN
+get_stamp (INT32 * plo, INT32 * phi)
+{
+	struct stat sbuf;
+	if (stat(BTR->b_basedir, &sbuf))
+		return FALSE;
+	*plo = (INT32)(sbuf.st_mtime & 0xffffffff);
+	*phi = (INT32)((sbuf.st_mtime >> 16) >> 16);
+	return TRUE;
+}
+/*=================================================
+ * lock_cache -- Take or release exclusive lock on cache file
+ *  Waits for other processes to release it.
+ *===============================================*/
+static BOOLEAN
+lock_cache (BOOLEAN lock)
+{
+	struct flock fl;
+	memset(&fl, 0, sizeof(fl));
+	fl.l_type = lock ? F_WRLCK : F_UNLCK;
+	fl.l_whence = SEEK_SET;
+	fl.l_start = 0;
+	fl.l_len = 0;
+	while (fcntl(rcfd, F_SETLKW, &fl) == -1) {
+		if (errno != EINTR)
+			return FALSE;
+	}
+	return TRUE;
+}
+#endif /* RECCACHE_MMAP */
@@ -223,8 +223,7 @@ set_record_key_info (RECORD rec, CNSTRING key)
 	rec->rec_nkey.ntype = ntype;
 	if ((node = rec->rec_top) != 0) {
 		if (!nxref(node) || !eqstr(nxref(node), xref)) {
-			if (nxref(node)) stdfree(nxref(node));
-			nxref(node) = strsave(xref);
+			set_node_xref(node, xref);
 		}
 	}
 }
@@ -49,12 +49,19 @@ extern BTREE BTR;
  * local function prototypes
  *********************************************/
 
+struct tag_refnrec;
+static void allocrefnrec(struct tag_refnrec * rr);
 static void annotate_node(NODE node, BOOLEAN expand_refns, BOOLEAN annotate_pointers, RFMT rfmt);
+static void freerefnrec(struct tag_refnrec * rr);
+static BOOLEAN getrefnrec(struct tag_refnrec * rr, CNSTRING refn);
 static BOOLEAN is_annotated_xref(CNSTRING val, INT * len);
 static STRING symbolic_link(CNSTRING);
-static void parserefnrec(RKEY rkey, CNSTRING p);
+static void parserefnrec(struct tag_refnrec * rr, RKEY rkey, CNSTRING p);
+static void reallocrefnrec(struct tag_refnrec * rr);
 static RKEY refn2rkey(CNSTRING refn);
+static BOOLEAN rekey_refnrec(struct tag_refnrec * rr, TABLE keymap);
 static BOOLEAN resolve_node(NODE node, BOOLEAN annotate_pointers);
+static void storerefnrec(struct tag_refnrec * rr, INT extra);
 
 /*********************************************
  * local variables
@@ -75,43 +82,37 @@ static BOOLEAN resolve_node(NODE node, BOOLEAN annotate_pointers);
  *   nrefns STRING refns - char buffer where the refns are stored
  *			   based on char offsets
  *-------------------------------------------------------------------
- * internal format -- At any time there can be only one refn record
- *   stored internally; the data is stored in global data structures
+ * internal format -- A refn record read from the database is held
+ *   in a REFNREC; lookups use one of their own (on the stack), so
+ *   they share no state, and updates use the module's refnrec
  *-------------------------------------------------------------------
- *   RKEY    RRkey   - RKEY of the current refn record
- *   STRING  RRrec   - current refn record
- *   INT     RRsize  - size of current refn record
- *   INT32   RRmax   - max allocation size of internal arrays
- *   INT32   RRcount - number of entries in current refn record
- *   RKEY   *RRkeys  - RKEYs of the INDI records with the refn
- *   INT32  *RRoffs  - char offsets to refnl in current refn record
- *   CNSTRING *RRrefns - refn values from INDI records that the
+ *   RKEY    key     - RKEY of the refn record
+ *   STRING  rec     - raw refn record
+ *   INT     size    - size of raw refn record
+ *   INT32   max     - max allocation size of arrays below
+ *   INT32   count   - number of entries in refn record
+ *   RKEY   *keys    - RKEYs of the INDI records with the refn
+ *   INT32  *offs    - char offsets to refns in raw refn record
+ *   CNSTRING *refns - refn values from INDI records that the
  *			  index is based upon
  *-------------------------------------------------------------------
- * When a refn record is used to match a search refn, the internal
- *   structures are modified to remove all entries that don't match
- *   the refn; in addition, other global data structures are used
- *-------------------------------------------------------------------
- *   STRING *RMkeys  - keys (strings) of all INDI records that match
- *   INT32   RMmax   - max allocation size of RMkeys array
- *   INT32   RMcount - number of entries in modified record arrays
+ * When a refn record is used to match a search refn, its arrays
+ *   are modified to remove all entries that don't match the refn
  *=================================================================*/
 
-/* Current refns record - raw */
-static RKEY    RRkey;
-static STRING  RRrec = NULL;
-static INT     RRsize;
-
-/* Current refns record - parsed */
-static INT32   RRmax = 0;
-static INT32   RRcount;
-static INT32  *RRoffs;
-static RKEY   *RRkeys;
-static CNSTRING *RRrefns;
+typedef struct tag_refnrec {
+	RKEY     key;
+	STRING   rec;
+	INT      size;
+	INT32    max;
+	INT32    count;
+	INT32   *offs;
+	RKEY    *keys;
+	CNSTRING *refns;
+} REFNREC;
 
-static STRING *RMkeys = NULL;
-static INT32   RMmax = 0;
-static INT32   RMcount = 0;
+/* Refn record being updated */
+static REFNREC refnrec;
 
 /*********************************************
  * local function definitions
@@ -119,149 +120,160 @@ static INT32   RMcount = 0;
  *********************************************/
 
 /*====================================================
- * allocrefnrec -- Allocate internal refn record
- *==================================================*/
-static void
-allocrefnrec(void)
-{
-	ASSERT(RRmax);
-        RRoffs = (INT32 *) stdalloc((RRmax)*sizeof(INT32));
-        RRkeys = (RKEY *) stdalloc((RRmax)*sizeof(RKEY));
-        RRrefns = (CNSTRING *) stdalloc((RRmax)*sizeof(CNSTRING));
-}
-
-/*====================================================
- * freerefnrec -- Free internal refn record
- *==================================================*/
-static void
-freerefnrec(void)
-{
-        stdfree(RRkeys);
-	RRkeys = NULL;
-        stdfree(RRoffs);
-	RRoffs = NULL;
-        stdfree((CNSTRING)RRrefns);
-	RRrefns = NULL;
-        RRmax = 0;
-}
-
-/*====================================================
- * reallocrefnrec -- Reallocate internal refn record
+ * allocrefnrec -- Allocate arrays of refn record
  *==================================================*/
 static void
-reallocrefnrec(void)
+allocrefnrec (REFNREC * rr)
 {
-        if (RRmax != 0) {
-                freerefnrec();
-        }
-        RRmax = RRcount + 10;
-        allocrefnrec();
+	ASSERT(rr->max);
+	rr->offs = (INT32 *) stdalloc((rr->max)*sizeof(INT32));
+	rr->keys = (RKEY *) stdalloc((rr->max)*sizeof(RKEY));
+	rr->refns = (CNSTRING *) stdalloc((rr->max)*sizeof(CNSTRING));
 }
 
 /*====================================================
- * allocrefnmrec -- Allocate internal refn match record
+ * freerefnrec -- Free refn record
  *==================================================*/
 static void
-allocrefnmrec(void)
+freerefnrec (REFNREC * rr)
 {
-	ASSERT(RRcount);
-	RMkeys = (STRING *) stdalloc(RRcount*sizeof(STRING));
-	RMcount = RRcount;
-	RMmax = RRcount;
-}
-
-/*====================================================
- * freerefnmrec -- Free internal refn match record
- *==================================================*/
-static void
-freerefnmrec(void)
-{
-	INT i;
-
-	for (i = 0; i < RMcount; i++)
-	{
-		stdfree(RMkeys[i]);
-		RMkeys[i] = NULL;
+	strfree(&rr->rec);
+	if (rr->max) {
+		stdfree(rr->keys);
+		stdfree(rr->offs);
+		stdfree((STRING)rr->refns);
 	}
-	stdfree(RMkeys);
-	RMkeys = NULL;
-	RMcount = 0;
-	RMmax = 0;
+	rr->keys = NULL;
+	rr->offs = NULL;
+	rr->refns = NULL;
+	rr->max = 0;
+	rr->count = 0;
 }
 
 /*====================================================
- * reallocrefnmrec -- Reallocate internal refn match record
+ * reallocrefnrec -- Reallocate arrays of refn record
  *==================================================*/
 static void
-reallocrefnmrec(void)
+reallocrefnrec (REFNREC * rr)
 {
-	freerefnmrec();
-	allocrefnmrec();
+	if (rr->max != 0) {
+		stdfree(rr->keys);
+		stdfree(rr->offs);
+		stdfree((STRING)rr->refns);
+	}
+	rr->max = rr->count + 10;
+	allocrefnrec(rr);
 }
 
 /*====================================================
- * parserefnrec -- Store refn rec in file buffers
+ * parserefnrec -- Parse raw refn record into arrays
+ *  p: [IN]  raw record (refns point into it)
  *==================================================*/
 static void
-parserefnrec (RKEY rkey, CNSTRING p)
+parserefnrec (REFNREC * rr, RKEY rkey, CNSTRING p)
 {
 	INT i;
 
-	ASSERT(RRcount < 1000000); /* 1000000 renfs in a given slot ? */
-
 	/* update refn record key */
-	RRkey = rkey;
+	rr->key = rkey;
 
 	/* copy record count */
-	memcpy (&RRcount, p, sizeof(RRcount));
-	p += sizeof(RRcount);
+	memcpy (&rr->count, p, sizeof(rr->count));
+	p += sizeof(rr->count);
+
+	ASSERT(rr->count < 1000000); /* 1000000 renfs in a given slot ? */
 
 	/* reallocate backing storage if needed */
-	if (RRcount >= RRmax - 1) {
-		reallocrefnrec();
+	if (rr->count >= rr->max - 1) {
+		reallocrefnrec(rr);
 	}
 
 	/* copy keys */
-	for (i = 0; i < RRcount; i++) {
-		memcpy(&RRkeys[i], p, sizeof(RRkeys[i]));
-		p += sizeof(RRkeys[i]);
+	for (i = 0; i < rr->count; i++) {
+		memcpy(&rr->keys[i], p, sizeof(rr->keys[i]));
+		p += sizeof(rr->keys[i]);
 	}
 
 	/* copy offsets */
-	for (i = 0; i < RRcount; i++) {
-		memcpy(&RRoffs[i], p, sizeof(RRoffs[i]));
-		p += sizeof(RRoffs[i]);
+	for (i = 0; i < rr->count; i++) {
+		memcpy(&rr->offs[i], p, sizeof(rr->offs[i]));
+		p += sizeof(rr->offs[i]);
 	}
 
 	/* copy refns */
-	for (i = 0; i < RRcount; i++)
-		RRrefns[i] = p + RRoffs[i];
+	for (i = 0; i < rr->count; i++)
+		rr->refns[i] = p + rr->offs[i];
 }
 /*====================================================
- * getrefnrec -- Read refn record and store in globals
+ * getrefnrec -- Read refn record and parse it
  *==================================================*/
-BOOLEAN
-getrefnrec (CNSTRING refn)
+static BOOLEAN
+getrefnrec (REFNREC * rr, CNSTRING refn)
 {
 	STRING p;
 /* Convert refn to key and read refn record */
-	RRkey = refn2rkey(refn);
-	if (RRrec) {
-		stdfree(RRrec);
-		RRrec = NULL;
-	}
-	p = RRrec = bt_getrecord(BTR, &RRkey, &RRsize);
-	if (!RRrec) {
-		RRcount = 0;
-		if (RRmax == 0) {
-			RRmax = 10;
-			allocrefnrec();
+	rr->key = refn2rkey(refn);
+	strfree(&rr->rec);
+	p = rr->rec = bt_getrecord(BTR, &rr->key, &rr->size);
+	if (!rr->rec) {
+		rr->count = 0;
+		if (rr->max == 0) {
+			rr->max = 10;
+			allocrefnrec(rr);
 		}
 		return FALSE;
 	}
-	parserefnrec(RRkey, p);
+	parserefnrec(rr, rr->key, p);
 	return TRUE;
 }
+/*====================================================
+ * storerefnrec -- Write refn record from its arrays
+ *  extra: [IN]  bytes needed beyond size of raw record
+ *==================================================*/
+static void
+storerefnrec (REFNREC * rr, INT extra)
+{
+	INT i, len;
+	INT32 off;
+	STRING rec, p;
+
+	/* allocate new record */
+	p = rec = (STRING) stdalloc(rr->size + extra);
+	len = off = 0;
+
+	/* copy record count */
+	memcpy(p, &rr->count, sizeof(rr->count));
+	p += sizeof(rr->count);
+	len += sizeof(rr->count);
+
+	/* copy keys */
+	for (i = 0; i < rr->count; i++) {
+		memcpy(p, &rr->keys[i], sizeof(rr->keys[i]));
+		p += sizeof(rr->keys[i]);
+		len += sizeof(rr->keys[i]);
+	}
+
+	/* recompute offsets */
+	ASSERT(sizeof(off) == sizeof(*rr->offs));
+	for (i = 0; i < rr->count; i++) {
+		memcpy(p, &off, sizeof(off));
+		p += sizeof(off);
+		len += sizeof(off);
+		off += strlen(rr->refns[i]) + 1;
+	}
+
+	/* copy refns */
+	for (i = 0; i < rr->count; i++) {
+		INT refnlen = strlen(rr->refns[i]) + 1;
+		memcpy(p, rr->refns[i], refnlen);
+		p += refnlen;
+		len += refnlen;
+	}
+
+	/* update record in btree, free record storage */
+	bt_addrecord(BTR, rr->key, rec, len);
+	stdfree(rec);
+}
 /*============================================
  * refn2rkey - Convert refn to refn record key
  *==========================================*/
@@ -311,66 +323,28 @@ refn_hi (void)
 BOOLEAN
 add_refn (CNSTRING refn, CNSTRING key)
 {
-	INT i, len, recsize;
-	INT32 off;
-	STRING rec, p;
+	INT i;
 	RKEY rkey;
 
 	/* load up local refn record buffers */
 	rkey = str2rkey(key);
-	(void) getrefnrec(refn);
+	(void) getrefnrec(&refnrec, refn);
 
 	/* check if refn already present in refn record */
-	for (i = 0; i < RRcount; i++) {
-		if (rkey_eq(&rkey, &RRkeys[i]) &&
-		    eqstr(refn, RRrefns[i]))
+	for (i = 0; i < refnrec.count; i++) {
+		if (rkey_eq(&rkey, &refnrec.keys[i]) &&
+		    eqstr(refn, refnrec.refns[i]))
 			return TRUE;
 	}
 
 	/* update directory */
-	RRkeys[RRcount] = rkey;
-	RRrefns[RRcount] = refn;
+	refnrec.keys[refnrec.count] = rkey;
+	refnrec.refns[refnrec.count] = refn;
 
 	/* increase record count */
-	RRcount++;
+	refnrec.count++;
 
-	/* allocate new record */
-	recsize = sizeof(RKEY) + sizeof(INT32) + strlen(refn) + 10;
-	p = rec = (STRING) stdalloc(RRsize + recsize);
-	len = off = 0;
-
-	/* copy record count */
-	memcpy(p, &RRcount, sizeof(RRcount));
-	p += sizeof(RRcount);
-	len += sizeof(RRcount);
-
-	/* copy keys */
-	for (i = 0; i < RRcount; i++) {
-		memcpy(p, &RRkeys[i], sizeof(RRkeys[i]));
-		p += sizeof(RRkeys[i]);
-		len += sizeof(RRkeys[i]);
-	}
-
-        /* recompute offsets */
-        ASSERT(sizeof(off) == sizeof(*RRoffs));
-	for (i = 0; i < RRcount; i++) {
-		memcpy(p, &off, sizeof(off));
-		p += sizeof(off);
-		len += sizeof(off);
-		off += strlen(RRrefns[i]) + 1;
-	}
-
-	/* copy refns */
-	for (i = 0; i < RRcount; i++) {
-		INT refnlen = strlen(RRrefns[i]) + 1;
-		memcpy(p, RRrefns[i], refnlen);
-		p += refnlen;
-		len += refnlen;
-	}
-
-	/* update record in btree, free record storage */
-	bt_addrecord(BTR, RRkey, rec, len);
-	stdfree(rec);
+	storerefnrec(&refnrec, sizeof(RKEY) + sizeof(INT32) + strlen(refn) + 10);
 
 	return TRUE;
 }
@@ -381,20 +355,18 @@ BOOLEAN
 remove_refn (CNSTRING refn,       /* record's refn */
              CNSTRING key)        /* record's GEDCOM key */
 {
-	STRING rec, p;
-	INT i, len;
-	INT32 off;
+	INT i;
 	BOOLEAN found = FALSE;
 	RKEY rkey;
 
 	/* load up local name record buffers */
 	rkey = str2rkey(key);
-	(void) getrefnrec(refn);
+	(void) getrefnrec(&refnrec, refn);
 
 	/* check if refn already present in refn record */
-	for (i = 0; i < RRcount; i++) {
-		if (rkey_eq(&rkey, &RRkeys[i]) &&
-		    eqstr(refn, RRrefns[i])) {
+	for (i = 0; i < refnrec.count; i++) {
+		if (rkey_eq(&rkey, &refnrec.keys[i]) &&
+		    eqstr(refn, refnrec.refns[i])) {
 			found = TRUE;
 			break;
 		}
@@ -402,55 +374,96 @@ remove_refn (CNSTRING refn,       /* record's refn */
 	if (!found) return FALSE;
 
 	/* update directory */
-	for ( ; i < RRcount-1; i++) {
-		RRkeys[i] = RRkeys[i+1];
-		RRrefns[i] = RRrefns[i+1];
+	for ( ; i < refnrec.count-1; i++) {
+		refnrec.keys[i] = refnrec.keys[i+1];
+		refnrec.refns[i] = refnrec.refns[i+1];
 	}
 
 	/* decrease record count */
-	RRcount--;
+	refnrec.count--;
 
-	/* allocate new record */
-	p = rec = (STRING) stdalloc(RRsize);
-	len = off = 0;
+	storerefnrec(&refnrec, 0);
 
-	/* copy record count */
-	memcpy(p, &RRcount, sizeof(RRcount));
-	p += sizeof(RRcount);
-	len += sizeof(RRcount);
-
-	/* copy keys */
-	for (i = 0; i < RRcount; i++) {
-		memcpy(p, &RRkeys[i], sizeof(RRkeys[i]));
-		p += sizeof(RRkeys[i]);
-		len += sizeof(RRkeys[i]);
+	return TRUE;
+}
+/*=============================================
+ * rekey_refns -- Move refn entries to other records
+ *  refns:  [IN]  refns whose entries may move
+ *  keymap: [IN]  old key -> new key
+ * Each refn record holding any of the refns is read
+ * and written once (see rekey_names)
+ *===========================================*/
+void
+rekey_refns (LIST refns, TABLE keymap)
+{
+	TABLE donetab = create_table_int();
+
+	FORLIST(refns, el)
+		CNSTRING refn = (CNSTRING)el;
+		RKEY rkey = refn2rkey(refn);
+		CNSTRING rkeystr = rkey2str(rkey);
+		if (!in_table(donetab, rkeystr)) {
+			insert_table_int(donetab, rkeystr, 1);
+			if (getrefnrec(&refnrec, refn) && rekey_refnrec(&refnrec, keymap))
+				storerefnrec(&refnrec, 0);
+		}
+	ENDLIST
+	destroy_table(donetab);
+}
+/*=============================================
+ * rekey_refnrec -- Move entries of refn record to new keys
+ *  keymap: [IN]  old key -> new key
+ * returns TRUE if record changed
+ *===========================================*/
+static BOOLEAN
+rekey_refnrec (REFNREC * rr, TABLE keymap)
+{
+	char rbuf[RKEYLEN+1];
+	INT * moved = 0;
+	char * gone = 0;
+	INT i, j, n=0;
+
+	for (i = 0; i < rr->count; i++) {
+		STRING newkey = valueof_str(keymap, rkey2str_r(rr->keys[i], rbuf));
+		if (!newkey) continue;
+		if (!moved) {
+			moved = (INT *)stdalloc(rr->count*sizeof(INT));
+			gone = (char *)stdalloc(rr->count);
+			memset(gone, 0, rr->count);
+		}
+		rr->keys[i] = str2rkey(newkey);
+		moved[n++] = i;
 	}
-
-        /* recompute offsets */
-        ASSERT(sizeof(off) == sizeof(*RRoffs));
-	for (i = 0; i < RRcount; i++) {
-		memcpy(p, &off, sizeof(off));
-		p += sizeof(off);
-		len += sizeof(off);
-		off += strlen(RRrefns[i]) + 1;
+	if (!n) return FALSE;
+
+	/* a moved entry may duplicate one already there */
+	while (n--) {
+		i = moved[n];
+		for (j = 0; j < rr->count; j++) {
+			if (j != i && !gone[j] && rkey_eq(&rr->keys[i], &rr->keys[j])
+				&& eqstr(rr->refns[i], rr->refns[j])) {
+				gone[i] = 1;
+				break;
+			}
+		}
 	}
-
-	/* copy refns */
-	for (i = 0; i < RRcount; i++) {
-		INT refnlen = strlen(RRrefns[i]) + 1;
-		memcpy(p, RRrefns[i], refnlen);
-		p += refnlen;
-		len += refnlen;
+	for (i = j = 0; i < rr->count; i++) {
+		if (gone[i]) continue;
+		rr->keys[j] = rr->keys[i];
+		rr->refns[j] = rr->refns[i];
+		j++;
 	}
-
-	/* update record in btree, free record storage */
-	bt_addrecord(BTR, RRkey, rec, len);
-	stdfree(rec);
-
+	rr->count = j;
+	stdfree(moved);
+	stdfree(gone);
 	return TRUE;
 }
 /*====================================================
  * get_refns -- Find all records who match refn or key
+ *  refn:  [IN]  refn to look up
+ *  pnum:  [OUT] number of records found
+ *  pkeys: [OUT] their keys (free with free_refns)
+ *  letr:  [IN]  type of record (0 if any)
  *==================================================*/
 void
 get_refns (STRING refn,
@@ -459,40 +472,48 @@ get_refns (STRING refn,
            INT letr)
 {
 	INT i, n;
+	REFNREC rr;
+	STRING *keys;
+	char rkeystr[RKEYLEN+1];
 
 	*pnum = 0;
+	*pkeys = NULL;
 	if (!refn) return;
 
-/* Clean up allocated memory from last call */
+/* Load refn record; return if no match */
 
-	freerefnmrec();
-
-/* Load static refn buffers; return if no match */
-
-	if (!getrefnrec(refn)) return;
+	memset(&rr, 0, sizeof(rr));
+	if (!getrefnrec(&rr, refn)) {
+		freerefnrec(&rr);
+		return;
+	}
 
-/* Compare user's refn with all refns in record; the refn
-      record data structures are modified */
+/* Compare user's refn with all refns in record */
 
 	n = 0;
-	for (i = 0; i < RRcount; i++) {
-		if (eqstr(refn, RRrefns[i])) {
-			if (letr == 0 || *(rkey2str(RRkeys[i])) == letr) {
-				if (i != n) {
-					RRrefns[n] = RRrefns[i];
-					RRkeys[n] = RRkeys[i];
-				}
-				n++;
-			}
+	keys = (STRING *) stdalloc((rr.count+1)*sizeof(STRING));
+	for (i = 0; i < rr.count; i++) {
+		if (eqstr(refn, rr.refns[i])) {
+			STRING key = rkey2str_r(rr.keys[i], rkeystr);
+			if (letr == 0 || *key == letr)
+				keys[n++] = strsave(key);
 		}
 	}
-	*pnum = RRcount = n;
-	if (RRcount > RMmax) {
-		reallocrefnmrec();
-	}
-	for (i = 0; i < RRcount; i++)
-		RMkeys[i] = strsave(rkey2str(RRkeys[i]));
-	*pkeys = RMkeys;
+	freerefnrec(&rr);
+	*pnum = n;
+	*pkeys = keys;
+}
+/*====================================================
+ * free_refns -- Free keys returned by get_refns
+ *==================================================*/
+void
+free_refns (INT num, STRING *keys)
+{
+	INT i;
+	if (!keys) return;
+	for (i = 0; i < num; i++)
+		stdfree(keys[i]);
+	stdfree(keys);
 }
 /*==========================================================
  * resolve_refn_links -- Resolve and check all links in node tree
@@ -539,8 +560,7 @@ resolve_node (NODE node, BOOLEAN annotate_pointers)
 		INT letr = record_letter(ntag(node));
 		NODE refr = refn_to_record(refn, letr);
 		if (refr) {
-			stdfree(nval(node));
-			nval(node) = strsave(nxref(refr));
+			set_node_val(node, nxref(refr));
 		} else {
 			return FALSE;
 		}
@@ -554,8 +574,7 @@ resolve_node (NODE node, BOOLEAN annotate_pointers)
 				newval[i] = nval(node)[i];
 			}
 			newval[i] = 0;
-			stdfree(nval(node));
-			nval(node) = strsave(newval);
+			set_node_val(node, newval);
 		}
 	}
 
@@ -643,8 +662,7 @@ annotate_node (NODE node, BOOLEAN expand_refns, BOOLEAN annotate_pointers, RFMT
 			strcpy(buffer, "<");
 			strcat(buffer, nval(refn));
 			strcat(buffer, ">");
-			stdfree(nval(node));
-			nval(node) = strsave(buffer);
+			set_node_val(node, buffer);
 		}
 	}
 
@@ -654,8 +672,7 @@ annotate_node (NODE node, BOOLEAN expand_refns, BOOLEAN annotate_pointers, RFMT
 		zs_apps(zstr, " {{");
 		zs_apps(zstr, str);
 		zs_apps(zstr, " }}");
-		stdfree(nval(node));
-		nval(node) = strsave(zs_str(zstr));
+		set_node_val(node, zs_str(zstr));
 		zs_free(&zstr);
 	}
 
@@ -778,11 +795,14 @@ refn_to_record (STRING ukey,    /* user refn key */
 {
 	STRING *keys;
 	INT num;
+	NODE node = NULL;
 
 	if (!ukey || *ukey == 0) return NULL;
 	get_refns(ukey, &num, &keys, letr);
-	if (!num) return NULL;
-	return nztop(key_possible_to_record(keys[0], *keys[0]));
+	if (num)
+		node = nztop(key_possible_to_record(keys[0], *keys[0]));
+	free_refns(num, keys);
+	return node;
 }
 /*===============================================
  * index_by_refn - Index node tree by REFN values
@@ -801,7 +821,7 @@ index_by_refn (NODE node,
 }
 /*====================================================
  * traverse_refns -- traverse refns in db
- *  delegates to traverse_db_rec_rkeys
+ *  delegates to traverse_leaf_records
  *   passing callback function: traverse_refn_callback
  *   and using local data in a TRAV_REFN_PARAM
  *==================================================*/
@@ -809,19 +829,22 @@ typedef struct
 {
 	TRAV_REFNS_FUNC func;
 	void * param;
+	REFNREC rr;
 } TRAV_REFN_PARAM;
 /* see above */
 static BOOLEAN
 traverse_refn_callback ( TRAV_RECORD_FUNC_BYKEY_ARGS(rkey, data, len, param) )
 {
 	TRAV_REFN_PARAM *tparam = (TRAV_REFN_PARAM *)param;
+	REFNREC *rr = &tparam->rr;
+	char rkeystr[RKEYLEN+1];
 	INT i;
 
-	parserefnrec(rkey, data);
+	parserefnrec(rr, rkey, data);
 
-	for (i=0; i<RRcount; i++)
+	for (i=0; i<rr->count; i++)
 	{
-		if (!tparam->func(rkey2str(RRkeys[i]), RRrefns[i], !i, tparam->param))
+		if (!tparam->func(rkey2str_r(rr->keys[i], rkeystr), rr->refns[i], !i, tparam->param))
 			return FALSE;
 	}
 	return TRUE;
@@ -831,16 +854,39 @@ void
 traverse_refns (TRAV_REFNS_FUNC func, void *param)
 {
 	TRAV_REFN_PARAM tparam;
+	memset(&tparam, 0, sizeof(tparam));
 	tparam.param = param;
 	tparam.func = func;
-	traverse_db_rec_rkeys(BTR, refn_lo(), refn_hi(), &traverse_refn_callback, &tparam);
+	traverse_leaf_records(BTR, refn_lo(), refn_hi(), NULL, &traverse_refn_callback, &tparam);
+	freerefnrec(&tparam.rr);
+}
+/*====================================================
+ * traverse_refn_record -- traverse refns in one refn record
+ *  already read from db (eg, by dbverify)
+ *  rkey: [IN]  btree key of record (RKEYLEN chars)
+ *  data: [IN]  raw record
+ * returns FALSE if rkey is not that of a refn record
+ *==================================================*/
+BOOLEAN
+traverse_refn_record (CNSTRING rkey, STRING data, TRAV_REFNS_FUNC func, void *param)
+{
+	TRAV_REFN_PARAM tparam;
+	RKEY rkey1, lo = refn_lo(), hi = refn_hi();
+	memcpy(rkey1.r_rkey, rkey, RKEYLEN);
+	if (ll_strncmp(lo.r_rkey, rkey1.r_rkey, RKEYLEN) >= 0
+		|| ll_strncmp(hi.r_rkey, rkey1.r_rkey, RKEYLEN) < 0)
+		return FALSE;
+	memset(&tparam, 0, sizeof(tparam));
+	tparam.param = param;
+	tparam.func = func;
+	traverse_refn_callback(rkey1, data, 0, &tparam);
+	freerefnrec(&tparam.rr);
+	return TRUE;
 }
 /*====================================================
  * term_refnrec -- Free memory for parsing refn records
  *==================================================*/
 void term_refnrec(void)
 {
-	strfree(&RRrec);
-	freerefnmrec();
-        freerefnrec();
+	freerefnrec(&refnrec);
 }
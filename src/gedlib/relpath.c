@@ -0,0 +1,394 @@
+/* 
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * relpath.c -- Shortest kinship path between two persons
+ *  Bidirectional breadth first search over the family graph
+ *  (famgraph.c), so no NODE trees are built while searching.
+ *  A step joins two persons who share a family: parent, child,
+ *  sibling or spouse.
+ *===========================================================*/
+
+#include <time.h>
+#include "llstdlib.h"
+#include "gedcom.h"
+#include "indiseq.h"
+#include "famgraph.h"
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/*
+ Search state of one person, valid only while stamp is that
+ of the current search, so the array need not be cleared
+ between searches. Side 0 grows from the first person, side 1
+ from the second; pred is 0 until the side reaches the person,
+ and the person itself at the start of a side.
+*/
+struct tag_relnode {
+	INT32 stamp;
+	INT32 pred[2];  /* previous person toward start of side */
+	INT32 fam[2];   /* family shared with pred */
+	INT32 dist[2];  /* steps from start of side */
+};
+
+/* limits of one search */
+struct tag_relbudget {
+	INT maxnodes;    /* persons that may be reached (0 = no limit) */
+	INT maxmsecs;    /* processor time allowed (0 = no limit) */
+	clock_t start;
+	INT reached;     /* persons reached so far, both sides */
+	BOOLEAN exceeded;
+};
+
+/* persons reached but not yet expanded, on one side */
+struct tag_relfront {
+	INT32 *keys;
+	INT n;
+	INT max;
+};
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static void append_step(INDISEQ seq, INT32 from, INT32 to, INT32 fam);
+static BOOLEAN expand_front(INT side, struct tag_relfront * front
+	, struct tag_relfront * next, INT32 * pmeet, INT32 * pbest);
+static INT fam_role(INT32 fkeynum, INT32 ikeynum);
+static BOOLEAN over_budget(void);
+static void push_front(struct tag_relfront * front, INT32 keynum);
+static BOOLEAN reach(INT side, INT32 from, INT32 to, INT32 fam
+	, struct tag_relfront * next);
+static struct tag_relnode * relnode(INT32 keynum);
+static INDISEQ relpath_to_indiseq(INT32 meet);
+static CNSTRING step_label(INT32 from, INT32 to, INT32 fam);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+static struct tag_relnode * relnodes = 0;
+static INT relnodes_max = 0;
+static INT32 relstamp = 0;
+static struct tag_relbudget budget;
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * relnode -- Search state of person (growing array as needed)
+ *  Entry is reset the first time it is touched in a search
+ *===============================================*/
+static struct tag_relnode *
+relnode (INT32 keynum)
+{
+	struct tag_relnode * node;
+	if (keynum >= relnodes_max) {
+		INT newmax = relnodes_max ? relnodes_max : 1024;
+		struct tag_relnode * nodes;
+		while (newmax <= keynum)
+			newmax <<= 1;
+		nodes = (struct tag_relnode *)stdalloc(newmax * sizeof(nodes[0]));
+		memset(nodes, 0, newmax * sizeof(nodes[0]));
+		if (relnodes) {
+			memcpy(nodes, relnodes, relnodes_max * sizeof(nodes[0]));
+			stdfree(relnodes);
+		}
+		relnodes = nodes;
+		relnodes_max = newmax;
+	}
+	node = &relnodes[keynum];
+	if (node->stamp != relstamp) {
+		memset(node, 0, sizeof(*node));
+		node->stamp = relstamp;
+	}
+	return node;
+}
+/*=================================================
+ * push_front -- Add person to a search frontier
+ *===============================================*/
+static void
+push_front (struct tag_relfront * front, INT32 keynum)
+{
+	if (front->n == front->max) {
+		INT32 * keys;
+		front->max = front->max ? 2 * front->max : 64;
+		keys = (INT32 *)stdalloc(front->max * sizeof(keys[0]));
+		if (front->keys) {
+			memcpy(keys, front->keys, front->n * sizeof(keys[0]));
+			stdfree(front->keys);
+		}
+		front->keys = keys;
+	}
+	front->keys[front->n++] = keynum;
+}
+/*=================================================
+ * reach -- Step from one person to another on one side
+ *  returns TRUE if the other side had already reached to
+ *===============================================*/
+static BOOLEAN
+reach (INT side, INT32 from, INT32 to, INT32 fam, struct tag_relfront * next)
+{
+	struct tag_relnode * node = relnode(to);
+	if (!node->pred[side]) {
+		node->pred[side] = from;
+		node->fam[side] = fam;
+		node->dist[side] = relnode(from)->dist[side] + 1;
+		push_front(next, to);
+		++budget.reached;
+	}
+	return node->pred[1-side] != 0;
+}
+/*=================================================
+ * expand_front -- Expand one whole level of one side
+ *  front:  [IN]  persons at current level
+ *  next:   [OUT] persons first reached from them
+ *  pmeet:  [I/O] person where best path so far meets
+ *  pbest:  [I/O] length of that path (-1 if none yet)
+ * returns FALSE if search budget ran out
+ * The whole level is expanded even after a meeting, as a
+ * later person in the level may give a shorter path.
+ *===============================================*/
+static BOOLEAN
+expand_front (INT side, struct tag_relfront * front
+	, struct tag_relfront * next, INT32 * pmeet, INT32 * pbest)
+{
+	static const INT indilists[] = { FGL_FAMC, FGL_FAMS };
+	INT i, j, k, m;
+	for (i=0; i<front->n; ++i) {
+		INT32 ikey = front->keys[i];
+		if (!(i % 64) && over_budget())
+			return FALSE;
+		for (j=0; j<ARRSIZE(indilists); ++j) {
+			const INT32 * fams;
+			INT nfams = famgraph_indi_links(ikey, indilists[j], &fams);
+			for (k=0; k<nfams; ++k) {
+				INT list;
+				for (list=FGL_HUSB; list<=FGL_CHIL; ++list) {
+					const INT32 * indis;
+					INT nindis = famgraph_fam_links(fams[k], list, &indis);
+					for (m=0; m<nindis; ++m) {
+						struct tag_relnode * node;
+						INT32 len;
+						if (indis[m] == ikey || !famgraph_indi_exists(indis[m]))
+							continue;
+						if (!reach(side, ikey, indis[m], fams[k], next))
+							continue;
+						node = relnode(indis[m]);
+						len = node->dist[0] + node->dist[1];
+						if (*pbest < 0 || len < *pbest) {
+							*pbest = len;
+							*pmeet = indis[m];
+						}
+					}
+				}
+			}
+		}
+	}
+	return TRUE;
+}
+/*=================================================
+ * over_budget -- Has search used up its persons or time ?
+ *===============================================*/
+static BOOLEAN
+over_budget (void)
+{
+	if (budget.maxnodes > 0 && budget.reached >= budget.maxnodes)
+		budget.exceeded = TRUE;
+	if (budget.maxmsecs > 0
+		&& (clock() - budget.start) * 1000.0 / CLOCKS_PER_SEC >= budget.maxmsecs)
+		budget.exceeded = TRUE;
+	return budget.exceeded;
+}
+/*=================================================
+ * relation_path_indiseq -- Find a shortest kinship path
+ *  key1:     [IN]  first person
+ *  key2:     [IN]  last person
+ *  maxnodes: [IN]  give up after reaching this many persons (0 = no limit)
+ *  maxmsecs: [IN]  give up after this many msecs of processor time
+ *                  (0 = no limit)
+ *  pstatus:  [OUT] RELPATH_FOUND, RELPATH_UNRELATED or RELPATH_BUDGET
+ * returns sequence of persons from key1 to key2 (NULL if none),
+ *  each valued with what it is to the one before it
+ *  ("father", "mother", "child", "sibling", "husband", "wife")
+ *  and the first valued with ""
+ *===============================================*/
+INDISEQ
+relation_path_indiseq (CNSTRING key1, CNSTRING key2, INT maxnodes
+	, INT maxmsecs, INT * pstatus)
+{
+	struct tag_relfront front[2], next;
+	INT32 ends[2], meet=0, best=-1;
+	INT side;
+	INDISEQ seq=0;
+
+	*pstatus = RELPATH_UNRELATED;
+	if (!key1 || !key2 || key1[0] != 'I' || key2[0] != 'I')
+		return NULL;
+	ends[0] = atoi(key1+1);
+	ends[1] = atoi(key2+1);
+	if (!famgraph_indi_exists(ends[0]) || !famgraph_indi_exists(ends[1]))
+		return NULL;
+	if (++relstamp <= 0) {
+		/* stamps wrapped: forget all old entries */
+		memset(relnodes, 0, relnodes_max * sizeof(relnodes[0]));
+		relstamp = 1;
+	}
+	budget.maxnodes = maxnodes;
+	budget.maxmsecs = maxmsecs;
+	budget.start = clock();
+	budget.reached = 2;
+	budget.exceeded = FALSE;
+	memset(front, 0, sizeof(front));
+	memset(&next, 0, sizeof(next));
+	for (side=0; side<2; ++side) {
+		struct tag_relnode * node = relnode(ends[side]);
+		node->pred[side] = ends[side];
+		push_front(&front[side], ends[side]);
+	}
+	if (ends[0] == ends[1]) {
+		meet = ends[0];
+		best = 0;
+	}
+	while (best < 0 && front[0].n && front[1].n) {
+		struct tag_relfront tmp;
+		/* grow the smaller side, one whole level */
+		side = (front[0].n <= front[1].n) ? 0 : 1;
+		next.n = 0;
+		if (!expand_front(side, &front[side], &next, &meet, &best)) {
+			*pstatus = RELPATH_BUDGET;
+			best = -1;
+			break;
+		}
+		tmp = front[side];
+		front[side] = next;
+		next = tmp;
+	}
+	if (best >= 0) {
+		*pstatus = RELPATH_FOUND;
+		seq = relpath_to_indiseq(meet);
+	}
+	for (side=0; side<2; ++side) {
+		if (front[side].keys)
+			stdfree(front[side].keys);
+	}
+	if (next.keys)
+		stdfree(next.keys);
+	return seq;
+}
+/*=================================================
+ * relpath_to_indiseq -- Build path through meeting person
+ *===============================================*/
+static INDISEQ
+relpath_to_indiseq (INT32 meet)
+{
+	INDISEQ seq = create_indiseq_sval();
+	INT32 * chain;
+	INT n=0, i;
+	INT32 ikey;
+	char key[MAXKEYWIDTH+2];
+
+	/* persons from meeting point back to first person */
+	chain = (INT32 *)stdalloc((relnode(meet)->dist[0] + 1) * sizeof(chain[0]));
+	for (ikey = meet; ; ikey = relnode(ikey)->pred[0]) {
+		chain[n++] = ikey;
+		if (relnode(ikey)->pred[0] == ikey)
+			break;
+	}
+	snprintf(key, sizeof(key), "I%d", chain[n-1]);
+	append_indiseq_sval(seq, key, NULL, strsave(""), TRUE, FALSE);
+	for (i=n-2; i>=0; --i)
+		append_step(seq, chain[i+1], chain[i], relnode(chain[i])->fam[0]);
+	stdfree(chain);
+	/* then on from meeting point to last person */
+	for (ikey = meet; relnode(ikey)->pred[1] != ikey; ) {
+		INT32 to = relnode(ikey)->pred[1];
+		append_step(seq, ikey, to, relnode(ikey)->fam[1]);
+		ikey = to;
+	}
+	IPrntype(seq) = ISPRN_RELPATHSEQ;
+	return seq;
+}
+/*=================================================
+ * append_step -- Add person to path, valued with its relation
+ *  to the person before it
+ *===============================================*/
+static void
+append_step (INDISEQ seq, INT32 from, INT32 to, INT32 fam)
+{
+	char key[MAXKEYWIDTH+2];
+	snprintf(key, sizeof(key), "I%d", to);
+	append_indiseq_sval(seq, key, NULL, strsave(step_label(from, to, fam))
+		, TRUE, FALSE);
+}
+/*=================================================
+ * fam_role -- Which list of family holds person ?
+ *  returns FGL_HUSB, FGL_WIFE, FGL_CHIL or -1
+ *===============================================*/
+static INT
+fam_role (INT32 fkeynum, INT32 ikeynum)
+{
+	INT list, i;
+	for (list=FGL_HUSB; list<=FGL_CHIL; ++list) {
+		const INT32 * indis;
+		INT nindis = famgraph_fam_links(fkeynum, list, &indis);
+		for (i=0; i<nindis; ++i) {
+			if (indis[i] == ikeynum)
+				return list;
+		}
+	}
+	return -1;
+}
+/*=================================================
+ * step_label -- What is to, to from (they share family fam) ?
+ *  Labels are untranslated, for reports to compare
+ *===============================================*/
+static CNSTRING
+step_label (INT32 from, INT32 to, INT32 fam)
+{
+	INT fromrole = fam_role(fam, from);
+	INT torole = fam_role(fam, to);
+	if (fromrole == FGL_CHIL) {
+		if (torole == FGL_HUSB) return N_("father");
+		if (torole == FGL_WIFE) return N_("mother");
+		return N_("sibling");
+	}
+	if (torole == FGL_CHIL) return N_("child");
+	if (torole == FGL_HUSB) return N_("husband");
+	return N_("wife");
+}
+/*=================================================
+ * term_relation_path -- Free search state
+ *===============================================*/
+void
+term_relation_path (void)
+{
+	if (relnodes)
+		stdfree(relnodes);
+	relnodes = 0;
+	relnodes_max = 0;
+}
@@ -26,13 +26,7 @@ extern BOOLEAN opt_finnish;
  * local function prototypes
  *********************************************/
 
-static INT trad_sxcodeof(int);
-
-/*********************************************
- * local variables
- *********************************************/
-
-static INT oldsx = 0;
+static INT trad_sxcodeof(int letter, INT *poldsx);
 
 /*********************************************
  * local function definitions
@@ -46,18 +40,28 @@ static INT oldsx = 0;
 CNSTRING
 trad_soundex (CNSTRING surname)
 {
-	static char scratch[6];
+	static char scratch[SOUNDEX_BUFLEN];
+	return trad_soundex_r(surname, scratch);
+}
+/*========================================
+ * trad_soundex_r -- Return name's SOUNDEX code, in caller's buffer
+ *  surname: [IN]  surname to code
+ *  buf:     [OUT] buffer of SOUNDEX_BUFLEN chars
+ *  returns buf (or a constant string)
+ *======================================*/
+CNSTRING
+trad_soundex_r (CNSTRING surname, STRING buf)
+{
 	CNSTRING p = surname;
-	STRING q = scratch;
-	INT c, i, j;
+	STRING q = buf;
+	INT c, i, j, oldsx = 0;
 	if (!surname || !surname[0] || eqstr(surname, "____"))
 		return (STRING) "Z999";
 	/* always copy first letter directly */
 	*q++ = ll_toupper((uchar)*p++);
 	i = 1;
-	oldsx = 0;
 	while (*p && (c = ll_toupper((uchar)*p++)) && i < 4) {
-		if ((j = trad_sxcodeof(c)) == 0) continue;
+		if ((j = trad_sxcodeof(c, &oldsx)) == 0) continue;
 		*q++ = j;
 		i++;
 	}
@@ -66,19 +70,20 @@ trad_soundex (CNSTRING surname)
 		i++;
 	}
 	*q = 0;
-	return scratch;
+	return buf;
 }
 /*========================================
  * trad_sxcodeof -- Return letter's SOUNDEX code.
  *  letter:  should be capitalized letter
+ *  poldsx:  [I/O] code of previous letter
  * returns soundex code, or 0 if not coded
- * Also returns 0 if same as last call (uses static oldsx variable).
+ * Also returns 0 if same as previous letter.
  * Note that Finnish version uses a different SOUNDEX
  * scheme here, making databases (name indices)
  * not portable between Finnish & normal LifeLines.
  *======================================*/
 static INT
-trad_sxcodeof (int letter)
+trad_sxcodeof (int letter, INT *poldsx)
 {
 	int newsx = 0;
 
@@ -123,11 +128,11 @@ trad_sxcodeof (int letter)
 	}
   
 	if (newsx == 0) {
-		oldsx = 0;
+		*poldsx = 0;
 		return 0;
 	}
-	if (newsx == oldsx) return 0;
-	oldsx = newsx;
+	if (newsx == *poldsx) return 0;
+	*poldsx = newsx;
 	return newsx;
 }
 /*========================================
@@ -145,7 +150,17 @@ soundex_count (void)
 CNSTRING
 soundex_get (INT i, CNSTRING surname)
 {
-	if (i==0) return trad_soundex(surname);
+	static char scratch[SOUNDEX_BUFLEN];
+	return soundex_get_r(i, surname, scratch);
+}
+/*========================================
+ * soundex_get_r -- Return a soundex coding, in caller's buffer
+ *  buf: [OUT] buffer of SOUNDEX_BUFLEN chars
+ *======================================*/
+CNSTRING
+soundex_get_r (INT i, CNSTRING surname, STRING buf)
+{
+	if (i==0) return trad_soundex_r(surname, buf);
 	return "";
 }
 
@@ -0,0 +1,1031 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * tagindex.c -- Secondary indexes of values on tag paths
+ *  An index is declared on a tag path (eg, "INDI.OCCU" or
+ *  "SOUR.TITL") with a key extractor, which turns each line
+ *  value on the path into the keys indexed (the whole value,
+ *  each word of it, or the year of a date). Like the refn
+ *  index, the entries are kept in btree records, each holding
+ *  all values of one index starting with the same characters,
+ *  and they are updated whenever a record is stored.
+ *===========================================================*/
+
+#include "llstdlib.h"
+#include "btree.h"
+#include "gedcom.h"
+#include "date.h"
+#include "zstr.h"
+#include "gedcomi.h"
+#include "rawscan.h"
+#include "tagindex.h"
+
+extern BTREE BTR;
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* values extracted from one record (or line) */
+typedef struct tag_tivalues {
+	STRING * vals;
+	INT count;
+	INT max;
+} TIVALUES;
+
+/* turns one line value into the values indexed */
+typedef void (*TI_EXTRACT)(CNSTRING val, INT len, TIVALUES * tiv);
+
+/* a declared index */
+typedef struct tag_tidecl {
+	char slot;           /* 'a'-'z', in keys of its index records */
+	STRING tagpath;
+	INT extractor;       /* in extractors[] */
+} TIDECL;
+
+/*
+ Index record, stored under key "  T" + slot + first 4
+ characters of value (ASCII letters uppercased, blank padded):
+        1 INT32 count - number of entries in this record
+    count RKEY  keys  - RKEYs of records with the values
+    count INT32 offs  - offsets into following strings
+    count STRING vals - values, NUL terminated
+ Entries are sorted by value (ignoring ASCII case) & then key.
+*/
+typedef struct tag_tirec {
+	RKEY key;
+	STRING rec;          /* raw record, if read by get_tirec */
+	INT32 count;
+	INT32 max;
+	RKEY * keys;
+	CNSTRING * vals;     /* into rec, or caller's strings */
+} TIREC;
+
+/* one entry, while building an index */
+typedef struct tag_tientry {
+	RKEY bucket;
+	RKEY key;
+	STRING value;
+} TIENTRY;
+
+/* state of a build traversal */
+typedef struct tag_tibuild {
+	const TIDECL * decl;
+	TIENTRY * list;
+	INT count;
+	INT max;
+	TIVALUES tiv;
+} TIBUILD;
+
+/* state of a range query traversal */
+typedef struct tag_tiquery {
+	CNSTRING value;
+	BOOLEAN prefix;
+	TAGINDEX_FUNC func;
+	void * param;
+	BOOLEAN stopped;
+} TIQUERY;
+
+/* extract state, passed through rawscan_values */
+typedef struct tag_tiextract {
+	TI_EXTRACT func;
+	TIVALUES * tiv;
+} TIEXTRACT;
+
+#define TI_MAXINDEXES 26
+#define TI_BUCKETLEN 4
+#define TI_DECLKEY "VTIDX"
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+static void add_entry(const TIDECL * decl, CNSTRING value, RKEY rkey);
+static void add_value(TIVALUES * tiv, CNSTRING val, INT len);
+static void bucket_rkey(char slot, CNSTRING value, INT pad, RKEY * rkey);
+static BOOLEAN build_record(RKEY rkey, STRING data, INT len, void * param);
+static int cmp_build_entries(const void * el1, const void * el2);
+static INT cmp_entry(CNSTRING val1, const RKEY * key1, CNSTRING val2, const RKEY * key2);
+static BOOLEAN collect_rkey(RKEY rkey, STRING data, INT len, void * param);
+static void collect_values(const TIDECL * decl, CNSTRING data, INT len, TIVALUES * tiv);
+static BOOLEAN extract_line(CNSTRING val, INT len, void * param);
+static void extract_value(CNSTRING val, INT len, TIVALUES * tiv);
+static void extract_words(CNSTRING val, INT len, TIVALUES * tiv);
+static void extract_year(CNSTRING val, INT len, TIVALUES * tiv);
+static INT find_declaration(CNSTRING tagpath);
+static INT find_extractor(CNSTRING name);
+static INT fold(INT c);
+static INT fold_cmp(CNSTRING str1, CNSTRING str2);
+static BOOLEAN fold_prefix(CNSTRING prefix, CNSTRING str);
+static void free_tirec(TIREC * tr);
+static void free_values(TIVALUES * tiv);
+static void get_tirec(TIREC * tr, RKEY rkey);
+static void grow_tirec(TIREC * tr, INT32 count);
+static BOOLEAN has_value(TIVALUES * tiv, CNSTRING val);
+static BOOLEAN is_record_key(CNSTRING key);
+static BOOLEAN is_word_char(INT c);
+static void load_declarations(void);
+static void normalize_tagpath(CNSTRING tagpath, STRING buf, INT buflen);
+static void parse_tirec(TIREC * tr, RKEY rkey, CNSTRING p, INT len);
+static BOOLEAN query_record(RKEY rkey, STRING data, INT len, void * param);
+static BOOLEAN record_applies(const TIDECL * decl, CNSTRING key);
+static void remove_entry(const TIDECL * decl, CNSTRING value, RKEY rkey);
+static BOOLEAN report_entries(TIREC * tr, TIQUERY * tq);
+static void store_declarations(void);
+static void store_tirec(TIREC * tr);
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+/* key extractors, by name */
+static struct {
+	CNSTRING name;
+	TI_EXTRACT func;
+} extractors[] = {
+	{ "value", extract_value }
+	, { "words", extract_words }
+	, { "year", extract_year }
+};
+
+static TIDECL tidecls[TI_MAXINDEXES];
+static INT tidecount = 0;
+/* record being stored, as it was before */
+static STRING tioldkey = 0;
+static STRING tioldrec = 0;
+static INT tioldlen = 0;
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=================================================
+ * fold -- Uppercase ASCII letter
+ *===============================================*/
+static INT
+fold (INT c)
+{
+	return (c >= 'a' && c <= 'z') ? c + 'A' - 'a' : c;
+}
+/*=================================================
+ * fold_cmp -- Compare strings, ignoring ASCII case
+ *===============================================*/
+static INT
+fold_cmp (CNSTRING str1, CNSTRING str2)
+{
+	const uchar * s1 = (const uchar *)str1;
+	const uchar * s2 = (const uchar *)str2;
+	for ( ; *s1 && fold(*s1) == fold(*s2); ++s1, ++s2)
+		;
+	return fold(*s1) - fold(*s2);
+}
+/*=================================================
+ * fold_prefix -- Does str start with prefix, ignoring ASCII case ?
+ *===============================================*/
+static BOOLEAN
+fold_prefix (CNSTRING prefix, CNSTRING str)
+{
+	const uchar * p = (const uchar *)prefix;
+	const uchar * s = (const uchar *)str;
+	for ( ; *p; ++p, ++s) {
+		if (fold(*p) != fold(*s))
+			return FALSE;
+	}
+	return TRUE;
+}
+/*=================================================
+ * cmp_entry -- Order of index entries
+ *  by value (ignoring ASCII case, then exactly) & key
+ *===============================================*/
+static INT
+cmp_entry (CNSTRING val1, const RKEY * key1, CNSTRING val2, const RKEY * key2)
+{
+	INT rel = fold_cmp(val1, val2);
+	if (!rel)
+		rel = strcmp(val1, val2);
+	if (!rel)
+		rel = cmpkeys(key1, key2);
+	return rel;
+}
+/*=================================================
+ * bucket_rkey -- Key of index record holding value
+ *  pad: [IN]  character padding short values (blank for
+ *             the record of a value, or the limits of a range)
+ *===============================================*/
+static void
+bucket_rkey (char slot, CNSTRING value, INT pad, RKEY * rkey)
+{
+	INT i;
+	rkey->r_rkey[0] = rkey->r_rkey[1] = ' ';
+	rkey->r_rkey[2] = 'T';
+	rkey->r_rkey[3] = slot;
+	for (i=0; i<TI_BUCKETLEN; ++i) {
+		if (*value)
+			rkey->r_rkey[4+i] = (char)fold((uchar)*value++);
+		else
+			rkey->r_rkey[4+i] = (char)pad;
+	}
+}
+/*=================================================
+ * extractors -- Turn a line value into values indexed
+ *  val is trimmed & nonempty, but not NUL terminated
+ *===============================================*/
+/* whole value */
+static void
+extract_value (CNSTRING val, INT len, TIVALUES * tiv)
+{
+	add_value(tiv, val, len);
+}
+/* each word (run of letters & digits, or of non-ASCII characters) */
+static void
+extract_words (CNSTRING val, INT len, TIVALUES * tiv)
+{
+	CNSTRING end = val + len, word;
+	while (val < end) {
+		while (val < end && !is_word_char((uchar)*val))
+			++val;
+		for (word = val; val < end && is_word_char((uchar)*val); ++val)
+			;
+		if (val > word)
+			add_value(tiv, word, val - word);
+	}
+}
+/* see above */
+static BOOLEAN
+is_word_char (INT c)
+{
+	return c >= 0x80 || isalnum(c);
+}
+/* year of a date (eg, "1852" for "ABT 3 MAR 1852") */
+static void
+extract_year (CNSTRING val, INT len, TIVALUES * tiv)
+{
+	char buf[128];
+	GDATEVAL gdv;
+	INT year;
+	if (len >= (INT)sizeof(buf))
+		return;
+	memcpy(buf, val, len);
+	buf[len] = 0;
+	if (!(gdv = extract_date(buf)))
+		return;
+	year = date_get_year(gdv);
+	free_gdateval(gdv);
+	if (year != BAD_YEAR) {
+		snprintf(buf, sizeof(buf), FMT_INT, year);
+		add_value(tiv, buf, strlen(buf));
+	}
+}
+/*=================================================
+ * add_value -- Add copy of value, unless already there
+ *===============================================*/
+static void
+add_value (TIVALUES * tiv, CNSTRING val, INT len)
+{
+	STRING str = (STRING)stdalloc(len + 1);
+	memcpy(str, val, len);
+	str[len] = 0;
+	if (has_value(tiv, str)) {
+		stdfree(str);
+		return;
+	}
+	if (tiv->count == tiv->max) {
+		STRING * old = tiv->vals;
+		tiv->max = tiv->max ? 2*tiv->max : 16;
+		tiv->vals = (STRING *)stdalloc(tiv->max * sizeof(STRING));
+		if (old) {
+			memcpy(tiv->vals, old, tiv->count * sizeof(STRING));
+			stdfree(old);
+		}
+	}
+	tiv->vals[tiv->count++] = str;
+}
+/*=================================================
+ * has_value -- Is value in list ?
+ *===============================================*/
+static BOOLEAN
+has_value (TIVALUES * tiv, CNSTRING val)
+{
+	INT i;
+	for (i=0; i<tiv->count; ++i) {
+		if (eqstr(tiv->vals[i], val))
+			return TRUE;
+	}
+	return FALSE;
+}
+/*=================================================
+ * free_values -- Empty list of values
+ *===============================================*/
+static void
+free_values (TIVALUES * tiv)
+{
+	INT i;
+	for (i=0; i<tiv->count; ++i)
+		stdfree(tiv->vals[i]);
+	tiv->count = 0;
+}
+/*=================================================
+ * extract_line -- Extract values of one line on tag path
+ *  (rawscan_values callback)
+ *===============================================*/
+static BOOLEAN
+extract_line (CNSTRING val, INT len, void * param)
+{
+	TIEXTRACT * tix = (TIEXTRACT *)param;
+	(*tix->func)(val, len, tix->tiv);
+	return TRUE;
+}
+/*=================================================
+ * collect_values -- Values an index holds for a raw record
+ *===============================================*/
+static void
+collect_values (const TIDECL * decl, CNSTRING data, INT len, TIVALUES * tiv)
+{
+	TIEXTRACT tix;
+	if (!data || !len || (len == 5 && !strncmp(data, "DELE\n", 5)))
+		return;
+	tix.func = extractors[decl->extractor].func;
+	tix.tiv = tiv;
+	rawscan_values(decl->tagpath, data, len, &extract_line, &tix);
+}
+/*=================================================
+ * is_record_key -- Is key that of a person, family, etc ?
+ *===============================================*/
+static BOOLEAN
+is_record_key (CNSTRING key)
+{
+	if (!key || !strchr("IFSEX", key[0]) || !key[0] || !key[1])
+		return FALSE;
+	for (++key; *key; ++key) {
+		if (chartype((uchar)*key) != DIGIT)
+			return FALSE;
+	}
+	return TRUE;
+}
+/*=================================================
+ * record_applies -- Could record hold values of index ?
+ *  (by the level 0 tag of its tag path)
+ *===============================================*/
+static BOOLEAN
+record_applies (const TIDECL * decl, CNSTRING key)
+{
+	CNSTRING path = decl->tagpath;
+	char ntype;
+	if (!is_record_key(key))
+		return FALSE;
+	if (path[0] == '*' && path[1] == '.')
+		return TRUE;
+	if (!strncmp(path, "INDI.", 5))
+		ntype = 'I';
+	else if (!strncmp(path, "FAM.", 4))
+		ntype = 'F';
+	else if (!strncmp(path, "SOUR.", 5))
+		ntype = 'S';
+	else if (!strncmp(path, "EVEN.", 5))
+		ntype = 'E';
+	else
+		ntype = 'X';
+	return key[0] == ntype;
+}
+/*=================================================
+ * normalize_tagpath -- Copy tag path, uppercased
+ *===============================================*/
+static void
+normalize_tagpath (CNSTRING tagpath, STRING buf, INT buflen)
+{
+	INT i;
+	for (i=0; i<buflen-1 && tagpath[i]; ++i)
+		buf[i] = (char)fold((uchar)tagpath[i]);
+	buf[i] = 0;
+}
+/*=================================================
+ * find_declaration -- Find index declared on tag path
+ *  returns index in tidecls, or -1
+ *===============================================*/
+static INT
+find_declaration (CNSTRING tagpath)
+{
+	char path[MAXPATHLEN];
+	INT i;
+	if (!tagpath)
+		return -1;
+	normalize_tagpath(tagpath, path, sizeof(path));
+	for (i=0; i<tidecount; ++i) {
+		if (eqstr(tidecls[i].tagpath, path))
+			return i;
+	}
+	return -1;
+}
+/*=================================================
+ * find_extractor -- Find key extractor by name
+ *  returns index in extractors, or -1
+ *===============================================*/
+static INT
+find_extractor (CNSTRING name)
+{
+	INT i;
+	if (!name || !name[0])
+		return 0;
+	for (i=0; i<ARRSIZE(extractors); ++i) {
+		if (eqstr(extractors[i].name, name))
+			return i;
+	}
+	return -1;
+}
+/*=================================================
+ * load_declarations -- Read declared indexes
+ *  One line per index, of slot, extractor & tag path
+ *  (eg, "a value INDI.OCCU")
+ *===============================================*/
+static void
+load_declarations (void)
+{
+	INT len=0;
+	STRING rec = retrieve_raw_record(TI_DECLKEY, &len);
+	CNSTRING p, end;
+	tidecount = 0;
+	if (!rec)
+		return;
+	for (p = rec, end = rec + len; p < end && tidecount < TI_MAXINDEXES; ) {
+		char name[32], path[MAXPATHLEN];
+		CNSTRING eol = memchr(p, '\n', end - p);
+		char line[MAXPATHLEN+64];
+		INT n, ext;
+		if (!eol) eol = end;
+		n = eol - p;
+		if (n >= (INT)sizeof(line))
+			n = sizeof(line) - 1;
+		memcpy(line, p, n);
+		line[n] = 0;
+		p = eol + 1;
+		if (line[0] < 'a' || line[0] > 'z' || line[1] != ' '
+			|| sscanf(line+2, "%31s %1023s", name, path) != 2)
+			continue;
+		if ((ext = find_extractor(name)) < 0 || !rawscan_tagpath_isvalid(path))
+			continue;
+		tidecls[tidecount].slot = line[0];
+		tidecls[tidecount].tagpath = strsave(path);
+		tidecls[tidecount].extractor = ext;
+		++tidecount;
+	}
+	stdfree(rec);
+}
+/*=================================================
+ * store_declarations -- Write declared indexes
+ *===============================================*/
+static void
+store_declarations (void)
+{
+	ZSTR zstr = zs_new();
+	INT i;
+	for (i=0; i<tidecount; ++i) {
+		zs_appf(zstr, "%c %s %s\n", tidecls[i].slot
+			, extractors[tidecls[i].extractor].name, tidecls[i].tagpath);
+	}
+	store_record(TI_DECLKEY, zs_str(zstr), zs_len(zstr));
+	zs_free(&zstr);
+}
+/*=================================================
+ * tagindex_open -- Read declared indexes of database
+ *  just opened
+ *===============================================*/
+void
+tagindex_open (void)
+{
+	tagindex_close();
+	load_declarations();
+}
+/*=================================================
+ * tagindex_close -- Forget declared indexes
+ *===============================================*/
+void
+tagindex_close (void)
+{
+	INT i;
+	for (i=0; i<tidecount; ++i)
+		strfree(&tidecls[i].tagpath);
+	tidecount = 0;
+	strfree(&tioldkey);
+	if (tioldrec)
+		stdfree(tioldrec);
+	tioldrec = 0;
+	tioldlen = 0;
+}
+/*=================================================
+ * tagindex_declared -- Get one declared index
+ *  i:          [IN]  which (from 0)
+ *  pextractor: [OUT] name of its key extractor
+ *  returns its tag path, or NULL if there are not that many
+ *===============================================*/
+CNSTRING
+tagindex_declared (INT i, CNSTRING * pextractor)
+{
+	if (i < 0 || i >= tidecount)
+		return NULL;
+	if (pextractor)
+		*pextractor = extractors[tidecls[i].extractor].name;
+	return tidecls[i].tagpath;
+}
+/*=================================================
+ * tagindex_extractor -- Get key extractor of index
+ *  returns its name, or NULL if no index on tag path
+ *===============================================*/
+CNSTRING
+tagindex_extractor (CNSTRING tagpath)
+{
+	INT i = find_declaration(tagpath);
+	return (i < 0) ? NULL : extractors[tidecls[i].extractor].name;
+}
+/*=================================================
+ * free_tirec -- Free index record & its arrays
+ *===============================================*/
+static void
+free_tirec (TIREC * tr)
+{
+	if (tr->rec)
+		stdfree(tr->rec);
+	if (tr->keys)
+		stdfree(tr->keys);
+	if (tr->vals)
+		stdfree((void *)tr->vals);
+	memset(tr, 0, sizeof(*tr));
+}
+/*=================================================
+ * grow_tirec -- Make room for count entries
+ *===============================================*/
+static void
+grow_tirec (TIREC * tr, INT32 count)
+{
+	RKEY * oldkeys = tr->keys;
+	CNSTRING * oldvals = tr->vals;
+	if (count <= tr->max)
+		return;
+	tr->max = count + 16;
+	tr->keys = (RKEY *)stdalloc(tr->max * sizeof(RKEY));
+	tr->vals = (CNSTRING *)stdalloc(tr->max * sizeof(CNSTRING));
+	if (oldkeys) {
+		memcpy(tr->keys, oldkeys, tr->count * sizeof(RKEY));
+		memcpy((void *)tr->vals, oldvals, tr->count * sizeof(CNSTRING));
+		stdfree(oldkeys);
+		stdfree((void *)oldvals);
+	}
+}
+/*=================================================
+ * parse_tirec -- Parse raw index record into arrays
+ *  p: [IN]  raw record (values point into it)
+ *===============================================*/
+static void
+parse_tirec (TIREC * tr, RKEY rkey, CNSTRING p, INT len)
+{
+	INT32 count=0, off, i;
+	CNSTRING strs;
+	tr->key = rkey;
+	tr->count = 0;
+	if (!p || len < (INT)sizeof(count))
+		return;
+	memcpy(&count, p, sizeof(count));
+	if (count <= 0 || len < (INT)(sizeof(count) + count*(sizeof(RKEY)+sizeof(off))))
+		return;
+	grow_tirec(tr, count + 1);
+	p += sizeof(count);
+	memcpy(tr->keys, p, count * sizeof(RKEY));
+	p += count * sizeof(RKEY);
+	strs = p + count * sizeof(off);
+	for (i=0; i<count; ++i) {
+		memcpy(&off, p + i * sizeof(off), sizeof(off));
+		tr->vals[i] = strs + off;
+	}
+	tr->count = count;
+}
+/*=================================================
+ * get_tirec -- Read index record (empty if none)
+ *===============================================*/
+static void
+get_tirec (TIREC * tr, RKEY rkey)
+{
+	INT len=0;
+	free_tirec(tr);
+	tr->rec = bt_getrecord(BTR, &rkey, &len);
+	parse_tirec(tr, rkey, tr->rec, len);
+}
+/*=================================================
+ * store_tirec -- Write index record from its arrays
+ *===============================================*/
+static void
+store_tirec (TIREC * tr)
+{
+	INT i, len = sizeof(INT32);
+	INT32 off = 0;
+	STRING rec, p;
+	for (i=0; i<tr->count; ++i)
+		len += sizeof(RKEY) + sizeof(INT32) + strlen(tr->vals[i]) + 1;
+	p = rec = (STRING)stdalloc(len);
+	memcpy(p, &tr->count, sizeof(tr->count));
+	p += sizeof(tr->count);
+	memcpy(p, tr->keys, tr->count * sizeof(RKEY));
+	p += tr->count * sizeof(RKEY);
+	for (i=0; i<tr->count; ++i) {
+		memcpy(p, &off, sizeof(off));
+		p += sizeof(off);
+		off += strlen(tr->vals[i]) + 1;
+	}
+	for (i=0; i<tr->count; ++i) {
+		INT n = strlen(tr->vals[i]) + 1;
+		memcpy(p, tr->vals[i], n);
+		p += n;
+	}
+	bt_addrecord(BTR, tr->key, rec, len);
+	stdfree(rec);
+}
+/*=================================================
+ * add_entry -- Add one value of a record to its index
+ *===============================================*/
+static void
+add_entry (const TIDECL * decl, CNSTRING value, RKEY rkey)
+{
+	TIREC tr;
+	RKEY bucket;
+	INT32 i, j;
+	memset(&tr, 0, sizeof(tr));
+	bucket_rkey(decl->slot, value, ' ', &bucket);
+	get_tirec(&tr, bucket);
+	for (i=0; i<tr.count; ++i) {
+		INT rel = cmp_entry(value, &rkey, tr.vals[i], &tr.keys[i]);
+		if (!rel)
+			goto done;
+		if (rel < 0)
+			break;
+	}
+	grow_tirec(&tr, tr.count + 1);
+	for (j=tr.count; j>i; --j) {
+		tr.keys[j] = tr.keys[j-1];
+		tr.vals[j] = tr.vals[j-1];
+	}
+	tr.keys[i] = rkey;
+	tr.vals[i] = value;
+	++tr.count;
+	store_tirec(&tr);
+done:
+	free_tirec(&tr);
+}
+/*=================================================
+ * remove_entry -- Remove one value of a record from its index
+ *===============================================*/
+static void
+remove_entry (const TIDECL * decl, CNSTRING value, RKEY rkey)
+{
+	TIREC tr;
+	RKEY bucket;
+	INT32 i;
+	memset(&tr, 0, sizeof(tr));
+	bucket_rkey(decl->slot, value, ' ', &bucket);
+	get_tirec(&tr, bucket);
+	for (i=0; i<tr.count; ++i) {
+		if (!cmp_entry(value, &rkey, tr.vals[i], &tr.keys[i]))
+			break;
+	}
+	if (i < tr.count) {
+		for (--tr.count; i<tr.count; ++i) {
+			tr.keys[i] = tr.keys[i+1];
+			tr.vals[i] = tr.vals[i+1];
+		}
+		store_tirec(&tr);
+	}
+	free_tirec(&tr);
+}
+/*=================================================
+ * tagindex_record_storing -- Note a record about to be
+ *  written (or deleted), so its old values can be removed
+ *  from indexes once it is
+ *===============================================*/
+void
+tagindex_record_storing (CNSTRING key)
+{
+	INT i;
+	strfree(&tioldkey);
+	if (tioldrec)
+		stdfree(tioldrec);
+	tioldrec = 0;
+	tioldlen = 0;
+	for (i=0; i<tidecount; ++i) {
+		if (record_applies(&tidecls[i], key))
+			break;
+	}
+	if (i == tidecount)
+		return;
+	tioldkey = strsave(key);
+	tioldrec = retrieve_raw_record(key, &tioldlen);
+}
+/*=================================================
+ * tagindex_record_stored -- Update indexes for a record
+ *  just written (or deleted)
+ *  key: [IN]  key of record stored
+ *  rec: [IN]  raw record bytes (NULL to reread from btree)
+ *  len: [IN]  length of rec
+ *===============================================*/
+void
+tagindex_record_stored (CNSTRING key, CNSTRING rec, INT len)
+{
+	TIVALUES oldv, newv;
+	STRING raw = 0;
+	RKEY rkey;
+	INT i, j;
+	if (!tioldkey || !eqstr(tioldkey, key))
+		return;
+	if (!rec) {
+		raw = retrieve_raw_record(key, &len);
+		rec = raw;
+	}
+	memset(&oldv, 0, sizeof(oldv));
+	memset(&newv, 0, sizeof(newv));
+	rkey = str2rkey(key);
+	for (i=0; i<tidecount; ++i) {
+		const TIDECL * decl = &tidecls[i];
+		if (!record_applies(decl, key))
+			continue;
+		collect_values(decl, tioldrec, tioldlen, &oldv);
+		collect_values(decl, rec, len, &newv);
+		for (j=0; j<oldv.count; ++j) {
+			if (!has_value(&newv, oldv.vals[j]))
+				remove_entry(decl, oldv.vals[j], rkey);
+		}
+		for (j=0; j<newv.count; ++j) {
+			if (!has_value(&oldv, newv.vals[j]))
+				add_entry(decl, newv.vals[j], rkey);
+		}
+		free_values(&oldv);
+		free_values(&newv);
+	}
+	if (oldv.vals)
+		stdfree(oldv.vals);
+	if (newv.vals)
+		stdfree(newv.vals);
+	if (raw)
+		stdfree(raw);
+	strfree(&tioldkey);
+	if (tioldrec)
+		stdfree(tioldrec);
+	tioldrec = 0;
+	tioldlen = 0;
+}
+/*=================================================
+ * build_record -- Collect values of one record, for a
+ *  new index (btree traversal)
+ *===============================================*/
+static BOOLEAN
+build_record (RKEY rkey, STRING data, INT len, void * param)
+{
+	TIBUILD * tb = (TIBUILD *)param;
+	char key[MAXKEYWIDTH+1];
+	INT i;
+	strcpy(key, rkey2str(rkey));
+	if (!record_applies(tb->decl, key))
+		return TRUE;
+	collect_values(tb->decl, data, len, &tb->tiv);
+	for (i=0; i<tb->tiv.count; ++i) {
+		TIENTRY * tie;
+		if (tb->count == tb->max) {
+			TIENTRY * old = tb->list;
+			tb->max = tb->max ? 2*tb->max : 256;
+			tb->list = (TIENTRY *)stdalloc(tb->max * sizeof(TIENTRY));
+			if (old) {
+				memcpy(tb->list, old, tb->count * sizeof(TIENTRY));
+				stdfree(old);
+			}
+		}
+		tie = &tb->list[tb->count++];
+		bucket_rkey(tb->decl->slot, tb->tiv.vals[i], ' ', &tie->bucket);
+		tie->key = rkey;
+		tie->value = tb->tiv.vals[i];
+	}
+	/* values now belong to entries */
+	tb->tiv.count = 0;
+	return TRUE;
+}
+/*=================================================
+ * cmp_build_entries -- Order entries by index record & entry
+ *===============================================*/
+static int
+cmp_build_entries (const void * el1, const void * el2)
+{
+	const TIENTRY * tie1 = (const TIENTRY *)el1;
+	const TIENTRY * tie2 = (const TIENTRY *)el2;
+	INT rel = cmpkeys(&tie1->bucket, &tie2->bucket);
+	if (!rel)
+		rel = cmp_entry(tie1->value, &tie1->key, tie2->value, &tie2->key);
+	return rel;
+}
+/*=================================================
+ * tagindex_create -- Declare & build an index
+ *  tagpath:   [IN]  tags from level 0 down (eg, "INDI.OCCU")
+ *  extractor: [IN]  "value", "words" or "year" (NULL or ""
+ *                   for "value")
+ *  returns FALSE if database is read only, tag path or
+ *   extractor is invalid, or there are too many indexes
+ *  (TRUE if it is already declared, with same extractor)
+ *===============================================*/
+BOOLEAN
+tagindex_create (CNSTRING tagpath, CNSTRING extractor)
+{
+	char path[MAXPATHLEN], slot;
+	TIBUILD tb;
+	TIREC tr;
+	RKEY lo, hi;
+	INT ext, i, j;
+	if (!BTR || bwrite(BTR) <= 0)
+		return FALSE;
+	if (!tagpath || !rawscan_tagpath_isvalid(tagpath)
+		|| (ext = find_extractor(extractor)) < 0)
+		return FALSE;
+	if ((i = find_declaration(tagpath)) >= 0)
+		return tidecls[i].extractor == ext;
+	if (tidecount == TI_MAXINDEXES)
+		return FALSE;
+	/* first free slot */
+	for (slot = 'a'; slot <= 'z'; ++slot) {
+		for (i=0; i<tidecount && tidecls[i].slot != slot; ++i)
+			;
+		if (i == tidecount)
+			break;
+	}
+	normalize_tagpath(tagpath, path, sizeof(path));
+	tidecls[tidecount].slot = slot;
+	tidecls[tidecount].tagpath = strsave(path);
+	tidecls[tidecount].extractor = ext;
+	/* collect all entries, then write each index record once */
+	memset(&tb, 0, sizeof(tb));
+	tb.decl = &tidecls[tidecount];
+	lo.r_rkey[0] = hi.r_rkey[0] = 0;
+	traverse_leaf_records(BTR, lo, hi, NULL, &build_record, &tb);
+	if (tb.count)
+		qsort(tb.list, tb.count, sizeof(tb.list[0]), cmp_build_entries);
+	memset(&tr, 0, sizeof(tr));
+	for (i=0; i<tb.count; i=j) {
+		tr.count = 0;
+		tr.key = tb.list[i].bucket;
+		for (j=i; j<tb.count && rkey_eq(&tb.list[j].bucket, &tr.key); ++j) {
+			grow_tirec(&tr, tr.count + 1);
+			tr.keys[tr.count] = tb.list[j].key;
+			tr.vals[tr.count++] = tb.list[j].value;
+		}
+		store_tirec(&tr);
+	}
+	free_tirec(&tr);
+	for (i=0; i<tb.count; ++i)
+		stdfree(tb.list[i].value);
+	if (tb.list)
+		stdfree(tb.list);
+	if (tb.tiv.vals)
+		stdfree(tb.tiv.vals);
+	++tidecount;
+	store_declarations();
+	return TRUE;
+}
+/*=================================================
+ * collect_rkey -- Collect key of one index record
+ *  (btree traversal)
+ *===============================================*/
+static BOOLEAN
+collect_rkey (RKEY rkey, HINT_PARAM_UNUSED STRING data, INT len, void * param)
+{
+	TIREC * tr = (TIREC *)param;
+	if (len <= (INT)sizeof(INT32))
+		return TRUE;
+	grow_tirec(tr, tr->count + 1);
+	tr->keys[tr->count++] = rkey;
+	return TRUE;
+}
+/*=================================================
+ * tagindex_drop -- Remove an index
+ *  Its index records are emptied
+ *  returns FALSE if database is read only, or there
+ *   is no index on tag path
+ *===============================================*/
+BOOLEAN
+tagindex_drop (CNSTRING tagpath)
+{
+	TIREC keys, tr;
+	RKEY lo, hi;
+	INT i, j;
+	if (!BTR || bwrite(BTR) <= 0 || (i = find_declaration(tagpath)) < 0)
+		return FALSE;
+	memset(&keys, 0, sizeof(keys));
+	memset(&tr, 0, sizeof(tr));
+	bucket_rkey(tidecls[i].slot, "", 0x01, &lo);
+	bucket_rkey(tidecls[i].slot, "", 0xff, &hi);
+	/* collect keys of its records first, as traversal must not write */
+	traverse_leaf_records(BTR, lo, hi, NULL, &collect_rkey, &keys);
+	for (j=0; j<keys.count; ++j) {
+		tr.key = keys.keys[j];
+		store_tirec(&tr);
+	}
+	free_tirec(&keys);
+	strfree(&tidecls[i].tagpath);
+	for (--tidecount; i<tidecount; ++i)
+		tidecls[i] = tidecls[i+1];
+	store_declarations();
+	return TRUE;
+}
+/*=================================================
+ * report_entries -- Pass matching entries of index record
+ *  to caller's function
+ *  returns FALSE if caller stopped
+ *===============================================*/
+static BOOLEAN
+report_entries (TIREC * tr, TIQUERY * tq)
+{
+	char key[MAXKEYWIDTH+1];
+	INT32 i;
+	for (i=0; i<tr->count; ++i) {
+		if (tq->prefix ? !fold_prefix(tq->value, tr->vals[i])
+			: fold_cmp(tq->value, tr->vals[i]))
+			continue;
+		strcpy(key, rkey2str(tr->keys[i]));
+		if (!(*tq->func)(key, tr->vals[i], tq->param)) {
+			tq->stopped = TRUE;
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+/*=================================================
+ * query_record -- Report entries of one index record
+ *  (btree traversal)
+ *===============================================*/
+static BOOLEAN
+query_record (RKEY rkey, STRING data, INT len, void * param)
+{
+	TIQUERY * tq = (TIQUERY *)param;
+	TIREC tr;
+	BOOLEAN more;
+	memset(&tr, 0, sizeof(tr));
+	parse_tirec(&tr, rkey, data, len);
+	more = report_entries(&tr, tq);
+	free_tirec(&tr);
+	return more;
+}
+/*=================================================
+ * tagindex_find -- Find records by value in an index
+ *  tagpath: [IN]  tag path index was declared on
+ *  value:   [IN]  value wanted (ASCII case is ignored)
+ *  prefix:  [IN]  find values starting with value ?
+ *  func:    [IN]  called with each record & value found,
+ *                 in order of value; must not write to
+ *                 database
+ *  returns FALSE if there is no index on tag path
+ *===============================================*/
+BOOLEAN
+tagindex_find (CNSTRING tagpath, CNSTRING value, BOOLEAN prefix
+	, TAGINDEX_FUNC func, void * param)
+{
+	TIQUERY tq;
+	TIREC tr;
+	RKEY lo, hi;
+	INT i = find_declaration(tagpath);
+	if (i < 0)
+		return FALSE;
+	if (!value || (!value[0] && !prefix))
+		return TRUE;
+	tq.value = value;
+	tq.prefix = prefix;
+	tq.func = func;
+	tq.param = param;
+	tq.stopped = FALSE;
+	if (!prefix || (INT)strlen(value) >= TI_BUCKETLEN) {
+		/* all in one index record */
+		memset(&tr, 0, sizeof(tr));
+		bucket_rkey(tidecls[i].slot, value, ' ', &lo);
+		get_tirec(&tr, lo);
+		report_entries(&tr, &tq);
+		free_tirec(&tr);
+		return TRUE;
+	}
+	/* all index records starting with prefix */
+	bucket_rkey(tidecls[i].slot, value, 0x01, &lo);
+	bucket_rkey(tidecls[i].slot, value, 0xff, &hi);
+	traverse_leaf_records(BTR, lo, hi, NULL, &query_record, &tq);
+	return TRUE;
+}
@@ -75,6 +75,7 @@ enum { ZON_X, ZON_INT, ZON_GUI, ZON_EDI, ZON_RPT, ZON_GED, NUM_ZONES };
 /* alphabetical */
 static void clear_legacy_tt(INT trnum);
 static void clear_predefined_list(void);
+static TRANTABLE get_legacy_tt(XLAT xlat);
 static struct conversion_s * getconvert(INT trnum);
 static BOOLEAN is_legacy_first(INT trnum);
 static void local_init(void);
@@ -200,6 +201,9 @@ translate_string (XLAT ttm, CNSTRING in, STRING out, INT maxlen)
 		out[0] = 0;
 		return;
 	}
+	/* simple conversions can go straight into out */
+	if (!get_legacy_tt(ttm) && xl_do_xlat_buf(ttm, in, out, maxlen))
+		return;
 	zstr = translate_string_to_zstring(ttm, in);
 	llstrsets(out, maxlen, uu8, zs_str(zstr));
 	zs_free(&zstr);
@@ -307,6 +311,15 @@ transl_load_all_tts (void)
 	if (!inited) local_init();
 	xl_load_all_dyntts(ttpath);
 }
+/*==========================================================
+ * get_legacy_tt -- Get legacy table applied with translation, if any
+ *========================================================*/
+static TRANTABLE
+get_legacy_tt (XLAT xlat)
+{
+	INT index = xl_get_uparam(xlat)-1;
+	return index>=0 ? legacytts[index].tt : NULL;
+}
 /*==========================================================
  * transl_xlat -- Perform a translation on a string
  * Created: 2002/11/28 (Perry Rapp)
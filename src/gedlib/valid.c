@@ -110,9 +110,11 @@ valid_indi_tree (NODE indi1, STRING *pmsg, NODE orig)
 		get_refns(ukey, &num, &keys, 'I');
 		if (num > 1 || (num == 1 && (!orig ||
 			nestr(keys[0], rmvat(nxref(indi1)))))) {
+			free_refns(num, keys);
 			*pmsg = _(qSbadirefn);
 			goto bad1;
 		}
+		free_refns(num, keys);
 	}
 	if (orig)
 		join_indi(orig, name0, refn0, sex0, body0, famc0, fams0);
@@ -37,6 +37,7 @@ struct tag_xlat {
 	BOOLEAN adhoc;
 	BOOLEAN valid;
 	INT uparam; /* opaque number used by client */
+	ZSTR zbuf; /* scratch output of iconv steps */
 };
 /* dynamically loadable translation table, entry in dyntt list */
 struct tag_dyntt {
@@ -53,6 +54,8 @@ typedef struct tag_dyntt *DYNTT;
 typedef struct xlat_step_s {
 	STRING iconv_src;
 	STRING iconv_dest;
+	ICVT icvt; /* opened on first use */
+	BOOLEAN icvt_failed;
 	DYNTT dyntt;
 } *XLSTEP;
 
@@ -74,6 +77,7 @@ static void dyntt_destructor(VTABLE *obj);
 static void free_dyntts(void);
 static void free_xlat(XLAT xlat);
 static DYNTT get_conversion_dyntt(CNSTRING src, CNSTRING dest);
+static ICVT get_step_icvt(XLSTEP xstep);
 static DYNTT get_subcoding_dyntt(CNSTRING codeset, CNSTRING subcoding);
 static void load_dyntt_if_needed(DYNTT dyntt);
 static void load_dynttlist_from_dir(STRING dir);
@@ -150,9 +154,12 @@ free_xlat (XLAT xlat)
 		xstep = (XLSTEP)el;
 		strfree(&xstep->iconv_src);
 		strfree(&xstep->iconv_dest);
+		icvt_close(&xstep->icvt);
 		xstep->dyntt = 0; /* f_dyntts owns dyntt memory */
 	ENDLIST
 	destroy_list(xlat->steps);
+	if (xlat->zbuf)
+		zs_free(&xlat->zbuf);
 	strfree(&xlat->src);
 	strfree(&xlat->dest);
 	stdfree(xlat);
@@ -389,6 +396,20 @@ load_dyntt_if_needed (DYNTT dyntt)
 	}
 	zs_free(&zerr);
 }
+/*==========================================================
+ * get_step_icvt -- Get open iconv conversion of an iconv step
+ *  (opened on first use, & kept until xlat is freed)
+ *========================================================*/
+static ICVT
+get_step_icvt (XLSTEP xstep)
+{
+	if (!xstep->icvt && !xstep->icvt_failed) {
+		xstep->icvt = icvt_open(xstep->iconv_src, xstep->iconv_dest);
+		if (!xstep->icvt)
+			xstep->icvt_failed = TRUE;
+	}
+	return xstep->icvt;
+}
 /*==========================================================
  * xl_do_xlat -- Perform a translation on a string
  * Created: 2002/11/25 (Perry Rapp)
@@ -404,13 +425,18 @@ xl_do_xlat (XLAT xlat, ZSTR zstr)
 		xstep = (XLSTEP)el;
 		if (xstep->iconv_src) {
 			/* an iconv step */
-			ZSTR ztemp=zs_new();
-			if (iconv_trans(xstep->iconv_src, xstep->iconv_dest, zs_str(zstr), ztemp, '?')) {
+			ICVT icvt = get_step_icvt(xstep);
+			if (!icvt) {
+				/* iconv failed, anything to do ? */
+			} else if (icvt_is_noop(icvt, zs_str(zstr))) {
 				cvtd=TRUE;
-				zs_move(zstr, &ztemp);
 			} else {
-				zs_free(&ztemp);
-				/* iconv failed, anything to do ? */
+				if (!xlat->zbuf)
+					xlat->zbuf = zs_new();
+				if (icvt_trans(icvt, zs_str(zstr), xlat->zbuf, '?')) {
+					cvtd=TRUE;
+					zs_swap(zstr, xlat->zbuf);
+				}
 			}
 		} else if (xstep->dyntt) {
 			/* a custom translation table step */
@@ -420,6 +446,42 @@ xl_do_xlat (XLAT xlat, ZSTR zstr)
 	ENDLIST
 	return cvtd;
 }
+/*==========================================================
+ * xl_do_xlat_buf -- Perform a translation into caller's buffer
+ *  xlat:   [IN]  translation
+ *  in:     [IN]  string to translate
+ *  out:    [OUT] translated string (truncated if need be)
+ *  maxlen: [IN]  size of out buffer
+ * Only handles translations of at most one iconv step;
+ * returns FALSE (without touching out) for others,
+ * which must go through xl_do_xlat
+ *========================================================*/
+BOOLEAN
+xl_do_xlat_buf (XLAT xlat, CNSTRING in, STRING out, INT maxlen)
+{
+	XLSTEP xstep=0;
+	ICVT icvt=0;
+	size_t inleft, outleft;
+	if (!xlat || !xlat->valid || maxlen < 1)
+		return FALSE;
+	if (length_list(xlat->steps) > 1)
+		return FALSE;
+	if (length_list(xlat->steps) == 1) {
+		xstep = (XLSTEP)get_list_element(xlat->steps, 1, NULL);
+		if (!xstep->iconv_src || !(icvt = get_step_icvt(xstep)))
+			return FALSE;
+	}
+	if (!icvt || icvt_is_noop(icvt, in)) {
+		llstrsets(out, maxlen, uu8, in);
+		return TRUE;
+	}
+	inleft = strlen(in);
+	outleft = maxlen-1;
+	icvt_reset(icvt);
+	icvt_convert(icvt, &in, &inleft, &out, &outleft, '?', TRUE);
+	*out = 0;
+	return TRUE;
+}
 /*==========================================================
  * xl_load_all_dyntts -- Load internal list of available translation
  *  tables (based on *.tt files in TTPATH)
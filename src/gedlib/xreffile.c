@@ -110,6 +110,7 @@ static void readrecs(DELETESET set);
 static BOOLEAN readxrefs(void);
 static BOOLEAN xref_isvalid_impl(DELETESET set, INT32 keynum);
 static INT xref_last(DELETESET set);
+static void xrefs_changed(void);
 
 /*********************************************
  * local variables
@@ -124,6 +125,9 @@ static INT xrefsize=0; /* xref file size */
 
 static INT32 maxkeynum=-1; /* cache value of largest key extant (-1 means not sure) */
 
+static INT xrefbatch=0; /* depth of begin_xref_batch calls */
+static BOOLEAN xrefdirty=FALSE; /* sets changed during batch, file not yet written */
+
 /*********************************************
  * local & exported function definitions
  * body of module
@@ -377,6 +381,40 @@ writexrefs (void)
 	fflush(xreffp);
 	return TRUE;
 }
+/*================================
+ * xrefs_changed -- Write xrefs file after a change,
+ *  or note it is due if a batch is open
+ *==============================*/
+static void
+xrefs_changed (void)
+{
+	if (xrefbatch > 0)
+		xrefdirty = TRUE;
+	else
+		ASSERT(writexrefs());
+}
+/*================================
+ * begin_xref_batch -- Hold back writes of xrefs file
+ *  until matching end_xref_batch, so deleting many
+ *  records writes the file once
+ *==============================*/
+void
+begin_xref_batch (void)
+{
+	++xrefbatch;
+}
+/*================================
+ * end_xref_batch -- Write xrefs file if changed in batch
+ *==============================*/
+void
+end_xref_batch (void)
+{
+	ASSERT(xrefbatch > 0);
+	if (--xrefbatch == 0 && xrefdirty) {
+		xrefdirty = FALSE;
+		ASSERT(writexrefs());
+	}
+}
 /*================================
  * dumpxrefs -- Print xrefs to stdout
  *  storage order: IFESX
@@ -468,7 +506,7 @@ add_xref_to_set_impl (INT32 keynum, DELETESET set, DUPS dups)
 		add this to the list
 		*/
 		--set->recs[0];
-		ASSERT(writexrefs());
+		xrefs_changed();
 		return TRUE;
 	}
 	if (set->n >= set->max)
@@ -491,7 +529,7 @@ add_xref_to_set_impl (INT32 keynum, DELETESET set, DUPS dups)
 		(set->recs)[i+1] = (set->recs)[i];
 	(set->recs)[lo] = keynum;
 	(set->n)++;
-	ASSERT(writexrefs());
+	xrefs_changed();
 	maxkeynum=-1;
 	return TRUE;
 }
@@ -77,6 +77,16 @@ extern int has_key(int);
 extern size_t wcslen(const wchar_t *s);
 #endif /* HAVE_WCSLEN */
 
+/* *****************************************************************
+ * mk_wcwidth()           
+ * Markus Kuhn's wcwidth, always built (see arch/wcswidth.c)
+ * ***************************************************************** */
+
+extern int mk_wcwidth(wchar_t ucs);
+extern int mk_wcswidth(const wchar_t *pwcs, size_t n);
+extern int mk_wcwidth_cjk(wchar_t ucs);
+extern int mk_wcswidth_cjk(const wchar_t *pwcs, size_t n);
+
 /* *****************************************************************
  * getopt()           
  * ***************************************************************** */
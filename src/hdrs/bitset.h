@@ -0,0 +1,27 @@
+#ifndef bitset_h_included
+#define bitset_h_included
+
+/*=================================================
+ * BITSET -- Growable set of small non-negative integers
+ *  (eg, record key numbers)
+ *===============================================*/
+struct tag_bitset {
+	INT bs_max;        /* number of bits allocated */
+	INT bs_count;      /* number of bits set */
+	unsigned char *bs_data;
+};
+typedef struct tag_bitset *BITSET;
+
+#define BSMax(s)     ((s)->bs_max)
+#define BSCount(s)   ((s)->bs_count)
+#define BSData(s)    ((s)->bs_data)
+
+void bitset_clear(BITSET bs, INT i);
+void bitset_clear_all(BITSET bs);
+INT bitset_count(BITSET bs);
+BOOLEAN bitset_set(BITSET bs, INT i);
+BOOLEAN bitset_test(BITSET bs, INT i);
+BITSET create_bitset(INT size);
+void destroy_bitset(BITSET bs);
+
+#endif /* bitset_h_included */
@@ -211,6 +211,7 @@ typedef BOOLEAN(*TRAV_INDEX_FUNC)(BTREE, INDEX, void*);
 typedef BOOLEAN(*TRAV_BLOCK_FUNC)(BTREE, BLOCK, void*);
 
 typedef BOOLEAN(*TRAV_RECORD_FUNC_BYKEY)(RKEY, STRING, INT, void*);
+typedef BOOLEAN(*TRAV_LEAF_FUNC)(RKEY * lo, RKEY * hi, void*);
 #define TRAV_RECORD_FUNC_BYKEY_ARGS(a,b,c,d) RKEY a, STRING b, HINT_PARAM_UNUSED INT c, void* d
 
 /*====================================
@@ -244,9 +245,12 @@ INT cmpkeys(const RKEY * rk1, const RKEY * rk2);
 /* traverse.c */
 BOOLEAN traverse_index_blocks(BTREE, INDEX, void *, TRAV_INDEX_FUNC ifunc, TRAV_BLOCK_FUNC dfunc);
 void traverse_db_rec_rkeys(BTREE, RKEY lo, RKEY hi, TRAV_RECORD_FUNC_BYKEY func, void *param);
+void traverse_leaf_keys(BTREE, RKEY * keys, INT nkeys, TRAV_RECORD_FUNC_BYKEY func, void *param);
+void traverse_leaf_records(BTREE, RKEY lo, RKEY hi, TRAV_LEAF_FUNC leaffunc, TRAV_RECORD_FUNC_BYKEY func, void *param);
 
 /* utils.c */
 STRING rkey2str(RKEY);
+STRING rkey2str_r(RKEY, STRING);
 RKEY   str2rkey(CNSTRING);
 STRING fkey2path(FKEY);
 
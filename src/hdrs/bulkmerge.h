@@ -0,0 +1,16 @@
+/*=============================================================
+ * bulkmerge.h -- Merge many pairs of duplicate persons at once
+ *===========================================================*/
+
+#ifndef BULKMERGE_H_INCLUDED
+#define BULKMERGE_H_INCLUDED
+
+#include "standard.h"
+
+/* called with each line of the merge report */
+typedef void (*BULKMERGE_REPORT)(CNSTRING line, void * param);
+
+INT bulk_merge_indis(INT count, CNSTRING * drops, CNSTRING * keeps
+	, BOOLEAN dryrun, BULKMERGE_REPORT func, void * param);
+
+#endif /* BULKMERGE_H_INCLUDED */
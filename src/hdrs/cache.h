@@ -54,6 +54,8 @@ CACHEEL qkey_to_indi_cacheel(STRING);
 CACHEEL qkey_to_sour_cacheel(STRING);
 CACHEEL qkey_to_othr_cacheel(STRING);
 
+NODE prefetch_record(CNSTRING key);
+
 void lock_cache(CACHEEL);
 void unlock_cache(CACHEEL);
 
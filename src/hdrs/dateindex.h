@@ -0,0 +1,26 @@
+/*=============================================================
+ * dateindex.h -- Sortable date ranges of person & family events
+ *===========================================================*/
+
+#ifndef DATEINDEX_H_INCLUDED
+#define DATEINDEX_H_INCLUDED
+
+#include "standard.h"
+
+/* date keys are year*10000 + month*100 + day (negative years BC) */
+#define DATEKEY_MIN (-2147483647)
+#define DATEKEY_MAX 2147483647
+
+/* called with each event found, return FALSE to stop */
+typedef BOOLEAN (*DATEINDEX_FUNC)(char ntype, INT keynum, INT32 lo, INT32 hi
+	, void * param);
+
+void dateindex_close(void);
+BOOLEAN dateindex_date_range(CNSTRING date, INT32 * plo, INT32 * phi);
+void dateindex_find(CNSTRING tag, INT32 from, INT32 to
+	, DATEINDEX_FUNC func, void * param);
+void dateindex_open(void);
+void dateindex_record_stored(CNSTRING key, CNSTRING rec, INT len);
+BOOLEAN dateindex_tag_ok(CNSTRING tag);
+
+#endif /* DATEINDEX_H_INCLUDED */
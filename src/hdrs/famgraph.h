@@ -0,0 +1,30 @@
+/*=============================================================
+ * famgraph.h -- Compact family graph (FAMC/FAMS/HUSB/WIFE/CHIL links)
+ *===========================================================*/
+
+#ifndef FAMGRAPH_H_INCLUDED
+#define FAMGRAPH_H_INCLUDED
+
+#include "standard.h"
+
+/* link lists held for a person */
+#define FGL_FAMC 0
+#define FGL_FAMS 1
+/* link lists held for a family */
+#define FGL_HUSB 0
+#define FGL_WIFE 1
+#define FGL_CHIL 2
+
+#define FGL_NUMLISTS 3
+
+BOOLEAN famgraph_fam_exists(INT fkeynum);
+INT famgraph_fam_links(INT fkeynum, INT list, const INT32 ** plinks);
+BOOLEAN famgraph_indi_exists(INT ikeynum);
+INT famgraph_indi_links(INT ikeynum, INT list, const INT32 ** plinks);
+void famgraph_close(void);
+BOOLEAN famgraph_index_loaded(void);
+BOOLEAN famgraph_index_matches(CNSTRING key, CNSTRING rec, INT len);
+void famgraph_open(void);
+void famgraph_record_stored(CNSTRING key, CNSTRING rec, INT len);
+
+#endif /* FAMGRAPH_H_INCLUDED */
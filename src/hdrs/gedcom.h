@@ -250,6 +250,7 @@ NODE copy_nodes(NODE node, BOOLEAN kids, BOOLEAN sibs);
 BOOLEAN create_database(STRING dbused, INT *lldberr);
 NODE create_node(STRING, STRING, STRING, NODE);
 NODE create_temp_node(STRING, STRING, STRING, NODE);
+INT database_version(void);
 void delete_metarec(STRING key);
 void dumpxrefs(void);
 BOOLEAN edit_mapping(INT);
@@ -293,12 +294,12 @@ STRING get_original_locale_collate(void);
 STRING get_original_locale_msgs(void);
 STRING get_property(STRING opt);
 void get_refns(STRING, INT*, STRING**, INT);
+void free_refns(INT num, STRING *keys);
 STRING getexref(void);
 STRING getfxref(void);
 INT32 getixrefnum(void);
 STRING getsxref(void);
 STRING getxxref(void);
-BOOLEAN getrefnrec(CNSTRING refn);
 void growexrefs(void);
 void growfxrefs(void);
 void growixrefs(void);
@@ -430,6 +431,8 @@ NODE qkeynum_to_indi(int keynum);
 INT record_letter(CNSTRING);
 void record_to_date_place(RECORD record, STRING tag, STRING * date, STRING * plac, INT * count);
 NODE record_to_first_event(RECORD record, CNSTRING tag);
+INT record_version(CNSTRING key);
+void record_versions_reset(void);
 NODE refn_to_record(STRING, INT);
 void register_uicodeset_callback(CALLBACK_FNC fncptr, VPTR uparm);
 void register_uilang_callback(CALLBACK_FNC fncptr, VPTR uparm);
@@ -460,6 +463,8 @@ void rptlocale(void);
 void save_original_locales(void);
 BOOLEAN save_tt_to_file(INT ttnum, STRING filename);
 void set_displaykeys(BOOLEAN);
+void set_node_val(NODE node, CNSTRING val);
+void set_node_xref(NODE node, CNSTRING xref);
 void set_temp_node(NODE, BOOLEAN temp);
 STRING shorten_plac(STRING);
 void show_node(NODE node);
@@ -478,6 +483,7 @@ void term_browse_lists(void);
 void term_namerec(void);
 void term_refnrec(void);
 BOOLEAN traverse_nodes(NODE node, BOOLEAN (*func)(NODE, VPTR), VPTR param);
+BOOLEAN traverse_refn_record(CNSTRING rkey, STRING data, TRAV_REFNS_FUNC func, void *param);
 void traverse_refns(TRAV_REFNS_FUNC func, void *param);
 INT tree_strlen(INT, NODE);
 void uilocale(void);
@@ -549,7 +555,10 @@ STRING manip_name(STRING name, SURCAPTYPE captype, SURORDER surorder, INT len);
 LIST name_to_list(CNSTRING name, INT *plen, INT *psind);
 STRING name_string(STRING);
 int namecmp(STRING, STRING);
+BOOLEAN namesortkey(CNSTRING name, ZSTR zkey);
+void rekey_names(LIST names, TABLE keymap);
 void remove_name(STRING name, CNSTRING key);
+BOOLEAN traverse_name_record(CNSTRING rkey, STRING data, TRAV_NAMES_FUNC func, void *param);
 void traverse_names(TRAV_NAMES_FUNC func, void *param);
 STRING trim_name(STRING, INT);
 
@@ -568,6 +577,8 @@ NODE fam_to_wife_node(NODE);
 NODE next_node_it_ptr(NODE_ITER nodeit);
 
 /* nodechk.c */
+void check_fam_lineage_links(NODE fam);
+void check_indi_lineage_links(NODE indi);
 void nodechk(NODE node, CNSTRING scope);
 void nodechk_enable(BOOLEAN enable);
 
@@ -587,15 +598,21 @@ LIST value_to_list (STRING str, INT *plen, STRING dlm);
 
 /* refns.c */
 void annotate_with_supplemental(NODE node, RFMT rfmt);
+void rekey_refns(LIST refns, TABLE keymap);
 
 /* soundex.c */
+#define SOUNDEX_BUFLEN 6
 CNSTRING trad_soundex(CNSTRING);
+CNSTRING trad_soundex_r(CNSTRING surname, STRING buf);
 INT soundex_count(void);
 CNSTRING soundex_get(INT i, CNSTRING name);
+CNSTRING soundex_get_r(INT i, CNSTRING name, STRING buf);
 
 /* xreffile.c */
 BOOLEAN addxref_if_missing (CNSTRING key);
+void begin_xref_batch(void);
 BOOLEAN delete_xref_if_present(CNSTRING key);
+void end_xref_batch(void);
 BOOLEAN is_key_in_use(CNSTRING key);
 INT xref_firste(void);
 INT xref_firstf(void);
@@ -13,8 +13,18 @@
 #ifndef ICVT_H_INCLUDED
 #define ICVT_H_INCLUDED 1
 
+/* conversion kept open between strings */
+typedef struct tag_icvt * ICVT;
+
 BOOLEAN iconv_trans(CNSTRING src, CNSTRING dest, CNSTRING sin, ZSTR zout, char illegal);
 BOOLEAN iconv_can_trans(CNSTRING src, CNSTRING dest);
+void icvt_close(ICVT * picvt);
+BOOLEAN icvt_convert(ICVT icvt, CNSTRING * pin, size_t * pinleft
+	, STRING * pout, size_t * poutleft, char illegal, BOOLEAN last);
+BOOLEAN icvt_is_noop(ICVT icvt, CNSTRING sin);
+ICVT icvt_open(CNSTRING src, CNSTRING dest);
+void icvt_reset(ICVT icvt);
+BOOLEAN icvt_trans(ICVT icvt, CNSTRING sin, ZSTR zout, char illegal);
 void init_win32_iconv_shim(CNSTRING dllpath);
 
 #endif /* ICVT_H_INCLUDED */
@@ -0,0 +1,95 @@
+/*=============================================================
+ * idxfile.h -- Index files kept beside a database
+ *  (shared by famgraph, dateindex & placeindex)
+ *===========================================================*/
+
+#ifndef IDXFILE_H_INCLUDED
+#define IDXFILE_H_INCLUDED
+
+#include "standard.h"
+#include "bitset.h"
+
+/*
+ Every index file is an array of native INT32, starting with a
+ header whose first IXH_COMMON words are these; an index keeps
+ its own header words after them. The maxima must match the
+ xrefs file, and the stamp that of the database, and the state
+ is set to IX_DIRTY as soon as any record is changed, so a crash
+ leaves an index that is ignored (and rebuilt) next time.
+*/
+enum { IXH_MAGIC, IXH_VERSION, IXH_STATE, IXH_IMAX, IXH_FMAX
+	, IXH_KEYID, IXH_FKEY, IXH_COMMON };
+#define IX_CLEAN   0
+#define IX_DIRTY   1
+
+/* longest event tag indexed (eg, "BIRT"; not "_MILT") */
+#define IDXFILE_MAXTAG 4
+
+/* one index file of the open database */
+struct tag_idxfile {
+	CNSTRING name;       /* file name in database directory */
+	INT32 magic;
+	INT32 version;
+	INT hdrsize;         /* header words, at least IXH_COMMON */
+	STRING path;         /* set while database is open */
+	INT32 * base;        /* contents of file, if loaded */
+	INT32 words;         /* size of base, in INT32 */
+	BOOLEAN mapped;      /* base is mmap'd (else stdalloc'd) */
+	BOOLEAN writable;
+	BOOLEAN dirty;       /* records changed since open */
+};
+typedef struct tag_idxfile * IDXFILE;
+
+/* writes the new file, whose common header words are filled in */
+typedef BOOLEAN (*IDXFILE_WRITE)(FILE * fp, INT32 * header);
+
+/*
+ Entries of person & family events, as held by dateindex &
+ placeindex: IDXENTRY_WORDS INT32 each, one of which (recword)
+ is the record's key number times two, plus one for a family.
+ The entries are sorted, and come from the index file or are
+ built from the records. Records stored since then have their
+ entries in newlist, and older entries of theirs are skipped.
+*/
+#define IDXENTRY_WORDS 4
+
+/* growable array of entries */
+struct tag_idxlist {
+	INT32 * words;
+	INT count;           /* entries, not words */
+	INT max;
+};
+
+/* adds entries of one (live) record to list */
+typedef void (*IDXENTRY_PARSE)(INT32 rec, CNSTRING raw, INT len
+	, struct tag_idxlist * list);
+
+struct tag_idxentries {
+	struct tag_idxfile file;
+	INT recword;         /* which word of an entry is its record */
+	IDXENTRY_PARSE parse;
+	int (*cmp)(const void * el1, const void * el2);
+	const INT32 * entries; /* sorted, from file or built */
+	INT count;
+	BOOLEAN loaded;      /* entries are in use */
+	BOOLEAN built;       /* entries were built from records */
+	BITSET changed;      /* recs stored since entries were loaded */
+	struct tag_idxlist newlist; /* entries of those recs */
+};
+typedef struct tag_idxentries * IDXENTRIES;
+
+void idxfile_add_entry(struct tag_idxlist * list, const INT32 * entry);
+void idxfile_build_entries(IDXENTRIES ie);
+void idxfile_close(IDXFILE idx, BOOLEAN replace);
+BOOLEAN idxfile_entry_changed(IDXENTRIES ie, const INT32 * entry);
+void idxfile_free_entries(IDXENTRIES ie);
+void idxfile_mark_dirty(IDXFILE idx);
+void idxfile_merge_entries(IDXENTRIES ie, struct tag_idxlist * all);
+BOOLEAN idxfile_open(IDXFILE idx);
+INT32 idxfile_pack_tag(CNSTRING tag, INT taglen);
+INT32 idxfile_rec_code(CNSTRING key);
+void idxfile_record_stored(IDXENTRIES ie, CNSTRING key, CNSTRING rec, INT len);
+void idxfile_unload(IDXFILE idx);
+BOOLEAN idxfile_write(IDXFILE idx, IDXFILE_WRITE func);
+
+#endif /* IDXFILE_H_INCLUDED */
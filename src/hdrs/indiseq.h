@@ -83,6 +83,24 @@ typedef struct tag_indiseq_value_fnctable
 } * INDISEQ_VALUE_FNCTABLE;
 
 
+/*
+	visitor for ancestor_indiseq & descendent_indiseq, called
+	for each person as it is added (gen is its generation);
+	returning FALSE stops the closure after that person
+*/
+typedef BOOLEAN (*SEQ_CLOSURE_VISIT_FNC)(CNSTRING key, INT gen, VPTR param);
+
+/* outcome of relation_path_indiseq */
+enum { RELPATH_FOUND, RELPATH_UNRELATED, RELPATH_BUDGET };
+
+/*====================
+ * indiseq print types
+ *==================*/
+#define ISPRN_NORMALSEQ 0
+#define ISPRN_FAMSEQ 1
+#define ISPRN_SPOUSESEQ 2
+#define ISPRN_RELPATHSEQ 3 /* svals are relation to previous person */
+
 /*=================================================
  * INDISEQ -- Data type for an entire indi sequence
  *===============================================*/
@@ -96,6 +114,8 @@ struct tag_indiseq {
 	INT is_valtype;    /* int, string, pointer */
 	STRING is_locale;  /* used by namesort */
 	INDISEQ_VALUE_FNCTABLE is_valfnctbl;
+	INT is_prncount;   /* print lines formatted on demand & kept */
+	INT is_prnclock;   /* last use stamp of those print lines */
 };
 #ifndef INDISEQ_type_defined
 typedef struct tag_indiseq *INDISEQ;
@@ -111,6 +131,8 @@ typedef struct tag_indiseq *INDISEQ;
 #define IValtype(s)  ((s)->is_valtype)
 #define ILocale(s)   ((s)->is_locale)
 #define IValfnctbl(s) ((s)->is_valfnctbl)
+#define IPrncount(s) ((s)->is_prncount)
+#define IPrnclock(s) ((s)->is_prnclock)
 
 #define KEYSORT       (1<<0)
 #define NAMESORT      (1<<1)
@@ -128,7 +150,7 @@ typedef struct tag_indiseq *INDISEQ;
 
 void add_browse_list(STRING, INDISEQ);
 void addref_indiseq(INDISEQ seq);
-INDISEQ ancestor_indiseq(INDISEQ seq);
+INDISEQ ancestor_indiseq(INDISEQ seq, INT maxgen, SEQ_CLOSURE_VISIT_FNC visit, VPTR param);
 void append_indiseq_null(INDISEQ, STRING key, CNSTRING name, BOOLEAN sure, BOOLEAN alloc);
 void append_indiseq_ival(INDISEQ, STRING key, STRING name, INT val, BOOLEAN sure, BOOLEAN alloc);
 void append_indiseq_pval(INDISEQ, STRING key, STRING name, VPTR val, BOOLEAN sure);
@@ -146,7 +168,7 @@ void default_delete_value(UNION uval, INT valtype);
 UNION default_create_gen_value(INT gen, INT * valtype);
 INT default_compare_values(VPTR ptr1, VPTR ptr2, INT valtype);
 BOOLEAN delete_indiseq(INDISEQ, STRING, STRING, INT);
-INDISEQ descendent_indiseq(INDISEQ seq);
+INDISEQ descendent_indiseq(INDISEQ seq, INT maxgen, SEQ_CLOSURE_VISIT_FNC visit, VPTR param);
 INDISEQ difference_indiseq(INDISEQ, INDISEQ);
 INT element_ikey(SORTEL el);
 BOOLEAN element_indiseq(INDISEQ seq, INT index, STRING *pkey, STRING *pname);
@@ -156,6 +178,7 @@ CNSTRING element_name(SORTEL el);
 VPTR element_pval(SORTEL el);
 CNSTRING element_skey(SORTEL el);
 CNSTRING element_sval(SORTEL el);
+INDISEQ event_date_indiseq(CNSTRING tag, INT32 from, INT32 to);
 INDISEQ fam_to_children(NODE);
 INDISEQ fam_to_fathers(NODE);
 INDISEQ fam_to_mothers(NODE);
@@ -178,6 +201,7 @@ INDISEQ intersect_indiseq(INDISEQ, INDISEQ);
 INDISEQ key_to_indiseq(STRING name, char ctype);
 void keysort_indiseq(INDISEQ);
 INDISEQ name_to_indiseq(STRING);
+void merge_sort(SORTEL *data, INT len, ELCMPFNC cmp, VPTR param, BOOLEAN parallel);
 void namesort_indiseq(INDISEQ);
 void new_write_node(INT, NODE, BOOLEAN);
 INDISEQ node_to_notes(NODE);
@@ -185,9 +209,12 @@ INDISEQ node_to_pointers(NODE node);
 INDISEQ node_to_sources(NODE);
 INDISEQ parent_indiseq(INDISEQ);
 void partition_sort(SORTEL*, INT, ELCMPFNC func, VPTR param);
+INDISEQ place_indiseq(CNSTRING place, CNSTRING tag);
 void preprint_indiseq(INDISEQ, INT len, RFMT rfmt);
+BOOLEAN preprint_indiseq_element(INDISEQ seq, INT i, INT len, RFMT rfmt);
 void print_indiseq_element (INDISEQ seq, INT i, STRING buf, INT len, RFMT rfmt);
 INDISEQ refn_to_indiseq(STRING, INT letr, INT sort);
+INDISEQ relation_path_indiseq(CNSTRING key1, CNSTRING key2, INT maxnodes, INT maxmsecs, INT * pstatus);
 void remove_browse_list(STRING, INDISEQ);
 void remove_indiseq(INDISEQ);
 void rename_indiseq(INDISEQ, STRING);
@@ -196,6 +223,7 @@ void set_indiseq_value_funcs(INDISEQ seq, INDISEQ_VALUE_FNCTABLE valfnctbl);
 INDISEQ sibling_indiseq(INDISEQ, BOOLEAN);
 INDISEQ spouse_indiseq(INDISEQ);
 INDISEQ str_to_indiseq(STRING name, char ctype);
+void term_relation_path(void);
 void unique_indiseq(INDISEQ);
 INDISEQ union_indiseq(INDISEQ one, INDISEQ two);
 void update_browse_list(STRING, INDISEQ);
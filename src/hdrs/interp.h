@@ -35,11 +35,12 @@
 #define _INTERP_H
 
 void poutput(STRING, BOOLEAN *eflg);
-void interp_main(LIST lifiles, STRING ofile, BOOLEAN picklist, BOOLEAN timing);
+BOOLEAN interp_main(LIST lifiles, STRING ofile, BOOLEAN picklist, BOOLEAN timing);
 void init_interpreter(void);
 void shutdown_interpreter(void);
 ZSTR get_report_error_msg (STRING msg);
 
 extern BOOLEAN prog_trace;
+extern BOOLEAN rpt_append_output;
 
 #endif /* _INTERP_H */
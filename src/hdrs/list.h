@@ -6,25 +6,14 @@
    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 /*=============================================================
- * list.h -- Declare doubly-linked list type
+ * list.h -- Declare list type
  * Copyright(c) 1991-95 by T.T. Wetmore IV; all rights reserved
+ *  Lists are double-ended queues, held in ring buffers, so
+ *  both ends and indexed elements are reached in constant time
  *===========================================================*/
 #ifndef list_h_included
 #define list_h_included
 
-/* node in list */
-typedef struct tag_lnode *LNODE;
-struct tag_lnode {
-	LNODE l_prev;
-	LNODE l_next;
-	VPTR l_element;
-	int l_locks;
-};
-#define lprev(n)    ((n)->l_prev)
-#define lnext(n)    ((n)->l_next)
-#define lelement(n) ((n)->l_element)
-#define llocks(n)   ((n)->l_locks)
-
 /* a LIST is an OBJECT */
 typedef struct tag_list *LIST;
 
@@ -40,32 +29,34 @@ typedef void (*ELEMENT_DESTRUCTOR)(VPTR);
 /* for caller-defined function to create new values */
 typedef VPTR (*LIST_CREATE_VALUE)(LIST);
 
-/* cycle through list from tail to head */
+/* cycle through list from tail to head
+ (elements are reached by position, so elements added at
+ the head during the loop are reached too) */
 #define FORLIST(l,e)\
 	{\
-		LNODE _lnode = trav_list_tail(l);\
+		LIST _list = (l);\
+		INT _lpos = trav_list_tail(_list);\
 		VPTR e;\
-		while (_lnode) {\
-			e = _lnode->l_element;\
-			lock_list_node(_lnode);
+		while (trav_list_element(_list, _lpos, &e)) {\
+			lock_list_element(_list, _lpos);
 #define ENDLIST\
-			unlock_list_node(_lnode);\
-			_lnode = _lnode->l_prev;\
+			unlock_list_element(_list, _lpos);\
+			--_lpos;\
 		}\
 	}
 #define STOPLIST\
-			unlock_list_node(_lnode);\
-			_lnode = 0;
+			unlock_list_element(_list, _lpos);\
+			_list = 0;
 
 /* cycle through list from head to tail */
 #define FORXLIST(l,e)\
 	{\
-		LNODE _lnode = trav_list_head(l);\
+		LIST _list = (l);\
+		INT _lpos = trav_list_head(_list);\
 		VPTR e;\
-		while (_lnode) {\
-			e = _lnode->l_element;
+		while (trav_list_element(_list, _lpos, &e)) {
 #define ENDXLIST\
-			_lnode = _lnode->l_next;\
+			++_lpos;\
 		}\
 	}
 
@@ -105,10 +96,11 @@ void end_list_iter(LIST_ITER * plistit);
 BOOLEAN next_list_ptr(LIST_ITER listit, VPTR *pptr);
 
 /* list macro support functions */
-void lock_list_node(LNODE node);
-LNODE trav_list_head(LIST list);
-LNODE trav_list_tail(LIST list);
-void unlock_list_node(LNODE node);
+void lock_list_element(LIST list, INT pos);
+BOOLEAN trav_list_element(LIST list, INT pos, VPTR *pptr);
+INT trav_list_head(LIST list);
+INT trav_list_tail(LIST list);
+void unlock_list_element(LIST list, INT pos);
 
 
 
@@ -107,6 +107,9 @@ void remove_listeners(LIST * notifiees);
 void get_current_lldate(LLDATE * creation);
 
 /* llstrcmp.c */
+BOOLEAN ll_sortkey(CNSTRING str, ZSTR zkey);
+int ll_sortkeycmp(CNSTRING key1, INT len1, CNSTRING key2, INT len2);
+void ll_sortkey_num(ZSTR zkey, INT num);
 int ll_strcmploc(const char*, const char*);
 CNSTRING ll_what_collation(void);
 int ll_strncmp(const char*, const char*, int);
@@ -224,6 +227,14 @@ size_t str8chlen(CNSTRING str);
 void unicode_to_utf8(INT wch, char * utf8);
 INT utf8len(char ch);
 
+/* utf8scan.c */
+size_t ascii_span(CNSTRING str, size_t len);
+BOOLEAN check_file_utf8(FILE * fp, BOOLEAN * pascii, INT * pline);
+size_t utf8_chars(CNSTRING str, size_t len);
+size_t utf8_fit_width(CNSTRING str, size_t len, size_t cols);
+size_t utf8_valid_span(CNSTRING str, size_t len);
+size_t utf8_width(CNSTRING str, size_t len);
+
 /* strwhite.c */
 BOOLEAN allwhite(STRING);
 void chomp(STRING);
@@ -175,6 +175,7 @@ enum {
 	, CMD_VHISTORY_BACK, CMD_VHISTORY_FWD, CMD_VHISTORY_LIST, CMD_VHISTORY_CLEAR
 	, CMD_CHISTORY_BACK, CMD_CHISTORY_FWD, CMD_CHISTORY_LIST, CMD_CHISTORY_CLEAR
 	, CMD_ADD_SOUR, CMD_ADD_EVEN, CMD_ADD_OTHR
+	, CMD_RELATION_PATH
 	/* for hardware keys */
 	, CMD_KY_UP=500, CMD_KY_DN
 	, CMD_KY_SHPGUP, CMD_KY_SHPGDN, CMD_KY_PGUP, CMD_KY_PGDN
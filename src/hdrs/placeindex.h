@@ -0,0 +1,26 @@
+/*=============================================================
+ * placeindex.h -- Place hierarchy of person & family events
+ *===========================================================*/
+
+#ifndef PLACEINDEX_H_INCLUDED
+#define PLACEINDEX_H_INCLUDED
+
+#include "standard.h"
+
+/* called with each event found, return FALSE to stop
+ place is the event's own place (see placeindex_place_name) */
+typedef BOOLEAN (*PLACEINDEX_FUNC)(char ntype, INT keynum, INT32 place
+	, void * param);
+/* called with each place found, return FALSE to stop */
+typedef BOOLEAN (*PLACEINDEX_PLACE_FUNC)(INT32 place, void * param);
+
+void placeindex_close(void);
+void placeindex_find(CNSTRING place, CNSTRING tag
+	, PLACEINDEX_FUNC func, void * param);
+void placeindex_open(void);
+ZSTR placeindex_place_name(INT32 place);
+void placeindex_record_stored(CNSTRING key, CNSTRING rec, INT len);
+void placeindex_subplaces(CNSTRING place
+	, PLACEINDEX_PLACE_FUNC func, void * param);
+
+#endif /* PLACEINDEX_H_INCLUDED */
@@ -0,0 +1,27 @@
+/*=============================================================
+ * rawscan.h -- Scan raw records of database for tag values
+ *===========================================================*/
+
+#ifndef RAWSCAN_H_INCLUDED
+#define RAWSCAN_H_INCLUDED
+
+#include "standard.h"
+
+/* compiled pattern (fpattern syntax) */
+typedef struct tag_scanpattern * SCANPATTERN;
+
+/* called with key of each matching record, return FALSE to stop */
+typedef BOOLEAN (*RAWSCAN_FUNC)(CNSTRING key, void * param);
+/* called with each value (not NUL terminated), return FALSE to stop */
+typedef BOOLEAN (*RAWSCAN_VALUE_FUNC)(CNSTRING val, INT len, void * param);
+
+SCANPATTERN create_scan_pattern(CNSTRING pattern);
+void destroy_scan_pattern(SCANPATTERN scanpat);
+void rawscan_records(CNSTRING rtypes, CNSTRING tagpath, BOOLEAN conts
+	, SCANPATTERN scanpat, RAWSCAN_FUNC func, void * param);
+BOOLEAN rawscan_tagpath_isvalid(CNSTRING tagpath);
+void rawscan_values(CNSTRING tagpath, CNSTRING data, INT len
+	, RAWSCAN_VALUE_FUNC func, void * param);
+BOOLEAN scan_pattern_match(SCANPATTERN scanpat, CNSTRING text);
+
+#endif /* RAWSCAN_H_INCLUDED */
@@ -0,0 +1,15 @@
+/*=============================================================
+ * reccache.h -- Raw record cache shared by read-only processes
+ *===========================================================*/
+
+#ifndef RECCACHE_H_INCLUDED
+#define RECCACHE_H_INCLUDED
+
+#include "standard.h"
+
+void reccache_close(void);
+STRING reccache_get(CNSTRING key, INT *plen);
+void reccache_open(void);
+void reccache_put(CNSTRING key, CNSTRING rec, INT len);
+
+#endif /* RECCACHE_H_INCLUDED */
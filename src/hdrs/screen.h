@@ -98,6 +98,8 @@ typedef struct tag_uiwindow {
 	INT cols;
 	INT cur_y;         /* row for input cursor */
 	INT cur_x;         /* col for input cursor */
+	struct tag_uirow * rowimg; /* what show_row last put on each row */
+	INT rowimg_len;
 } * UIWINDOW;
 #define uiw_win(x)      ((x)->win)
 #define uiw_boxwin(x)   ((x)->boxwin)
@@ -193,6 +195,7 @@ void show_indi(UIWINDOW uiwin, RECORD indi, INT mode, LLRECT
 void show_indi_vitals(UIWINDOW uiwin, RECORD irec, LLRECT, INT *scroll, BOOLEAN reuse);
 BOOLEAN show_record(UIWINDOW uiwin, STRING key, INT mode, LLRECT
 	, INT * scroll, BOOLEAN reuse);
+void show_row(UIWINDOW uiwin, INT row, INT x1, INT x2, CNSTRING text, INT maxlen);
 void show_vert_line(UIWINDOW, INT, INT, INT);
 void term_screen(void);
 void toggle_browse_menu(void);
@@ -0,0 +1,24 @@
+/*=============================================================
+ * tagindex.h -- Secondary indexes of values on tag paths
+ *===========================================================*/
+
+#ifndef TAGINDEX_H_INCLUDED
+#define TAGINDEX_H_INCLUDED
+
+#include "standard.h"
+
+/* called with each record found, return FALSE to stop */
+typedef BOOLEAN (*TAGINDEX_FUNC)(CNSTRING key, CNSTRING value, void * param);
+
+void tagindex_close(void);
+BOOLEAN tagindex_create(CNSTRING tagpath, CNSTRING extractor);
+CNSTRING tagindex_declared(INT i, CNSTRING * pextractor);
+BOOLEAN tagindex_drop(CNSTRING tagpath);
+CNSTRING tagindex_extractor(CNSTRING tagpath);
+BOOLEAN tagindex_find(CNSTRING tagpath, CNSTRING value, BOOLEAN prefix
+	, TAGINDEX_FUNC func, void * param);
+void tagindex_open(void);
+void tagindex_record_stored(CNSTRING key, CNSTRING rec, INT len);
+void tagindex_record_storing(CNSTRING key);
+
+#endif /* TAGINDEX_H_INCLUDED */
@@ -16,6 +16,7 @@
 
 /* xlat.c */
 BOOLEAN xl_do_xlat(XLAT xlat, ZSTR zstr);
+BOOLEAN xl_do_xlat_buf(XLAT xlat, CNSTRING in, STRING out, INT maxlen);
 void xl_free_adhoc_xlats(void);
 void xl_free_xlats(void);
 ZSTR xlat_get_description(XLAT xlat);
@@ -40,6 +40,7 @@
 #include "feedback.h"
 #include "lloptions.h"
 #include "date.h"
+#include "dateindex.h"
 #include "zstr.h"
 #include "codesets.h"
 #include "arch.h"
@@ -2658,6 +2659,37 @@ llrpt_date2jd (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 	*eflg = FALSE;
 	return create_pvalue_from_float(jd);
 }
+/*==========================================+
+ * llrpt_datekey -- Return sortable key of date
+ * usage: datekey(EVENT) -> INT
+ *        datekey(STRING) -> INT
+ *  key is year*10000 + month*100 + day, as kept by the
+ *  date index (negative years BC; unknown month & day
+ *  taken as early as possible); 0 if date has no year
+ * =========================================*/
+PVALUE
+llrpt_datekey (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	STRING str=0;
+	INT32 lo=0, hi=0;
+	PNODE argvar = builtin_args(node);
+	PVALUE val = eval_without_coerce(argvar, stab, eflg);
+	if (val && which_pvalue_type(val) == PSTRING) {
+		str = pvalue_to_string(val);
+	} else {
+		coerce_pvalue(PGNODE, val, eflg);
+		if (*eflg) {
+			prog_error(node, nonnodstr1, "datekey");
+			return NULL;
+		}
+		str = event_to_date(pvalue_to_node(val), FALSE);
+	}
+	if (!dateindex_date_range(str, &lo, &hi))
+		lo = 0;
+	delete_pvalue(val);
+	*eflg = FALSE;
+	return create_pvalue_from_int(lo);
+}
 /*=============================================+
  * llrpt_dayofweek -- Return day of week
  * usage: dayofweek(EVENT) -> STRING
@@ -50,7 +50,7 @@ BUILTINS builtins[] = {
 	{"addnode",         3,    3,    llrpt_addnode},
 	{"addtoset",        3,    3,    llrpt_addtoset},
 	{"alpha",           1,    1,    llrpt_alpha},
-	{"ancestorset",     1,    1,    llrpt_ancestorset},
+	{"ancestorset",     1,    2,    llrpt_ancestorset},
 	{"and",             2,    32,   llrpt_and},
 	{"arccos",          1,    1,    llrpt_arccos},
 	{"arcsin",          1,    1,    llrpt_arcsin},
@@ -78,12 +78,14 @@ BUILTINS builtins[] = {
 	{"convertcode",     2,    3,    llrpt_convertcode}, 
 	{"copyfile",        1,    1,    llrpt_copyfile},
 	{"cos",             1,    1,    llrpt_cos},
+	{"createindex",     1,    2,    llrpt_createindex},
 	{"createnode",      2,    2,    llrpt_createnode},
 	{"d",               1,    1,    llrpt_d},
 	{"database",        0,    1,    llrpt_database},
 	{"date",            1,    1,    llrpt_date},
 	{"date2jd",         1,    1,    llrpt_date2jd},
 	{"dateformat",      1,    1,    llrpt_dateformat},
+	{"datekey",         1,    1,    llrpt_datekey},
 	{"datepic",         1,    1,    llrpt_datepic },
 	{"dayformat",       1,    1,    llrpt_dayformat},
 	{"dayofweek",       1,    1,    llrpt_dayofweek},
@@ -95,18 +97,20 @@ BUILTINS builtins[] = {
 	{"deletenode",      1,    1,    llrpt_detachnode},
 	{"dequeue",         1,    1,    llrpt_dequeue},
 	{"dereference",     1,    1,    llrpt_dereference},
-	{"descendantset",   1,    1,    llrpt_descendentset},
-	{"descendentset",   1,    1,    llrpt_descendentset},
+	{"descendantset",   1,    2,    llrpt_descendentset},
+	{"descendentset",   1,    2,    llrpt_descendentset},
 	{"detachnode",      1,    1,    llrpt_detachnode},
 	{"difference",      2,    2,    llrpt_difference},
 	{"div",             2,    2,    llrpt_div},
 	{"dms2deg",         4,    4,    llrpt_dms2deg},
+	{"dropindex",       1,    1,    llrpt_dropindex},
 	{"dup",             1,    1,    llrpt_dup},
 	{"empty",           1,    1,    llrpt_empty},
 	{"enqueue",         2,    2,    llrpt_enqueue},
 	{"eq",              2,    2,    llrpt_eq},
 	{"eqstr",           2,    2,    llrpt_eqstr},
 	{"eraformat",       1,    1,   	llrpt_eraformat},
+	{"eventset",        3,    3,    llrpt_eventset},
 	{"exp",             2,    2,    llrpt_exp},
 	{"extractdate",     4,    4,    llrpt_extractdate},
 	{"extractdatestr",  5,    6,    llrpt_extractdatestr},
@@ -148,6 +152,7 @@ BUILTINS builtins[] = {
 	{"husband",         1,    1,    llrpt_husband},
 	{"incr",            1,    2,    llrpt_incr},
 	{"index",           3,    3,    llrpt_index},
+	{"indexkeys",       2,    3,    llrpt_indexkeys},
 	{"indi",            1,    1,    llrpt_indi},
 	{"indiset",         1,    1,    llrpt_indiset},
 	{"inlist",          2,    2,    llrpt_inlist},
@@ -176,6 +181,7 @@ BUILTINS builtins[] = {
 	{"male",            1,    1,    llrpt_male},
 	{"marriage",        1,    1,    llrpt_marr},
 	{"menuchoose",      1,    2,    llrpt_menuchoose},
+	{"mergeindis",      3,    4,    llrpt_mergeindis},
 	{"mod",             2,    2,    llrpt_mod},
 	{"monthformat",     1,    1,    llrpt_monthformat},
 	{"mother",          1,    1,    llrpt_moth},
@@ -203,6 +209,7 @@ BUILTINS builtins[] = {
 	{"parents",         1,    1,    llrpt_parents},
 	{"parentset",       1,    1,    llrpt_parentset},
 	{"place",           1,    1,    llrpt_place},
+	{"placeset",        1,    2,    llrpt_placeset},
 	{"pn",              2,    2,    llrpt_pn},
 	{"pop",             1,    1,    llrpt_pop},
 	{"pos",             2,    2,    llrpt_pos},
@@ -215,6 +222,7 @@ BUILTINS builtins[] = {
 	{"pvalue",          1,    1,    llrpt_pvalue},
 	{"qt",              0,    0,    llrpt_qt},
 	{"reference",       1,    1,    llrpt_reference},
+	{"relationpath",    2,    4,    llrpt_relationpath},
 	{"requeue",         2,    2,    llrpt_requeue},
 	{"rjustify",        2,    2,    llrpt_rjustify},
 	{"roman",           1,    1,    llrpt_roman},
@@ -223,6 +231,7 @@ BUILTINS builtins[] = {
 	{"rsort",           1,    2,    llrpt_rsort},
 	{"save",            1,    1,    llrpt_save},
 	{"savenode",        1,    1,    llrpt_savenode},
+	{"scanrecords",     2,    3,    llrpt_scanrecords},
 	{"set",             2,    2,    llrpt_set},
 	{"setdate",         2,    2,    llrpt_setdate},
 	{"setel",           3,    3,    llrpt_setel},
@@ -245,6 +254,7 @@ BUILTINS builtins[] = {
 	{"strsoundex",      1,    1,    llrpt_strsoundex},
 	{"strtoint",        1,    1,    llrpt_strtoint},
 	{"sub",             2,    2,    llrpt_sub},
+	{"subplaces",       1,    1,    llrpt_subplaces},
 	{"substring",       3,    3,    llrpt_substring},
 	{"surname",         1,    1,    llrpt_surname},
 	{"system",          1,    1,    llrpt_runsystem},
@@ -488,6 +488,7 @@ end_find_program:
  *  pactx: [I/O] pointer to global parsing context
  *  ifile: [IN]  file to parse
  * Parse file (yyparse may wind up adding entries to plist, via include statements)
+ * or load it from the report cache (see rptcache.c)
  *=====================================*/
 static void
 parse_file (PACTX pactx, STRING fname, STRING fullpath)
@@ -515,7 +516,14 @@ parse_file (PACTX pactx, STRING fname, STRING fullpath)
 	pactx->lineno = 0;
 	pactx->charpos = 0;
 
-	yyparse(pactx);
+	/* skip parsing if an up to date copy is in the report cache */
+	if (!rptcache_load(pactx)) {
+		INT perrors = Perrors;
+		yyparse(pactx);
+		if (Perrors == perrors)
+			rptcache_save(pactx);
+	}
+	rptcache_close(pactx);
 
 error_fileopen:
 	closefp(&pactx->Pinfp);
@@ -545,8 +553,9 @@ print_report_duration (INT duration, INT uiduration)
  *  ofile:    [IN]  output file - can be NULL
  *  picklist: [IN]  show user list of existing reports ?
  *  timing:   [IN]  show report elapsed time info ?
+ * returns TRUE if a report was run, without errors
  *===================================*/
-void
+BOOLEAN
 interp_main (LIST lifiles, STRING ofile, BOOLEAN picklist, BOOLEAN timing)
 {
 	time_t begin = time(NULL);
@@ -572,6 +581,7 @@ interp_main (LIST lifiles, STRING ofile, BOOLEAN picklist, BOOLEAN timing)
 	TO DO: unlock all cache elements (2001/03/17, Perry)
 	in case any were left locked by report
 	*/
+	return ranit != 0;
 }
 /*======================================
  * interpret -- Interpret statement list
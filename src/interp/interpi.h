@@ -48,6 +48,7 @@ struct tag_pactx {
 	STRING fullpath; /* actual path of current program */
 	INT lineno;      /* current line number (0-based) */
 	INT charpos;     /* current offset on line (0-based) */
+	struct tag_rptcache *rcache; /* report cache state for current file, if any */
 };
 typedef struct tag_pactx *PACTX;
 
@@ -311,12 +312,14 @@ PVALUE llrpt_complexpic(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_concat(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_convertcode(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_copyfile(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_createindex(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_createnode(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_d(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_database(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_date(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_date2jd(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_dateformat(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_datekey(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_datepic(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_dayformat(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_dayofweek(PNODE, SYMTAB, BOOLEAN *);
@@ -331,11 +334,13 @@ PVALUE llrpt_detachnode(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_difference(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_div(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_dms2deg(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_dropindex(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_dup(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_empty(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_enqueue(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_eq(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_eqstr(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_eventset(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_exp(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_extractdate(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_extractdatestr(PNODE, SYMTAB, BOOLEAN *);
@@ -376,6 +381,7 @@ PVALUE llrpt_heapused(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_husband(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_incr(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_index(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_indexkeys(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_indi(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_indiset(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_inlist(PNODE, SYMTAB, BOOLEAN *);
@@ -405,6 +411,7 @@ PVALUE llrpt_lt(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_male(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_marr(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_menuchoose(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_mergeindis(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_mod(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_monthformat(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_moth(PNODE, SYMTAB, BOOLEAN *);
@@ -433,6 +440,7 @@ PVALUE llrpt_parent(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_parents(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_parentset(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_place(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_placeset(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_pn(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_pop(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_pos(PNODE, SYMTAB, BOOLEAN *);
@@ -445,6 +453,7 @@ PVALUE llrpt_push(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_pvalue(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_qt(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_reference(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_relationpath(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_requeue(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_rjustify(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_roman(PNODE, SYMTAB, BOOLEAN *);
@@ -453,6 +462,7 @@ PVALUE llrpt_row(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_rsort(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_save(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_savenode(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_scanrecords(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_set(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_setdate(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_setel(PNODE, SYMTAB, BOOLEAN *);
@@ -473,6 +483,7 @@ PVALUE llrpt_strlen(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_strsoundex(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_strtoint(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_sub(PNODE, SYMTAB, BOOLEAN *);
+PVALUE llrpt_subplaces(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_substring(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_surname(PNODE, SYMTAB, BOOLEAN *);
 PVALUE llrpt_runsystem(PNODE, SYMTAB, BOOLEAN *);
@@ -610,6 +621,10 @@ void prog_var_error(PNODE node, SYMTAB stab, PNODE arg, PVALUE val, STRING fmt,
 STRING prot(STRING str);
 BOOLEAN record_to_node(PVALUE val);
 PNODE return_node(PACTX pactx, PNODE);
+void rptcache_close(PACTX pactx);
+BOOLEAN rptcache_load(PACTX pactx);
+void rptcache_note_defn(PACTX pactx, CNSTRING what, CNSTRING name, PNODE args, PNODE body);
+void rptcache_save(PACTX pactx);
 void set_rptfile_prop(PACTX pactx, STRING fname, STRING key, STRING value);
 void show_pnode(PNODE);
 void show_pnodes(PNODE);
@@ -36,11 +36,14 @@
 #include "interpi.h"
 #include "indiseq.h"
 #include "gengedc.h"
+#include "dateindex.h"
 
 /*********************************************
  * local function prototypes
  *********************************************/
 
+static BOOLEAN get_closure_maxgen(PNODE node, SYMTAB stab, PNODE arg2
+	, STRING fname, INT * pmaxgen, BOOLEAN *eflg);
 static UNION pvseq_copy_value(UNION uval, INT valtype);
 static void pvseq_delete_value(UNION uval, INT valtype);
 static INT pvseq_compare_values(VPTR ptr1, VPTR ptr2, INT valtype);
@@ -499,42 +502,245 @@ llrpt_spouseset (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 }
 /*================================================+
  * llrpt_ancestorset -- Create ancestor set of an INDISEQ
- * usage: ancestorset(SET) -> SET
+ * usage: ancestorset(SET [, INT]) -> SET
+ *  optional INT limits the number of generations (0 = all)
  *===============================================*/
 PVALUE
 llrpt_ancestorset (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 {
 	INDISEQ seq=0;
+	INT maxgen=0;
 	PNODE arg1 = builtin_args(node);
 	PVALUE val1 = eval_and_coerce(PSET, arg1, stab, eflg);
 	if (*eflg) {
-		prog_var_error(node, stab, arg1, val1, nonset1, "ancestorset");
+		prog_var_error(node, stab, arg1, val1, nonsetx, "ancestorset", "1");
+		return NULL;
+	}
+	if (!get_closure_maxgen(node, stab, inext(arg1), "ancestorset", &maxgen, eflg)) {
+		delete_pvalue(val1);
 		return NULL;
 	}
 	ASSERT(seq = pvalue_to_seq(val1));
-	seq = ancestor_indiseq(seq);
+	seq = ancestor_indiseq(seq, maxgen, NULL, NULL);
 	set_pvalue_seq(val1, seq);
 	return val1;
 }
 /*====================================================+
  * llrpt_descendentset -- Create descendent set of an INDISEQ
- * usage: descendantset(SET) -> SET
+ * usage: descendantset(SET [, INT]) -> SET
+ *  optional INT limits the number of generations (0 = all)
  *===================================================*/
 PVALUE
 llrpt_descendentset (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 {
 	INDISEQ seq=0;
+	INT maxgen=0;
 	PNODE arg1 = builtin_args(node);
 	PVALUE val1 = eval_and_coerce(PSET, arg1, stab, eflg);
 	if (*eflg) {
-		prog_var_error(node, stab, arg1, val1, nonset1, "descendentset");
+		prog_var_error(node, stab, arg1, val1, nonsetx, "descendentset", "1");
+		return NULL;
+	}
+	if (!get_closure_maxgen(node, stab, inext(arg1), "descendentset", &maxgen, eflg)) {
+		delete_pvalue(val1);
 		return NULL;
 	}
 	ASSERT(seq = pvalue_to_seq(val1));
-	seq = descendent_indiseq(seq);
+	seq = descendent_indiseq(seq, maxgen, NULL, NULL);
 	set_pvalue_seq(val1, seq);
 	return val1;
 }
+/*====================================================+
+ * get_closure_maxgen -- Evaluate optional generation limit
+ *  of ancestorset & descendentset
+ *  arg2: [IN]  second argument (may be NULL)
+ *  pmaxgen: [OUT] limit (0 if not given)
+ * returns FALSE (with eflg set) on error
+ *===================================================*/
+static BOOLEAN
+get_closure_maxgen (PNODE node, SYMTAB stab, PNODE arg2, STRING fname
+	, INT * pmaxgen, BOOLEAN *eflg)
+{
+	PVALUE val2=0;
+	*pmaxgen = 0;
+	if (!arg2)
+		return TRUE;
+	val2 = eval_and_coerce(PINT, arg2, stab, eflg);
+	if (*eflg) {
+		prog_var_error(node, stab, arg2, val2, nonintx, fname, "2");
+		delete_pvalue(val2);
+		return FALSE;
+	}
+	*pmaxgen = pvalue_to_int(val2);
+	delete_pvalue(val2);
+	if (*pmaxgen < 0) {
+		prog_var_error(node, stab, arg2, NULL
+			, _("%s: the generation limit may not be negative"), fname);
+		*eflg = TRUE;
+		return FALSE;
+	}
+	return TRUE;
+}
+/*====================================================+
+ * llrpt_relationpath -- Find shortest kinship path
+ * usage: relationpath(INDI, INDI [, INT [, INT]]) -> SET
+ *  runs from first person to second, each person valued with
+ *  its relation to the one before ("father", "mother", "child",
+ *  "sibling", "husband" or "wife"; "" for the first)
+ *  optional INTs limit persons reached & msecs spent (0 = no limit)
+ *  set is empty if persons are not related, or a limit was hit
+ *===================================================*/
+PVALUE
+llrpt_relationpath (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	NODE indi1=0, indi2=0;
+	INDISEQ seq=0, path=0;
+	INT limits[2] = { 0, 0 };
+	INT i, status=0;
+	PNODE arg1 = builtin_args(node), arg2 = inext(arg1), argn=0;
+	static STRING argnums[] = { "3", "4" };
+	indi1 = eval_indi(arg1, stab, eflg, NULL);
+	if (*eflg) {
+		prog_var_error(node, stab, arg1, NULL, nonindx, "relationpath", "1");
+		return NULL;
+	}
+	indi2 = eval_indi(arg2, stab, eflg, NULL);
+	if (*eflg) {
+		prog_var_error(node, stab, arg2, NULL, nonindx, "relationpath", "2");
+		return NULL;
+	}
+	for (i=0, argn=inext(arg2); argn && i<2; ++i, argn=inext(argn)) {
+		PVALUE val = eval_and_coerce(PINT, argn, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argn, val, nonintx, "relationpath", argnums[i]);
+			delete_pvalue(val);
+			return NULL;
+		}
+		limits[i] = pvalue_to_int(val);
+		delete_pvalue(val);
+	}
+	seq = create_indiseq_pval();
+	set_indiseq_value_funcs(seq, &pvseq_fnctbl);
+	if (indi1 && indi2) {
+		path = relation_path_indiseq(rmvat(nxref(indi1)), rmvat(nxref(indi2))
+			, limits[0], limits[1], &status);
+	}
+	if (path) {
+		FORINDISEQ(path, el, num)
+			append_indiseq_pval(seq, (STRING)element_skey(el), NULL
+				, create_pvalue_from_string(element_sval(el)), TRUE);
+		ENDINDISEQ
+		remove_indiseq(path);
+	}
+	return create_pvalue_from_seq(seq);
+}
+/*====================================================+
+ * llrpt_eventset -- Find persons by event date (date index)
+ * usage: eventset(STRING, STRING, STRING) -> SET
+ *  persons with an event of the tag given (eg, "BIRT";
+ *  "" for any) whose date lies wholly between the two dates
+ *  ("" leaves that end open); family events (eg, "MARR")
+ *  count for husband and wife
+ *  tags longer than four characters are not indexed (see
+ *  IDXFILE_MAXTAG), so are an error
+ *  each person is valued with the date key of the event
+ *  (see datekey)
+ *===================================================*/
+PVALUE
+llrpt_eventset (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	STRING args[3];
+	INT32 bounds[2] = { DATEKEY_MIN, DATEKEY_MAX };
+	INT32 lo=0, hi=0;
+	INDISEQ seq=0, found=0;
+	INT i;
+	PNODE argn = builtin_args(node);
+	static STRING argnums[] = { "1", "2", "3" };
+	for (i=0; i<3; ++i, argn=inext(argn)) {
+		PVALUE val = eval_and_coerce(PSTRING, argn, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argn, val, nonstrx, "eventset", argnums[i]);
+			delete_pvalue(val);
+			for (--i; i>=0; --i)
+				strfree(&args[i]);
+			return NULL;
+		}
+		args[i] = strsave(pvalue_to_string(val) ? pvalue_to_string(val) : "");
+		delete_pvalue(val);
+	}
+	if (!dateindex_tag_ok(args[0])) {
+		prog_var_error(node, stab, NULL, NULL
+			, _("%s: tag %s is longer than the date index holds"), "eventset", args[0]);
+		*eflg = TRUE;
+	}
+	for (i=0; i<2 && !*eflg; ++i) {
+		if (!args[i+1][0])
+			continue;
+		if (!dateindex_date_range(args[i+1], &lo, &hi)) {
+			prog_var_error(node, stab, NULL, NULL
+				, _("%s: cannot read date %s"), "eventset", args[i+1]);
+			*eflg = TRUE;
+			break;
+		}
+		bounds[i] = i ? hi : lo;
+	}
+	if (!*eflg)
+		found = event_date_indiseq(args[0], bounds[0], bounds[1]);
+	for (i=0; i<3; ++i)
+		strfree(&args[i]);
+	if (*eflg)
+		return NULL;
+	seq = create_indiseq_pval();
+	set_indiseq_value_funcs(seq, &pvseq_fnctbl);
+	FORINDISEQ(found, el, num)
+		append_indiseq_pval(seq, (STRING)element_skey(el), NULL
+			, create_pvalue_from_int(get_indiseq_ival(found, num)), TRUE);
+	ENDINDISEQ
+	remove_indiseq(found);
+	return create_pvalue_from_seq(seq);
+}
+/*====================================================+
+ * llrpt_placeset -- Find persons by event place (place index)
+ * usage: placeset(STRING [, STRING]) -> SET
+ *  persons with an event at the place given, or at any place
+ *  within it (eg, "Gloucestershire, England" includes
+ *  "Bristol, Gloucestershire, England"); the place need only
+ *  name its most specific parts, and case is ignored
+ *  optional STRING is the event tag (eg, "BIRT"; "" for any);
+ *  family events (eg, "MARR") count for husband and wife
+ *  each person is valued with the full place of the event
+ *===================================================*/
+PVALUE
+llrpt_placeset (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	STRING args[2] = { 0, 0 };
+	INDISEQ seq=0, found=0;
+	INT i;
+	PNODE argn = builtin_args(node);
+	static STRING argnums[] = { "1", "2" };
+	for (i=0; argn && i<2; ++i, argn=inext(argn)) {
+		PVALUE val = eval_and_coerce(PSTRING, argn, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argn, val, nonstrx, "placeset", argnums[i]);
+			delete_pvalue(val);
+			strfree(&args[0]);
+			return NULL;
+		}
+		args[i] = strsave(pvalue_to_string(val) ? pvalue_to_string(val) : "");
+		delete_pvalue(val);
+	}
+	found = place_indiseq(args[0], args[1]);
+	for (i=0; i<2; ++i)
+		strfree(&args[i]);
+	seq = create_indiseq_pval();
+	set_indiseq_value_funcs(seq, &pvseq_fnctbl);
+	FORINDISEQ(found, el, num)
+		append_indiseq_pval(seq, (STRING)element_skey(el), NULL
+			, create_pvalue_from_string(element_sval(el)), TRUE);
+	ENDINDISEQ
+	remove_indiseq(found);
+	return create_pvalue_from_seq(seq);
+}
 /*===================================================+
  * llrpt_gengedcom -- Generate GEDCOM output from an INDISEQ
  * usage: gengedcom(SET) -> VOID
@@ -34,11 +34,14 @@
 #include "table.h"
 #include "translat.h"
 #include "gedcom.h"
+#include "rawscan.h"
 #include "interpi.h"
 #include "liflines.h"
 #include "lloptions.h"
 #include "feedback.h" /* call_system_cmd */
 #include "zstr.h"
+#include "placeindex.h"
+#include "tagindex.h"
 #include "version.h"
 
 /*********************************************
@@ -946,6 +949,206 @@ llrpt_reference (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 	set_pvalue_bool(val, rc);
 	return val;
 }
+/*================================================+
+ * llrpt_scanrecords -- Find records by value under tag path
+ * usage: scanrecords(STRING, STRING [, STRING]) -> LIST
+ *  tag path (eg, "SOUR.TITL", "*.NOTE"), pattern, and record
+ *  types (eg, "IF", default all); returns keys of records having
+ *  a matching value (or CONC/CONT line of one), in btree order
+ * Records are read raw, bypassing the record cache
+ *===============================================*/
+static BOOLEAN
+scanrecords_callback (CNSTRING key, void * param)
+{
+	enqueue_list((LIST)param, create_pvalue_from_string(key));
+	return TRUE;
+}
+/* see above */
+PVALUE
+llrpt_scanrecords (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	PVALUE vals[3] = { 0, 0, 0 };
+	STRING strs[3] = { 0, 0, 0 };
+	static STRING argnums[] = { "1", "2", "3" };
+	SCANPATTERN scanpat = 0;
+	LIST list = 0;
+	PVALUE val = 0;
+	INT i;
+	for (i=0; argvar && i<3; ++i, argvar=inext(argvar)) {
+		vals[i] = eval_and_coerce(PSTRING, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, vals[i], nonstrx, "scanrecords", argnums[i]);
+			goto exitscan;
+		}
+		strs[i] = pvalue_to_string(vals[i]);
+	}
+	argvar = builtin_args(node);
+	if (!rawscan_tagpath_isvalid(strs[0])) {
+		*eflg = TRUE;
+		prog_var_error(node, stab, argvar, vals[0]
+			, _("%s: the arg #%s is not a valid tag path"), "scanrecords", "1");
+		goto exitscan;
+	}
+	if (!(scanpat = create_scan_pattern(strs[1]))) {
+		*eflg = TRUE;
+		prog_var_error(node, stab, inext(argvar), vals[1]
+			, _("%s: the arg #%s is not a valid pattern"), "scanrecords", "2");
+		goto exitscan;
+	}
+	list = create_list3(delete_vptr_pvalue);
+	rawscan_records(strs[2], strs[0], TRUE, scanpat, scanrecords_callback, list);
+	val = create_pvalue_from_list(list);
+	release_list(list);
+exitscan:
+	destroy_scan_pattern(scanpat);
+	for (i=0; i<3; ++i)
+		delete_pvalue(vals[i]);
+	return val;
+}
+/*========================================+
+ * llrpt_subplaces -- Find places within a place (place index)
+ * usage: subplaces(STRING) -> LIST
+ *  full names of the places directly within the place given
+ *  (eg, the towns of "Gloucestershire, England"), or of the
+ *  places not within any other for ""
+ *=======================================*/
+static BOOLEAN
+subplaces_callback (INT32 place, void * param)
+{
+	ZSTR zname = placeindex_place_name(place);
+	enqueue_list((LIST)param, create_pvalue_from_string(zs_str(zname)));
+	zs_free(&zname);
+	return TRUE;
+}
+/* see above */
+PVALUE
+llrpt_subplaces (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	PVALUE val = eval_and_coerce(PSTRING, argvar, stab, eflg);
+	STRING place;
+	LIST list;
+	if (*eflg) {
+		prog_var_error(node, stab, argvar, val, nonstr1, "subplaces");
+		delete_pvalue(val);
+		return NULL;
+	}
+	place = pvalue_to_string(val);
+	list = create_list3(delete_vptr_pvalue);
+	placeindex_subplaces(place ? place : "", subplaces_callback, list);
+	delete_pvalue(val);
+	val = create_pvalue_from_list(list);
+	release_list(list);
+	return val;
+}
+/*========================================+
+ * llrpt_createindex -- Declare & build a secondary index
+ * usage: createindex(STRING [, STRING]) -> BOOL
+ *  indexes values on a tag path (eg, "INDI.OCCU") with a
+ *  key extractor: "value" (the default), "words" or "year"
+ *  false if database is read only, or arguments are invalid
+ *=======================================*/
+PVALUE
+llrpt_createindex (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	PVALUE vals[2] = { 0, 0 };
+	STRING strs[2] = { 0, 0 };
+	static STRING argnums[] = { "1", "2" };
+	BOOLEAN rtn=FALSE;
+	INT i;
+	for (i=0; argvar && i<2; ++i, argvar=inext(argvar)) {
+		vals[i] = eval_and_coerce(PSTRING, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, vals[i], nonstrx, "createindex", argnums[i]);
+			goto exitcreate;
+		}
+		strs[i] = pvalue_to_string(vals[i]);
+	}
+	rtn = tagindex_create(strs[0], strs[1]);
+exitcreate:
+	for (i=0; i<2; ++i)
+		delete_pvalue(vals[i]);
+	return *eflg ? NULL : create_pvalue_from_bool(rtn);
+}
+/*========================================+
+ * llrpt_dropindex -- Remove a secondary index
+ * usage: dropindex(STRING) -> BOOL
+ *  false if database is read only, or there is no index on
+ *  the tag path
+ *=======================================*/
+PVALUE
+llrpt_dropindex (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	PVALUE val = eval_and_coerce(PSTRING, argvar, stab, eflg);
+	BOOLEAN rtn;
+	if (*eflg) {
+		prog_var_error(node, stab, argvar, val, nonstr1, "dropindex");
+		delete_pvalue(val);
+		return NULL;
+	}
+	rtn = tagindex_drop(pvalue_to_string(val));
+	delete_pvalue(val);
+	return create_pvalue_from_bool(rtn);
+}
+/*========================================+
+ * llrpt_indexkeys -- Find records in a secondary index
+ * usage: indexkeys(STRING, STRING [, BOOL]) -> LIST
+ *  keys of records with the value given (or, if the BOOL is
+ *  true, a value starting with it) in the index on the tag
+ *  path, in order of value; ASCII case is ignored
+ *  a record is listed once for each of its values found
+ *=======================================*/
+static BOOLEAN
+indexkeys_callback (CNSTRING key, HINT_PARAM_UNUSED CNSTRING value, void * param)
+{
+	enqueue_list((LIST)param, create_pvalue_from_string(key));
+	return TRUE;
+}
+/* see above */
+PVALUE
+llrpt_indexkeys (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	PVALUE vals[2] = { 0, 0 };
+	STRING strs[2] = { 0, 0 };
+	static STRING argnums[] = { "1", "2" };
+	BOOLEAN prefix=FALSE;
+	LIST list = 0;
+	PVALUE val = 0;
+	INT i;
+	for (i=0; i<2; ++i, argvar=inext(argvar)) {
+		vals[i] = eval_and_coerce(PSTRING, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, vals[i], nonstrx, "indexkeys", argnums[i]);
+			goto exitkeys;
+		}
+		strs[i] = pvalue_to_string(vals[i]);
+	}
+	if (argvar) {
+		val = eval_and_coerce(PBOOL, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, val, nonboox, "indexkeys", "3");
+			delete_pvalue(val);
+			val = 0;
+			goto exitkeys;
+		}
+		prefix = pvalue_to_bool(val);
+		delete_pvalue(val);
+		val = 0;
+	}
+	list = create_list3(delete_vptr_pvalue);
+	if (strs[0])
+		tagindex_find(strs[0], strs[1] ? strs[1] : "", prefix, indexkeys_callback, list);
+	val = create_pvalue_from_list(list);
+	release_list(list);
+exitkeys:
+	for (i=0; i<2; ++i)
+		delete_pvalue(vals[i]);
+	return val;
+}
 /*========================================+
  * llrpt_rjustify -- Right justify string value
  * usage: rjustify(STRING, INT) -> STRING
@@ -46,6 +46,13 @@
 #include "interpi.h"
 
 
+/*********************************************
+ * global/exported variables
+ *********************************************/
+
+/* set by caller to append to report output file (batch mode) */
+BOOLEAN rpt_append_output = FALSE;
+
 /*********************************************
  * external/imported variables
  *********************************************/
@@ -215,12 +222,13 @@ llrpt_newfile (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 /*======================================+
  * start_output_file -- Start outputing to specified file
  *  (Closes any previously open output file)
+ * Appends if rpt_append_output is set, else truncates
  * Calls msg_error & returns FALSE, if problem
  *=====================================*/
 BOOLEAN
 start_output_file (STRING outfname)
 {
-	BOOLEAN append=FALSE;
+	BOOLEAN append=rpt_append_output;
 	if (set_output_file(outfname, append)) {
 		strupdate(&outfilename, outfname);
 		return TRUE;
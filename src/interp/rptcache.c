@@ -0,0 +1,753 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * rptcache.c -- Cache of parsed report program files
+ *  If ReportCacheDir is set, the top-level definitions of each
+ *  program file that parses cleanly are written there, keyed
+ *  by a hash of the file contents, the report language version
+ *  and the codesets its strings were converted with.  The next
+ *  time the same file is run they are read back and handed to
+ *  the same parse-time handlers yacc.y calls, so lexing and
+ *  parsing are skipped.  Function calls are resolved again as
+ *  they are loaded, exactly as func_node does while parsing.
+ *  Any mismatch or damage falls back to parsing the file.
+ *===========================================================*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include "sys_inc.h"
+#ifdef WIN32
+#include <process.h> /* getpid */
+#endif
+#include "llstdlib.h"
+#include "table.h"
+#include "translat.h"
+#include "gedcom.h"
+#include "cache.h"
+#include "interpi.h"
+#include "lloptions.h"
+#include "codesets.h"
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* bump whenever the layout written below changes */
+#define RPTCACHE_FORMAT 1
+static const char rptcache_magic[4] = { 'L', 'L', 'R', 'C' };
+
+/* one top-level definition, as seen by yacc.y */
+typedef struct tag_rcdefn {
+	STRING what;   /* global, include, option, char_encoding, require, proc, func */
+	STRING name;   /* variable, proc or func name */
+	INT line;
+	PNODE args;    /* string constant, or parameters of proc or func */
+	PNODE body;
+} *RCDEFN;
+
+struct tag_rptcache {
+	STRING path;       /* cache file for program file being parsed */
+	uint64_t hash;     /* of program file contents */
+	INT length;        /* of program file */
+	STRING codeset;    /* report codeset when parse began */
+	LIST defns;        /* of RCDEFN, in parse order */
+};
+
+/* cursor over a cache file read into memory */
+typedef struct tag_rcread {
+	const unsigned char *p;
+	const unsigned char *end;
+	BOOLEAN bad;
+} RCREAD;
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+static PNODE build_node(PACTX pactx, INT type, INT line, INT ival, FLOAT fval
+	, STRING strs[], PNODE lists[]);
+static BOOLEAN get_defns(PACTX pactx, RCREAD *rd, BOOLEAN build);
+static FLOAT get_float(RCREAD *rd);
+static INT get_int(RCREAD *rd);
+static PNODE get_nodes(PACTX pactx, RCREAD *rd, BOOLEAN build);
+static STRING get_str(RCREAD *rd, BOOLEAN build);
+static uint64_t hash_bytes(uint64_t hash, const void *buf, size_t len);
+static uint64_t hash_str(uint64_t hash, CNSTRING str);
+static CNSTRING node_fields(INT type);
+static void node_parts(PNODE node, CNSTRING *strs, PNODE *lists);
+static void put_float(FILE *fp, FLOAT fval);
+static void put_int(FILE *fp, INT ival);
+static BOOLEAN put_nodes(FILE *fp, PNODE node);
+static void put_str(FILE *fp, CNSTRING str);
+static BOOLEAN read_header(RCREAD *rd, struct tag_rptcache *rc);
+static void replay_defn(PACTX pactx, STRING what, STRING name, INT line
+	, PNODE args, PNODE body);
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*===========================================
+ * hash_bytes -- Continue FNV-1a hash over buffer
+ *=========================================*/
+static uint64_t
+hash_bytes (uint64_t hash, const void *buf, size_t len)
+{
+	const unsigned char *p = buf;
+	while (len--) {
+		hash ^= *p++;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+/*===========================================
+ * hash_str -- Continue FNV-1a hash over string
+ *  (including its terminator, so "ab","c" differs from "a","bc")
+ *=========================================*/
+static uint64_t
+hash_str (uint64_t hash, CNSTRING str)
+{
+	if (!str)
+		str = "";
+	return hash_bytes(hash, str, strlen(str)+1);
+}
+/*===========================================
+ * node_fields -- What a node of given type holds
+ *  'n' node list, 's' string, in the order of
+ *  the arguments of its constructor in alloc.c
+ *  NULL if nodes of that type are never cached
+ *=========================================*/
+static CNSTRING
+node_fields (INT type)
+{
+	switch (type) {
+	case IICONS: case IFCONS: return "";
+	case ISCONS: case IIDENT: return "s";
+	case IIF: return "nnn";
+	case IWHILE: return "nn";
+	case IBREAK: case ICONTINUE: return "";
+	case IRETURN: return "n";
+	case IPCALL: case IFCALL: case IBCALL: return "sn";
+	case ICHILDREN: case IFAMILYSPOUSES: case IFAMCS: case ILIST: case ITRAV:
+		return "nssn";
+	case ISPOUSES: case IFAMILIES: case IFATHS: case IMOTHS: case ISET:
+		return "nsssn";
+	case IINDI: case IFAM: case ISOUR: case IEVEN: case IOTHR:
+		return "ssn";
+	case INOTES: case INODES:
+		return "nsn";
+	}
+	return NULL;
+}
+/*===========================================
+ * node_parts -- Fetch strings and node lists of node
+ *  in the order given by node_fields
+ *=========================================*/
+static void
+node_parts (PNODE node, CNSTRING *strs, PNODE *lists)
+{
+	switch (itype(node)) {
+	case ISCONS:
+		strs[0] = get_internal_string_node_value(node);
+		return;
+	case IIDENT:
+		strs[0] = iident_name(node);
+		return;
+	case IIF:
+		lists[0] = node->vars.iif.icond;
+		lists[1] = node->vars.iif.ithen;
+		lists[2] = node->vars.iif.ielse;
+		return;
+	case IWHILE:
+		lists[0] = node->vars.iwhile.icond;
+		lists[1] = node->vars.iwhile.ibody;
+		return;
+	case IRETURN:
+		lists[0] = (PNODE)iargs(node);
+		return;
+	case IPCALL:
+		strs[0] = node->vars.ipcall.fname;
+		lists[0] = node->vars.ipcall.fargs;
+		return;
+	case IFCALL: case IBCALL:
+		strs[0] = iname(node);
+		lists[0] = (PNODE)iargs(node);
+		return;
+	case ICHILDREN:
+		strs[0] = ichild(node);
+		strs[1] = inum(node);
+		break;
+	case IFAMILYSPOUSES:
+		strs[0] = iiparent(node);
+		strs[1] = inum(node);
+		break;
+	case IFAMCS:
+		strs[0] = ifamily(node);
+		strs[1] = inum(node);
+		break;
+	case ILIST:
+		strs[0] = ielement(node);
+		strs[1] = inum(node);
+		break;
+	case ITRAV:
+		strs[0] = ielement(node);
+		strs[1] = ilev(node);
+		break;
+	case ISPOUSES:
+		strs[0] = ispouse(node);
+		strs[1] = ifamily(node);
+		strs[2] = inum(node);
+		break;
+	case IFAMILIES:
+		strs[0] = ifamily(node);
+		strs[1] = ispouse(node);
+		strs[2] = inum(node);
+		break;
+	case IFATHS: case IMOTHS:
+		strs[0] = iiparent(node);
+		strs[1] = ifamily(node);
+		strs[2] = inum(node);
+		break;
+	case ISET:
+		strs[0] = ielement(node);
+		strs[1] = ivalvar(node);
+		strs[2] = inum(node);
+		break;
+	case IINDI: case IFAM: case ISOUR: case IEVEN: case IOTHR:
+		strs[0] = ielement(node);
+		strs[1] = inum(node);
+		lists[0] = (PNODE)ibody(node);
+		return;
+	case INOTES: case INODES:
+		strs[0] = ielement(node);
+		break;
+	default:
+		return;
+	}
+	/* remaining loops: expression first, body last */
+	lists[0] = (PNODE)iloopexp(node);
+	lists[1] = (PNODE)ibody(node);
+}
+/*===========================================
+ * build_node -- Create node from cached parts
+ *  strs:  [IN]  heap strings, consumed
+ *  lists: [IN]  node lists
+ * Same constructors, in the same order, as yacc.y
+ *=========================================*/
+static PNODE
+build_node (PACTX pactx, INT type, INT line, INT ival, FLOAT fval
+	, STRING strs[], PNODE lists[])
+{
+	PNODE node=0;
+	pactx->lineno = line;
+	switch (type) {
+	case IICONS: node = create_icons_node(pactx, ival); break;
+	case IFCONS: node = create_fcons_node(pactx, fval); break;
+	case ISCONS:
+		node = create_string_node(pactx, strs[0]);
+		stdfree(strs[0]);
+		break;
+	case IIDENT: node = create_iden_node(pactx, strs[0]); break;
+	case IIF: node = if_node(pactx, lists[0], lists[1], lists[2]); break;
+	case IWHILE: node = while_node(pactx, lists[0], lists[1]); break;
+	case IBREAK: node = break_node(pactx); break;
+	case ICONTINUE: node = continue_node(pactx); break;
+	case IRETURN: node = return_node(pactx, lists[0]); break;
+	case IPCALL: node = create_call_node(pactx, strs[0], lists[0]); break;
+	case IFCALL: case IBCALL: node = func_node(pactx, strs[0], lists[0]); break;
+	case ICHILDREN:
+		node = children_node(pactx, lists[0], strs[0], strs[1], lists[1]);
+		break;
+	case IFAMILYSPOUSES:
+		node = familyspouses_node(pactx, lists[0], strs[0], strs[1], lists[1]);
+		break;
+	case IFAMCS:
+		node = parents_node(pactx, lists[0], strs[0], strs[1], lists[1]);
+		break;
+	case ILIST:
+		node = forlist_node(pactx, lists[0], strs[0], strs[1], lists[1]);
+		break;
+	case ITRAV:
+		node = traverse_node(pactx, lists[0], strs[0], strs[1], lists[1]);
+		break;
+	case ISPOUSES:
+		node = spouses_node(pactx, lists[0], strs[0], strs[1], strs[2], lists[1]);
+		break;
+	case IFAMILIES:
+		node = families_node(pactx, lists[0], strs[0], strs[1], strs[2], lists[1]);
+		break;
+	case IFATHS:
+		node = fathers_node(pactx, lists[0], strs[0], strs[1], strs[2], lists[1]);
+		break;
+	case IMOTHS:
+		node = mothers_node(pactx, lists[0], strs[0], strs[1], strs[2], lists[1]);
+		break;
+	case ISET:
+		node = forindiset_node(pactx, lists[0], strs[0], strs[1], strs[2], lists[1]);
+		break;
+	case IINDI: node = forindi_node(pactx, strs[0], strs[1], lists[0]); break;
+	case IFAM: node = forfam_node(pactx, strs[0], strs[1], lists[0]); break;
+	case ISOUR: node = forsour_node(pactx, strs[0], strs[1], lists[0]); break;
+	case IEVEN: node = foreven_node(pactx, strs[0], strs[1], lists[0]); break;
+	case IOTHR: node = forothr_node(pactx, strs[0], strs[1], lists[0]); break;
+	case INOTES: node = fornotes_node(pactx, lists[0], strs[0], lists[1]); break;
+	case INODES: node = fornodes_node(pactx, lists[0], strs[0], lists[1]); break;
+	}
+	/* yacc.y stamps most statements with the line they began on */
+	iline(node) = line;
+	return node;
+}
+/*===========================================
+ * put_int -- Write integer (8 bytes, little-endian)
+ *=========================================*/
+static void
+put_int (FILE *fp, INT ival)
+{
+	unsigned char buf[8];
+	uint64_t u = (uint64_t)(INT64)ival;
+	int i;
+	for (i=0; i<8; ++i) {
+		buf[i] = (unsigned char)(u & 0xff);
+		u >>= 8;
+	}
+	fwrite(buf, 1, sizeof(buf), fp);
+}
+/*===========================================
+ * put_float -- Write floating point (native layout)
+ *=========================================*/
+static void
+put_float (FILE *fp, FLOAT fval)
+{
+	fwrite(&fval, 1, sizeof(fval), fp);
+}
+/*===========================================
+ * put_str -- Write string, length first (-1 for NULL)
+ *=========================================*/
+static void
+put_str (FILE *fp, CNSTRING str)
+{
+	if (!str) {
+		put_int(fp, -1);
+		return;
+	}
+	put_int(fp, strlen(str));
+	fwrite(str, 1, strlen(str), fp);
+}
+/*===========================================
+ * put_nodes -- Write list of nodes, ended by 0
+ * returns FALSE if list holds a node we cannot cache
+ *=========================================*/
+static BOOLEAN
+put_nodes (FILE *fp, PNODE node)
+{
+	for ( ; node; node = inext(node)) {
+		CNSTRING fields = node_fields(itype(node));
+		CNSTRING strs[3] = { 0, 0, 0 };
+		PNODE lists[3] = { 0, 0, 0 };
+		INT ns=0, nl=0;
+		if (!fields)
+			return FALSE;
+		put_int(fp, itype(node));
+		put_int(fp, iline(node));
+		if (itype(node) == IICONS)
+			put_int(fp, node->vars.iicons.value->value.ixd);
+		else if (itype(node) == IFCONS)
+			put_float(fp, node->vars.ifcons.value->value.fxd);
+		node_parts(node, strs, lists);
+		for ( ; *fields; ++fields) {
+			if (*fields == 's') {
+				if (!strs[ns])
+					return FALSE;
+				put_str(fp, strs[ns++]);
+			} else if (!put_nodes(fp, lists[nl++])) {
+				return FALSE;
+			}
+		}
+	}
+	put_int(fp, 0);
+	return TRUE;
+}
+/*===========================================
+ * get_int -- Read integer written by put_int
+ *=========================================*/
+static INT
+get_int (RCREAD *rd)
+{
+	uint64_t u = 0;
+	int i;
+	if (rd->bad || rd->end - rd->p < 8) {
+		rd->bad = TRUE;
+		return 0;
+	}
+	for (i=7; i>=0; --i)
+		u = (u << 8) | rd->p[i];
+	rd->p += 8;
+	return (INT)(INT64)u;
+}
+/*===========================================
+ * get_float -- Read floating point written by put_float
+ *=========================================*/
+static FLOAT
+get_float (RCREAD *rd)
+{
+	FLOAT fval = 0;
+	if (rd->bad || rd->end - rd->p < (INT)sizeof(fval)) {
+		rd->bad = TRUE;
+		return 0;
+	}
+	memcpy(&fval, rd->p, sizeof(fval));
+	rd->p += sizeof(fval);
+	return fval;
+}
+/*===========================================
+ * get_str -- Read string written by put_str
+ *  build: [IN]  return heap copy (else only skip it,
+ *               returning "" if it was not NULL)
+ *=========================================*/
+static STRING
+get_str (RCREAD *rd, BOOLEAN build)
+{
+	INT len = get_int(rd);
+	STRING str=0;
+	if (rd->bad || len < 0)
+		return NULL;
+	if (len > rd->end - rd->p) {
+		rd->bad = TRUE;
+		return NULL;
+	}
+	if (build) {
+		str = stdalloc(len+1);
+		memcpy(str, rd->p, len);
+		str[len] = 0;
+	} else {
+		str = (STRING)"";
+	}
+	rd->p += len;
+	return str;
+}
+/*===========================================
+ * get_nodes -- Read list of nodes written by put_nodes
+ *  build: [IN]  create the nodes (else only check the data)
+ *=========================================*/
+static PNODE
+get_nodes (PACTX pactx, RCREAD *rd, BOOLEAN build)
+{
+	PNODE first=0, last=0;
+	INT type;
+	while (!rd->bad && (type = get_int(rd)) != 0) {
+		CNSTRING fields = node_fields(type);
+		STRING strs[3] = { 0, 0, 0 };
+		PNODE lists[3] = { 0, 0, 0 };
+		INT ns=0, nl=0, line, ival=0;
+		FLOAT fval=0;
+		PNODE node;
+		if (!fields) {
+			rd->bad = TRUE;
+			break;
+		}
+		line = get_int(rd);
+		if (type == IICONS)
+			ival = get_int(rd);
+		else if (type == IFCONS)
+			fval = get_float(rd);
+		for ( ; *fields; ++fields) {
+			if (*fields == 's') {
+				strs[ns] = get_str(rd, build);
+				if (!strs[ns])
+					rd->bad = TRUE;
+				++ns;
+			} else {
+				lists[nl++] = get_nodes(pactx, rd, build);
+			}
+		}
+		if (!build || rd->bad)
+			continue;
+		node = build_node(pactx, type, line, ival, fval, strs, lists);
+		if (last)
+			inext(last) = node;
+		else
+			first = node;
+		last = node;
+	}
+	return first;
+}
+/*===========================================
+ * replay_defn -- Hand top-level definition to its
+ *  parse-time handler, as the defn rule of yacc.y does
+ *  name: [IN]  heap string, consumed
+ *=========================================*/
+static void
+replay_defn (PACTX pactx, STRING what, STRING name, INT line
+	, PNODE args, PNODE body)
+{
+	pactx->lineno = line;
+	if (eqstr(what, "proc") && name) {
+		pa_handle_proc(pactx, name, args, body);
+		return;
+	}
+	if (eqstr(what, "func") && name) {
+		pa_handle_func(pactx, name, args, body);
+		return;
+	}
+	if (eqstr(what, "global") && name)
+		pa_handle_global(name);
+	if (args && itype(args) == ISCONS) {
+		if (eqstr(what, "include"))
+			pa_handle_include(pactx, args);
+		if (eqstr(what, "option"))
+			pa_handle_option(get_internal_string_node_value(args));
+		if (eqstr(what, "char_encoding"))
+			pa_handle_char_encoding(pactx, args);
+		if (eqstr(what, "require"))
+			pa_handle_require(pactx, args);
+	}
+	if (name)
+		stdfree(name);
+}
+/*===========================================
+ * get_defns -- Read top-level definitions
+ *  build: [IN]  replay them (else only check the data)
+ *=========================================*/
+static BOOLEAN
+get_defns (PACTX pactx, RCREAD *rd, BOOLEAN build)
+{
+	STRING what;
+	while ((what = get_str(rd, TRUE)) != NULL) {
+		INT line = get_int(rd);
+		STRING name = get_str(rd, build);
+		PNODE args = get_nodes(pactx, rd, build);
+		PNODE body = get_nodes(pactx, rd, build);
+		if (build && !rd->bad)
+			replay_defn(pactx, what, name, line, args, body);
+		stdfree(what);
+		if (rd->bad)
+			break;
+	}
+	return !rd->bad && rd->p == rd->end;
+}
+/*===========================================
+ * read_header -- Check cache file was written for
+ *  this very file, language version and codesets
+ *=========================================*/
+static BOOLEAN
+read_header (RCREAD *rd, struct tag_rptcache *rc)
+{
+	STRING str=0;
+	BOOLEAN ok;
+
+	if (rd->end - rd->p < (INT)sizeof(rptcache_magic)
+		|| memcmp(rd->p, rptcache_magic, sizeof(rptcache_magic)))
+		return FALSE;
+	rd->p += sizeof(rptcache_magic);
+	if (get_int(rd) != RPTCACHE_FORMAT
+		|| get_int(rd) != (INT)sizeof(FLOAT)
+		|| get_int(rd) != rc->length
+		|| (uint64_t)(INT64)get_int(rd) != rc->hash)
+		return FALSE;
+	str = get_str(rd, TRUE);
+	ok = str && eqstr(str, LIFELINES_REPORTS_VERSION);
+	strfree(&str);
+	str = get_str(rd, TRUE);
+	ok = ok && str && eqstr(str, int_codeset ? int_codeset : "");
+	strfree(&str);
+	str = get_str(rd, TRUE);
+	ok = ok && str && eqstr(str, rc->codeset);
+	strfree(&str);
+	return ok && !rd->bad;
+}
+/*===========================================
+ * rptcache_load -- Load current program file from
+ *  report cache, if enabled and up to date
+ *  pactx: [I/O] parse context, with file open
+ * Returns TRUE if loaded, so file need not be parsed
+ * (also prepares pactx for rptcache_save otherwise)
+ *=========================================*/
+BOOLEAN
+rptcache_load (PACTX pactx)
+{
+	CNSTRING dir = getlloptstr("ReportCacheDir", NULL);
+	struct tag_rptcache *rc=0;
+	char buffer[4096], fname[32], path[MAXPATHLEN];
+	uint64_t key;
+	long pos;
+	size_t n;
+	FILE *fp=0;
+	unsigned char *data=0;
+	long len;
+	RCREAD rd;
+	BOOLEAN loaded = FALSE;
+
+	if (!dir || !dir[0] || !pactx->Pinfp)
+		return FALSE;
+
+	rc = (struct tag_rptcache *)stdalloc(sizeof(*rc));
+	memset(rc, 0, sizeof(*rc));
+	rc->hash = 0xcbf29ce484222325ULL;
+	rc->codeset = strsave(get_rptinfo(pactx->fullpath)->codeset);
+	rc->defns = create_list2(LISTNOFREE);
+	pactx->rcache = rc;
+
+	/* hash whole file, then return to where parsing starts */
+	pos = ftell(pactx->Pinfp);
+	rewind(pactx->Pinfp);
+	while ((n = fread(buffer, 1, sizeof(buffer), pactx->Pinfp)) > 0) {
+		rc->hash = hash_bytes(rc->hash, buffer, n);
+		rc->length += n;
+	}
+	fseek(pactx->Pinfp, pos, SEEK_SET);
+
+	key = rc->hash;
+	key = hash_str(key, LIFELINES_REPORTS_VERSION);
+	key = hash_str(key, int_codeset);
+	key = hash_str(key, rc->codeset);
+	snprintf(fname, sizeof(fname), "%016" PRIx64 ".llc", key);
+	concat_path(dir, fname, uu8, path, sizeof(path));
+	rc->path = strsave(path);
+
+	if (!(fp = fopen(rc->path, LLREADBINARY)))
+		return FALSE;
+	if (fseek(fp, 0, SEEK_END) || (len = ftell(fp)) <= 0)
+		goto rptcache_load_exit;
+	rewind(fp);
+	data = (unsigned char *)stdalloc(len);
+	if (fread(data, 1, len, fp) != (size_t)len)
+		goto rptcache_load_exit;
+
+	/* check all of it before creating anything */
+	rd.p = data;
+	rd.end = data + len;
+	rd.bad = FALSE;
+	if (!read_header(&rd, rc))
+		goto rptcache_load_exit;
+	if (!get_defns(pactx, &rd, FALSE))
+		goto rptcache_load_exit;
+
+	rd.p = data;
+	rd.bad = FALSE;
+	read_header(&rd, rc);
+	get_defns(pactx, &rd, TRUE);
+	loaded = TRUE;
+
+rptcache_load_exit:
+	if (data)
+		stdfree(data);
+	fclose(fp);
+	return loaded;
+}
+/*===========================================
+ * rptcache_note_defn -- Record top-level definition
+ *  just parsed, for rptcache_save
+ *  what:  [IN]  keyword (global, include, ..., proc, func)
+ *  name:  [IN]  variable, proc or func name (copied)
+ *  args:  [IN]  string constant, or parameters
+ *  body:  [IN]  body of proc or func
+ * Called directly from generated parser code (ie, from code in yacc.y)
+ *=========================================*/
+void
+rptcache_note_defn (PACTX pactx, CNSTRING what, CNSTRING name
+	, PNODE args, PNODE body)
+{
+	RCDEFN defn;
+	if (!pactx->rcache)
+		return;
+	defn = (RCDEFN)stdalloc(sizeof(*defn));
+	defn->what = strsave(what);
+	defn->name = name ? strsave(name) : NULL;
+	defn->line = pactx->lineno;
+	defn->args = args;
+	defn->body = body;
+	enqueue_list(pactx->rcache->defns, defn);
+}
+/*===========================================
+ * rptcache_save -- Write definitions of program file
+ *  just parsed to report cache
+ *  (caller only does so if the file parsed cleanly)
+ *  Written to a file of this process's own, then renamed,
+ *  as other processes may be saving the same report.
+ *=========================================*/
+void
+rptcache_save (PACTX pactx)
+{
+	struct tag_rptcache *rc = pactx->rcache;
+	char tmppath[MAXPATHLEN];
+	BOOLEAN ok = TRUE;
+	FILE *fp;
+
+	if (!rc || !rc->path)
+		return;
+	llstrncpyf(tmppath, sizeof(tmppath), 0, "%s.%ld.tmp", rc->path
+		, (long)getpid());
+	if (!mkalldirs(tmppath) || !(fp = fopen(tmppath, LLWRITEBINARY)))
+		return;
+
+	fwrite(rptcache_magic, 1, sizeof(rptcache_magic), fp);
+	put_int(fp, RPTCACHE_FORMAT);
+	put_int(fp, sizeof(FLOAT));
+	put_int(fp, rc->length);
+	put_int(fp, (INT)(INT64)rc->hash);
+	put_str(fp, LIFELINES_REPORTS_VERSION);
+	put_str(fp, int_codeset ? int_codeset : "");
+	put_str(fp, rc->codeset);
+	FORLIST(rc->defns, el)
+		RCDEFN defn = (RCDEFN)el;
+		put_str(fp, defn->what);
+		put_int(fp, defn->line);
+		put_str(fp, defn->name);
+		if (!put_nodes(fp, defn->args) || !put_nodes(fp, defn->body))
+			ok = FALSE;
+	ENDLIST
+	put_str(fp, NULL);
+
+	if (ferror(fp))
+		ok = FALSE;
+	if (fclose(fp))
+		ok = FALSE;
+	if (!ok || rename(tmppath, rc->path))
+		unlink(tmppath);
+}
+/*===========================================
+ * rptcache_close -- Done with current program file
+ *=========================================*/
+void
+rptcache_close (PACTX pactx)
+{
+	struct tag_rptcache *rc = pactx->rcache;
+	if (!rc)
+		return;
+	while (!is_empty_list(rc->defns)) {
+		RCDEFN defn = (RCDEFN)dequeue_list(rc->defns);
+		stdfree(defn->what);
+		if (defn->name)
+			stdfree(defn->name);
+		stdfree(defn);
+	}
+	destroy_list(rc->defns);
+	strfree(&rc->path);
+	strfree(&rc->codeset);
+	stdfree(rc);
+	pactx->rcache = 0;
+}
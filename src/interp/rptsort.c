@@ -14,6 +14,7 @@
 #include "llstdlib.h"
 /* llstdlib.h pulls in standard.h, config.h, sys_inc.h */
 #include "interpi.h"
+#include "zstr.h"
 
  /*========================================
  * sort_array_by_array -- sort first array of pvalues
@@ -48,34 +49,55 @@ obj_lookup_comparator (OBJECT *pobj1, OBJECT *pobj2, VPTR param)
 typedef struct tag_sortpair {
 	PVALUE value;
 	PVALUE key;
+	CNSTRING sortkey; /* collation key of string key (see make_sortkeys) */
+	INT sortkeyoff;
+	INT sortkeylen;
 } *SORTPAIR;
-#if UNUSED_CODE
-/* comparison fnc to use with our partition_sort, commented out below */
+/* comparison fnc to use with merge_sort */
 static INT
-sortpaircmp (SORTEL el1, SORTEL el2, VPTR param)
+sortpaircmp (SORTEL el1, SORTEL el2, HINT_PARAM_UNUSED VPTR param)
 {
 	SORTPAIR sp1 = (SORTPAIR)el1;
 	SORTPAIR sp2 = (SORTPAIR)el2;
+	ASSERT(sp1->key);
+	ASSERT(sp2->key);
 	return pvalues_collate(sp1->key, sp2->key);
 }
-#endif
-/* IMPORTANT NOTE
- * This function must use a return type of "int", not "INT", in order to be
- * compatible with the definition of qsort().  Since qsort is only expecting
- * a return value of -1, 0 or 1 from this routine, a down-cast from int64_t
- * to int32_t is acceptable.
- */
-static int
-sortpair_bin (const void * el1, const void * el2)
+/* merge_sort comparator on collation keys built by make_sortkeys
+ (safe to call from several threads at once) */
+static INT
+sortpair_sortkey (SORTEL el1, SORTEL el2, HINT_PARAM_UNUSED VPTR param)
 {
-	SORTPAIR sp1, sp2;
-	ASSERT(el1);
-	ASSERT(el2);
-	sp1 = *(SORTPAIR *)el1;
-	sp2 = *(SORTPAIR *)el2;
-	ASSERT(sp1->key);
-	ASSERT(sp2->key);
-	return (int)pvalues_collate(sp1->key, sp2->key);
+	SORTPAIR sp1 = (SORTPAIR)el1;
+	SORTPAIR sp2 = (SORTPAIR)el2;
+	return ll_sortkeycmp(sp1->sortkey, sp1->sortkeylen
+		, sp2->sortkey, sp2->sortkeylen);
+}
+/*========================================
+ * make_sortkeys -- build collation keys of sort pairs
+ *  so sort compares each pair's key without collating again
+ *  only done when all keys are strings
+ *  returns FALSE if not done
+ *  zkeys: [I/O] holds all the collation keys
+ *======================================*/
+static BOOLEAN
+make_sortkeys (struct tag_sortpair * array, INT nsort, ZSTR zkeys)
+{
+	INT i;
+	for (i=0; i<nsort; ++i) {
+		if (ptype(array[i].key) != PSTRING)
+			return FALSE;
+	}
+	for (i=0; i<nsort; ++i) {
+		array[i].sortkeyoff = zs_len(zkeys);
+		if (!ll_sortkey(pvalue_to_string(array[i].key), zkeys))
+			return FALSE;
+		array[i].sortkeylen = zs_len(zkeys) - array[i].sortkeyoff;
+	}
+	/* keys are final now that zkeys is done growing */
+	for (i=0; i<nsort; ++i)
+		array[i].sortkey = zs_str(zkeys) + array[i].sortkeyoff;
+	return TRUE;
 }
 static PVALUE
 sortimpl (PNODE node, SYMTAB stab, BOOLEAN *eflg, BOOLEAN fwd)
@@ -88,6 +110,7 @@ sortimpl (PNODE node, SYMTAB stab, BOOLEAN *eflg, BOOLEAN fwd)
 	INT i=0;
 	struct tag_sortpair * array = 0;
 	SORTPAIR * index = 0;
+	ZSTR zkeys = 0;
 	/* 1st is values collection */
 	/* it must be a list or array */
 	if (which_pvalue_type(val1) == PLIST) {
@@ -158,13 +181,13 @@ sortimpl (PNODE node, SYMTAB stab, BOOLEAN *eflg, BOOLEAN fwd)
 		index[i] = &array[i];
 	}
 
-	qsort(index, nsort, sizeof(index[0]), sortpair_bin);
-
-/* I tried speeding up the lifelines version by removing recursion and
-	doing median of three pivot, but it is still much slower than qsort
-	on MS-Windows (Perry, 2003-03-01)
-*/
-	/* partition_sort((SORTEL *)index, nsort, sortpaircmp, 0);*/
+	/* stable, so pairs with equal keys keep their order */
+	zkeys = zs_new();
+	if (make_sortkeys(array, nsort, zkeys))
+		merge_sort((SORTEL *)index, nsort, sortpair_sortkey, 0, TRUE);
+	else
+		merge_sort((SORTEL *)index, nsort, sortpaircmp, 0, FALSE);
+	zs_free(&zkeys);
 
 	/* Now we reorder both the values (1st) and keys (2nd) collections */
 
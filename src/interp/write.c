@@ -29,12 +29,21 @@
 #include "llstdlib.h"
 #include "gedcom.h"
 #include "interpi.h"
+#include "bulkmerge.h"
 
 /*********************************************
  * external/imported variables
  *********************************************/
 
-extern STRING nonind1,nonstrx,nonnod1,nonnodx;
+extern STRING nonind1,nonstrx,nonnod1,nonnodx,nonlstx,nonboox;
+extern STRING qSbmrglen;
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static void add_merge_line(CNSTRING line, void * param);
+static CNSTRING list_el_key(LIST list, INT index1b);
 
 /*=====================================
  * llrpt_createnode -- Create GEDCOM node
@@ -304,3 +313,101 @@ llrpt_writefam (PNODE node, SYMTAB stab, BOOLEAN *eflg)
 end_writefam:
 	return create_pvalue_from_bool(rtn);
 }
+/*=====================================
+ * llrpt_mergeindis -- Merge many duplicate persons at once
+ * usage: mergeindis(LIST, LIST, BOOL [, LIST]) -> INT
+ *  each person of the first list (or key) is merged into
+ *  the person at the same place in the second list
+ *  if BOOL is TRUE, nothing is changed (dry run)
+ *  lines of report are added to the optional last list
+ *  returns number of persons merged (or that would be)
+ *===================================*/
+PVALUE
+llrpt_mergeindis (PNODE node, SYMTAB stab, BOOLEAN *eflg)
+{
+	PNODE argvar = builtin_args(node);
+	LIST lists[3] = { 0, 0, 0 };
+	CNSTRING * drops=0, * keeps=0;
+	BOOLEAN dryrun;
+	INT i, count, merged;
+	PVALUE val;
+	static STRING argnums[] = { "1", "2", "3", "4" };
+
+	for (i = 0; i < 2; i++, argvar = inext(argvar)) {
+		val = eval_and_coerce(PLIST, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, val, nonlstx, "mergeindis", argnums[i]);
+			delete_pvalue(val);
+			return NULL;
+		}
+		lists[i] = pvalue_to_list(val);
+		delete_pvalue(val);
+	}
+	val = eval_and_coerce(PBOOL, argvar, stab, eflg);
+	if (*eflg) {
+		prog_var_error(node, stab, argvar, val, nonboox, "mergeindis", "3");
+		delete_pvalue(val);
+		return NULL;
+	}
+	dryrun = pvalue_to_bool(val);
+	delete_pvalue(val);
+	if ((argvar = inext(argvar)) != NULL) {
+		val = eval_and_coerce(PLIST, argvar, stab, eflg);
+		if (*eflg) {
+			prog_var_error(node, stab, argvar, val, nonlstx, "mergeindis", "4");
+			delete_pvalue(val);
+			return NULL;
+		}
+		lists[2] = pvalue_to_list(val);
+		delete_pvalue(val);
+	}
+	count = length_list(lists[0]);
+	if (count != length_list(lists[1])) {
+		*eflg = TRUE;
+		prog_var_error(node, stab, NULL, NULL, _(qSbmrglen));
+		return NULL;
+	}
+
+	if (count > 0) {
+		drops = (CNSTRING *)stdalloc(count*sizeof(drops[0]));
+		keeps = (CNSTRING *)stdalloc(count*sizeof(keeps[0]));
+	}
+	for (i = 0; i < count; i++) {
+		drops[i] = strsave(list_el_key(lists[0], i+1));
+		keeps[i] = strsave(list_el_key(lists[1], i+1));
+	}
+	merged = bulk_merge_indis(count, drops, keeps, dryrun
+		, lists[2] ? add_merge_line : NULL, lists[2]);
+	for (i = 0; i < count; i++) {
+		stdfree((STRING)drops[i]);
+		stdfree((STRING)keeps[i]);
+	}
+	if (drops) stdfree((STRING)drops);
+	if (keeps) stdfree((STRING)keeps);
+	return create_pvalue_from_int(merged);
+}
+/*=====================================
+ * list_el_key -- Key of person (or string) in report list
+ *  returns "" if element is neither
+ *===================================*/
+static CNSTRING
+list_el_key (LIST list, INT index1b)
+{
+	PVALUE val = (PVALUE)get_list_element(list, index1b, NULL);
+	CNSTRING key = 0;
+	if (!val)
+		return "";
+	if (which_pvalue_type(val) == PINDI)
+		key = nzkey(pvalue_to_record(val));
+	else if (which_pvalue_type(val) == PSTRING)
+		key = pvalue_to_string(val);
+	return key ? key : "";
+}
+/*=====================================
+ * add_merge_line -- Add line of merge report to report list
+ *===================================*/
+static void
+add_merge_line (CNSTRING line, void * param)
+{
+	enqueue_list((LIST)param, create_pvalue_from_string(line));
+}
@@ -130,6 +130,7 @@ defn 	:	proc
 	|	func
 	|	IDEN '(' IDEN ')' {
 			/* consumes $1 and $3 */
+			rptcache_note_defn(pactx, (STRING) $1, (STRING) $3, 0, 0);
 			if (eqstr("global", (STRING) $1))
 				pa_handle_global((STRING) $3);
 			free_iden($1);
@@ -137,6 +138,7 @@ defn 	:	proc
 		}
 	|	IDEN '(' SCONS ')' {
 			/* consumes $1 */
+			rptcache_note_defn(pactx, (STRING) $1, 0, (PNODE) $3, 0);
 			if (eqstr("include", (STRING) $1))
 				pa_handle_include(pactx, (PNODE) $3);
 			if (eqstr("option", (STRING) $1))
@@ -151,12 +153,14 @@ defn 	:	proc
 
 proc	:	PROC IDEN '(' idenso ')' '{' tmplts '}' {
 			/* consumes $2 */
+			rptcache_note_defn(pactx, "proc", (STRING) $2, (PNODE) $4, (PNODE) $7);
 			pa_handle_proc(pactx, (STRING) $2, (PNODE) $4, (PNODE) $7);
 		}
 
 	;
 func	:	FUNC_TOK IDEN '(' idenso ')' '{' tmplts '}' {
 			/* consumes $2 */
+			rptcache_note_defn(pactx, "func", (STRING) $2, (PNODE) $4, (PNODE) $7);
 			pa_handle_func(pactx, (STRING) $2, (PNODE) $4, (PNODE) $7);
 		}
 	;
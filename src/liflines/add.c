@@ -688,7 +688,7 @@ add_new_fam_to_db (NODE fam2, NODE spouse1, NODE spouse2, NODE child)
 	STRING key=0;
 	STRING xref = getfxref();
 
-	nxref(fam2) = strsave(xref);
+	set_node_xref(fam2, xref);
 
 /* Modify spouse/s and/or child */
 
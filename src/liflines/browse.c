@@ -45,6 +45,7 @@
 
 #include "llinesi.h"
 #include "screen.h"
+#include "screeni.h"
 
 /*********************************************
  * global/exported variables
@@ -77,6 +78,8 @@ extern STRING qSbadhistcnt,qSbadhistcnt2,qSbadhistlen;
  *********************************************/
 
 #define MAX_SPOUSES 30
+#define MAX_PREFETCH 48   /* neighbor records queued per display */
+#define PREFETCH_DEPTH 4  /* links followed out from displayed record */
 struct hist;
 
 /*********************************************
@@ -113,9 +116,13 @@ static void load_nkey_list(STRING key, struct hist * histp);
 static void prompt_add_spouse_with_candidate(RECORD fam, RECORD save);
 static RECORD pick_create_new_family(RECORD current, RECORD save, STRING * addstrings);
 static void pick_remove_spouse_from_family(RECORD frec);
+static BOOLEAN prefetch_neighbor(VPTR param);
+static void queue_prefetch(CNSTRING key, INT depth);
+static void queue_prefetch_links(NODE root, INT depth);
 static void save_hist_lists(void);
 static void save_nkey_list(STRING key, struct hist * histp);
 static void setrecord(RECORD * dest, RECORD * src);
+static void start_prefetch(RECORD rec);
 static void term_hist_lists(void);
 static void term_hist(struct hist * histp);
 
@@ -143,6 +150,14 @@ struct hist {
 static struct hist vhist; /* records visited */
 static struct hist chist; /* records changed */
 
+/* neighbors of displayed record, loaded into cache while idle */
+static struct prefetch_tag {
+	char key[32];
+	INT depth; /* links from displayed record */
+} prefetchq[MAX_PREFETCH];
+static INT prefetch_len = 0;
+static INT prefetch_next = 0;
+
 
 /*********************************************
  * local function definitions
@@ -360,6 +375,68 @@ setrecord (RECORD * dest, RECORD * src)
 		*dest = 0;
 	}
 }
+/*====================================================
+ * start_prefetch -- Queue neighbors of displayed record
+ *  Drops whatever remained queued for the previous
+ *  record, so navigating cancels stale prefetching
+ *==================================================*/
+static void
+start_prefetch (RECORD rec)
+{
+	prefetch_len = prefetch_next = 0;
+	if (!rec) return;
+	queue_prefetch(nzkey(rec), 0);
+	set_interact_idle(&prefetch_neighbor, NULL);
+}
+/*====================================================
+ * queue_prefetch -- Add key to prefetch queue once
+ *==================================================*/
+static void
+queue_prefetch (CNSTRING key, INT depth)
+{
+	INT i;
+	if (!key || prefetch_len >= MAX_PREFETCH) return;
+	for (i=0; i<prefetch_len; ++i) {
+		if (eqstr(prefetchq[i].key, key))
+			return;
+	}
+	llstrncpy(prefetchq[prefetch_len].key, key, sizeof(prefetchq[0].key), uu8);
+	prefetchq[prefetch_len].depth = depth;
+	++prefetch_len;
+}
+/*====================================================
+ * queue_prefetch_links -- Queue families of a person,
+ *  or members of a family
+ *==================================================*/
+static void
+queue_prefetch_links (NODE root, INT depth)
+{
+	NODE node;
+	for (node = nchild(root); node; node = nsibling(node)) {
+		CNSTRING tag = ntag(node);
+		if (eqstr(tag, "FAMC") || eqstr(tag, "FAMS") || eqstr(tag, "HUSB")
+			|| eqstr(tag, "WIFE") || eqstr(tag, "CHIL"))
+			queue_prefetch(rmvat(nval(node)), depth);
+	}
+}
+/*====================================================
+ * prefetch_neighbor -- Idle work: load next queued record
+ *  returns FALSE when queue is exhausted
+ *==================================================*/
+static BOOLEAN
+prefetch_neighbor (HINT_PARAM_UNUSED VPTR param)
+{
+	NODE root;
+	INT depth;
+	if (prefetch_next >= prefetch_len)
+		return FALSE;
+	depth = prefetchq[prefetch_next].depth;
+	root = prefetch_record(prefetchq[prefetch_next].key);
+	++prefetch_next;
+	if (root && depth < PREFETCH_DEPTH)
+		queue_prefetch_links(root, depth+1);
+	return TRUE;
+}
 /*====================================================
  * browse_indi_modes -- Handle person/pedigree browse.
  *  prec1 [I/O]  current record (or upper in tandem screens)
@@ -402,7 +479,9 @@ browse_indi_modes (RECORD *prec1, RECORD *prec2, INDISEQ *pseq, INT indimode)
 		history_record(current, &vhist);
 			/* display & get input, preserving INDI in cache */
 		display_indi(current, indimode, reuse);
+		start_prefetch(current);
 		c = interact_indi();
+		set_interact_idle(NULL, NULL);
 		/* last keynum & mode, so can tell if changed */
 		nkeyp = nzkeynum(current);
 		indimodep = indimode;
@@ -1073,7 +1152,9 @@ browse_fam (RECORD *prec1, RECORD *prec2, INDISEQ *pseq)
 		}
 		history_record(current, &vhist);
 		display_fam(current, fammode, reuse);
+		start_prefetch(current);
 		c = interact_fam();
+		set_interact_idle(NULL, NULL);
 		/* last keynum & mode, so can tell if changed */
 		nkeyp = nzkeynum(current);
 		fammodep = fammode;
@@ -145,6 +145,7 @@ static MenuItem f_MenuItemNext = { N_("+  Next in db"), 0, CMD_NEXT, 0 };
 static MenuItem f_MenuItemPrev = { N_("-  Prev in db"), 0, CMD_PREV, 0 };
 static MenuItem f_MenuItemCopyTopToBottom = { N_("d  Copy top to bottom"), 0, CMD_COPY_TOP_TO_BOTTOM, 0 };
 static MenuItem f_MenuItemMergeBottomToTop = { N_("j  Merge bottom to top"), 0, CMD_MERGE_BOTTOM_TO_TOP, 0 };
+static MenuItem f_MenuItemRelationPath = { N_("r  Relationship path"), 0, CMD_RELATION_PATH, 0 };
 static MenuItem f_MenuItemMoveDownList = { N_("j  Move down list"), 0, CMD_NONE, 0 };
 static MenuItem f_MenuItemMoveUpList = { N_("k  Move up list"), 0, CMD_NONE, 0 };
 static MenuItem f_MenuItemEditThis = { N_("e  Edit this person"), 0, CMD_NONE, 0 };
@@ -317,6 +318,7 @@ static MenuItem * f_Menu2Person[] =
 	&f_MenuItemAddFamily,
 	&f_MenuItemMergeBottomToTop,
 	&f_MenuItemSwitchTopBottom,
+	&f_MenuItemRelationPath,
 	&f_MenuItemModeGedcom,
 	&f_MenuItemModeGedcomX,
 	&f_MenuItemModeGedcomT,
@@ -24,7 +24,6 @@
 /* alphabetical */
 static void disp_to_int(ZSTR zstr);
 static void int_to_disp(ZSTR zstr);
-static size_t output_width(ZSTR zstr);
 
 /*********************************************
  * local & exported function definitions
@@ -53,20 +52,6 @@ disp_to_int (ZSTR zstr)
 	if (xlat)
 		transl_xlat(xlat, zstr); /* ignore failure */
 }
-/*============================
- * output_width -- display width of string in characters
- *==========================*/
-static size_t
-output_width (ZSTR zstr)
-{
-	if (gui8) {
-		/* TODO: Need to use wcswidth here */
-		return str8chlen(zs_str(zstr));
-	} else {
-		return zs_len(zstr);
-
-	}
-}
 /*============================
  * mvcuwaddstr -- convert to GUI codeset & output to screen
  * Created: 2002/12/13 (Perry Rapp)
@@ -105,25 +90,12 @@ mvccwaddnstr (WINDOW *wp, int y, int x, const char *cp, int n)
 
 	if (zs_len(zstr) < (unsigned int)n) {
 		rtn = mvwaddstr(wp, y, x, zs_str(zstr));
+	} else if (gui8) {
+		/* chop at n columns (not n bytes), without breaking a
+		multibyte, counting combining & wide characters by wcwidth */
+		zs_chop(zstr, utf8_fit_width(zs_str(zstr), zs_len(zstr), n));
+		rtn = mvwaddstr(wp, y, x, zs_str(zstr));
 	} else {
-		if (output_width(zstr) > (size_t)n) {
-			STRING str = zs_str(zstr);
-			/* We need to do length truncation correctly for UTF-8 output */
-			/* #1) We need to not break UTF-8 multibytes */
-
-			INT width=0;
-			STRING prev = find_prev_char(&str[n-1], &width, str, gui8);
-			width += (prev - str);
-			zs_chop(zstr, width);
-
-			/* #2) We should account for zero-width characters, eg, use wcwidth */
-			/* Unfortunately, lifelines doesn't yet use wcwidth or config test it */
-			/* TODO:
-			config test for wcswidth
-			and substitute Markus Kuhn's
-			http://www.cl.cam.ac.uk/~mgk25/ucs/wcwidth.c
-			*/
-		}
 		rtn = mvwaddnstr(wp, y, x, zs_str(zstr), n);
 	}
 	zs_free(&zstr);
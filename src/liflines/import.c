@@ -144,6 +144,8 @@ do_import (IMPORT_FEEDBACK ifeed, FILE *fp)
 	TABLE metadatatab = create_table_str();
 	STRING gdcodeset=0;
 	INT warnings=0;
+	BOOLEAN ascii=FALSE, utf8ok;
+	INT badline=0;
 
 	/* start by assuming default */
 	strupdate(&gdcodeset, gedcom_codeset_in);
@@ -158,6 +160,8 @@ do_import (IMPORT_FEEDBACK ifeed, FILE *fp)
 	if (eqstr_ex(unistr, "UTF-8")) {
 		strupdate(&gdcodeset, "UTF-8");
 	}
+	/* one quick pass to learn if file is all ASCII, or valid UTF-8 */
+	utf8ok = check_file_utf8(fp, &ascii, &badline);
 
 	if (!scan_header(fp, metadatatab, &zerr)) {
 		msg_error("%s", zs_str(zerr));
@@ -178,10 +182,20 @@ do_import (IMPORT_FEEDBACK ifeed, FILE *fp)
 		strupdate(&gdcodeset, str);
 	}
 
-	/* TODO: Push this codeset question down to after the validation, where we can know if
-	the incoming file happened to really be all ASCII */
+	if (!utf8ok && eqstr_ex(norm_charmap(gdcodeset), "UTF-8")) {
+		ZSTR zstr=zs_new();
+		BOOLEAN b;
+		zs_setf(zstr, _("File is not valid UTF-8 (first bad character at line " FMT_INT ")")
+			, badline);
+		b = ask_yes_or_no_msg(zs_str(zstr), _("Proceed anyway?"));
+		zs_free(&zstr);
+		if (!b)
+			goto end_import;
+	}
+
+	/* an ASCII file needs no codeset conversion, so no questions about it */
 
-	if (!int_codeset[0]) {
+	if (!int_codeset[0] && !ascii) {
 		/* TODO: ask if user would like to adopt codeset of incoming file, if we found it */
 		if (!ask_yes_or_no_msg(
 			_("No current internal codeset, so no codeset conversion can be done")
@@ -191,7 +205,7 @@ do_import (IMPORT_FEEDBACK ifeed, FILE *fp)
 	}
 
 	/* Warn if lossy code conversion likely */
-	if (gdcodeset[0] && int_codeset[0]) {
+	if (gdcodeset[0] && int_codeset[0] && !ascii) {
 		if (is_lossy_conversion(gdcodeset, int_codeset)) {
 			ZSTR zstr=zs_new();
 			zs_setf(zstr, _("Lossy codeset conversion (from <%s> to <%s>) likely")
@@ -226,7 +240,11 @@ do_import (IMPORT_FEEDBACK ifeed, FILE *fp)
 	if (gdcodeset[0] && int_codeset[0]) {
 retry_input_codeset:
 		ttm = transl_get_xlat(gdcodeset, int_codeset);
-		if (!transl_is_xlat_valid(ttm)) {
+		if (!transl_is_xlat_valid(ttm) && ascii) {
+			/* no conversion needed after all */
+			transl_release_xlat(ttm);
+			ttm = 0;
+		} else if (!transl_is_xlat_valid(ttm)) {
 			ZSTR zstr=zs_new();
 			char csname[64];
 			BOOLEAN b;
@@ -356,8 +374,7 @@ restore_record (NODE node, INT type, HINT_PARAM_UNUSED INT num)
 	default: FATAL();
 	}
 	if (nestr(old, new)) {
-		stdfree(old);
-		nxref(node) = strsave(new);
+		set_node_xref(node, new);
 	}
 	traverse_nodes(node, translate_values, 0);
 	if (type == INDI_REC) {
@@ -413,8 +430,7 @@ translate_values (NODE node, HINT_PARAM_UNUSED VPTR param)
 	STRING new;
 	if (!pointer_value(nval(node))) return TRUE;
 	new = translate_key(rmvat(nval(node)));
-	stdfree(nval(node));
-	nval(node) = strsave(new);
+	set_node_val(node, new);
 	return TRUE;
 }
 /*============================================================
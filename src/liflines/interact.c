@@ -48,12 +48,15 @@ extern STRING qSmn_unkcmd;
 static INT interact_worker(UIWINDOW uiwin, STRING str, INT screen);
 static INT translate_control_key(INT c);
 static INT translate_hdware_key(INT c);
+static INT wgetch_idle(WINDOW * win);
 
 /*********************************************
  * local variables
  *********************************************/
 
 static int ui_time_elapsed = 0; /* total time waiting for user input */
+static INTERACT_IDLE_FNC idle_fnc = 0; /* work to do while waiting */
+static VPTR idle_param = 0;
 
 /*********************************************
  * local & exported function definitions
@@ -99,7 +102,7 @@ interact_worker (UIWINDOW uiwin, STRING str, INT screen)
 		INT time_start=time(NULL);
 		crmode();
 		keypad(uiw_win(uiwin),1);
-		c = wgetch(uiw_win(uiwin));
+		c = wgetch_idle(uiw_win(uiwin));
 		ui_time_elapsed += time(NULL) - time_start;
 		if (c == EOF) c = 'q';
 		nocrmode();
@@ -146,6 +149,36 @@ interact_worker (UIWINDOW uiwin, STRING str, INT screen)
 		/* choice was no good, we loop & wait for another choice */
 	}
 }
+/*===============================
+ * set_interact_idle -- Set (or clear, with NULL)
+ *  work to do while waiting for a key
+ *=============================*/
+void
+set_interact_idle (INTERACT_IDLE_FNC fnc, VPTR param)
+{
+	idle_fnc = fnc;
+	idle_param = param;
+}
+/*===============================
+ * wgetch_idle -- Get key, calling idle function
+ *  as long as no key is waiting and it has work
+ *=============================*/
+static INT
+wgetch_idle (WINDOW * win)
+{
+	INT c = ERR;
+	if (idle_fnc) {
+		wtimeout(win, 0);
+		while ((c = wgetch(win)) == ERR) {
+			if (!(*idle_fnc)(idle_param))
+				break;
+		}
+		wtimeout(win, -1);
+	}
+	if (c == ERR)
+		c = wgetch(win);
+	return c;
+}
 /*===============================
  * translate_hdware_key -- 
  *  translate curses keycode into menuitem.h constant
@@ -75,8 +75,7 @@ browse_list (RECORD *prec1, RECORD *prec2, INDISEQ *pseq)
 		return  BROWSE_QUIT;
 	top = cur = 0;
 	mark =  -1;
-	calc_indiseq_names(seq); /* ensure we have names */
-	current_seq = seq;
+	current_seq = seq; /* names are found as elements are shown */
 
 	while (TRUE) {
 		element_indiseq(seq, cur, &key, &name);
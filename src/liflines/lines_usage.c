@@ -49,6 +49,14 @@ print_lines_usage (CNSTRING exename)
 	printf(_("Specify a user property (e.g. -ILLEDITOR=gvim)"));
 	printf("\n\t-a\n\t\t");
 	printf(_("log dynamic memory operation (for debugging)"));
+	if (0 == strcmp(exename, "llexec")) {
+		printf("\n\t");
+		printf(_("-b[FILE]"));
+		printf("\n\t\t");
+		printf(_("run each report listed in FILE (- for stdin) in turn,\n"
+			"\t\tkeeping the database open between them; each line is\n"
+			"\t\tREPORT [OUTPUT] [KEY=VALUE]..."));
+	}
 	printf("\n\t");
 	printf(_("-c[TYPE][DIRECT,INDIRECT]"));
 	printf("\n\t\t");
@@ -108,6 +116,12 @@ print_lines_usage (CNSTRING exename)
 	    printf(_("Unlock database 'myfamily', after a power failure left the"));
 	    printf("\n\t\t");
 	    printf(_("database locked and run 'eol.ll' report"));
+	    printf("\n\t");
+	    printf(_("%s myfamily -b nightly.txt"), exename);
+	    printf("\n\t\t");
+	    printf(_("Open the database 'myfamily' once and run every report"));
+	    printf("\n\t\t");
+	    printf(_("listed in nightly.txt"));
 	    printf("\n\n");
 	} else {
 	    printf(_("%s myfamily"), exename);
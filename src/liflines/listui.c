@@ -39,6 +39,7 @@
 #include "llinesi.h"
 #include "menuitem.h"
 #include "screen.h"
+#include "screeni.h"
 #include "cscurses.h"
 #include "zstr.h"
 #include "cache.h"
@@ -84,6 +85,9 @@ typedef struct listdisp_s
 	INT listlen; /* #items total */
 	INT top; /* current item at top of display, 0-based */
 	INT mode; /* record display mode */
+	INDISEQ seq; /* records listed, if not array of strings */
+	INT prnwidth; /* width of list items formatted */
+	INT prefetch; /* next item to try formatting while idle */
 } listdisp;
 
 /*********************************************
@@ -95,6 +99,7 @@ static void activate_popup_list_uiwin (listdisp * ld);
 static void display_string(UIWINDOW uiwin, LLRECT rect, STRING text);
 static INT handle_list_cmds(listdisp * ld, INT code);
 static BOOLEAN handle_popup_list_resize(listdisp * ld, INT code);
+static BOOLEAN prefetch_list_items(VPTR param);
 static void print_list_title(char * buffer, INT len, const listdisp * ld, STRING ttl);
 static void shw_array_of_strings(STRING *strings, listdisp *ld
 	, DETAILFNC detfnc, void * param);
@@ -239,11 +244,12 @@ choose_one_or_list_from_indiseq (STRING ttl, INDISEQ seq, BOOLEAN multi)
 
 	ASSERT(seq);
 
-	calc_indiseq_names(seq); /* we certainly need the names */
-	
+	/* names & print lines are found only for items shown */
 	memset(&ld, 0, sizeof(ld));
 	ld.listlen = length_indiseq(seq);
 	ld.mode = 'n';
+	ld.seq = seq;
+	set_interact_idle(&prefetch_list_items, &ld);
 
 	/* TO DO: connect this to menuitem system */
 	if (multi) {
@@ -324,11 +330,40 @@ resize_win: /* we come back here if we resize the window */
 			}
 		}
 	}
+	set_interact_idle(NULL, NULL);
 	deactivate_uiwin_and_touch_all(); /* kills ld.uiwin */
 	ld.uiwin = NULL;
 	
 	return ld.cur;
 }
+/*=============================================================
+ * prefetch_list_items -- Format items near those shown
+ *  while waiting for user, so paging does not wait on them
+ *  (the page or two after those shown, then before)
+ * Returns FALSE when all are formatted
+ *===========================================================*/
+static BOOLEAN
+prefetch_list_items (VPTR param)
+{
+	listdisp * ld = (listdisp *)param;
+	INT rows = ld->rectList.bottom - ld->rectList.top + 1;
+	INT ahead = 2*rows;
+	INT i;
+	if (!ld->seq || !ld->prnwidth)
+		return FALSE;
+	while (ld->prefetch < 2*ahead) {
+		if (ld->prefetch < ahead)
+			i = ld->top + rows + ld->prefetch;
+		else
+			i = ld->top - 1 - (ld->prefetch - ahead);
+		ld->prefetch++;
+		if (i < 0 || i >= ld->listlen)
+			continue;
+		if (preprint_indiseq_element(ld->seq, i, ld->prnwidth, &disp_shrt_rfmt))
+			return TRUE;
+	}
+	return FALSE;
+}
 /*=============================================================
  * handle_list_cmds -- Process choices from list display
  *  This handles moving up & down, adjusting size of detail,
@@ -511,6 +546,9 @@ shw_recordlist_list (INDISEQ seq, listdisp * ld)
 	}
 	if (width > (INT)sizeof(buffer)-1)
 		width = sizeof(buffer)-1;
+	/* items near these may be formatted again while idle */
+	ld->prnwidth = width;
+	ld->prefetch = 0;
 	for (j=0; j<rows; j++) {
 		/* j is zero-based iterator */
 		/* i is actual offset into indiseq */
@@ -779,8 +817,6 @@ manufacture a listdisp here
 	INT viewlines = 13;
 	BOOLEAN scrollable = (viewlines < len);
 
-	calc_indiseq_names(seq); /* we certainly need the names */
-	
 	for (i = LIST_LINES+2; i < LIST_LINES+2+viewlines; i++)
 		mvccwaddstr(win, i, 1, empstr51);
 	row = LIST_LINES+2;
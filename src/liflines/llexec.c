@@ -15,6 +15,9 @@
 #ifdef HAVE_LOCALE_H
 #include <locale.h>
 #endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
 #include "table.h"
 #include "translat.h"
 #include "gedcom.h"
@@ -78,16 +81,32 @@ STRING  readpath = NULL;       /* database path used to open */
 STRING  ext_codeset = 0;       /* default codeset from locale */
 INT screen_width = 20; /* TODO */
 
+/*********************************************
+ * local types
+ *********************************************/
+
+/* one report to run in batch mode (-b) */
+typedef struct tag_batchjob {
+	INT lineno;      /* line of job file */
+	STRING report;
+	STRING outfile;  /* NULL to use -o, if any */
+	TABLE opts;      /* user properties for this job */
+} *BATCHJOB;
+
 /*********************************************
  * local function prototypes
  *********************************************/
 
 /* alphabetical */
+static void free_batch(LIST jobs);
 static void print_usage(void);
 static void load_usage(void);
 static void main_db_notify(STRING db, BOOLEAN opening);
+static double now_seconds(void);
 static void parse_arg(const char * optarg, char ** optname, char **optval);
 static void platform_init(void);
+static LIST read_batch(CNSTRING jobfile, TABLE baseopts);
+static BOOLEAN run_batch(CNSTRING jobfile, STRING progout, TABLE baseopts);
 
 /*********************************************
  * local function definitions
@@ -112,6 +131,8 @@ main (int argc, char **argv)
 	LIST exprogs=NULL;
 	TABLE exargs=NULL;
 	STRING progout=NULL;
+	STRING batchfile=NULL;
+	BOOLEAN batchok=TRUE;
 	STRING configfile=0;
 	STRING crashlog=NULL;
 	int i=0;
@@ -155,7 +176,7 @@ main (int argc, char **argv)
 
 	/* Parse Command-Line Arguments */
 	opterr = 0;	/* turn off getopt's error message */
-	while ((c = getopt(argc, argv, "adkrwil:fntc:Fu:x:o:zC:I:vh?")) != -1) {
+	while ((c = getopt(argc, argv, "adkrwil:fntc:Fu:x:b:o:zC:I:vh?")) != -1) {
 		switch (c) {
 		case 'c':	/* adjust cache sizes */
 			while(optarg && *optarg) {
@@ -238,6 +259,9 @@ main (int argc, char **argv)
 			}
 			push_list(exprogs, strdup(optarg ? optarg : ""));
 			break;
+		case 'b': /* batch of programs, "-" for stdin */
+			batchfile = optarg;
+			break;
 		case 'I': /* program arguments */
 			{
 				STRING optname=0, optval=0;
@@ -352,17 +376,23 @@ prompt_for_db:
 	/* does not use browse module */
 	if (exargs) {
 		set_cmd_options(exargs);
-		release_table(exargs);
-		exargs = 0;
 	}
 	if (exprogs) {
 		BOOLEAN picklist = FALSE;
 		BOOLEAN timing = FALSE;
 		interp_main(exprogs, progout, picklist, timing);
 		destroy_list(exprogs);
-	} else {
+	} else if (!batchfile) {
 		/* TODO: prompt for report filename */
 	}
+	if (batchfile) {
+		/* database stays open, and caches warm, between jobs */
+		batchok = run_batch(batchfile, progout, exargs);
+	}
+	if (exargs) {
+		release_table(exargs);
+		exargs = 0;
+	}
 	/* does not use show module */
 	/* does not use browse module */
 	ok=TRUE;
@@ -387,7 +417,7 @@ usage:
 	if (showusage) puts(usage_summary);
 
 	/* Exit */
-	return !ok;
+	return !ok || !batchok;
 }
 /*==================================
  * parse_arg -- Break argument into name & value
@@ -417,6 +447,165 @@ parse_arg (const char * optarg, char ** optname, char **optval)
 		}
 	}
 }
+/*==================================================
+ * now_seconds -- Wall clock time, for job timing
+ *================================================*/
+static double
+now_seconds (void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec/1000000.0;
+#else
+	return (double)time(NULL);
+#endif
+}
+/*==================================================
+ * read_batch -- Read list of jobs for batch mode
+ *  jobfile:  [IN]  file of jobs, or "-" for stdin
+ *  baseopts: [IN]  user properties given with -I (may be NULL)
+ * Each line holds a report, optionally followed by an
+ * output file ("-" for none) and NAME=VALUE user properties
+ * for that report only.  Blank lines and lines starting
+ * with # are skipped.
+ * All jobs are read before any is run, so that reports
+ * prompting for input do not read jobs from stdin.
+ * Returns NULL (after message) if file cannot be read
+ *================================================*/
+static LIST
+read_batch (CNSTRING jobfile, TABLE baseopts)
+{
+	FILE *fp = eqstr(jobfile, "-") ? stdin : fopen(jobfile, LLREADTEXT);
+	LIST jobs=0;
+	char line[1024];
+	INT lineno=0;
+	BOOLEAN ok=TRUE;
+
+	if (!fp) {
+		llwprintf(_("Cannot open batch file %s\n"), jobfile);
+		return NULL;
+	}
+	jobs = create_list2(LISTNOFREE);
+	while (fgets(line, sizeof(line), fp)) {
+		STRING word;
+		BATCHJOB job=0;
+		INT nword=0;
+		++lineno;
+		if (!strchr(line, '\n') && !feof(fp)) {
+			llwprintf(_("Batch file %s: line " FMT_INT " is too long\n")
+				, jobfile, lineno);
+			ok = FALSE;
+			break;
+		}
+		for (word = strtok(line, " \t\r\n"); word; word = strtok(NULL, " \t\r\n")) {
+			if (!job) {
+				if (word[0] == '#')
+					break;
+				job = (BATCHJOB)stdalloc(sizeof(*job));
+				job->lineno = lineno;
+				job->report = strsave(word);
+				job->outfile = 0;
+				job->opts = create_table_str();
+				if (baseopts)
+					copy_table(baseopts, job->opts);
+				enqueue_list(jobs, job);
+			} else if (strchr(word, '=')) {
+				STRING optname=0, optval=0;
+				parse_arg(word, &optname, &optval);
+				if (optname && optval)
+					replace_table_str(job->opts, optname, optval);
+				strfree(&optname);
+				strfree(&optval);
+			} else if (nword == 1) {
+				job->outfile = strsave(word);
+			} else {
+				llwprintf(_("Batch file %s: line " FMT_INT ": %s is not NAME=VALUE\n")
+					, jobfile, lineno, word);
+				ok = FALSE;
+			}
+			++nword;
+		}
+	}
+	if (fp != stdin)
+		fclose(fp);
+	if (!ok) {
+		free_batch(jobs);
+		return NULL;
+	}
+	return jobs;
+}
+/*==================================================
+ * free_batch -- Free list of jobs from read_batch
+ *================================================*/
+static void
+free_batch (LIST jobs)
+{
+	while (!is_empty_list(jobs)) {
+		BATCHJOB job = (BATCHJOB)dequeue_list(jobs);
+		strfree(&job->report);
+		strfree(&job->outfile);
+		release_table(job->opts);
+		stdfree(job);
+	}
+	destroy_list(jobs);
+}
+/*==================================================
+ * run_batch -- Run each report of job file in turn
+ *  jobfile:  [IN]  file of jobs, or "-" for stdin
+ *  progout:  [IN]  output file for jobs naming none (-o)
+ *  baseopts: [IN]  user properties given with -I (may be NULL)
+ * The interpreter starts each job afresh (as for each
+ * report run from llines), but database and caches are
+ * shared by all of them.  The outcome and wall clock time
+ * of each job is printed after it.
+ * The first job writing to an output file truncates it,
+ * later jobs writing to the same file append to it.
+ * Returns TRUE if every job ran without errors
+ *================================================*/
+static BOOLEAN
+run_batch (CNSTRING jobfile, STRING progout, TABLE baseopts)
+{
+	LIST jobs = read_batch(jobfile, baseopts);
+	TABLE written=0; /* output files already started by a job */
+	INT njobs=0, nfailed=0;
+	double start = now_seconds();
+
+	if (!jobs)
+		return FALSE;
+	written = create_table_int();
+	FORLIST(jobs, el)
+		BATCHJOB job = (BATCHJOB)el;
+		LIST progs = create_list2(LISTDOFREE);
+		STRING outfile = job->outfile ? job->outfile : progout;
+		double jobstart = now_seconds();
+		BOOLEAN ran;
+
+		if (outfile && eqstr(outfile, "-"))
+			outfile = NULL;
+		enqueue_list(progs, strsave(job->report));
+		set_cmd_options(job->opts);
+		rpt_append_output = outfile && in_table(written, outfile);
+		ran = interp_main(progs, outfile, FALSE, FALSE);
+		rpt_append_output = FALSE;
+		if (outfile && !in_table(written, outfile))
+			insert_table_int(written, outfile, 1);
+		destroy_list(progs);
+		++njobs;
+		if (!ran)
+			++nfailed;
+		llwprintf(_("Job " FMT_INT " (line " FMT_INT "): %s: %s, %.3f s\n")
+			, njobs, job->lineno, job->report
+			, ran ? _("ok") : _("failed"), now_seconds() - jobstart);
+	ENDLIST
+	llwprintf(_("Batch: " FMT_INT " jobs, " FMT_INT " failed, %.3f s\n")
+		, njobs, nfailed, now_seconds() - start);
+	if (baseopts)
+		set_cmd_options(baseopts);
+	destroy_table(written);
+	free_batch(jobs);
+	return nfailed == 0;
+}
 /*===================================================
  * shutdown_ui -- (Placeholder, we don't need it)
  *=================================================*/
@@ -131,9 +131,11 @@ void pedigree_toggle_mode(void);
 /* scan.c */
 INDISEQ full_name_scan(STRING sts);
 INDISEQ name_fragment_scan(STRING sts);
+INDISEQ place_scan(STRING sts);
 INDISEQ refn_scan(STRING sts);
 INDISEQ scan_souce_by_author(STRING sts);
 INDISEQ scan_souce_by_title(STRING sts);
+INDISEQ tag_path_scan(STRING sts);
 
 /* screen.c */
 void clear_status_display(void);
@@ -60,8 +60,6 @@ static NODE sort_children(NODE, NODE);
  *********************************************/
 
 /* alphabetical */
-static void check_indi_lineage_links(NODE indi);
-static void check_fam_lineage_links(NODE fam);
 
 
 /*================================================================
@@ -278,8 +276,7 @@ merge_two_indis (NODE indi1, NODE indi2, BOOLEAN conf)
 		that = chil;
 		while (that) {
 			if (eqstr(nval(that), nxref(indi1))) {
-				stdfree(nval(that));
-				nval(that) = strsave(nxref(indi2));
+				set_node_val(that, nxref(indi2));
 			}
 			prev = that;
 			that = nsibling(that);
@@ -346,8 +343,7 @@ merge_two_indis (NODE indi1, NODE indi2, BOOLEAN conf)
 		that = (sx2 == SEX_MALE) ? husb : wife;
 		while (that) {
 			if (eqstr(nval(that), nxref(indi1))) {
-				stdfree(nval(that));
-				nval(that) = strsave(nxref(indi2));
+				set_node_val(that, nxref(indi2));
 			}
 			prev = that;
 			that = nsibling(that);
@@ -626,8 +622,7 @@ merge_fam_links (NODE fam1, NODE fam2, NODE list1, NODE list2, INT code)
 		} else {
 			while (this) {
 				if (eqstr(nval(this), nxref(fam1))) {
-					stdfree(nval(this));
-					nval(this) = strsave(nxref(fam2));
+					set_node_val(this, nxref(fam2));
 				}
 				prev = this;
 				this = nsibling(this);
@@ -740,232 +735,3 @@ remove_dupes (NODE list1, NODE list2)
 	}
 	return copy1;
 }
-/*=================================================
- * check_indi_lineage_links -- Check all families of
- *  this person to make sure they point back to this person
- *===============================================*/
-static void
-check_indi_lineage_links (NODE indi)
-{
-	NODE name=0, refn=0, sex=0, body=0, famc=0, fams=0;
-	NODE curs=0; /* for travesing node lists */
-	TABLE memtab = memtab = create_table_int();
-	TABLE_ITER tabit=0;
-	CNSTRING famkey=0; /* used inside traversal loops */
-	INT count=0;
-	CNSTRING ikey = nxref(indi);
-
-	/* sanity check record is not deleted */
-	ASSERT(is_key_in_use(ikey));
-
-/* Now validate lineage links of this person */
-	split_indi_old(indi, &name, &refn, &sex, &body, &famc, &fams);
-
-	/*
-	Make table listing all families this person is spouse in
-	(& how many times each)
-	*/
-	for (curs = fams; curs; curs = nsibling(curs)) {
-		famkey = rmvat(nval(curs));
-		if (!eqstr(ntag(curs), "FAMS")) {
-			char msg[512];
-			snprintf(msg, sizeof(msg), _("Bad spouse tag: %s"), ntag(curs));
-			FATAL2(msg);
-		}
-		increment_table_int(memtab, famkey);
-	}
-
-	/*
-	Check that all listed families contain person as spouse as many times
-	as expected
-	*/
-	tabit = begin_table_iter(memtab);
-	while (next_table_int(tabit, &famkey, &count)) {
-		NODE fam = key_to_fam(famkey);
-		/*
-		count how many times our main person (ikey)
-		occurs in this family (fam) as a spouse (HUSB or WIFE)
-		*/
-		INT occur = 0;
-		for (curs = nchild(fam); curs; curs = nsibling(curs)) {
-			if (eqstr(ntag(curs), "HUSB") || eqstr(ntag(curs), "WIFE")) {
-				if (eqstr(nval(curs), ikey)) {
-					++occur;
-				}
-			}
-		}
-		if (count != occur) {
-			char msg[512];
-			snprintf(msg, sizeof(msg)
-				, _("Mismatched lineage spouse links between %s and %s: " FMT_INT " and " FMT_INT)
-				, ikey, famkey, count, occur);
-			FATAL2(msg);
-		}
-	}
-	destroy_table(memtab);
-	memtab = create_table_int();
-
-	/*
-	Make table listing all families this person is child in
-	(& how many times each)
-	*/
-	for (curs = famc; curs; curs = nsibling(curs)) {
-		famkey = rmvat(nval(curs));
-		if (!eqstr(ntag(curs), "FAMC")) {
-			char msg[512];
-			snprintf(msg, sizeof(msg), _("Bad child tag: %s"), ntag(curs));
-			FATAL2(msg);
-		}
-		increment_table_int(memtab, famkey);
-	}
-
-	/*
-	Check that all listed families contain person as child (CHIL) as many times
-	as expected
-	*/
-	tabit = begin_table_iter(memtab);
-	while (next_table_int(tabit, &famkey, &count)) {
-		NODE fam = key_to_fam(famkey);
-		/*
-		count how many times our main person (ikey)
-		occurs in this family (fam) as a child (CHIL)
-		*/
-		INT occur = 0;
-		for (curs = nchild(fam); curs; curs = nsibling(curs)) {
-			if (eqstr(ntag(curs), "CHIL")) {
-				if (eqstr(nval(curs), ikey)) {
-					++occur;
-				}
-			}
-		}
-		if (count != occur) {
-			char msg[512];
-			snprintf(msg, sizeof(msg)
-				, _("Mismatched lineage child links between %s and %s: " FMT_INT " and " FMT_INT)
-				, ikey, famkey, count, occur);
-			FATAL2(msg);
-		}
-	}
-
-	join_indi(indi, name, refn, sex, body, famc, fams);
-	destroy_table(memtab);
-}
-/*=================================================
- * check_fam_lineage_links -- Check all persons of
- *  this family to make sure they point back to this family
- *===============================================*/
-static void
-check_fam_lineage_links (NODE fam)
-{
-	NODE fref=0, husb=0, wife=0, chil=0, rest=0;
-	NODE curs=0; /* for travesing node lists */
-	TABLE memtab = memtab = create_table_int();
-	TABLE_ITER tabit=0;
-	CNSTRING indikey=0; /* used inside traversal loops */
-	INT count=0;
-	CNSTRING fkey = nxref(fam);
-
-	/* sanity check record is not deleted */
-	ASSERT(is_key_in_use(fkey));
-	
-/* Now validate lineage links of this family */
-	split_fam(fam, &fref, &husb, &wife, &chil, &rest);
-
-	/*
-	Make table listing all spouses in this family
-	(& how many times each)
-	*/
-	for (curs = husb; curs; curs = nsibling(curs)) {
-		indikey = rmvat(nval(curs));
-		if (!eqstr(ntag(curs), "HUSB")) {
-			char msg[512];
-			snprintf(msg, sizeof(msg), _("Bad HUSB tag: %s"), ntag(curs));
-			FATAL2(msg);
-		}
-		increment_table_int(memtab, indikey);
-	}
-	for (curs = wife; curs; curs = nsibling(curs)) {
-		indikey = rmvat(nval(curs));
-		if (!eqstr(ntag(curs), "WIFE")) {
-			char msg[512];
-			snprintf(msg, sizeof(msg), _("Bad HUSB tag: %s"), ntag(curs));
-			FATAL2(msg);
-		}
-		increment_table_int(memtab, indikey);
-	}
-
-	/*
-	Check that all listed persons contain family as FAMS as many times
-	as expected
-	*/
-	tabit = begin_table_iter(memtab);
-	while (next_table_int(tabit, &indikey, &count)) {
-		NODE indi = key_to_indi(indikey);
-		/*
-		count how many times our main family (fkey)
-		occurs in this person (indi) as a spousal family (FAMS)
-		*/
-		INT occur = 0;
-		for (curs = nchild(indi); curs; curs = nsibling(curs)) {
-			if (eqstr(ntag(curs), "FAMS")) {
-				if (eqstr(nval(curs), fkey)) {
-					++occur;
-				}
-			}
-		}
-		if (count != occur) {
-			char msg[512];
-			snprintf(msg, sizeof(msg)
-				, _("Mismatched lineage spouse links between %s and %s: " FMT_INT " and " FMT_INT)
-				, fkey, indikey, count, occur);
-			FATAL2(msg);
-		}
-	}
-	destroy_table(memtab);
-	memtab = create_table_int();
-
-	/*
-	Make table listing all families this person is child in
-	(& how many times each)
-	*/
-	for (curs = chil; curs; curs = nsibling(curs)) {
-		indikey = rmvat(nval(curs));
-		if (!eqstr(ntag(curs), "CHIL")) {
-			char msg[512];
-			snprintf(msg, sizeof(msg), _("Bad child tag: %s"), ntag(curs));
-			FATAL2(msg);
-		}
-		increment_table_int(memtab, indikey);
-	}
-
-	/*
-	Check that all listed families contain person as FAMC as many times
-	as expected
-	*/
-	tabit = begin_table_iter(memtab);
-	while (next_table_int(tabit, &indikey, &count)) {
-		NODE indi = key_to_indi(indikey);
-		/*
-		count how many times our main family (fkey)
-		occurs in this person (indi) as a parental family (FAMC)
-		*/
-		INT occur = 0;
-		for (curs = nchild(indi); curs; curs = nsibling(curs)) {
-			if (eqstr(ntag(curs), "FAMC")) {
-				if (eqstr(nval(curs), fkey)) {
-					++occur;
-				}
-			}
-		}
-		if (count != occur) {
-			char msg[512];
-			snprintf(msg, sizeof(msg)
-				, _("Mismatched lineage child links between %s and %s: " FMT_INT " and " FMT_INT)
-				, fkey, indikey, count, occur);
-			FATAL2(msg);
-		}
-	}
-	
-	
-	join_fam(fam, fref, husb, wife, chil, rest);
-}
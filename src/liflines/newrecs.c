@@ -198,7 +198,7 @@ edit_add_record (STRING recstr, STRING redt, STRING redtopt, char ntype, STRING
 		if (node) free_nodes(node);
 		return NULL;
 	}
-	nxref(node) = strsave((STRING)(*getreffnc)());
+	set_node_xref(node, (STRING)(*getreffnc)());
 	key = rmvat(nxref(node));
 	for (refn = nchild(node); refn; refn = nsibling(refn)) {
 		if (eqstr("REFN", ntag(refn)) && nval(refn))
@@ -41,8 +41,19 @@ struct displaynode_s
 	struct displaynode_s * nextsib;
 	int keynum; /* used by anc/desc trees */
 	STRING str; /* used by extended gedcom node trees */
+	BOOLEAN expanded; /* anc/desc: parents or children added */
+	INT version; /* anc/desc: versions of records links came from */
+	INT rows; /* anc/desc: rows of subtree at current depth */
 };
 typedef struct displaynode_s *DISPNODE;
+/* anc/desc tree kept between draws */
+typedef struct pedtree_s
+{
+	DISPNODE root;
+	BOOLEAN ancestors;
+	INT gens; /* depth rows were last counted for */
+	INT checked; /* database version links were last checked against */
+} *PEDTREE;
 typedef STRING (*LINEPRINT_FNC)(INT width, void * param);
 /* parameters for anc/desc trees */
 typedef struct indi_print_param_s
@@ -67,26 +78,32 @@ typedef struct node_text_print_param_s
 
 #define GENS_MAX 7
 #define GENS_MIN 2
+#define DISPNODE_BLOCK 256 /* displaynodes allocated at a time */
 
 /*********************************************
  * local function prototypes
  *********************************************/
 
 /* alphabetical */
-static DISPNODE add_children(NODE indi, INT gen, INT maxgen, INT * count);
-static DISPNODE add_parents(NODE indi, INT gen, INT maxgen, INT * count);
+static void add_children(DISPNODE tn);
+static void add_links(DISPNODE tn, BOOLEAN ancestors);
+static void add_parents(DISPNODE tn);
 static DISPNODE alloc_displaynode(void);
 static void append_to_text_list(LIST list, STRING text, INT width, BOOLEAN newline);
 static void check_scroll_max(CANVASDATA canvas);
 static void count_nodes(NODE node, INT gen, INT maxgen, INT * count);
-static void draw_gedcom_text(RECORD rec, CANVASDATA canvas, BOOLEAN reuse, INT indent);
+static DISPNODE detach_subtree(DISPNODE * link, INT keynum);
+static void draw_gedcom_text(RECORD rec, CANVASDATA canvas, INT indent);
+static INT expand_tree(DISPNODE tn, INT gen, INT maxgen, BOOLEAN ancestors, BOOLEAN check);
 static void free_displaynode(DISPNODE tn);
 static void free_dispnode_tree(DISPNODE tn);
-static void free_entire_tree(void);
 static INT get_indent(void);
+static DISPNODE get_pedtree(PEDTREE tree, INT keynum);
 static STRING indi_lineprint(INT width, void * param);
+static INT links_version(NODE indi, BOOLEAN ancestors);
 static STRING node_lineprint(INT width, void * param);
 static void print_to_screen(INT gen, INT indent, INT * row, LINEPRINT_FNC, void *lpf_param, CANVASDATA canvas);
+static BOOLEAN rows_hidden(INT row, INT rows, CANVASDATA canvas);
 static LIST text_to_list (STRING text, INT width, INT whattofree);
 static STRING tn_lineprint(INT width, void * param);
 static void trav_bin_in_print_tn(DISPNODE tn, INT * row, INT gen, INT indent, CANVASDATA canvas);
@@ -102,7 +119,20 @@ static void set_scroll_max(CANVASDATA canvas, INT count);
 static int Gens = 4;
 static int Ancestors_mode = 1;
 static int ScrollMax = 0;
-static DISPNODE Root = 0; /* cached tree we display */
+static DISPNODE Freenodes = 0; /* pool of unused displaynodes, linked by nextsib */
+static struct pedtree_s Anctree = { 0, TRUE, 0, 0 };
+static struct pedtree_s Desctree = { 0, FALSE, 0, 0 };
+static DISPNODE Spare = 0; /* previous root, to graft under new root */
+/* wrapped text tree & what it was built from */
+static struct {
+	DISPNODE root;
+	char key[32];
+	INT version;
+	INT width;
+	INT indent;
+	INT gens;
+	INT rows;
+} Texttree;
 
 /*********************************************
  * local & exported function definitions
@@ -111,16 +141,30 @@ static DISPNODE Root = 0; /* cached tree we display */
 
 /*=================================================
  * alloc_displaynode -- get new displaynode
- *  In preparation for using a block allocator
+ *  Taken from free-list, which is refilled a block
+ *  at a time (blocks are kept for reuse, not freed)
  *===============================================*/
 static DISPNODE
 alloc_displaynode (void)
 {
-	DISPNODE tn = (DISPNODE)stdalloc(sizeof(*tn));
+	DISPNODE tn;
+	if (!Freenodes) {
+		DISPNODE block = (DISPNODE)stdalloc(DISPNODE_BLOCK*sizeof(*block));
+		INT i;
+		for (i=0; i<DISPNODE_BLOCK; i++) {
+			block[i].nextsib = Freenodes;
+			Freenodes = &block[i];
+		}
+	}
+	tn = Freenodes;
+	Freenodes = tn->nextsib;
 	tn->firstchild = NULL;
 	tn->nextsib = NULL;
 	tn->keynum = 0;
 	tn->str = NULL;
+	tn->expanded = FALSE;
+	tn->version = 0;
+	tn->rows = 1;
 	return tn;
 }
 /*========================================
@@ -131,49 +175,88 @@ static void
 free_displaynode (DISPNODE tn)
 {
 	tn->firstchild = NULL;
-	tn->nextsib = NULL;
 	tn->keynum = -1;
 	if (tn->str) {
 		stdfree(tn->str);
 		tn->str = NULL;
 	}
-	stdfree(tn);
+	tn->nextsib = Freenodes;
+	Freenodes = tn;
 }
 /*=================================================
- * add_children -- add children to tree recursively
+ * links_version -- Versions of records that parents
+ *  (or children) of indi are read from
  *===============================================*/
-static DISPNODE
-add_children (NODE indi, INT gen, INT maxgen, INT * count)
+static INT
+links_version (NODE indi, BOOLEAN ancestors)
+{
+	unsigned int version;
+	NODE node;
+	if (!indi) return 0;
+	version = (unsigned int)record_version(rmvat(nxref(indi)));
+	for (node = nchild(indi); node; node = nsibling(node)) {
+		if (eqstr(ntag(node), ancestors ? "FAMC" : "FAMS"))
+			version = version*31 + (unsigned int)record_version(rmvat(nval(node)));
+	}
+	return (INT)version;
+}
+/*=================================================
+ * add_links -- add parents or children of tn
+ *  reusing Spare subtree if it is one of them
+ *===============================================*/
+static void
+add_links (DISPNODE tn, BOOLEAN ancestors)
+{
+	DISPNODE tn1;
+	if (ancestors)
+		add_parents(tn);
+	else
+		add_children(tn);
+	tn->expanded = TRUE;
+	if (!Spare)
+		return;
+	for (tn1 = tn->firstchild; tn1; tn1 = tn1->nextsib) {
+		if (tn1->keynum && tn1->keynum == Spare->keynum) {
+			/* swap in previous tree for the new leaf */
+			DISPNODE * link = &tn->firstchild;
+			while (*link != tn1)
+				link = &(*link)->nextsib;
+			Spare->nextsib = tn1->nextsib;
+			*link = Spare;
+			Spare = 0;
+			free_displaynode(tn1);
+			return;
+		}
+	}
+}
+/*=================================================
+ * add_children -- add children of tn to tree
+ *===============================================*/
+static void
+add_children (DISPNODE tn)
 {
-	DISPNODE tn = alloc_displaynode();
 	DISPNODE tn0, tn1;
+	NODE indi = tn->keynum ? qkeynum_to_indi(tn->keynum) : NULL;
+	INDISEQ childseq;
 	int i;
 
-	tn->keynum = indi_to_keynum(indi);
-	tn->firstchild = 0;
-	tn->nextsib = 0;
-	(*count)++;
-
-	if (gen < maxgen) {
-		INDISEQ childseq = indi_to_children(indi);
-		if (childseq) {
-			tn0=0;
-			for (i=0; i<length_indiseq(childseq); i++) {
-				NODE child;
-				STRING childkey, childname;
-				element_indiseq(childseq, i, &childkey, &childname);
-				child = key_to_indi(childkey);
-				tn1 = add_children(child, gen+1, maxgen, count);
-				/* link new displaynode into tree we're building */
-				if (tn0)
-					tn0 = tn0->nextsib = tn1;
-				else /* first child - first time thru loop */
-					tn0 = tn->firstchild = tn1;
-			}
-			remove_indiseq(childseq);
+	tn->version = links_version(indi, FALSE);
+	childseq = indi_to_children(indi);
+	if (childseq) {
+		tn0=0;
+		for (i=0; i<length_indiseq(childseq); i++) {
+			STRING childkey, childname;
+			element_indiseq(childseq, i, &childkey, &childname);
+			tn1 = alloc_displaynode();
+			tn1->keynum = atoi(childkey+1);
+			/* link new displaynode into tree we're building */
+			if (tn0)
+				tn0 = tn0->nextsib = tn1;
+			else /* first child - first time thru loop */
+				tn0 = tn->firstchild = tn1;
 		}
+		remove_indiseq(childseq);
 	}
-	return tn;
 }
 /*===========================
  * text_to_list -- Split text into list of lines
@@ -401,26 +484,108 @@ count_nodes (NODE node, INT gen, INT maxgen, INT * count)
 	}
 }
 /*===============================================
- * add_parents -- add parents to tree recursively
+ * add_parents -- add parents of tn to tree
+ *  (unknown parents get empty nodes, keynum 0)
+ *=============================================*/
+static void
+add_parents (DISPNODE tn)
+{
+	NODE indi = tn->keynum ? qkeynum_to_indi(tn->keynum) : NULL;
+	tn->version = links_version(indi, TRUE);
+	tn->firstchild = alloc_displaynode();
+	tn->firstchild->keynum = indi_to_keynum(indi_to_fath(indi));
+	/* reload indi in case lost from cache */
+	if (tn->keynum)
+		indi = qkeynum_to_indi(tn->keynum);
+	tn->firstchild->nextsib = alloc_displaynode();
+	tn->firstchild->nextsib->keynum = indi_to_keynum(indi_to_moth(indi));
+}
+/*===============================================
+ * expand_tree -- make anc/desc tree reach maxgen,
+ *  counting rows of each subtree
+ *  check:  [IN]  records changed, so rebuild links that
+ *                came from changed records, and drop
+ *                those past maxgen (as they go unchecked)
+ * returns rows of tn subtree
+ *=============================================*/
+static INT
+expand_tree (DISPNODE tn, INT gen, INT maxgen, BOOLEAN ancestors, BOOLEAN check)
+{
+	DISPNODE tn1;
+	if (check && tn->expanded) {
+		NODE indi = tn->keynum ? qkeynum_to_indi(tn->keynum) : NULL;
+		if (gen >= maxgen || links_version(indi, ancestors) != tn->version) {
+			if (tn->firstchild)
+				free_dispnode_tree(tn->firstchild);
+			tn->firstchild = 0;
+			tn->expanded = FALSE;
+		}
+	}
+	tn->rows = 1;
+	if (gen >= maxgen)
+		return tn->rows;
+	if (!tn->expanded)
+		add_links(tn, ancestors);
+	for (tn1 = tn->firstchild; tn1; tn1 = tn1->nextsib)
+		tn->rows += expand_tree(tn1, gen+1, maxgen, ancestors, check);
+	return tn->rows;
+}
+/*===============================================
+ * detach_subtree -- unlink first subtree for keynum
+ *  link:  [I/O]  link to (sibling list of) tree to search
  *=============================================*/
 static DISPNODE
-add_parents (NODE indi, INT gen, INT maxgen, INT * count)
+detach_subtree (DISPNODE * link, INT keynum)
 {
-	DISPNODE tn = alloc_displaynode();
-	tn->keynum = indi_to_keynum(indi);
-	tn->firstchild = 0;
-	tn->nextsib = 0;
-	(*count)++;
-	if (gen<maxgen) {
-		tn->firstchild = 
-			add_parents(indi_to_fath(indi), gen+1, maxgen, count);
-		/* reload indi in case lost from cache */
-		if (tn->keynum)
-			indi=keynum_to_indi(tn->keynum);
-		tn->firstchild->nextsib = 
-			add_parents(indi_to_moth(indi), gen+1, maxgen, count);
+	DISPNODE tn, found;
+	while ((tn = *link)) {
+		if (tn->keynum == keynum) {
+			*link = tn->nextsib;
+			tn->nextsib = 0;
+			return tn;
+		}
+		if ((found = detach_subtree(&tn->firstchild, keynum)))
+			return found;
+		link = &tn->nextsib;
 	}
-	return tn;
+	return 0;
+}
+/*===============================================
+ * get_pedtree -- anc/desc tree of keynum to Gens
+ *  Reuses what it can of the tree last drawn: all of it
+ *  when nothing changed, the subtree of the new root when
+ *  moving to a relative in the tree, or the old tree as a
+ *  subtree when moving to the old root's parent or child
+ *=============================================*/
+static DISPNODE
+get_pedtree (PEDTREE tree, INT keynum)
+{
+	INT dbversion = database_version();
+	BOOLEAN check = (tree->checked != dbversion);
+	if (tree->root && tree->root->keynum == keynum
+		&& !check && tree->gens == Gens)
+		return tree->root;
+	if (!tree->root || tree->root->keynum != keynum) {
+		DISPNODE old = tree->root, found = 0;
+		if (old && old->firstchild)
+			found = detach_subtree(&old->firstchild, keynum);
+		if (found) {
+			free_dispnode_tree(old);
+			tree->root = found;
+		} else {
+			tree->root = alloc_displaynode();
+			tree->root->keynum = keynum;
+			Spare = old;
+		}
+	}
+	expand_tree(tree->root, 0, Gens, tree->ancestors, check);
+	if (Spare) {
+		free_dispnode_tree(Spare);
+		Spare = 0;
+	}
+	tree->gens = Gens;
+	tree->checked = dbversion;
+	return tree->root;
 }
 /*=====================================
  * print_to_screen -- print output line
@@ -543,10 +708,16 @@ trav_pre_print_tn (DISPNODE tn, INT * row, INT gen, INT indent, CANVASDATA canva
 {
 	DISPNODE n0;
 	struct indi_print_param_s ipp;
+	if (rows_hidden(*row, tn->rows, canvas)) {
+		*row += tn->rows;
+		return;
+	}
 	ipp.keynum = tn->keynum;
 	/* all display printing passes thru generic print_to_screen,
 	which handles scrolling */
 	print_to_screen(gen, indent, row, &indi_lineprint, &ipp, canvas);
+	if (gen >= Gens)
+		return;
 	for (n0=tn->firstchild; n0; n0=n0->nextsib)
 		trav_pre_print_tn(n0, row, gen+1, indent, canvas);
 }
@@ -595,14 +766,31 @@ static void
 trav_bin_in_print_tn (DISPNODE tn, INT * row, INT gen, INT indent, CANVASDATA canvas)
 {
 	struct indi_print_param_s ipp;
+	DISPNODE parent = (gen < Gens) ? tn->firstchild : NULL;
+	if (rows_hidden(*row, tn->rows, canvas)) {
+		*row += tn->rows;
+		return;
+	}
 	ipp.keynum = tn->keynum;
-	if (tn->firstchild)
-		trav_bin_in_print_tn(tn->firstchild, row, gen+1, indent, canvas);
+	if (parent)
+		trav_bin_in_print_tn(parent, row, gen+1, indent, canvas);
 	/* all display printing passes thru generic print_to_screen,
 	which handles scrolling */
 	print_to_screen(gen, indent, row, &indi_lineprint, &ipp, canvas);
-	if (tn->firstchild && tn->firstchild->nextsib)
-		trav_bin_in_print_tn(tn->firstchild->nextsib, row, gen+1, indent, canvas);
+	if (parent && parent->nextsib)
+		trav_bin_in_print_tn(parent->nextsib, row, gen+1, indent, canvas);
+}
+/*===========================================
+ * rows_hidden -- are rows all scrolled off canvas ?
+ *  row:   [IN]  first row (before scrolling)
+ *  rows:  [IN]  number of rows
+ *=========================================*/
+static BOOLEAN
+rows_hidden (INT row, INT rows, CANVASDATA canvas)
+{
+	INT drow = row - canvas->scroll; /* effective display row */
+	return drow + rows - 1 < canvas->rect->top
+		|| drow > canvas->rect->bottom;
 }
 /*======================================================
  * set_scroll_max -- compute max allowable scroll based on
@@ -645,33 +833,31 @@ get_indent (void)
  * Created: 2000/12/07, Perry Rapp
  *=======================================================*/
 void
-pedigree_draw_descendants (RECORD rec, CANVASDATA canvas, BOOLEAN reuse)
+pedigree_draw_descendants (RECORD rec, CANVASDATA canvas
+	, HINT_PARAM_UNUSED BOOLEAN reuse)
 {
 	INT gen=0;
 	INT row = canvas->rect->top;
 	INT indent = get_indent();
-	/* build displaynode tree */
-	if (!reuse) {
-		INT count=0;
-		free_entire_tree();
-		Root = add_children(nztop(rec), gen, Gens, &count);
-		set_scroll_max(canvas, count);
-	}
+	/* build (or update) displaynode tree */
+	DISPNODE root = get_pedtree(&Desctree, nzkeynum(rec));
+	set_scroll_max(canvas, root->rows);
 	check_scroll_max(canvas);
 	/* preorder traversal */
-	trav_pre_print_tn(Root, &row, gen, indent, canvas);
+	trav_pre_print_tn(root, &row, gen, indent, canvas);
 }
 /*=========================================================
  * pedigree_draw_gedcom -- print out gedcom node tree
  * Created: 2001/01/27, Perry Rapp
  *=======================================================*/
 void
-pedigree_draw_gedcom (RECORD rec, INT gdvw, CANVASDATA canvas, BOOLEAN reuse)
+pedigree_draw_gedcom (RECORD rec, INT gdvw, CANVASDATA canvas
+	, HINT_PARAM_UNUSED BOOLEAN reuse)
 {
 	INT count=0, gen=0, row=canvas->rect->top;
 	INT indent = get_indent();
 	if (gdvw == GDVW_TEXT) {
-		draw_gedcom_text(rec, canvas, reuse, indent);
+		draw_gedcom_text(rec, canvas, indent);
 		return;
 	}
 	count_nodes(nztop(rec), gen, Gens, &count);
@@ -684,25 +870,37 @@ pedigree_draw_gedcom (RECORD rec, INT gdvw, CANVASDATA canvas, BOOLEAN reuse)
  * draw_gedcom_text -- print out gedcom node tree in text wrapped view
  *  This builds a displaynode tree then displays it with a
  *  preorder traversal
+ *  The wrapped tree is kept until the record, its version,
+ *  or the width, indent or depth it was wrapped for change
  * Created: 2001/04/15, Perry Rapp
  *=======================================================*/
 static void
-draw_gedcom_text (RECORD rec, CANVASDATA canvas, BOOLEAN reuse, INT indent)
+draw_gedcom_text (RECORD rec, CANVASDATA canvas, INT indent)
 {
 	int gen=0;
 	INT row = canvas->rect->top;
+	INT width = canvas->rect->right - canvas->rect->left;
+	INT version = record_version(nzkey(rec));
 	DISPNODE tn;
-	if (!reuse) {
+	if (!Texttree.root || !eqstr(Texttree.key, nzkey(rec))
+		|| Texttree.version != version || Texttree.width != width
+		|| Texttree.indent != indent || Texttree.gens != Gens) {
 		INT count=0;
-		/* INT skip=0; */
-		free_entire_tree();
-		Root = add_dnodes(nztop(rec), gen, indent, Gens, &count, canvas);
-		set_scroll_max(canvas, count); 
+		if (Texttree.root)
+			free_dispnode_tree(Texttree.root);
+		Texttree.root = add_dnodes(nztop(rec), gen, indent, Gens, &count, canvas);
+		llstrncpy(Texttree.key, nzkey(rec), sizeof(Texttree.key), uu8);
+		Texttree.version = version;
+		Texttree.width = width;
+		Texttree.indent = indent;
+		Texttree.gens = Gens;
+		Texttree.rows = count;
 	}
+	set_scroll_max(canvas, Texttree.rows);
 	check_scroll_max(canvas);
 	/* preorder traversal */
 	/* root may have siblings due to overflow/assimilation */
-	for (tn=Root ; tn; tn = tn->nextsib) {
+	for (tn=Texttree.root ; tn; tn = tn->nextsib) {
 		trav_pre_print_tn_str(tn, &row, gen, indent, canvas);
 	}
 }
@@ -713,21 +911,18 @@ draw_gedcom_text (RECORD rec, CANVASDATA canvas, BOOLEAN reuse, INT indent)
  * Created: 2000/12/07, Perry Rapp
  *===================================================*/
 void
-pedigree_draw_ancestors (RECORD irec, CANVASDATA canvas, BOOLEAN reuse)
+pedigree_draw_ancestors (RECORD irec, CANVASDATA canvas
+	, HINT_PARAM_UNUSED BOOLEAN reuse)
 {
 	int gen=0;
 	INT row = canvas->rect->top;
 	INT indent = get_indent();
-	/* build displaynode tree */
-	if (!reuse) {
-		INT count=0;
-		free_entire_tree();
-		Root = add_parents(nztop(irec), gen, Gens, &count);
-		set_scroll_max(canvas, count);
-	}
+	/* build (or update) displaynode tree */
+	DISPNODE root = get_pedtree(&Anctree, nzkeynum(irec));
+	set_scroll_max(canvas, root->rows);
 	check_scroll_max(canvas);
 	/* inorder traversal */
-	trav_bin_in_print_tn(Root, &row, gen, indent, canvas);
+	trav_bin_in_print_tn(root, &row, gen, indent, canvas);
 }
 /*===========================================
  * pedigree_toggle_mode -- toggle between 
@@ -771,17 +966,3 @@ free_dispnode_tree (DISPNODE tn)
 	if (sib)
 		free_dispnode_tree(sib);
 }
-/*===============================================================
- * free_entire_tree -- free a displaynode tree
- *  Root may have siblings because of overflow/assimilation
- * Created: 2000/04/15, Perry Rapp
- *=============================================================*/
-static void
-free_entire_tree (void)
-{
-	if (Root) {
-		/* free_dispnode_tree frees both children & siblings */
-		free_dispnode_tree(Root);
-		Root = 0;
-	}
-}
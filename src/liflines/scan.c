@@ -35,6 +35,8 @@
 #include "feedback.h"
 #include "liflines.h"
 #include "fpattern.h"
+#include "rawscan.h"
+#include "tagindex.h"
 
 #include "llinesi.h"
 
@@ -67,15 +69,20 @@ static INT SCAN_NAME_FRAG=1;
 static INT SCAN_REFN=2;
 static INT SCAN_SRC_AUTH=3;
 static INT SCAN_SRC_TITL=4;
+static INT SCAN_TAG_PATH=5;
 
 /*********************************************
  * local function prototypes
  *********************************************/
 
-static void do_fields_scan(SCANNER * scanner, RECORD rec);
+static BOOLEAN ask_scan_pattern(SCANNER * scanner, CNSTRING prompt);
 static void do_name_scan(SCANNER * scanner, STRING prompt);
+static void do_raw_scan(SCANNER * scanner, CNSTRING rtypes, CNSTRING tagpath);
 static void do_sources_scan(SCANNER * scanner, CNSTRING prompt);
+static BOOLEAN index_callback(CNSTRING key, CNSTRING value, void *param);
+static BOOLEAN index_scan(SCANNER * scanner);
 static BOOLEAN ns_callback(CNSTRING key, CNSTRING name, BOOLEAN newset, void *param);
+static BOOLEAN raw_callback(CNSTRING key, void *param);
 static BOOLEAN rs_callback(CNSTRING key, CNSTRING refn, BOOLEAN newset, void *param);
 static void scanner_add_result(SCANNER * scanner, CNSTRING key);
 static BOOLEAN scanner_does_pattern_match(SCANNER *scanner, CNSTRING text);
@@ -186,6 +193,92 @@ do_name_scan (SCANNER * scanner, STRING prompt)
 	msg_status("%s", (STRING)scanner->statusmsg);
 	traverse_names(ns_callback, scanner);
 }
+/*==============================
+ * tag_path_scan -- Ask for tag path & pattern and search all records
+ *  sts: [IN]  status to show during scan
+ *============================*/
+INDISEQ
+tag_path_scan (STRING sts)
+{
+	SCANNER scanner;
+	scanner_init(&scanner, SCAN_TAG_PATH, sts);
+	while (1) {
+		char request[MAXPATHLEN];
+		STRING prompt = _("Enter tag path to scan (eg, SOUR.TITL or *.NOTE).");
+		BOOLEAN rtn = ask_for_string(prompt, _("tag path: "),
+			request, sizeof(request));
+		if (!rtn || !request[0])
+			return scanner_free_and_return_seq(&scanner);
+		if (rawscan_tagpath_isvalid(request)) {
+			scanner_set_field(&scanner, request);
+			break;
+		}
+	}
+	scanner.conts = TRUE;
+	if (ask_scan_pattern(&scanner, _("Enter pattern to match against tag values."))
+		&& !index_scan(&scanner))
+		do_raw_scan(&scanner, NULL, scanner.field);
+	return scanner_free_and_return_seq(&scanner);
+}
+/*==============================
+ * place_scan -- Ask for place and find persons with events there
+ *  (uses place index, so no records are read)
+ *  sts: [IN]  status to show during search
+ *============================*/
+INDISEQ
+place_scan (STRING sts)
+{
+	char request[MAXPATHLEN];
+	STRING prompt = _("Enter place to find (eg, Bristol, Gloucestershire).");
+	BOOLEAN rtn = ask_for_string(prompt, _("place: "),
+		request, sizeof(request));
+	INDISEQ seq;
+	if (!rtn || !request[0])
+		return NULL;
+	msg_status("%s", sts);
+	seq = place_indiseq(request, NULL);
+	namesort_indiseq(seq);
+	return seq;
+}
+/*==============================
+ * index_scan -- Look pattern up in index of tag path, if
+ *  there is one of whole values, and pattern is plain text
+ *  (perhaps ending in *, to find values starting with it)
+ *  Unlike a raw scan, this does not check CONC & CONT lines.
+ *  scanner:   [I/O] all necessary scan info, including sequence of results
+ * returns FALSE if there is no such index, or pattern is not plain
+ *============================*/
+static BOOLEAN
+index_scan (SCANNER * scanner)
+{
+	char value[sizeof(scanner->pattern)];
+	CNSTRING ext = tagindex_extractor(scanner->field);
+	BOOLEAN prefix = FALSE;
+	INT len;
+	if (!ext || !eqstr(ext, "value"))
+		return FALSE;
+	strcpy(value, scanner->pattern);
+	len = strlen(value);
+	if (len && value[len-1] == FPAT_CLOS) {
+		value[--len] = 0;
+		prefix = TRUE;
+	}
+	if (!len || strpbrk(value, "\\`/!?*[]\x1A"))
+		return FALSE;
+	msg_status("%s", (STRING)scanner->statusmsg);
+	tagindex_find(scanner->field, value, prefix, &index_callback, scanner);
+	return TRUE;
+}
+/*===========================================
+ * index_callback -- callback for index lookup
+ *=========================================*/
+static BOOLEAN
+index_callback (CNSTRING key, HINT_PARAM_UNUSED CNSTRING value, void *param)
+{
+	SCANNER * scanner = (SCANNER *)param;
+	scanner_add_result(scanner, key);
+	return TRUE;
+}
 /*==============================
  * do_sources_scan -- traverse sources looking for pattern matching
  *  scanner:   [I/O] all necessary scan info, including sequence of results
@@ -194,66 +287,48 @@ do_name_scan (SCANNER * scanner, STRING prompt)
 static void
 do_sources_scan (SCANNER * scanner, CNSTRING prompt)
 {
-	INT keynum = 0;
+	char tagpath[64];
 
+	if (!ask_scan_pattern(scanner, prompt))
+		return;
+	/* NB: Only scanning top-level nodes right now */
+	snprintf(tagpath, sizeof(tagpath), "SOUR.%s", scanner->field);
+	do_raw_scan(scanner, "S", tagpath);
+}
+/*==============================
+ * ask_scan_pattern -- ask user for pattern until valid
+ *  scanner:   [I/O] all necessary scan info
+ *  prompt:    [IN]  appropriate prompt to ask for pattern
+ * returns FALSE if user cancelled
+ *============================*/
+static BOOLEAN
+ask_scan_pattern (SCANNER * scanner, CNSTRING prompt)
+{
 	while (1) {
 		char request[MAXPATHLEN];
 		BOOLEAN rtn = ask_for_string(prompt, _("pattern: "),
 			request, sizeof(request));
 		if (!rtn || !request[0])
-			return;
+			return FALSE;
 		if (scanner_set_pattern(scanner, request))
-			break;
-	}
-	/* msg_status takes STRING arg, should take CNSTRING - const declaration error */
-	msg_status("%s", (STRING)scanner->statusmsg);
-
-	while (1) {
-		RECORD rec = 0;
-		keynum = xref_nexts(keynum);
-		if (!keynum)
-			break;
-		rec = keynum_to_srecord(keynum);
-		do_fields_scan(scanner, rec);
+			return TRUE;
 	}
 }
 /*==============================
- * do_fields_scan -- traverse top nodes looking for desired field value
+ * do_raw_scan -- scan raw records for values matching pattern
+ *  (does not load records into cache)
  *  scanner:   [I/O] all necessary scan info, including sequence of results
- *  rec:       [IN]  record to search
+ *  rtypes:    [IN]  types of records to scan (NULL for all)
+ *  tagpath:   [IN]  tags from level 0 down, eg "SOUR.AUTH"
  *============================*/
 static void
-do_fields_scan (SCANNER * scanner, RECORD rec)
+do_raw_scan (SCANNER * scanner, CNSTRING rtypes, CNSTRING tagpath)
 {
-	/* NB: Only scanning top-level nodes right now */
-	NODE node = nztop(rec);
-	for (node = nchild(node); node; node = nsibling(node)) {
-		STRING tag = ntag(node);
-		if (tag && eqstr(tag, scanner->field)) {
-			STRING val = nval(node);
-			if (val && scanner_does_pattern_match(scanner, val)) {
-				CNSTRING key = nzkey(rec);
-				scanner_add_result(scanner, key);
-				return;
-			}
-			if (scanner->conts) {
-				NODE node2 = 0;
-				for (node2 = nchild(node); node2; node2 = nsibling(node2)) {
-					STRING tag2 = ntag(node2);
-					if (tag2 && (eqstr(tag2, "CONC") || eqstr(tag2, "CONT"))) {
-						STRING val2 = nval(node2);
-						if (val2 && scanner_does_pattern_match(scanner, val2)) {
-							CNSTRING key = nzkey(rec);
-							scanner_add_result(scanner, key);
-							return;
-						}
-					} else {
-						break;
-					}
-				}
-			}
-		}
-	}
+	SCANPATTERN scanpat = create_scan_pattern(scanner->pattern);
+	/* msg_status takes STRING arg, should take CNSTRING - const declaration error */
+	msg_status("%s", (STRING)scanner->statusmsg);
+	rawscan_records(rtypes, tagpath, scanner->conts, scanpat, raw_callback, scanner);
+	destroy_scan_pattern(scanpat);
 }
 /*==============================
  * init_scan_pattern -- Initialize scan pattern fields
@@ -364,6 +439,16 @@ ns_callback (CNSTRING key, CNSTRING name, HINT_PARAM_UNUSED BOOLEAN newset, void
 	}
 	return TRUE;
 }
+/*===========================================
+ * raw_callback -- callback for raw record scan
+ *=========================================*/
+static BOOLEAN
+raw_callback (CNSTRING key, void *param)
+{
+	SCANNER * scanner = (SCANNER *)param;
+	scanner_add_result(scanner, key);
+	return TRUE;
+}
 /*===========================================
  * rs_callback -- callback for refn traversal
  *=========================================*/
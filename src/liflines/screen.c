@@ -67,6 +67,14 @@ INT MAINWIN_WIDTH=0;
 #define NEWWIN(r,c)   newwin(r,c,(LINES - (r))/2,(COLS - (c))/2)
 #define SUBWIN(w,r,c) subwin(w,r,c,(LINES - (r))/2,(COLS - (c))/2)
 
+/* what show_row last drew on one row of a window */
+struct tag_uirow {
+	INT x1;
+	INT x2;
+	INT maxlen;
+	STRING text; /* NULL if row unknown */
+};
+
 /*********************************************
  * global/exported variables
  *********************************************/
@@ -160,6 +168,7 @@ static void edit_tt_menu(void);
 static void edit_user_options(void);
 static void edit_place_table(void);
 static void end_action(void);
+static void forget_rows(UIWINDOW uiwin, LLRECT rect);
 BOOLEAN get_answer(UIWINDOW uiwin, INT row, INT col, STRING buffer, INT buflen);
 static INT get_brwsmenu_size(INT screen);
 static RECORD invoke_add_menu(void);
@@ -469,6 +478,8 @@ create_uiwindow_impl (UIWINDOW * puiw, CNSTRING name, WINDOW * win, INT rows, IN
 	}
 	uiw_rows(uiwin) = rows;
 	uiw_cols(uiwin) = cols;
+	/* new or resized curses window holds none of the old rows */
+	forget_rows(uiwin, NULL);
 }
 /*==========================================
  * add_uiwin -- Record new uiwin into master list
@@ -535,6 +546,10 @@ delete_uiwindow_impl (UIWINDOW w)
 		// delete window name
 		ASSERT(w->name);
 		stdfree((STRING)w->name);
+		// delete row image
+		forget_rows(w, NULL);
+		if (w->rowimg)
+			stdfree(w->rowimg);
 		// delete window
 		stdfree(w);
 	}
@@ -2457,6 +2472,17 @@ clear_stdout_hseg (INT row, INT x1, INT x2)
 void
 clear_hseg (WINDOW *win, INT row, INT x1, INT x2)
 {
+	struct tag_llrect rect;
+	rect.top = rect.bottom = row;
+	rect.left = x1;
+	rect.right = x2;
+	/* whatever show_row left here is going */
+	if (list_uiwin) {
+		FORLIST(list_uiwin, el)
+			if (uiw_win((UIWINDOW)el) == win)
+				forget_rows((UIWINDOW)el, &rect);
+		ENDLIST
+	}
 	/* workaround for curses bug with spacs */
 	if (getlloptint("ForceScreenErase", 0) > 0) {
 		/* fill virtual output with dots */
@@ -2981,6 +3007,7 @@ void
 wipe_window_rect (UIWINDOW uiwin, LLRECT rect)
 {
 	WINDOW * win = uiw_win(uiwin);
+	forget_rows(uiwin, rect);
 	/* workaround for curses bug with spaces */
 	if (getlloptint("ForceScreenErase", 0) > 0) {
 		/*
@@ -3004,6 +3031,78 @@ wipe_window_rect (UIWINDOW uiwin, LLRECT rect)
 			werase(win); /* let curses do it */
 	}
 }
+/*================================================
+ * show_row -- Put text on one row of a window
+ *  uiwin:  [IN] window
+ *  row:    [IN] row to draw on
+ *  x1,x2:  [IN] segment of row owned by the text
+ *  text:   [IN] text to show (internal codeset), may be empty
+ *  maxlen: [IN] columns allowed for text (<=0 for no limit)
+ * Does nothing if show_row already put the same text on the
+ * same segment, and nothing else has wiped it since, so
+ * that redisplaying a record only touches the rows that
+ * changed. Anything that draws other text into a window
+ * must go through wipe_window_rect (or uierase) first.
+ *==============================================*/
+void
+show_row (UIWINDOW uiwin, INT row, INT x1, INT x2, CNSTRING text, INT maxlen)
+{
+	WINDOW * win = uiw_win(uiwin);
+	struct tag_uirow * img = 0;
+
+	if (row < 0 || row >= uiw_rows(uiwin))
+		return;
+	if (getlloptint("ForceScreenErase", 0) <= 0) {
+		if (row >= uiwin->rowimg_len) {
+			INT len = uiw_rows(uiwin);
+			struct tag_uirow * rows = (struct tag_uirow *)stdalloc(len*sizeof(*rows));
+			memset(rows, 0, len*sizeof(*rows));
+			if (uiwin->rowimg) {
+				memcpy(rows, uiwin->rowimg, uiwin->rowimg_len*sizeof(*rows));
+				stdfree(uiwin->rowimg);
+			}
+			uiwin->rowimg = rows;
+			uiwin->rowimg_len = len;
+		}
+		img = &uiwin->rowimg[row];
+		if (img->text && img->x1 == x1 && img->x2 == x2
+			&& img->maxlen == maxlen && eqstr(img->text, text))
+			return;
+	}
+	clear_hseg(win, row, x1, x2);
+	if (text[0]) {
+		if (maxlen > 0)
+			mvccwaddnstr(win, row, x1, text, maxlen);
+		else
+			mvccwaddstr(win, row, x1, text);
+	}
+	if (img) {
+		strfree(&img->text);
+		img->text = strsave(text);
+		img->x1 = x1;
+		img->x2 = x2;
+		img->maxlen = maxlen;
+	}
+}
+/*================================================
+ * forget_rows -- Drop row image of rows in rect
+ *  (all rows if rect is NULL)
+ *  because something else is drawing on them
+ *==============================================*/
+static void
+forget_rows (UIWINDOW uiwin, LLRECT rect)
+{
+	INT top = 0, bottom = uiwin->rowimg_len-1;
+	INT i;
+	if (rect) {
+		if (rect->top > top)
+			top = rect->top;
+		if (rect->bottom < bottom)
+			bottom = rect->bottom;
+	}
+	for (i=top; i<=bottom; ++i)
+		strfree(&uiwin->rowimg[i].text);
+}
 /*============================
  * uicolor -- fill window with character
  *  if rect is nonzero, fill that rectangular area
@@ -7,8 +7,11 @@
 #define screeni_h_included
 
 /* interact.c */
+/* does a little background work, returns FALSE when none is left */
+typedef BOOLEAN (*INTERACT_IDLE_FNC)(VPTR param);
 INT interact_choice_string(UIWINDOW uiwin, STRING str);
 INT interact_screen_menu(UIWINDOW uiwin, INT screen);
+void set_interact_idle(INTERACT_IDLE_FNC fnc, VPTR param);
 
 /* screen.h */
 void place_cursor_popup(UIWINDOW uiwin);
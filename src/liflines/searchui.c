@@ -42,7 +42,7 @@
 extern STRING qSmn_ret;
 extern STRING qSmn_sea_ttl;
 extern STRING qSsts_sca_ful,qSsts_sca_fra,qSsts_sca_ref,qSsts_sca_non;
-extern STRING qSsts_sca_src;
+extern STRING qSsts_sca_pla,qSsts_sca_src,qSsts_sca_tag;
 
 /*********************************************
  * local function prototypes
@@ -167,7 +167,7 @@ invoke_fullscan_menu (void)
 	BOOLEAN done=FALSE;
 
 	if (!fullscan_menu_win) {
-		create_newwin2(&fullscan_menu_win, "fullscan", 8, 66);
+		create_newwin2(&fullscan_menu_win, "fullscan", 10, 66);
 		/* paint it for the first & only time (it's static) */
 		repaint_fullscan_menu(fullscan_menu_win);
 	}
@@ -176,7 +176,7 @@ invoke_fullscan_menu (void)
 	while (!done) {
 		activate_uiwin(uiwin);
 		place_cursor_popup(uiwin);
-		code = interact_choice_string(uiwin, "fnrsq");
+		code = interact_choice_string(uiwin, "fnprstq");
 
 		switch (code) {
 		case 'f':
@@ -185,12 +185,18 @@ invoke_fullscan_menu (void)
 		case 'n':
 			seq = name_fragment_scan(_(qSsts_sca_fra));
 			break;
+		case 'p':
+			seq = place_scan(_(qSsts_sca_pla));
+			break;
 		case 'r':
 			seq = refn_scan(_(qSsts_sca_ref));
 			break;
 		case 's':
 			seq = invoke_search_source_menu();
 			break;
+		case 't':
+			seq = tag_path_scan(_(qSsts_sca_tag));
+			break;
 		case 'q': 
 			done=TRUE;
 			break;
@@ -222,8 +228,10 @@ repaint_fullscan_menu (UIWINDOW uiwin)
 	mvccwaddstr(win, row++, 2, title);
 	mvccwaddstr(win, row++, 4, _("f  Full name scan"));
 	mvccwaddstr(win, row++, 4, _("n  Name fragment (whitespace-delimited) scan"));
+	mvccwaddstr(win, row++, 4, _("p  Place search (place index)"));
 	mvccwaddstr(win, row++, 4, _("r  Refn scan"));
 	mvccwaddstr(win, row++, 4, _("s  Source scan"));
+	mvccwaddstr(win, row++, 4, _("t  Tag scan (all record types)"));
 	mvccwaddstr(win, row++, 4, _(qSmn_ret));
 	/* set cursor position */
 	uiw_cury(uiwin) = 1;
@@ -76,31 +76,65 @@ struct tag_prefix {
 	STRING tag;
 	STRING prefix;
 };
+/* a record drawn on by a display, and its version then */
+struct tag_dispdep {
+	char key[MAXKEYWIDTH+1];
+	INT version;
+};
+/* formatted vitals display of one person or family */
+typedef struct tag_dispent {
+	INT type;          /* 'I' or 'F', 0 if unused */
+	char key[MAXKEYWIDTH+1];
+	INT width;
+	INT layout;        /* display_layout() when formatted */
+	INT lastuse;       /* for choosing which to replace */
+	struct tag_dispdep * deps;
+	INT ndeps;
+	INT maxdeps;
+	ZSTR * lines;      /* fixed lines, then spouses & children */
+	INT nlines;
+	INT maxlines;
+	ZSTR badkeys;      /* missing keys found while formatting */
+} * DISPENT;
 
 /*********************************************
  * local enums & defines
  *********************************************/
 
-/* to handle large families, this needs to be made a regular
-variable, and checked & resized at init_display_indi time */
-#define MAXOTHERS 30
+/* how many formatted displays to keep (tandem shows two,
+and browsing often goes back & forth among a few) */
+#define MAXDISPENTS 8
+/* lines above spouses & children in vitals displays */
+#define INDI_FIXED 5
+#define FAM_FIXED 7
 
 /*********************************************
  * local function prototypes
  *********************************************/
 
 /* alphabetical */
-static void add_child_line(INT, RECORD, INT width);
-static void add_spouse_line(INT, NODE, NODE, INT width);
+static void add_child_line(DISPENT ent, INT, RECORD, INT width, INT skip);
+static void add_dep(DISPENT ent, CNSTRING key);
+static void add_fam_deps(DISPENT ent, NODE fam);
+static ZSTR add_line(DISPENT ent);
+static void add_spouse_line(DISPENT ent, INT, NODE, NODE, INT width);
 static BOOLEAN append_event(STRING * pstr, STRING evt, INT * plen, INT minlen);
+static BOOLEAN deps_current(DISPENT ent);
 static void disp_person_birthdeath(ZSTR zstr, RECORD irec, struct tag_prefix * tags, RFMT rfmt);
 static void disp_person_name(ZSTR zstr, STRING prefix, RECORD irec, INT width);
+static INT display_layout(void);
+static void flush_displays(VPTR uparm);
+static STRING format_out_line(INT x, STRING string, INT maxcol, INT flag);
+static DISPENT get_display(INT type, RECORD rec, INT width, BOOLEAN reuse);
 static void indi_events(STRING outstr, NODE indi, INT len);
-static void init_display_indi(RECORD irec, INT width);
-static void init_display_fam(RECORD frec, INT width);
+static void init_display_indi(DISPENT ent, RECORD irec, INT width);
+static void init_display_fam(DISPENT ent, RECORD frec, INT width);
+static INT max_keywidth(void);
 static void pedigree_line(CANVASDATA canvas, INT x, INT y, STRING string, INT overflow);
 static STRING person_display(NODE, NODE, INT);
 static void put_out_line(UIWINDOW uiwin, INT x, INT y, STRING string, INT maxcol, INT flag);
+static void show_display(UIWINDOW uiwin, DISPENT ent, LLRECT rect, INT nfixed
+	, INT fixedlen, INT othersleft, INT othersmax, INT *scroll);
 static STRING sh_fam_to_event_shrt(NODE node, STRING tag, STRING head
 	, INT len);
 static STRING sh_indi_to_event_long(NODE node, STRING tag
@@ -112,13 +146,10 @@ static STRING sh_indi_to_event_shrt(NODE node, STRING tag
  * local variables
  *********************************************/
 
-static LINESTRING Sfath, Smoth, Smarr;
-static ZSTR Spers=0, Sbirt=0, Sdeat=0;
-static ZSTR Shusb=0, Swife=0;
-static ZSTR Shbirt=0, Shdeat=0, Swbirt=0, Swdeat=0;
-static LINESTRING Sothers[MAXOTHERS];
+static struct tag_dispent Sdisps[MAXDISPENTS];
+static INT Sdispclock = 0;
+static LINESTRING Sline; /* scratch for building a line */
 static INT liwidth;
-static INT Solen = 0;
 static INT Scroll2 = 0;
 static INT number_child_enable = 0;
 static struct tag_prefix f_birth_tags[] = {
@@ -150,23 +181,13 @@ static struct tag_prefix f_death_tags[] = {
 void
 init_show_module (void)
 {
-	INT i;
 	liwidth = ll_cols+1;
 
-	Spers = zs_new();
-	Sbirt = zs_new();
-	Sdeat = zs_new();
-	Sfath = (LINESTRING)stdalloc(liwidth);
-	Smoth = (LINESTRING)stdalloc(liwidth);
-	Smarr = (LINESTRING)stdalloc(liwidth);
-	Shusb = zs_new();
-	Shbirt = zs_new();
-	Shdeat = zs_new();
-	Swife = zs_new();
-	Swbirt = zs_new();
-	Swdeat = zs_new();
-	for (i=0; i<MAXOTHERS; i++)
-		Sothers[i] = (LINESTRING)stdalloc(liwidth);
+	Sline = (LINESTRING)stdalloc(liwidth);
+	memset(Sdisps, 0, sizeof(Sdisps));
+	/* formatting depends on options & language */
+	register_notify(&flush_displays);
+	register_uilang_callback(&flush_displays, 0);
 	init_disp_reformat();
 }
 /*===============================================
@@ -174,23 +195,218 @@ init_show_module (void)
  *=============================================*/
 void
 term_show_module (void)
+{
+	INT i, j;
+
+	unregister_notify(&flush_displays);
+	unregister_uilang_callback(&flush_displays, 0);
+	stdfree(Sline);
+	for (i=0; i<MAXDISPENTS; i++) {
+		DISPENT ent = &Sdisps[i];
+		for (j=0; j<ent->maxlines; j++)
+			zs_free(&ent->lines[j]);
+		if (ent->lines)
+			stdfree(ent->lines);
+		if (ent->deps)
+			stdfree(ent->deps);
+		zs_free(&ent->badkeys);
+	}
+	memset(Sdisps, 0, sizeof(Sdisps));
+}
+/*===============================================
+ * flush_displays -- Forget all formatted displays
+ *  (callback when options or language change)
+ *=============================================*/
+static void
+flush_displays (HINT_PARAM_UNUSED VPTR uparm)
 {
 	INT i;
+	for (i=0; i<MAXDISPENTS; i++)
+		Sdisps[i].type = 0;
+}
+/*===============================================
+ * display_layout -- Settings outside of the records
+ *  that change how vitals are formatted
+ *=============================================*/
+static INT
+display_layout (void)
+{
+	return max_keywidth()*2 + (number_child_enable ? 1 : 0);
+}
+/*===============================================
+ * add_dep -- Note that display drew on record key
+ *=============================================*/
+static void
+add_dep (DISPENT ent, CNSTRING key)
+{
+	struct tag_dispdep * dep;
+	if (!key || !key[0]) return;
+	if (ent->ndeps == ent->maxdeps) {
+		INT newmax = ent->maxdeps ? ent->maxdeps*2 : 16;
+		struct tag_dispdep * deps = (struct tag_dispdep *)stdalloc(newmax*sizeof(*deps));
+		if (ent->deps) {
+			memcpy(deps, ent->deps, ent->ndeps*sizeof(*deps));
+			stdfree(ent->deps);
+		}
+		ent->deps = deps;
+		ent->maxdeps = newmax;
+	}
+	dep = &ent->deps[ent->ndeps++];
+	llstrncpy(dep->key, key, sizeof(dep->key), uu8);
+	dep->version = record_version(dep->key);
+}
+/*===============================================
+ * add_fam_deps -- Note family & its members as
+ *  records the display drew on
+ * (a spouse line uses the first child's birth)
+ *=============================================*/
+static void
+add_fam_deps (DISPENT ent, NODE fam)
+{
+	NODE node;
+	add_dep(ent, key_of_record(fam));
+	for (node = nchild(fam); node; node = nsibling(node)) {
+		if (nval(node) && (eqstr(ntag(node), "HUSB")
+			|| eqstr(ntag(node), "WIFE") || eqstr(ntag(node), "CHIL")))
+			add_dep(ent, rmvat(nval(node)));
+	}
+}
+/*===============================================
+ * deps_current -- Are all records display drew on
+ *  unchanged since ?
+ *=============================================*/
+static BOOLEAN
+deps_current (DISPENT ent)
+{
+	INT i;
+	for (i=0; i<ent->ndeps; i++) {
+		if (record_version(ent->deps[i].key) != ent->deps[i].version)
+			return FALSE;
+	}
+	return TRUE;
+}
+/*===============================================
+ * add_line -- Append an empty line to display
+ *=============================================*/
+static ZSTR
+add_line (DISPENT ent)
+{
+	if (ent->nlines == ent->maxlines) {
+		INT newmax = ent->maxlines ? ent->maxlines*2 : 16;
+		ZSTR * lines = (ZSTR *)stdalloc(newmax*sizeof(*lines));
+		memset(lines, 0, newmax*sizeof(*lines));
+		if (ent->lines) {
+			memcpy(lines, ent->lines, ent->maxlines*sizeof(*lines));
+			stdfree(ent->lines);
+		}
+		ent->lines = lines;
+		ent->maxlines = newmax;
+	}
+	if (!ent->lines[ent->nlines])
+		ent->lines[ent->nlines] = zs_new();
+	zs_clear(ent->lines[ent->nlines]);
+	return ent->lines[ent->nlines++];
+}
+/*===============================================
+ * get_display -- Find or format vitals display
+ *  type:   [IN] 'I' or 'F'
+ *  rec:    [IN] person or family to display
+ *  width:  [IN] how many columns to use
+ *  reuse:  [IN] caller knows record is unchanged
+ * Reformats only if the record, or any record it
+ * drew on (parents, spouses, children...), has been
+ * stored since it was last formatted.
+ *=============================================*/
+static DISPENT
+get_display (INT type, RECORD rec, INT width, BOOLEAN reuse)
+{
+	CNSTRING key = nzkey(rec);
+	INT layout = display_layout();
+	DISPENT ent = 0;
+	INT i;
+
+	for (i=0; i<MAXDISPENTS; i++) {
+		DISPENT cand = &Sdisps[i];
+		if (cand->type == type && cand->width == width
+			&& eqstr(cand->key, key)) {
+			ent = cand;
+			break;
+		}
+		if (!ent || cand->lastuse < ent->lastuse)
+			ent = cand; /* least recently used */
+	}
+	ent->lastuse = ++Sdispclock;
+	if (ent->type == type && ent->width == width && eqstr(ent->key, key)
+		&& ent->layout == layout && (reuse || deps_current(ent)))
+		return ent;
 
-	zs_free(&Spers);
-	zs_free(&Sbirt);
-	zs_free(&Sdeat);
-	stdfree(Sfath);
-	stdfree(Smoth);
-	stdfree(Smarr);
-	zs_free(&Shusb);
-	zs_free(&Shbirt);
-	zs_free(&Shdeat);
-	zs_free(&Swife);
-	zs_free(&Swbirt);
-	zs_free(&Swdeat);
-	for (i=0; i<MAXOTHERS; i++)
-		stdfree(Sothers[i]);
+	ent->type = type;
+	llstrncpy(ent->key, key, sizeof(ent->key), uu8);
+	ent->width = width;
+	ent->layout = layout;
+	ent->ndeps = 0;
+	ent->nlines = 0;
+	if (!ent->badkeys)
+		ent->badkeys = zs_new();
+	badkeylist[0] = '\0';
+	listbadkeys = 1;
+	if (type == 'I')
+		init_display_indi(ent, rec, width);
+	else
+		init_display_fam(ent, rec, width);
+	listbadkeys = 0;
+	zs_sets(ent->badkeys, badkeylist);
+	return ent;
+}
+/*===============================================
+ * show_display -- Put vitals display on screen
+ *  ent:         [IN] formatted display
+ *  rect:        [IN] area to fill
+ *  nfixed:      [IN] how many lines do not scroll
+ *  fixedlen:    [IN] columns for fixed lines
+ *  othersleft:  [IN] column for spouses & children
+ *  othersmax:   [IN] last column for spouses & children
+ *  scroll:      [I/O] how many scrolling lines to skip
+ * Only rows that differ from what is on screen are redrawn
+ *=============================================*/
+static void
+show_display (UIWINDOW uiwin, DISPENT ent, LLRECT rect, INT nfixed
+	, INT fixedlen, INT othersleft, INT othersmax, INT *scroll)
+{
+	INT hgt = rect->bottom - rect->top + 1;
+	INT nothers = ent->nlines - nfixed;
+	INT row, i;
+
+	if (*scroll) {
+		if (*scroll > nothers + nfixed - hgt)
+			*scroll = nothers + nfixed - hgt;
+		if (*scroll < 0)
+			*scroll = 0;
+	}
+	for (row = rect->top; row <= rect->bottom; row++) {
+		i = row - rect->top;
+		if (i < nfixed) {
+			show_row(uiwin, row, rect->left, rect->right
+				, zs_str(ent->lines[i]), fixedlen);
+			continue;
+		}
+		/* the other lines scroll internally, and we
+		mark the top one displayed if not the actual top one, and the
+		bottom one displayed if not the actual bottom */
+		i += *scroll - nfixed;
+		if (i < nothers) {
+			INT overflow = ((i+1 == hgt-nfixed+ *scroll)&&(i+1 != nothers));
+			STRING line;
+			if (*scroll && (i == *scroll))
+				overflow = 1;
+			line = format_out_line(othersleft, zs_str(ent->lines[nfixed+i])
+				, othersmax, overflow);
+			show_row(uiwin, row, rect->left, rect->right, line, 0);
+			stdfree(line);
+		} else {
+			show_row(uiwin, row, rect->left, rect->right, "", 0);
+		}
+	}
 }
 /*===============================================
  * disp_person_name -- Display person's name
@@ -274,54 +490,68 @@ disp_person_birthdeath (ZSTR zstr, RECORD irec, struct tag_prefix * tags, RFMT r
 }
 /*===============================================
  * init_display_indi -- Initialize display person
- *  Fill in all the local buffers for normal person
- *  display mode (Spers, Sbirt, etc)
+ *  Fill in the lines of display entry for normal
+ *  person display mode (name, birth, etc), and
+ *  note which records they drew on
  *=============================================*/
 static void
-init_display_indi (RECORD irec, INT width)
+init_display_indi (DISPENT ent, RECORD irec, INT width)
 {
 	NODE pers=nztop(irec);
 	NODE this_fam = 0;
+	NODE node;
 	INT nsp, nch, num, nm;
 	STRING s;
 	NODE fth;
 	NODE mth;
 	CACHEEL icel;
 
-	ASSERT(width < ll_cols+1); /* size of Spers etc */
+	ASSERT(width < ll_cols+1); /* size of Sline */
 
 
 	ASSERT(pers);
 
-	disp_person_name(Spers, _(qSdspl_indi), irec, width);
+	disp_person_name(add_line(ent), _(qSdspl_indi), irec, width);
 
-	disp_person_birthdeath(Sbirt, irec, f_birth_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), irec, f_birth_tags, &disp_long_rfmt);
 
-	disp_person_birthdeath(Sdeat, irec, f_death_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), irec, f_death_tags, &disp_long_rfmt);
 
 	fth = indi_to_fath(pers);
 	s = person_display(fth, NULL, width-13);
-	if (s) llstrncpyf(Sfath, liwidth, uu8, "  %s: %s", _(qSdspl_fath), s);
-	else llstrncpyf(Sfath, liwidth, uu8, "  %s:", _(qSdspl_fath));
+	if (s) llstrncpyf(Sline, liwidth, uu8, "  %s: %s", _(qSdspl_fath), s);
+	else llstrncpyf(Sline, liwidth, uu8, "  %s:", _(qSdspl_fath));
+	zs_sets(add_line(ent), Sline);
 
 	mth = indi_to_moth(pers);
 	s = person_display(mth, NULL, width-13);
-	if (s) llstrncpyf(Smoth, liwidth, uu8, "  %s: %s", _(qSdspl_moth), s);
-	else llstrncpyf(Smoth, liwidth, uu8, "  %s:", _(qSdspl_moth));
+	if (s) llstrncpyf(Sline, liwidth, uu8, "  %s: %s", _(qSdspl_moth), s);
+	else llstrncpyf(Sline, liwidth, uu8, "  %s:", _(qSdspl_moth));
+	zs_sets(add_line(ent), Sline);
 
-	Solen = 0;
 	nsp = nch = 0;
 	icel = indi_to_cacheel_old(pers);
 	lock_cache(icel);
 	FORFAMSS(pers, fam, sp, num)
-		if (sp) add_spouse_line(++nsp, sp, fam, width);
+		if (sp) add_spouse_line(ent, ++nsp, sp, fam, width);
 	        if (this_fam != fam) {
 		        this_fam = fam; /* only do each family once */
 			FORCHILDREN(fam, chld, nm)
-				if(chld) add_child_line(++nch, chld, width);
+				if(chld) add_child_line(ent, ++nch, chld, width, 0);
 			ENDCHILDREN
 		}
 	ENDFAMSS
+	add_dep(ent, key_of_record(pers));
+	for (node = nchild(pers); node; node = nsibling(node)) {
+		NODE fam;
+		if (!nval(node) || !(eqstr(ntag(node), "FAMC")
+			|| eqstr(ntag(node), "FAMS")))
+			continue;
+		if ((fam = qkey_to_fam(rmvat(nval(node)))))
+			add_fam_deps(ent, fam);
+		else
+			add_dep(ent, rmvat(nval(node)));
+	}
 	unlock_cache(icel);
 }
 /*==============================
@@ -341,54 +571,17 @@ void
 show_indi_vitals (UIWINDOW uiwin, RECORD irec, LLRECT rect
 	, INT *scroll, BOOLEAN reuse)
 {
-	INT i;
-	INT localrow;
-	INT overflow;
-	WINDOW * win = uiw_win(uiwin);
-	INT row = rect->top;
+	DISPENT ent;
 	INT width = rect->right - rect->left + 1;
 	INT hgt = rect->bottom - rect->top + 1;
 
-	badkeylist[0] = '\0';
-	listbadkeys = 1;
 	if (hgt<=0) return;
-	if (!reuse)
-		init_display_indi(irec, width);
-	wipe_window_rect(uiwin, rect);
-	if (*scroll) {
-		if (*scroll > Solen + 5 - hgt)
-			*scroll = Solen + 5 - hgt;
-		if (*scroll < 0)
-			*scroll = 0;
-	}
-	/* we keep putting lines out til we run out or exhaust our alloted
-	height */
-	localrow = row - *scroll;
-
-	mvccwaddnstr(win, row+0, 1, zs_str(Spers), width-1);
-	if (hgt==1) return;
-	mvccwaddnstr(win, row+1, 1, zs_str(Sbirt), width-1);
-	if (hgt==2) return;
-	mvccwaddnstr(win, row+2, 1, zs_str(Sdeat), width-1);
-	if (hgt==3) return;
-	mvccwaddnstr(win, row+3, 1, Sfath, width-1);
-	if (hgt==4) return;
-	mvccwaddnstr(win, row+4, 1, Smoth, width-1);
-	if (hgt==5) return;
-	for (i = *scroll; i < Solen && i < hgt-5+ *scroll; i++)
-	{
-		/* the other lines scroll internally, and we
-		mark the top one displayed if not the actual top one, and the
-		bottom one displayed if not the actual bottom */
-		overflow = ((i+1 == hgt-5+ *scroll)&&(i+1 != Solen));
-		if (*scroll && (i == *scroll))
-			overflow = 1;
-		put_out_line(uiwin, localrow+5+i, rect->left, Sothers[i], rect->right, overflow);
-	}
-	listbadkeys = 0;
-	if(badkeylist[0]) {
+	ent = get_display('I', irec, width, reuse);
+	show_display(uiwin, ent, rect, INDI_FIXED, width-1
+		, rect->left, rect->right, scroll);
+	if (!reuse && zs_len(ent->badkeys)) {
 		char buf[132];
-		llstrncpyf(buf, sizeof(buf), uu8, "%s: %.40s", _(qSmisskeys), badkeylist);
+		llstrncpyf(buf, sizeof(buf), uu8, "%s: %.40s", _(qSmisskeys), zs_str(ent->badkeys));
 		message("%s", buf);
 	}
 }
@@ -396,40 +589,41 @@ show_indi_vitals (UIWINDOW uiwin, RECORD irec, LLRECT rect
  * add_spouse_line -- Add spouse line to others
  *===========================================*/
 static void
-add_spouse_line (HINT_PARAM_UNUSED INT num, NODE indi, NODE fam, INT width)
+add_spouse_line (DISPENT ent, HINT_PARAM_UNUSED INT num, NODE indi, NODE fam, INT width)
 {
-	STRING line, ptr=Sothers[Solen];
+	STRING line, ptr=Sline;
 	INT mylen=liwidth;
-	if (Solen >= MAXOTHERS) return;
 	if (mylen>width) mylen=width;
+	Sline[0] = 0;
 	llstrcatn(&ptr, " ", &mylen);
 	llstrcatn(&ptr, _(qSdspl_spouse), &mylen);
 	llstrcatn(&ptr, ": ", &mylen);
 	line = person_display(indi, fam, mylen-1);
 	llstrcatn(&ptr, line, &mylen);
-	++Solen;
+	zs_sets(add_line(ent), Sline);
 }
 /*===========================================
  * add_child_line -- Add child line to others
+ *  skip: [IN] leading columns to drop
  *=========================================*/
 static void
-add_child_line (INT num, RECORD irec, INT width)
+add_child_line (DISPENT ent, INT num, RECORD irec, INT width, INT skip)
 {
 	STRING line;
 	STRING child = _(qSdspl_child);
-	if (Solen >= MAXOTHERS) return;
 	line = person_display(nztop(irec), NULL, width-15);
 	if (number_child_enable)
-		llstrncpyf(Sothers[Solen], liwidth, uu8, "  " FMT_INT_2 "%s: %s", num, child, line);
+		llstrncpyf(Sline, liwidth, uu8, "  " FMT_INT_2 "%s: %s", num, child, line);
 	else
-		llstrncpyf(Sothers[Solen], liwidth, uu8, "  "           "%s: %s",      child, line);
-	Sothers[Solen++][width-2] = 0;
+		llstrncpyf(Sline, liwidth, uu8, "  "           "%s: %s",      child, line);
+	Sline[width-2] = 0;
+	zs_sets(add_line(ent), Sline+skip);
 }
 /*==============================================
  * init_display_fam -- Initialize display family
  *============================================*/
 static void
-init_display_fam (RECORD frec, INT width)
+init_display_fam (DISPENT ent, RECORD frec, INT width)
 {
 	NODE fam=nztop(frec);
 	NODE husb=0, wife=0;
@@ -442,6 +636,7 @@ init_display_fam (RECORD frec, INT width)
 	INT husbstatus = 0;
 	INT wifestatus = 0;
 	NODE fnode;
+	ZSTR zline;
 
 	/* Get the first two spouses in the family and use them rather than
 	 * displaying first husband and first mother
@@ -472,57 +667,60 @@ init_display_fam (RECORD frec, INT width)
 		husbstatus  = 0;
 	}
 
+	zline = add_line(ent);
 	if (husbstatus == 1) {
 		INT avail = width - zs_len(famkey) - 3;
-		disp_person_name(Shusb, SEX(husb)==SEX_MALE?father:mother, ihusb, avail);
+		disp_person_name(zline, SEX(husb)==SEX_MALE?father:mother, ihusb, avail);
 	} else {
-		zs_setf(Shusb, "%s:", father);
+		zs_setf(zline, "%s:", father);
 		if (husbstatus == -1)
-			zs_apps(Shusb, "??");
+			zs_apps(zline, "??");
 	}
 	if(getlloptint("DisplayKeyTags", 0) > 0) {
-		zs_appf(Shusb, " (f%s)", zs_str(famkey));
+		zs_appf(zline, " (f%s)", zs_str(famkey));
 	} else {
-		zs_appf(Shusb, " (%s)", zs_str(famkey));
+		zs_appf(zline, " (%s)", zs_str(famkey));
 	}
 	zs_free(&famkey);
 
-	disp_person_birthdeath(Shbirt, ihusb, f_birth_tags, &disp_long_rfmt);
-	disp_person_birthdeath(Shdeat, ihusb, f_death_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), ihusb, f_birth_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), ihusb, f_death_tags, &disp_long_rfmt);
 
+	zline = add_line(ent);
 	if (wifestatus == 1) {
 		INT avail = width;
-		disp_person_name(Swife, SEX(wife)==SEX_MALE?father:mother, iwife, avail);
+		disp_person_name(zline, SEX(wife)==SEX_MALE?father:mother, iwife, avail);
 	} else {
-		zs_setf(Swife, "%s:", mother);
+		zs_setf(zline, "%s:", mother);
 		if (wifestatus == -1)
-			zs_apps(Swife, "??");
+			zs_apps(zline, "??");
 	}
 
-	disp_person_birthdeath(Swbirt, iwife, f_birth_tags, &disp_long_rfmt);
-	disp_person_birthdeath(Swdeat, iwife, f_death_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), iwife, f_birth_tags, &disp_long_rfmt);
+	disp_person_birthdeath(add_line(ent), iwife, f_death_tags, &disp_long_rfmt);
 
 	/* Find marriage (or marital contract, or engagement) */
 	s = sh_indi_to_event_long(fam, "MARR", _(qSdspl_mar), width-3);
 	if (!s) s = sh_indi_to_event_long(fam, "MARC", _(qSdspl_marc), width-3);
 	if (!s) s = sh_indi_to_event_long(fam, "ENGA", _(qSdspl_eng), width-3);
-	if (s) llstrncpyf(Smarr, liwidth, uu8, "%s", s);
-	else llstrncpyf(Smarr, liwidth, uu8, "%s", _(qSdspl_mar));
+	if (s) llstrncpyf(Sline, liwidth, uu8, "%s", s);
+	else llstrncpyf(Sline, liwidth, uu8, "%s", _(qSdspl_mar));
 
 	/* append divorce to marriage line, if room */
 	/* (Might be nicer to make it a separate, following line */
-	wtemp = width-5 - strlen(Smarr);
+	wtemp = width-5 - strlen(Sline);
 	if (wtemp > 10) {
 		s = sh_indi_to_event_long(fam, "DIV", _(qSdspa_div), wtemp);
 		if (s)
-			llstrncpyf(Smarr+strlen(Smarr), liwidth-strlen(Smarr), uu8, ", %s", s);
+			llstrncpyf(Sline+strlen(Sline), liwidth-strlen(Sline), uu8, ", %s", s);
 	}
+	zs_sets(add_line(ent), Sline);
 
-	Solen = 0;
 	nch = 0;
 	FORCHILDREN(fam, chld, nm)
-		add_child_line(++nch, chld, width);
+		add_child_line(ent, ++nch, chld, width, 1);
 	ENDCHILDREN
+	add_fam_deps(ent, fam);
 	release_record(ihusb);
 	release_record(iwife);
 }
@@ -538,12 +736,8 @@ void
 show_fam_vitals (UIWINDOW uiwin, RECORD frec, INT row, INT hgt
 	, INT width, INT *scroll, BOOLEAN reuse)
 {
-	INT i;
-	INT localrow;
-	INT overflow;
 	char buf[132];
-	INT maxcol = width-1;
-	WINDOW * win = uiw_win(uiwin);
+	DISPENT ent;
 	struct tag_llrect rect;
 
 	rect.bottom = row+hgt-1;
@@ -551,41 +745,12 @@ show_fam_vitals (UIWINDOW uiwin, RECORD frec, INT row, INT hgt
 	rect.left = 1;
 	rect.right = width-2;
 
-	badkeylist[0] = '\0';
-	listbadkeys = 1;
-	if (!reuse)
-		init_display_fam(frec, width);
-	wipe_window_rect(uiwin, &rect);
-	if (*scroll) {
-		if (*scroll > Solen + 7 - hgt)
-			*scroll = Solen + 7 - hgt;
-		if (*scroll < 0)
-			*scroll = 0;
-	}
-	localrow = row - *scroll;
-	mvccwaddnstr(win, row+0, 1, zs_str(Shusb), width-2);
-	if (hgt==1) return;
-	mvccwaddnstr(win, row+1, 1, zs_str(Shbirt), width-2);
-	if (hgt==2) return;
-	mvccwaddnstr(win, row+2, 1, zs_str(Shdeat), width-2);
-	if (hgt==3) return;
-	mvccwaddnstr(win, row+3, 1, zs_str(Swife), width-2);
-	if (hgt==4) return;
-	mvccwaddnstr(win, row+4, 1, zs_str(Swbirt), width-2);
-	if (hgt==5) return;
-	mvccwaddnstr(win, row+5, 1, zs_str(Swdeat), width-2);
-	if (hgt==6) return;
-	mvccwaddnstr(win, row+6, 1, Smarr, width-2);
-	for (i = *scroll; i < Solen && i < hgt-7+*scroll; i++)
-	{
-		overflow = ((i+1 == hgt-7+*scroll)&&(i+1 != Solen));
-		if (*scroll && (i == *scroll))
-			overflow = 1;
-		put_out_line(uiwin, localrow+7+i, 1, Sothers[i]+1, maxcol, overflow);
-	}
-	listbadkeys = 0;
-	if(badkeylist[0]) {
-		snprintf(buf, sizeof(buf), "WARNING: missing keys: %.40s", badkeylist);
+	if (hgt<=0) return;
+	ent = get_display('F', frec, width, reuse);
+	show_display(uiwin, ent, &rect, FAM_FIXED, width-2
+		, 1, width-1, scroll);
+	if (!reuse && zs_len(ent->badkeys)) {
+		snprintf(buf, sizeof(buf), "WARNING: missing keys: %.40s", zs_str(ent->badkeys));
 		message("%s", buf);
 	}
 }
@@ -979,6 +1144,18 @@ static void
 put_out_line (UIWINDOW uiwin, INT y, INT x, STRING string, INT maxcol, INT flag)
 {
 	WINDOW * win = uiw_win(uiwin);
+	LINESTRING buffer = format_out_line(x, string, maxcol, flag);
+	mvccwaddstr(win, y, x, buffer);
+	stdfree(buffer);
+}
+/*=====================================
+ * format_out_line - limit string to fit
+ * between x and maxcol, and append ++ if flagged
+ * returns heap buffer
+ *====================================*/
+static STRING
+format_out_line (INT x, STRING string, INT maxcol, INT flag)
+{
 	INT buflen = (maxcol - x + 1) + 1;
 	LINESTRING buffer = (LINESTRING)stdalloc(buflen);
 
@@ -999,8 +1176,7 @@ put_out_line (UIWINDOW uiwin, INT y, INT x, STRING string, INT maxcol, INT flag)
 		buffer[i++] = '+';
 		buffer[i++] = '\0';
 	}
-	mvccwaddstr(win, y, x, buffer);
-	stdfree(buffer);
+	return buffer;
 }
 /*==================================================================
  * show_childnumbers - toggle display of numbers for children
@@ -40,6 +40,7 @@
 #include "liflines.h"
 #include "feedback.h"
 #include "llinesi.h"
+#include "lloptions.h"
 
 #include "menuitem.h"
 #include "screen.h"
@@ -51,7 +52,7 @@
 extern STRING qSnofath, qSnomoth, qSnospse, qSnocofp;
 extern STRING qStwohsb, qStwowif, qSidsbrs, qSidplst, qSidcbrs;
 extern STRING qSidhbrs, qSidwbrs, qSid1wbr, qSid2wbr;
-extern STRING qSnowife;
+extern STRING qSnowife, qSnorelp, qSrelpbgt;
 
 /*********************************************
  * local function prototypes
@@ -158,6 +159,20 @@ INT browse_tandem (RECORD *prec1, RECORD *prec2, INDISEQ *pseq)
 			current1 = current2;
 			current2 = tmp;
 			break;
+		case CMD_RELATION_PATH: 	/* browse shortest kinship path */
+			{
+				INT status=0;
+				seq = relation_path_indiseq(nzkey(current1), nzkey(current2)
+					, getlloptint("RelationPathMaxPersons", 0)
+					, getlloptint("RelationPathMsecs", 5000), &status);
+				if (!seq) {
+					message("%s", status == RELPATH_BUDGET
+						? _(qSrelpbgt) : _(qSnorelp));
+					break;
+				}
+				*pseq = seq;
+				return BROWSE_LIST;
+			}
 		case CMD_ADDFAMILY: 	/* make two persons parents in family */
 			tmp = add_family_by_edit(current1, current2, NULL, &disp_long_rfmt);
 			if (tmp) {
@@ -0,0 +1,125 @@
+/* 
+   Copyright (c) 2026 LifeLines developers
+   "The MIT license"
+   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/*======================================================================
+ * bitset.c -- growable bit set, indexed by small non-negative integers
+ *  Used to mark record key numbers (eg, people visited in a closure)
+ *  without going through string-keyed tables.
+ *====================================================================*/
+
+#include "llstdlib.h"
+#include "bitset.h"
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+static void enlarge_bitset(BITSET bs, INT i);
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=========================================================
+ * create_bitset -- Create empty bit set
+ *  size: [IN]  initial number of bits (grows on demand)
+ *=======================================================*/
+BITSET
+create_bitset (INT size)
+{
+	BITSET bs = (BITSET)stdalloc(sizeof(*bs));
+	if (size < 64) size = 64;
+	BSMax(bs) = (size + 7) & ~7;
+	BSCount(bs) = 0;
+	BSData(bs) = (unsigned char *)stdalloc(BSMax(bs)/8);
+	memset(BSData(bs), 0, BSMax(bs)/8);
+	return bs;
+}
+/*=========================================================
+ * destroy_bitset -- Free bit set
+ *=======================================================*/
+void
+destroy_bitset (BITSET bs)
+{
+	if (!bs) return;
+	stdfree(BSData(bs));
+	stdfree(bs);
+}
+/*=========================================================
+ * enlarge_bitset -- Make room for bit i
+ *=======================================================*/
+static void
+enlarge_bitset (BITSET bs, INT i)
+{
+	INT newmax = BSMax(bs);
+	unsigned char * data;
+	while (newmax <= i)
+		newmax <<= 1;
+	data = (unsigned char *)stdalloc(newmax/8);
+	memcpy(data, BSData(bs), BSMax(bs)/8);
+	memset(data + BSMax(bs)/8, 0, (newmax - BSMax(bs))/8);
+	stdfree(BSData(bs));
+	BSData(bs) = data;
+	BSMax(bs) = newmax;
+}
+/*=========================================================
+ * bitset_set -- Set bit i
+ *  returns TRUE if bit was not previously set
+ *=======================================================*/
+BOOLEAN
+bitset_set (BITSET bs, INT i)
+{
+	unsigned char mask = (unsigned char)(1 << (i & 7));
+	ASSERT(i >= 0);
+	if (i >= BSMax(bs))
+		enlarge_bitset(bs, i);
+	if (BSData(bs)[i >> 3] & mask)
+		return FALSE;
+	BSData(bs)[i >> 3] |= mask;
+	++BSCount(bs);
+	return TRUE;
+}
+/*=========================================================
+ * bitset_clear -- Clear bit i
+ *=======================================================*/
+void
+bitset_clear (BITSET bs, INT i)
+{
+	unsigned char mask = (unsigned char)(1 << (i & 7));
+	if (i < 0 || i >= BSMax(bs)) return;
+	if (BSData(bs)[i >> 3] & mask) {
+		BSData(bs)[i >> 3] &= ~mask;
+		--BSCount(bs);
+	}
+}
+/*=========================================================
+ * bitset_clear_all -- Clear all bits (keeps allocation)
+ *=======================================================*/
+void
+bitset_clear_all (BITSET bs)
+{
+	memset(BSData(bs), 0, BSMax(bs)/8);
+	BSCount(bs) = 0;
+}
+/*=========================================================
+ * bitset_test -- Is bit i set ?
+ *=======================================================*/
+BOOLEAN
+bitset_test (BITSET bs, INT i)
+{
+	if (i < 0 || i >= BSMax(bs)) return FALSE;
+	return (BSData(bs)[i >> 3] & (1 << (i & 7))) != 0;
+}
+/*=========================================================
+ * bitset_count -- Number of bits set
+ *=======================================================*/
+INT
+bitset_count (BITSET bs)
+{
+	return BSCount(bs);
+}
@@ -10,12 +10,12 @@
  *==============================================================*/
 
 #include "llstdlib.h" /* includes standard.h, sys_inc.h, llnls.h, config.h */
-#include <errno.h>
 #ifdef HAVE_ICONV
 # ifdef WIN32_ICONV_SHIM
 #  include "mswin/iconvshim.h"
 # else
 #  include <iconv.h>
+#  include <errno.h>
 # endif
 #endif
 /* wcslen may be declared in "arch.h" or <wchar.h> */
@@ -27,6 +27,49 @@
 #include "icvt.h"
 
 
+/*********************************************
+ * local enums & defines
+ *********************************************/
+
+/* without errno (MS-Windows dll), iconv output room or input left
+ below which a failed conversion is taken as full or incomplete */
+#define ICVT_MINROOM 8
+/* times icvt_trans grows output without any input being converted */
+#define ICVT_MAXGROW 4
+
+/*********************************************
+ * local types
+ *********************************************/
+
+/* an open conversion, kept for reuse */
+struct tag_icvt {
+#ifdef HAVE_ICONV
+	iconv_t ict;
+#endif
+	INT inwidth;      /* bytes per input character, if fixed (UCS-2/4) */
+	INT chwidth;      /* bytes per output character, if fixed */
+	double expand;    /* estimated growth of output over input */
+	BOOLEAN srcutf8;
+	BOOLEAN ascii;    /* ASCII converts to itself */
+	BOOLEAN initial;  /* nothing converted since last reset */
+};
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+#ifdef HAVE_ICONV
+static BOOLEAN check_ascii(ICVT icvt);
+static BOOLEAN put_illegal(ICVT icvt, char ** pout, size_t * poutleft
+	, char illegal);
+#endif
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
 /*===================================================
  * iconv_can_trans -- Can iconv do this translation ?
  *=================================================*/
@@ -56,133 +99,327 @@ iconv_can_trans (HINT_PARAM_UNUSED CNSTRING src, HINT_PARAM_UNUSED CNSTRING dest
  *  sin:     [IN]  source string to be converted
  *  zout:    [I/O] converted result
  *  illegal: [IN]  character to use as placeholder for unconvertible input
+ * Opens a conversion just for this string; callers converting
+ * many strings should keep one from icvt_open instead
  *=================================================*/
 BOOLEAN
-#ifdef HAVE_ICONV
 iconv_trans (CNSTRING src, CNSTRING dest, CNSTRING sin, ZSTR zout, char illegal)
+{
+	ICVT icvt = icvt_open(src, dest);
+	BOOLEAN rtn;
+	if (!icvt)
+		return FALSE;
+	rtn = icvt_trans(icvt, sin, zout, illegal);
+	icvt_close(&icvt);
+	return rtn;
+}
+/*===================================================
+ * icvt_open -- Open a reusable conversion between codesets
+ *  returns NULL if iconv cannot do it
+ *=================================================*/
+ICVT
+#ifdef HAVE_ICONV
+icvt_open (CNSTRING src, CNSTRING dest)
 #else
-iconv_trans (HINT_PARAM_UNUSED CNSTRING src, HINT_PARAM_UNUSED CNSTRING dest, HINT_PARAM_UNUSED CNSTRING sin, HINT_PARAM_UNUSED ZSTR zout, HINT_PARAM_UNUSED char illegal)
+icvt_open (HINT_PARAM_UNUSED CNSTRING src, HINT_PARAM_UNUSED CNSTRING dest)
 #endif
 {
 #ifdef HAVE_ICONV
+	ICVT icvt;
 	iconv_t ict;
-	char * inptr;
-	char * outptr;
-	size_t inleft;
-	size_t outleft;
-	size_t cvted;
 #ifdef ICONV_SET_TRANSLITERATE
 	int transliterate=2; 
 #endif
-	double expand=1.3;
-	int chwidth=1;
-	int badchars=0; /* count # illegal placeholders inserted */
-	int inlen = sin ? strlen(sin) : 0;
 
 	ASSERT(src);
 	ASSERT(dest);
 
 	ict = iconv_open(dest, src);
+	if (ict == (iconv_t)-1)
+		return NULL;
 
-	if (ict == (iconv_t)-1) {
-		return FALSE;
-	}
+	/* testing recursive transliteration in my private iconv, Perry, 2002.07.11 */
+#ifdef ICONV_SET_TRANSLITERATE
+	iconvctl(ict, ICONV_SET_TRANSLITERATE, &transliterate);
+#endif
+
+	icvt = (ICVT)stdalloc(sizeof(*icvt));
+	memset(icvt, 0, sizeof(*icvt));
+	icvt->ict = ict;
+	icvt->inwidth = 1;
+	icvt->chwidth = 1;
+	icvt->expand = 1.3;
+	icvt->srcutf8 = eqstr(src, "UTF-8");
 	if (!strncmp(src, "UCS-2", strlen("UCS-2"))) {
 		/* assume MS-Windows makenarrow call */
-		inlen = 2 * wcslen((const wchar_t *)sin);
+		icvt->inwidth = 2;
 	}
 	if (!strncmp(src, "UCS-4", strlen("UCS-4"))) {
 		/* assume UNIX makenarrow call */
-		inlen = 4 * wcslen((const wchar_t *)sin);
+		icvt->inwidth = 4;
 	}
 	if (!strncmp(dest, "UCS-2", strlen("UCS-2"))) {
-		chwidth = expand = 2;
+		icvt->chwidth = icvt->expand = 2;
 	}
 	if (!strncmp(dest, "UCS-4", strlen("UCS-4"))) {
-		chwidth = expand = 4;
+		icvt->chwidth = icvt->expand = 4;
 	}
 	if (eqstr(dest, "wchar_t")) {
-		chwidth = expand = sizeof(wchar_t);
+		icvt->chwidth = icvt->expand = sizeof(wchar_t);
 
 	}
 	/* TODO: What about UTF-16 or UTF-32 ? */
 
-	zs_reserve(zout, (unsigned int)(inlen*expand+6));
+	icvt->ascii = check_ascii(icvt);
+	icvt_reset(icvt);
+	return icvt;
+#else
+	return NULL;
+#endif /* HAVE_ICONV */
+}
+/*===================================================
+ * icvt_close -- Close conversion opened by icvt_open
+ *=================================================*/
+void
+icvt_close (ICVT * picvt)
+{
+	ICVT icvt = *picvt;
+	if (!icvt)
+		return;
+#ifdef HAVE_ICONV
+	iconv_close(icvt->ict);
+#endif
+	stdfree(icvt);
+	*picvt = NULL;
+}
+#ifdef HAVE_ICONV
+/*===================================================
+ * check_ascii -- Does ASCII come through conversion unchanged ?
+ *  (true of most 8-bit codesets & UTF-8, but not of EBCDIC,
+ *  UTF-7 or the wide ones)
+ *=================================================*/
+static BOOLEAN
+check_ascii (ICVT icvt)
+{
+	char probe[128], result[256];
+	char * inptr = probe;
+	char * outptr = result;
+	size_t inleft = sizeof(probe)-1;
+	size_t outleft = sizeof(result);
+	INT i;
 
-	if (!inlen) {
-		outptr = zs_str(zout);
-		goto icvt_terminate_and_exit;
-	}
+	if (icvt->inwidth != 1 || icvt->chwidth != 1)
+		return FALSE;
+	for (i=1; i<128; ++i)
+		probe[i-1] = (char)i;
+	icvt_reset(icvt);
+	if (iconv(icvt->ict, &inptr, &inleft, &outptr, &outleft) == (size_t)-1)
+		return FALSE;
+	/* return to initial state, in case codeset has shift states */
+	if (iconv(icvt->ict, NULL, NULL, &outptr, &outleft) == (size_t)-1)
+		return FALSE;
+	return outptr - result == (INT)sizeof(probe)-1
+		&& !memcmp(probe, result, sizeof(probe)-1);
+}
+#endif /* HAVE_ICONV */
+/*===================================================
+ * icvt_is_noop -- Would converting this string leave it unchanged ?
+ *  true if string is pure ASCII & conversion leaves ASCII alone
+ *=================================================*/
+BOOLEAN
+icvt_is_noop (ICVT icvt, CNSTRING sin)
+{
+	size_t len;
+	if (!icvt->ascii)
+		return FALSE;
+	len = strlen(sin);
+	return ascii_span(sin, len) == len;
+}
+/*===================================================
+ * icvt_reset -- Return conversion to its initial state
+ *  (to begin converting a new stream)
+ *=================================================*/
+void
+icvt_reset (ICVT icvt)
+{
+#ifdef HAVE_ICONV
+	iconv(icvt->ict, NULL, NULL, NULL, NULL);
+#endif
+	icvt->initial = TRUE;
+}
+/*===================================================
+ * icvt_convert -- Convert part of a stream, between caller's buffers
+ *  icvt:     [I/O] open conversion (see icvt_reset)
+ *  pin:      [I/O] input (advanced past what was converted)
+ *  pinleft:  [I/O] bytes of input left
+ *  pout:     [I/O] output (advanced past what was written)
+ *  poutleft: [I/O] bytes of room left in output
+ *  illegal:  [IN]  placeholder for unconvertible input
+ *  last:     [IN]  no more input follows this
+ * Output is not zero-terminated.
+ * Returns FALSE if output filled up before all input was converted.
+ * Unless last, an incomplete character at end of input is left there,
+ * for caller to pass again with the next part of the stream.
+ * On MS-Windows we call iconv in a dll & don't get errno, so why it
+ * stopped is guessed: with little output room left it is taken as
+ * full, near the end of input as an incomplete character, and
+ * otherwise as unconvertible input.
+ *=================================================*/
+BOOLEAN
+#ifdef HAVE_ICONV
+icvt_convert (ICVT icvt, CNSTRING * pin, size_t * pinleft
+	, STRING * pout, size_t * poutleft, char illegal, BOOLEAN last)
+#else
+icvt_convert (HINT_PARAM_UNUSED ICVT icvt, HINT_PARAM_UNUSED CNSTRING * pin
+	, HINT_PARAM_UNUSED size_t * pinleft, HINT_PARAM_UNUSED STRING * pout
+	, HINT_PARAM_UNUSED size_t * poutleft, HINT_PARAM_UNUSED char illegal
+	, HINT_PARAM_UNUSED BOOLEAN last)
+#endif
+{
+#ifdef HAVE_ICONV
+	char * inptr = (char *)*pin;
+	size_t cvted;
+	BOOLEAN rtn = TRUE;
+	BOOLEAN full, incomplete;
 
-	/* testing recursive transliteration in my private iconv, Perry, 2002.07.11 */
-#ifdef ICONV_SET_TRANSLITERATE
-	iconvctl(ict, ICONV_SET_TRANSLITERATE, &transliterate);
+	if (icvt->initial && icvt->ascii) {
+		/* skip iconv for ASCII at start of stream */
+		size_t n = *pinleft < *poutleft ? *pinleft : *poutleft;
+		size_t i = ascii_span(inptr, n);
+		memcpy(*pout, inptr, i);
+		inptr += i;
+		*pinleft -= i;
+		*pout += i;
+		*poutleft -= i;
+	}
+	while (*pinleft) {
+		icvt->initial = FALSE;
+		cvted = iconv(icvt->ict, &inptr, pinleft, pout, poutleft);
+		if (cvted != (size_t)-1)
+			break;
+#ifdef WIN32_ICONV_SHIM
+		full = (*poutleft < ICVT_MINROOM);
+		incomplete = (*pinleft < ICVT_MINROOM);
+#else
+		full = (errno == E2BIG);
+		incomplete = (errno == EINVAL);
+#endif
+		if (full) {
+			rtn = FALSE;
+			break;
+		}
+		if (incomplete && !last) {
+			/* wait for rest of character */
+			break;
+		}
+		/* unconvertible input character */
+		/* append placeholder & skip over */
+		if (!put_illegal(icvt, pout, poutleft, illegal)) {
+			rtn = FALSE;
+			break;
+		}
+		{
+			size_t wid = icvt->inwidth;
+			if (icvt->srcutf8)
+				wid = utf8len(*inptr);
+			if (wid < 1)
+				wid = 1;
+			if (wid > *pinleft)
+				wid = *pinleft;
+			inptr += wid;
+			*pinleft -= wid;
+		}
+	}
+	*pin = inptr;
+	return rtn;
+#else
+	return FALSE;
+#endif /* HAVE_ICONV */
+}
+#ifdef HAVE_ICONV
+/*===================================================
+ * put_illegal -- Write placeholder for unconvertible character
+ *  returns FALSE if no room
+ *=================================================*/
+static BOOLEAN
+put_illegal (ICVT icvt, char ** pout, size_t * poutleft, char illegal)
+{
+	if (*poutleft < (size_t)icvt->chwidth)
+		return FALSE;
+	/* Following code is only correct for UCS-2LE, UCS-4LE */
+	if (icvt->chwidth == 2)
+	{
+		unsigned short u = illegal;
+		memcpy(*pout, &u, sizeof(u));
+	}
+	else if (icvt->chwidth == 4)
+	{
+		unsigned int u = illegal;
+		memcpy(*pout, &u, sizeof(u));
+	}
+	else
+	{
+		**pout = illegal;
+	}
+	*pout += icvt->chwidth;
+	*poutleft -= icvt->chwidth;
+	return TRUE;
+}
+#endif /* HAVE_ICONV */
+/*===================================================
+ * icvt_trans -- Translate string via open conversion
+ *  icvt:    [IN]  open conversion
+ *  sin:     [IN]  source string to be converted
+ *  zout:    [I/O] converted result
+ *  illegal: [IN]  character to use as placeholder for unconvertible input
+ * Returns FALSE if iconv would not take all of the input
+ *=================================================*/
+BOOLEAN
+#ifdef HAVE_ICONV
+icvt_trans (ICVT icvt, CNSTRING sin, ZSTR zout, char illegal)
+#else
+icvt_trans (HINT_PARAM_UNUSED ICVT icvt, HINT_PARAM_UNUSED CNSTRING sin, HINT_PARAM_UNUSED ZSTR zout, HINT_PARAM_UNUSED char illegal)
 #endif
+{
+#ifdef HAVE_ICONV
+	CNSTRING inptr = sin;
+	char * outptr;
+	size_t inleft;
+	size_t outleft;
+	int chwidth = icvt->chwidth;
+	INT stuck = 0; /* retries that converted no input */
 
+	if (icvt->inwidth == 2) {
+		inleft = 2 * wcslen((const wchar_t *)sin);
+	} else if (icvt->inwidth == 4) {
+		inleft = 4 * wcslen((const wchar_t *)sin);
+	} else {
+		inleft = sin ? strlen(sin) : 0;
+	}
 
-	inptr = (char *)sin;
+	icvt_reset(icvt);
+	zs_clear(zout);
+	zs_reserve(zout, (unsigned int)(inleft*icvt->expand+6));
 	outptr = zs_str(zout);
-	inleft = inlen;
-	/* we are terminating with 4 zero bytes just in case dest is UCS-4 */
-	outleft = zs_allocsize(zout)-zs_len(zout)-4;
-	cvted = 0;
-
-cvting:
-	/* main convert */
-	cvted = iconv (ict, &inptr, &inleft, &outptr, &outleft);
-
-	/* zero terminate & fix output zstring */
-	/* there may be embedded nulls, if UCS-2/4 is target! */
-	*outptr=0;
-	zs_set_len(zout, outptr-zs_str(zout));
 
-	/* handle error cases */
-	if (cvted == (size_t)-1) {
-		/* errno is not reliable, because on MS-Windows we called
-		iconv in a dll & didn't get errno */
-		if (outleft<3) {
-			/* may be out of space, so grow & retry */
-			zs_reserve(zout, (unsigned int)(inleft * expand + 6 + zs_allocsize(zout)));
-		} else {
-			/* unconvertible input character */
-			/* append placeholder & skip over */
-			size_t wid = 1;
-			if (eqstr(src, "UTF-8")) {
-				wid = utf8len(*inptr);
-			}
-			if (wid > inleft)
-				wid = inleft;
-			inptr += wid;
-			inleft -= wid;
-			/* Following code is only correct for UCS-2LE, UCS-4LE */
-			if (chwidth == 2)
-			{
-				unsigned short * u = (unsigned short *)outptr;
-				*u = illegal;
-				outptr += sizeof(u);
-			}
-			else if (chwidth == 4)
-			{
-				unsigned int * u = (unsigned int *)outptr;
-				*u = illegal;
-				outptr += sizeof(u);
-			}
-			else
-			{
-				*outptr++ = illegal;
-			}
-			++badchars;
-			zs_set_len(zout, outptr-zs_str(zout));
-		}
-		/* update output variables */
-		/* (may have reallocated, plus need to point to end */
-		outptr = zs_str(zout)+zs_len(zout);
+	while (inleft) {
+		size_t wasleft = inleft;
+		/* we are terminating with 4 zero bytes just in case dest is UCS-4 */
 		outleft = zs_allocsize(zout)-zs_len(zout)-4;
-		if (inleft)
-			goto cvting;
+		if (icvt_convert(icvt, &inptr, &inleft, &outptr, &outleft, illegal, TRUE))
+			break;
+		/* growing should soon let input through; if not, give up */
+		stuck = (inleft == wasleft) ? stuck+1 : 0;
+		if (stuck > ICVT_MAXGROW)
+			break;
+		/* out of space, so grow & retry */
+		/* there may be embedded nulls, if UCS-2/4 is target! */
+		zs_set_len(zout, outptr-zs_str(zout));
+		zs_reserve(zout, (unsigned int)(inleft * icvt->expand + 6 + zs_allocsize(zout)));
+		/* (may have reallocated, so need to point to end */
+		outptr = zs_str(zout)+zs_len(zout);
 	}
 
-icvt_terminate_and_exit:
 	/* zero-terminate with appropriately wide zero */
 	if (chwidth > 1) {
 		*outptr++=0;
@@ -193,9 +430,7 @@ icvt_terminate_and_exit:
 	}
 	*outptr=0;
 	zs_set_len(zout, outptr-zs_str(zout));
-
-	iconv_close(ict);
-	return TRUE;
+	return inleft == 0;
 #else
 	return FALSE;
 #endif /* HAVE_ICONV */
@@ -6,8 +6,15 @@
    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 /*=============================================================
- * list.c -- Doubly-linked list data type
+ * list.c -- List data type
  * Copyright(c) 1991-94 by T.T. Wetmore IV; all rights reserved
+ *  A list is a double-ended queue held in a ring buffer.
+ *  Elements have positions, which run from the head of the list
+ *  (l_lo) up to the tail (l_hi - 1); pushing on the head lowers
+ *  l_lo, adding to the tail raises l_hi, so positions of other
+ *  elements stay put (which lets iteration survive changes
+ *  at the ends). The element at a position is in slot
+ *  (position mod size of buffer), and the size is a power of 2.
  *===========================================================*/
 
 #include "standard.h"
@@ -18,15 +25,21 @@
  * local types
  *********************************************/
 
+/* slot in ring buffer of list */
+struct tag_lslot {
+	VPTR l_element;
+	int l_locks;
+};
 
 /* list object itself */
 struct tag_list {
 	/* a LIST is an OBJECT */
 	struct tag_vtable * vtable; /* generic object table (see vtable.h) */
 	INT l_refcnt; /* reference counted object */
-	LNODE l_head;
-	LNODE l_tail;
-	INT l_len;
+	struct tag_lslot * l_slots; /* ring buffer */
+	INT l_max; /* number of slots (0 or a power of 2) */
+	INT l_lo; /* position of head */
+	INT l_hi; /* position after tail */
 	INT l_type;
 	ELEMENT_DESTRUCTOR l_del_element;
 };
@@ -36,9 +49,10 @@ struct tag_list {
 struct tag_list_iter {
 	struct tag_vtable *vtable; /* generic object */
 	INT refcnt; /* ref-countable object */
-	LNODE current;
+	INT current; /* position of current element */
+	BOOLEAN started;
 	LIST list;
-	INT status; /* 1=forward, 1=reverse, 0=EOF */
+	INT status; /* 1=forward, -1=reverse, 0=EOF */
 };
 /* typedef struct tag_list_iter * LIST_ITER; */ /* in list.h */
 
@@ -47,9 +61,9 @@ struct tag_list_iter {
  *********************************************/
 
 #define ltype(l)   ((l)->l_type)
-#define lhead(l)   ((l)->l_head)
-#define ltail(l)   ((l)->l_tail)
-#define llen(l)    ((l)->l_len)
+#define llen(l)    ((l)->l_hi - (l)->l_lo)
+#define lslot(l,pos)  (&(l)->l_slots[(pos) & ((l)->l_max - 1)])
+#define linlist(l,pos)  ((pos) >= (l)->l_lo && (pos) < (l)->l_hi)
 
 /*********************************************
  * local function prototypes
@@ -58,11 +72,12 @@ struct tag_list_iter {
 /* alphabetical */
 static void free_list_element(VPTR vptr);
 static void free_list_iter(LIST_ITER listit);
+static void grow_list(LIST list);
 static void list_destructor(VTABLE *obj);
 static void listit_destructor(VTABLE *obj);
 void make_list_empty_impl(LIST list, ELEMENT_DESTRUCTOR func);
-static LNODE nth_in_list_from_tail(LIST list, INT index1b, BOOLEAN createels
-	, LIST_CREATE_VALUE createfnc);
+static struct tag_lslot * nth_in_list_from_tail(LIST list, INT index1b
+	, BOOLEAN createels, LIST_CREATE_VALUE createfnc);
 static void validate_list(LIST list);
 
 /*********************************************
@@ -102,8 +117,8 @@ create_list_impl (void)
 	list->vtable = &vtable_for_list;
 	list->l_refcnt = 1;
 	ltype(list) = LISTNOFREE;
-	lhead(list) = ltail(list) = NULL;
-	llen(list) = 0;
+	list->l_slots = NULL;
+	list->l_max = list->l_lo = list->l_hi = 0;
 	validate_list(list);
 	return list;
 }
@@ -160,6 +175,8 @@ destroy_empty_list (LIST list)
 	if (!list) return;
 	ASSERT(list->vtable == &vtable_for_list);
 	ASSERT(llen(list) == 0);
+	if (list->l_slots)
+		stdfree(list->l_slots);
 	stdfree(list);
 }
 /*===========================
@@ -168,20 +185,17 @@ destroy_empty_list (LIST list)
  *  el:   [IN]  parameter to pass thru to check function
  *  func: [IN]  check function
  * Calls check function on each element in turn until one returns TRUE
- * Returns index of element found, or -1 if none pass check
+ * Returns index of element found (0 for head), or -1 if none pass check
  *=========================*/
 INT
 in_list (LIST list, VPTR param, BOOLEAN (*func)(VPTR param, VPTR el))
 {
-	LNODE lnode;
-	INT index=0;
+	INT pos;
 	if (is_empty_list(list)) /* calls validate_list */
 		return -1;
-	lnode = lhead(list);
-	while (lnode) {
-		if ((*func)(param, lelement(lnode)))
-			return index;
-		lnode = lnext(lnode);
+	for (pos = list->l_lo; pos < list->l_hi; ++pos) {
+		if ((*func)(param, lslot(list, pos)->l_element))
+			return pos - list->l_lo;
 	}
 	validate_list(list);
 	return -1;
@@ -200,7 +214,7 @@ free_list_element (VPTR vptr)
 void
 make_list_empty_impl (LIST list, ELEMENT_DESTRUCTOR func)
 {
-	LNODE lnode0, lnode;
+	INT pos;
 
 	if (!list) return;
 
@@ -211,15 +225,12 @@ make_list_empty_impl (LIST list, ELEMENT_DESTRUCTOR func)
 			func = &free_list_element;
 	}
 	
-	lnode0 = lhead(list);
-	while (lnode0) {
-		lnode = lnext(lnode0);
-		if (func) (*func)(lelement(lnode0));
-		stdfree(lnode0);
-		lnode0 = lnode;
+	if (func) {
+		for (pos = list->l_lo; pos < list->l_hi; ++pos)
+			(*func)(lslot(list, pos)->l_element);
 	}
-	lhead(list) = ltail(list) = NULL;
-	llen(list) = 0;
+	/* keep the buffer, for the list to be refilled */
+	list->l_lo = list->l_hi = 0;
 	/* no effect on refcount */
 	validate_list(list);
 }
@@ -241,6 +252,22 @@ is_empty_list (const LIST list)
 	validate_list(list);
 	return !list || !llen(list);
 }
+/*===================================
+ * grow_list -- Double ring buffer of full list
+ *  elements keep their positions
+ *=================================*/
+static void
+grow_list (LIST list)
+{
+	struct tag_lslot * old = list->l_slots;
+	INT oldmax = list->l_max, pos;
+	list->l_max = oldmax ? 2*oldmax : 8;
+	list->l_slots = (struct tag_lslot *)stdalloc(list->l_max * sizeof(*old));
+	for (pos = list->l_lo; pos < list->l_hi; ++pos)
+		*lslot(list, pos) = old[pos & (oldmax - 1)];
+	if (old)
+		stdfree(old);
+}
 /*==================================
  * push_list -- Push element on head of list
  *  list:  [I/O]  list
@@ -249,21 +276,14 @@ is_empty_list (const LIST list)
 void
 push_list (LIST list, VPTR el)
 {
-	LNODE node = NULL;
+	struct tag_lslot * slot;
 
 	if (!list) return;
-	node = (LNODE) stdalloc(sizeof(*node));
-	lelement(node) = el;
-	if (is_empty_list(list)) {
-		lprev(node) = lnext(node) = NULL;
-		lhead(list) = ltail(list) = node;
-	} else {
-		lnext(node) = lhead(list);
-		lprev(lhead(list)) = node;
-		lprev(node) = NULL;
-		lhead(list) = node;
-	}
-	++llen(list);
+	if (llen(list) == list->l_max)
+		grow_list(list);
+	slot = lslot(list, --list->l_lo);
+	slot->l_element = el;
+	slot->l_locks = 0;
 	validate_list(list);
 }
 /*=========================================
@@ -274,21 +294,14 @@ push_list (LIST list, VPTR el)
 void
 back_list (LIST list, VPTR el)
 {
-	LNODE node = NULL;
+	struct tag_lslot * slot;
 
 	if (!list) return;
-	node = (LNODE) stdalloc(sizeof(*node));
-	lelement(node) = el;
-	if (is_empty_list(list)) {
-		lprev(node) = lnext(node) = NULL;
-		lhead(list) = ltail(list) = node;
-	} else {
-		lprev(node) = ltail(list);
-		lnext(ltail(list)) = node;
-		lnext(node) = NULL;
-		ltail(list) = node;
-	}
-	++llen(list);
+	if (llen(list) == list->l_max)
+		grow_list(list);
+	slot = lslot(list, list->l_hi++);
+	slot->l_element = el;
+	slot->l_locks = 0;
 	validate_list(list);
 }
 /*==================================
@@ -298,19 +311,10 @@ back_list (LIST list, VPTR el)
 VPTR
 pop_list (LIST list)
 {
-	LNODE node;
 	VPTR el;
 	if (is_empty_list(list)) /* calls validate_list */
 		return NULL;
-	node = lhead(list);
-	lhead(list) = lnext(node);
-	if (!lhead(list))
-		ltail(list) = NULL;
-	else
-		lprev(lhead(list)) = NULL;
-	el = lelement(node);
-	stdfree(node);
-	--llen(list);
+	el = lslot(list, list->l_lo++)->l_element;
 	validate_list(list);
 	return el;
 }
@@ -325,7 +329,8 @@ validate_list (HINT_PARAM_UNUSED LIST list)
 #endif
 {
 #ifdef LIST_ASSERTS
-	ASSERT(!list || (lhead(list)&&ltail(list)) || (!lhead(list)&&!ltail(list)));
+	ASSERT(!list || (list->l_lo <= list->l_hi && llen(list) <= list->l_max));
+	ASSERT(!list || !(list->l_max & (list->l_max - 1)));
 #endif
 }
 /*========================================
@@ -350,28 +355,19 @@ dequeue_list (LIST list)
 VPTR
 pop_list_tail (LIST list)
 {
-	LNODE node;
 	VPTR el;
 	if (is_empty_list(list)) /* calls validate_list */
 		return NULL;
-	node = ltail(list);
-	ltail(list) = lprev(node);
-	if (!ltail(list))
-		lhead(list) = NULL;
-	else
-		lnext(ltail(list)) = NULL;
-	el = lelement(node);
-	stdfree(node);
-	--llen(list);
+	el = lslot(list, --list->l_hi)->l_element;
 	validate_list(list);
 	return el;
 }
 /*=================================================
- * nth_in_list_from_tail -- Find nth node in list, relative 1
+ * nth_in_list_from_tail -- Find nth slot in list, relative 1
  *  start at tail & count towards head
  *  createels is FALSE if caller does not want elements added (delete_list_element)
  *===============================================*/
-static LNODE
+static struct tag_lslot *
 nth_in_list_from_tail (LIST list, INT index1b, BOOLEAN createels, LIST_CREATE_VALUE createfnc)
 {
 	if (!list) return NULL;
@@ -380,22 +376,8 @@ nth_in_list_from_tail (LIST list, INT index1b, BOOLEAN createels, LIST_CREATE_VA
 	if (index1b < 1) index1b += llen(list);
 	/* null if out of bounds */
 	if (index1b < 1) return NULL;
-	if (index1b < llen(list)/2) {
-		/* want element in back half, so count back from tail */
-		LNODE node = ltail(list);
-		INT i = index1b;
-		while (--i) {
-			node = lprev(node);
-		}
-		return node;
-	} else if (index1b <= llen(list)) {
-		/* want element in front half, so count forward from head */
-		LNODE node = lhead(list);
-		INT i = llen(list) + 1 - index1b;
-		while (--i) {
-			node = lnext(node);
-		}
-		return node;
+	if (index1b <= llen(list)) {
+		return lslot(list, list->l_hi - index1b);
 	} else if (createels) {
 		/* want element beyond end, so add as required */
 		INT i = index1b + 1 - llen(list);
@@ -404,7 +386,7 @@ nth_in_list_from_tail (LIST list, INT index1b, BOOLEAN createels, LIST_CREATE_VA
 			enqueue_list(list, newv);
 		}
 		validate_list(list);
-		return lhead(list);
+		return lslot(list, list->l_lo);
 	} else {
 		/* element beyond but caller said not to create */
 		return NULL;
@@ -416,12 +398,12 @@ nth_in_list_from_tail (LIST list, INT index1b, BOOLEAN createels, LIST_CREATE_VA
 void
 set_list_element (LIST list, INT index1b, VPTR val, LIST_CREATE_VALUE createfnc)
 {
-	LNODE node = NULL;
+	struct tag_lslot * slot = NULL;
 	BOOLEAN createels = TRUE;
 	if (!list) return;
-	node = nth_in_list_from_tail(list, index1b, createels, createfnc);
-	if (!node) return;
-	lelement(node) = val;
+	slot = nth_in_list_from_tail(list, index1b, createels, createfnc);
+	if (!slot) return;
+	slot->l_element = val;
 	validate_list(list);
 }
 /*=======================================================
@@ -430,12 +412,12 @@ set_list_element (LIST list, INT index1b, VPTR val, LIST_CREATE_VALUE createfnc)
 VPTR
 get_list_element (LIST list, INT index1b, LIST_CREATE_VALUE createfnc)
 {
-	LNODE node = NULL;
+	struct tag_lslot * slot = NULL;
 	BOOLEAN createels = TRUE;
 	if (!list) return 0;
-	node = nth_in_list_from_tail(list, index1b, createels, createfnc);
-	if (!node) return 0;
-	return lelement(node);
+	slot = nth_in_list_from_tail(list, index1b, createels, createfnc);
+	if (!slot) return 0;
+	return slot->l_element;
 }
 /*==================================
  * length_list -- Return list length
@@ -451,11 +433,8 @@ length_list (LIST list)
 VPTR
 peek_list_head (LIST list)
 {
-	LNODE node;
-	if (!list) return 0;
-	node = lhead(list);
-	if (!node) return 0;
-	return lelement(node);
+	if (!list || !llen(list)) return 0;
+	return lslot(list, list->l_lo)->l_element;
 }
 /*=================================================
  * create_list_iter -- Create new list iterator
@@ -476,8 +455,8 @@ LIST_ITER
 begin_list (LIST list)
 {
 	LIST_ITER listit = create_list_iter(list);
-	/* current=0 is signal to next_list_element that we're starting */
-	listit->status = (lhead(listit->list) ? 1 : 0);
+	/* started=FALSE is signal to next_list_element that we're starting */
+	listit->status = (llen(listit->list) ? 1 : 0);
 	return listit;
 }
 /*=================================================
@@ -487,8 +466,8 @@ LIST_ITER
 begin_list_rev (LIST list)
 {
 	LIST_ITER listit = create_list_iter(list);
-	/* current=0 is signal to next_list_element that we're starting */
-	listit->status = (ltail(listit->list) ? -1 : 0);
+	/* started=FALSE is signal to next_list_element that we're starting */
+	listit->status = (llen(listit->list) ? -1 : 0);
 	return listit;
 }
 /*=================================================
@@ -497,23 +476,22 @@ begin_list_rev (LIST list)
 static BOOLEAN
 next_list_element (LIST_ITER listit)
 {
+	LIST list = listit->list;
 	if (!listit->status)
 		return FALSE;
-	if (!listit->current) {
+	if (!listit->started) {
 		/* beginning */
+		listit->started = TRUE;
 		if (listit->status > 0)
-			listit->current = lhead(listit->list);
+			listit->current = list->l_lo;
 		else
-			listit->current = ltail(listit->list);
+			listit->current = list->l_hi - 1;
 	} else {
-		unlock_list_node(listit->current);
-		if (listit->status > 0)
-			listit->current = lnext(listit->current);
-		else
-			listit->current = lprev(listit->current);
+		unlock_list_element(list, listit->current);
+		listit->current += listit->status;
 	}
-	if (listit->current)
-		lock_list_node(listit->current);
+	if (linlist(list, listit->current))
+		lock_list_element(list, listit->current);
 	else
 		listit->status = 0;
 	return !!listit->status;
@@ -528,7 +506,7 @@ next_list_ptr (LIST_ITER listit, VPTR *pptr)
 		*pptr = 0;
 		return FALSE;
 	}
-	*pptr = lelement(listit->current);
+	*pptr = lslot(listit->list, listit->current)->l_element;
 	return TRUE;
 }
 /*=================================================
@@ -537,9 +515,11 @@ next_list_ptr (LIST_ITER listit, VPTR *pptr)
 BOOLEAN
 change_list_ptr (LIST_ITER listit, VPTR newptr)
 {
-	if (!listit || !listit->current)
+	if (!listit || !listit->started || !listit->status)
+		return FALSE;
+	if (!linlist(listit->list, listit->current))
 		return FALSE;
-	lelement(listit->current) = newptr;
+	lslot(listit->list, listit->current)->l_element = newptr;
 	return TRUE;
 }
 /*=================================================
@@ -568,21 +548,28 @@ free_list_iter (LIST_ITER listit)
 	stdfree(listit);
 }
 /*=================================================
- * lock_list_node -- Increment node lock count
+ * lock_list_element -- Increment element lock count
  *===============================================*/
 void
-lock_list_node (LNODE node)
+lock_list_element (LIST list, INT pos)
 {
-	++llocks(node);
+	ASSERT(list && linlist(list, pos));
+	++lslot(list, pos)->l_locks;
 }
 /*=================================================
- * unlock_list_node -- Decrement node lock count
+ * unlock_list_element -- Decrement element lock count
+ *  element may have been removed from list meanwhile
+ *  (lock went with it)
  *===============================================*/
 void
-unlock_list_node (LNODE node)
+unlock_list_element (LIST list, INT pos)
 {
-	--llocks(node);
-	ASSERT(llocks(node) >= 0);
+	struct tag_lslot * slot;
+	if (!list || !linlist(list, pos))
+		return;
+	slot = lslot(list, pos);
+	if (slot->l_locks)
+		--slot->l_locks;
 }
 /*==================================================
  * delete_list_element - Delete element using array access
@@ -592,96 +579,90 @@ unlock_list_node (LNODE node)
 BOOLEAN
 delete_list_element (LIST list, INT index1b, ELEMENT_DESTRUCTOR func)
 {
-	LNODE node = NULL;
+	struct tag_lslot * slot = NULL;
 	BOOLEAN createels = FALSE;
+	INT pos;
 	if (!list) return FALSE;
-	node = nth_in_list_from_tail(list, index1b, createels, 0);
-	if (!node) return FALSE;
-	if (llocks(node)) return FALSE;
-	detach_node_from_list(list, node);
+	slot = nth_in_list_from_tail(list, index1b, createels, 0);
+	if (!slot) return FALSE;
+	if (slot->l_locks) return FALSE;
 	if (func)
-		(*func)(lelement(node));
-	stdfree(node);
+		(*func)(slot->l_element);
+	/* close up gap, moving tail towards head */
+	for (pos = list->l_hi - index1b; pos < list->l_hi - 1; ++pos)
+		*lslot(list, pos) = *lslot(list, pos+1);
+	--list->l_hi;
 	return TRUE;
 }
 #endif
-/*==================================================
- * detach_node_from_list - Remove node from list
- *  does not delete node, simply detaches it from the list
- *  and decrements list's count
- *================================================*/
-static void
-detach_node_from_list (LIST list, LNODE node)
-{
-	validate_list(list);
-	if (lprev(node)) {
-		lnext(lprev(node)) = lnext(node);
-	}
-	if (lnext(node)) {
-		lprev(lnext(node)) = lprev(node);
-	}
-	if (lhead(list) == node) {
-		lhead(list) = lnext(node);
-	}
-	if (ltail(list) == node) {
-		ltail(list) = lprev(node);
-	}
-	--llen(list);
-	validate_list(list);
-}
 /*==================================================
  * find_delete_list_elements - Delete qualifying element(s)
  *  list:      [I/O] list to change
  *  func:      [IN]  test function to qualify elements (return TRUE to choose)
  *  deleteall: [IN]  true to delete all qualifying, false to delete first
  * returns number elements deleted
+ * remaining elements are moved up towards head, in one pass
  *================================================*/
 INT
 find_delete_list_elements (LIST list, VPTR param,
 	BOOLEAN (*func)(VPTR param, VPTR el), BOOLEAN deleteall)
 {
-	LNODE lnode = NULL;
 	INT count = 0;
+	INT pos, newhi;
 	if (is_empty_list(list)) /* calls validate_list */
 		return 0;
 	ASSERT(func);
-	lnode = lhead(list);
-	while (lnode) {
-		LNODE lnext = lnext(lnode);
-		if ((*func)(param, lelement(lnode))) {
-			detach_node_from_list(list, lnode);
+	newhi = list->l_lo;
+	for (pos = list->l_lo; pos < list->l_hi; ++pos) {
+		struct tag_lslot * slot = lslot(list, pos);
+		if ((deleteall || !count) && (*func)(param, slot->l_element)) {
 			++count;
 			if (ltype(list) == LISTDOFREE) {
-				free_list_element(lelement(lnode));
+				free_list_element(slot->l_element);
 			}
-			stdfree(lnode);
-			if (!deleteall)
-				return count;
+			continue;
 		}
-		lnode = lnext;
+		if (newhi != pos)
+			*lslot(list, newhi) = *slot;
+		++newhi;
 	}
+	list->l_hi = newhi;
+	validate_list(list);
 	return count;
 
 }
 /*==================================================
- * trav_list_head - Return tail node of list
- *  Only for internal use in FORLIST implementation
+ * trav_list_head - Return position of head of list
+ *  Only for internal use in FORXLIST implementation
  *================================================*/
-LNODE
+INT
 trav_list_head (LIST list)
 {
 	ASSERT(list);
-	return list->l_head;
+	return list->l_lo;
 }
 /*==================================================
- * trav_list_tail - Return tail node of list
+ * trav_list_tail - Return position of tail of list
  *  Only for internal use in FORLIST implementation
  *================================================*/
-LNODE
+INT
 trav_list_tail (LIST list)
 {
 	ASSERT(list);
-	return list->l_tail;
+	return list->l_hi - 1;
+}
+/*==================================================
+ * trav_list_element - Get element at position, if any
+ *  Only for internal use in FORLIST implementation
+ * returns FALSE if position is off either end of list
+ *================================================*/
+BOOLEAN
+trav_list_element (LIST list, INT pos, VPTR *pptr)
+{
+	if (!list || !linlist(list, pos))
+		return FALSE;
+	*pptr = lslot(list, pos)->l_element;
+	return TRUE;
 }
 /*=================================================
  * list_destructor -- destructor for list
@@ -34,7 +34,9 @@ extern int opt_finnish;
 static usersortfnc usersort = 0;
 
 
+static void append_unit(ZSTR zkey, unsigned long unit);
 static BOOLEAN widecmp(CNSTRING str1, CNSTRING str2, INT *rtn);
+static BOOLEAN widexfrm(CNSTRING str, ZSTR zkey);
 
 /*===================================================
  * ll_strcmp -- Compare two strings
@@ -88,6 +90,91 @@ ll_strcmploc (const char *str1, const char *str2)
 	return(strcmp(str1, str2));
 #endif
 }
+/*===================================================
+ * ll_sortkey -- Append collation key of string to sort key
+ *  str:  [IN]  string to collate
+ *  zkey: [I/O] sort key being built
+ * Keys compared with ll_sortkeycmp order the same way as
+ * ll_strcmploc orders the strings, so a sort can build each
+ * key once instead of collating on every comparison.
+ * Each string's key ends with a terminator lower than any
+ * content, so keys of several strings may be appended in turn.
+ * Returns FALSE if current collation has no keys (Finnish
+ * or user-defined), and caller must use ll_strcmploc.
+ *=================================================*/
+BOOLEAN
+ll_sortkey (CNSTRING str, ZSTR zkey)
+{
+	if (opt_finnish || usersort)
+		return FALSE;
+	if (!str)
+		str = "";
+
+	/* regular wchar.h implementation, if available */
+	if (widexfrm(str, zkey))
+		return TRUE;
+
+#ifdef HAVE_STRCOLL
+	/* regular 8-bit strxfrm */
+	{
+		size_t len;
+		unsigned int oldlen = zs_len(zkey);
+		errno = 0;
+		len = strxfrm(NULL, str, 0);
+		if (!errno) {
+			zs_reserve(zkey, oldlen + len + 2);
+			strxfrm(zs_str(zkey)+oldlen, str, len+1);
+		}
+		if (!errno) {
+			/* keep terminating zero of strxfrm output */
+			zs_set_len(zkey, oldlen + len + 1);
+			return TRUE;
+		}
+		zs_set_len(zkey, oldlen);
+	}
+#endif
+	/* simple strcmp 8-bit numerical order */
+	zs_reserve(zkey, zs_len(zkey) + strlen(str) + 2);
+	memcpy(zs_str(zkey)+zs_len(zkey), str, strlen(str)+1);
+	zs_set_len(zkey, zs_len(zkey) + strlen(str) + 1);
+	return TRUE;
+}
+/*===================================================
+ * ll_sortkey_num -- Append number to sort key
+ *  (ordered numerically, in fixed width)
+ *=================================================*/
+void
+ll_sortkey_num (ZSTR zkey, INT num)
+{
+	append_unit(zkey, (unsigned long)((num + 0x80000000L) & 0xFFFFFFFFL));
+}
+/*===================================================
+ * ll_sortkeycmp -- Compare two sort keys
+ *  (built by ll_sortkey & ll_sortkey_num)
+ *=================================================*/
+int
+ll_sortkeycmp (CNSTRING key1, INT len1, CNSTRING key2, INT len2)
+{
+	int rtn = memcmp(key1, key2, len1 < len2 ? len1 : len2);
+	if (rtn)
+		return rtn;
+	return len1 < len2 ? -1 : (len1 > len2 ? 1 : 0);
+}
+/*===================================================
+ * append_unit -- Append 32-bit unit to sort key
+ *  most significant byte first, so keys compare with memcmp
+ *=================================================*/
+static void
+append_unit (ZSTR zkey, unsigned long unit)
+{
+	unsigned int len = zs_len(zkey);
+	unsigned char * p = (unsigned char *)zs_reserve(zkey, len + 5) + len;
+	p[0] = (unsigned char)(unit >> 24);
+	p[1] = (unsigned char)(unit >> 16);
+	p[2] = (unsigned char)(unit >> 8);
+	p[3] = (unsigned char)unit;
+	zs_set_len(zkey, len + 4);
+}
 /*===================================================
  * ll_what_collation -- get string describing collation in use
  *=================================================*/
@@ -168,3 +255,38 @@ widecmp (HINT_PARAM_UNUSED CNSTRING str1, HINT_PARAM_UNUSED CNSTRING str2, HINT_
 
 	return success;
 }
+/*===================================================
+ * widexfrm -- Append unicode collation key (wcsxfrm), if available
+ *  each wide character of key is appended as one 32-bit unit,
+ *  ending with a zero unit
+ *=================================================*/
+static BOOLEAN
+#ifdef HAVE_WCSCOLL
+widexfrm (CNSTRING str, ZSTR zkey)
+#else
+widexfrm (HINT_PARAM_UNUSED CNSTRING str, HINT_PARAM_UNUSED ZSTR zkey)
+#endif
+{
+	BOOLEAN success = FALSE;
+#ifdef HAVE_WCSCOLL
+	ZSTR zws = makewide(str);
+	if (zws) {
+		const wchar_t * wfs = (const wchar_t *)zs_str(zws);
+		wchar_t wbuf[128];
+		wchar_t * wxf = wbuf;
+		size_t len = wcsxfrm(NULL, wfs, 0), i;
+		if (len >= (size_t)ARRSIZE(wbuf))
+			wxf = (wchar_t *)stdalloc((len+1)*sizeof(wchar_t));
+		wcsxfrm(wxf, wfs, len+1);
+		for (i=0; i<len; ++i)
+			append_unit(zkey, (unsigned long)wxf[i]);
+		append_unit(zkey, 0);
+		if (wxf != wbuf)
+			stdfree(wxf);
+		zs_free(&zws);
+		success = TRUE;
+	}
+#endif /* HAVE_WCSCOLL */
+
+	return success;
+}
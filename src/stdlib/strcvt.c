@@ -36,9 +36,12 @@
 #include "icvt.h"
 #include "stdlibi.h"
 
+static ICVT get_widecvt(void);
 static const char * get_wchar_codeset_name(void);
 static ZSTR (*upperfunc)(CNSTRING) = 0;
 static ZSTR (*lowerfunc)(CNSTRING) = 0;
+static ICVT widecvt = 0; /* internal to wchar_t, for makewide */
+static STRING widecvt_src = 0; /* internal codeset widecvt was opened for */
 
 /*===================================================
  * get_wchar_codeset_name -- name of wchar_t codeset
@@ -66,16 +69,34 @@ ZSTR
 makewide (const char *str)
 {
 	ZSTR zstr=0;
-	if (int_codeset && int_codeset[0]) {
-		CNSTRING dest = get_wchar_codeset_name();
+	ICVT icvt = get_widecvt();
+	if (icvt) {
 		zstr = zs_new();
-		/* dest = "wchar_t" doesn't work--Perry, 2002-11-20 */
-		if (!iconv_trans(int_codeset, dest, str, zstr, '?')) {
+		if (!icvt_trans(icvt, str, zstr, '?')) {
 			zs_free(&zstr);
 		}
 	}
 	return zstr;
 }
+/*===================================================
+ * get_widecvt -- conversion from internal codeset to wchar_t
+ *  kept open for makewide, which collation calls constantly
+ *  returns NULL if not available
+ *=================================================*/
+static ICVT
+get_widecvt (void)
+{
+	if (!int_codeset || !int_codeset[0])
+		return NULL;
+	if (!widecvt_src || !eqstr(widecvt_src, int_codeset)) {
+		/* dest = "wchar_t" doesn't work--Perry, 2002-11-20 */
+		icvt_close(&widecvt);
+		strfree(&widecvt_src);
+		widecvt_src = strsave(int_codeset);
+		widecvt = icvt_open(int_codeset, get_wchar_codeset_name());
+	}
+	return widecvt;
+}
 /*===================================================
  * makeznarrow -- Inverse of makewide
  *  Created: 2002-12-15 (Perry Rapp)
@@ -39,23 +39,7 @@ utf8len (char ch)
 size_t
 str8chlen (CNSTRING str)
 {
-	CNSTRING ptr = str;
-	size_t len = 0;
-	size_t chwidth = 0;
-	size_t i=0;
-	while (*ptr) {
-		chwidth = utf8len(*ptr);
-		++len;
-		/* advance pointer, but be careful
-		not to skip blindly over null in middle
-		of broken multibyte sequence */
-		for (i=0; i<chwidth; ++i) {
-			if (!ptr[0])
-				return len;
-			++ptr;
-		}
-	}
-	return len;
+	return utf8_chars(str, strlen(str));
 }
 /*=========================================
  * find_prev_char -- Back up to start of previous character.
@@ -0,0 +1,367 @@
+/*
+   Copyright (c) 2026 the LifeLines developers
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation
+   files (the "Software"), to deal in the Software without
+   restriction, including without limitation the rights to use, copy,
+   modify, merge, publish, distribute, sublicense, and/or sell copies
+   of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+   EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+   NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+   BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+   ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+   SOFTWARE.
+*/
+/*=============================================================
+ * utf8scan.c -- Scanning long UTF-8 buffers
+ *  (validation, character counts, display widths)
+ * Runs of ASCII are skipped 16 bytes at a time with SSE2 where
+ * the compiler offers it, else 8 bytes at a time in a word.
+ *==============================================================*/
+
+#include "llstdlib.h" /* includes standard.h, sys_inc.h, llnls.h, config.h */
+/* mk_wcwidth is in arch/wcswidth.c */
+#include "arch.h"
+#ifdef HAVE_WCHAR_H
+#include <wchar.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_SSE2
+#include <emmintrin.h>
+#endif
+
+/*********************************************
+ * local function prototypes
+ *********************************************/
+
+/* alphabetical */
+static INT char_width(INT32 ucs);
+static size_t count_lead_bytes(const uchar * s, size_t len);
+static INT decode_char(const uchar * s, size_t len, INT32 * pucs);
+#ifdef UTF8_SSE2
+static INT low_bit(unsigned int mask);
+#endif
+
+/*********************************************
+ * local variables
+ *********************************************/
+
+/* high bit of every byte of a word */
+#define HIGHBITS ((uint64_t)0x8080808080808080ULL)
+/* low bit of every byte of a word */
+#define LOWBITS ((uint64_t)0x0101010101010101ULL)
+/* read file this much at a time in check_file_utf8 */
+#define SCANBUF 65536
+
+/*********************************************
+ * local & exported function definitions
+ * body of module
+ *********************************************/
+
+/*=========================================
+ * ascii_span -- How many bytes at start of buffer are ASCII ?
+ *=======================================*/
+size_t
+ascii_span (CNSTRING str, size_t len)
+{
+	const uchar * s = (const uchar *)str;
+	size_t i=0;
+#ifdef UTF8_SSE2
+	for ( ; i+16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(s+i));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(v);
+		if (mask)
+			return i + low_bit(mask);
+	}
+#else
+	for ( ; i+8 <= len; i += 8) {
+		uint64_t w;
+		memcpy(&w, s+i, sizeof(w));
+		if (w & HIGHBITS)
+			break;
+	}
+#endif
+	while (i<len && !(s[i] & 0x80))
+		++i;
+	return i;
+}
+#ifdef UTF8_SSE2
+/*=========================================
+ * low_bit -- Index of lowest set bit in nonzero mask
+ *=======================================*/
+static INT
+low_bit (unsigned int mask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	INT i=0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		++i;
+	}
+	return i;
+#endif
+}
+#endif /* UTF8_SSE2 */
+/*=========================================
+ * count_lead_bytes -- Count bytes that are not UTF-8 trail bytes
+ *  (trail bytes are 10xxxxxx)
+ *=======================================*/
+static size_t
+count_lead_bytes (const uchar * s, size_t len)
+{
+	size_t i=0, trail=0;
+#ifdef UTF8_SSE2
+	/* as signed bytes, trail bytes are those below -64 */
+	const __m128i limit = _mm_set1_epi8(-64);
+	for ( ; i+16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(s+i));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(
+			_mm_cmplt_epi8(v, limit));
+		while (mask) {
+			mask &= mask-1;
+			++trail;
+		}
+	}
+#else
+	for ( ; i+8 <= len; i += 8) {
+		uint64_t w;
+		memcpy(&w, s+i, sizeof(w));
+		/* high bit set & next bit clear, moved down to low bit */
+		w = ((w & ~(w << 1)) & HIGHBITS) >> 7;
+		/* add up the bytes into the top byte */
+		trail += (size_t)((w * LOWBITS) >> 56);
+	}
+#endif
+	for ( ; i<len; ++i) {
+		if ((s[i] & 0xC0) == 0x80)
+			++trail;
+	}
+	return len - trail;
+}
+/*=========================================
+ * decode_char -- Decode one UTF-8 character
+ *  s:    [IN]  start of character (not ASCII)
+ *  len:  [IN]  bytes available
+ *  pucs: [OUT] code point, or -1 if not valid UTF-8
+ * Returns bytes used, which is 1 for an invalid byte,
+ *  or 0 for a valid but incomplete sequence at end of buffer.
+ * Rejects overlong forms, surrogates, and values past U+10FFFF.
+ *=======================================*/
+static INT
+decode_char (const uchar * s, size_t len, INT32 * pucs)
+{
+	INT n, i;
+	INT32 ucs, min;
+	uchar lo=0x80, hi=0xBF; /* allowed range of second byte */
+	*pucs = -1;
+	if (s[0] < 0xC2) {
+		return 1; /* trail byte or overlong 2-byte lead */
+	} else if (s[0] < 0xE0) {
+		n = 2; ucs = s[0] & 0x1F; min = 0x80;
+	} else if (s[0] < 0xF0) {
+		n = 3; ucs = s[0] & 0x0F; min = 0x800;
+		if (s[0] == 0xE0) lo = 0xA0;
+		if (s[0] == 0xED) hi = 0x9F; /* surrogates */
+	} else if (s[0] < 0xF5) {
+		n = 4; ucs = s[0] & 0x07; min = 0x10000;
+		if (s[0] == 0xF0) lo = 0x90;
+		if (s[0] == 0xF4) hi = 0x8F; /* past U+10FFFF */
+	} else {
+		return 1;
+	}
+	for (i=1; i<n; ++i) {
+		if ((size_t)i >= len)
+			return 0;
+		if (i==1 ? (s[i] < lo || s[i] > hi) : ((s[i] & 0xC0) != 0x80))
+			return 1;
+		ucs = (ucs << 6) | (s[i] & 0x3F);
+	}
+	if (ucs < min)
+		return 1;
+	*pucs = ucs;
+	return n;
+}
+/*=========================================
+ * char_width -- Display columns of one character
+ *  control characters and invalid bytes take one column
+ *=======================================*/
+static INT
+char_width (INT32 ucs)
+{
+	INT wid;
+	if (ucs < 0)
+		return 1;
+	if (sizeof(wchar_t) < 4 && ucs > 0xFFFF) {
+		/* wchar_t cannot hold it (MS-Windows) */
+		return (ucs >= 0x20000 && ucs <= 0x3FFFD) ? 2 : 1;
+	}
+	wid = mk_wcwidth((wchar_t)ucs);
+	return wid < 0 ? 1 : wid;
+}
+/*=========================================
+ * utf8_valid_span -- How many bytes at start of buffer are valid UTF-8 ?
+ *  Returns len if all of it is valid.
+ *  An incomplete character at the end counts as invalid; callers
+ *  reading a stream in pieces should retry it with more input.
+ *=======================================*/
+size_t
+utf8_valid_span (CNSTRING str, size_t len)
+{
+	const uchar * s = (const uchar *)str;
+	size_t i=0;
+	while (i<len) {
+		INT32 ucs;
+		INT n;
+		i += ascii_span(str+i, len-i);
+		if (i == len)
+			break;
+		n = decode_char(s+i, len-i, &ucs);
+		if (ucs < 0)
+			break;
+		i += n;
+	}
+	return i;
+}
+/*=========================================
+ * utf8_chars -- Number of characters in UTF-8 buffer
+ *  Counts every byte that is not a trail byte, so a stray
+ *  lead byte counts as one character
+ *=======================================*/
+size_t
+utf8_chars (CNSTRING str, size_t len)
+{
+	return count_lead_bytes((const uchar *)str, len);
+}
+/*=========================================
+ * utf8_width -- Display columns of UTF-8 buffer
+ *  Uses Markus Kuhn's character widths, so combining marks take
+ *  no columns, and East Asian wide characters take two.
+ *=======================================*/
+size_t
+utf8_width (CNSTRING str, size_t len)
+{
+	const uchar * s = (const uchar *)str;
+	size_t i=0, cols=0;
+	while (i<len) {
+		INT32 ucs;
+		INT n;
+		size_t run = ascii_span(str+i, len-i);
+		i += run;
+		cols += run;
+		if (i == len)
+			break;
+		n = decode_char(s+i, len-i, &ucs);
+		cols += char_width(ucs);
+		i += n ? (size_t)n : len-i;
+	}
+	return cols;
+}
+/*=========================================
+ * utf8_fit_width -- How many bytes at start of UTF-8 buffer fit
+ *  into so many display columns ?
+ *  Never splits a character, and keeps any combining marks that
+ *  follow the last character that fits.
+ *=======================================*/
+size_t
+utf8_fit_width (CNSTRING str, size_t len, size_t cols)
+{
+	const uchar * s = (const uchar *)str;
+	size_t i=0, used=0;
+	while (i<len) {
+		INT32 ucs;
+		INT n, wid;
+		if (!(s[i] & 0x80)) {
+			size_t run;
+			if (used == cols)
+				break;
+			run = ascii_span(str+i, len-i < cols-used ? len-i : cols-used);
+			i += run;
+			used += run;
+			continue;
+		}
+		n = decode_char(s+i, len-i, &ucs);
+		if (!n)
+			break; /* incomplete character at end */
+		wid = char_width(ucs);
+		if (used + wid > cols)
+			break;
+		used += wid;
+		i += n;
+	}
+	return i;
+}
+/*=========================================
+ * check_file_utf8 -- Is rest of file valid UTF-8 ?
+ *  fp:      [IN]  file (left at same position on return)
+ *  pascii:  [OUT] whether rest of file is all ASCII
+ *  pline:   [OUT] line of first invalid byte, counting from
+ *                 current position (only set if invalid)
+ * Reads file in large blocks, skipping over ASCII in words.
+ *=======================================*/
+BOOLEAN
+check_file_utf8 (FILE * fp, BOOLEAN * pascii, INT * pline)
+{
+	char * buffer = (char *)stdalloc(SCANBUF);
+	long start = ftell(fp);
+	size_t carry=0, bad=0, len, span, i;
+	long badoff=-1, offset=0;
+	BOOLEAN ascii=TRUE;
+	INT line=1;
+
+	while ((len = fread(buffer+carry, 1, SCANBUF-carry, fp)) > 0 || carry) {
+		BOOLEAN last = (len == 0);
+		len += carry;
+		span = 0;
+		if (ascii) {
+			span = ascii_span(buffer, len);
+			if (span == len) {
+				offset += (long)len;
+				continue;
+			}
+			ascii = FALSE;
+		}
+		span += utf8_valid_span(buffer+span, len-span);
+		if (span < len) {
+			/* incomplete character at end of block is carried over */
+			INT32 ucs;
+			if (last || decode_char((const uchar *)buffer+span
+				, len-span, &ucs) != 0) {
+				bad = span;
+				badoff = offset;
+				break;
+			}
+		}
+		carry = len - span;
+		memmove(buffer, buffer+span, carry);
+		offset += (long)span;
+	}
+	if (badoff >= 0) {
+		/* count lines up to bad byte (only on failure, so not in loop) */
+		INT ch;
+		long n = badoff + (long)bad;
+		fseek(fp, start, SEEK_SET);
+		for (i=0; i<(size_t)n && (ch = fgetc(fp)) != EOF; ++i) {
+			if (ch == '\n')
+				++line;
+		}
+		if (pline)
+			*pline = line;
+	}
+	fseek(fp, start, SEEK_SET);
+	stdfree(buffer);
+	if (pascii)
+		*pascii = ascii;
+	return badoff < 0;
+}
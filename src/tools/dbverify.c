@@ -43,12 +43,22 @@
 #include "arch.h"
 #include "gedcom.h"
 #include "version.h"
+#include "famgraph.h"
+#include <time.h>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
 
 #ifndef INCLUDED_STDARG_H
 #include <stdarg.h>
 #define INCLUDED_STDARG_H
 #endif
 
+/* data blocks may be checked by several processes at once */
+#if defined(HAVE_FORK) && defined(HAVE_WAITPID) && defined(HAVE_SYS_WAIT_H)
+#define WORKER_PROCESSES
+#endif
+
 
 /*********************************************
  * external variables (no header)
@@ -101,8 +111,21 @@ struct work {
 	INT fix_block_splits;
 	INT check_missing_data_records; /* record in index, but no data */
 	INT fix_missing_data_records;
+	INT check_famgraph_index;
+	INT incremental; /* only data blocks changed since checkpoint */
 	INT pass; /* =1 is checking, =2 is fixing */
 };
+/*==============================================
+ * leaf -- one data block of btree to be checked
+ *  lo & hi are key limits set by its parent index
+ *============================================*/
+struct leaf {
+	FKEY fkey;
+	RKEY lo;
+	RKEY hi;
+	BOOLEAN haslo;
+	BOOLEAN hashi;
+};
 /*=======================================
  * NAMEREFN_REC -- holds one name or refn
  *  key is the target pointed to
@@ -119,18 +142,21 @@ typedef struct
  *********************************************/
 
 /* alphabetical */
+static void add_leaf(FKEY fkey, RKEY * lo, RKEY * hi);
 static NAMEREFN_REC * alloc_namerefn(CNSTRING namerefn, CNSTRING key, INT err);
 static BOOLEAN cgn_callback(TRAV_NAMES_FUNC_ARGS(key, name, newset, param));
 static BOOLEAN cgr_callback(TRAV_REFNS_FUNC_ARGS(key, refn, newset, param));
 static void check_and_fix_records(void);
 static BOOLEAN check_block(BTREE btr, BLOCK block, RKEY * lo, RKEY * hi);
 static BOOLEAN check_btree(BTREE btr);
+static void check_entry(RKEY rkey, STRING data, INT len);
 static BOOLEAN check_even(CNSTRING key, RECORD rec);
 static BOOLEAN check_fam(CNSTRING key, RECORD rec);
-static void check_ghosts(void);
 static BOOLEAN check_keys(BLOCK block, RKEY * lo, RKEY * hi);
 static BOOLEAN check_index(BTREE btr, INDEX index, TABLE fkeytab, RKEY * lo, RKEY * hi);
 static BOOLEAN check_indi(CNSTRING key, RECORD rec);
+static void check_leaf(struct leaf * lf);
+static void check_leaves(void);
 static void check_node(CNSTRING key, NODE node, INT level);
 static void check_nodes(void);
 static void check_missing_data_records(void);
@@ -139,9 +165,13 @@ static void check_set(INDISEQ seq, char ctype);
 static BOOLEAN check_sour(CNSTRING key, RECORD rec);
 static void check_typed_missing_data_records(char ntype);
 static BOOLEAN check_othe(CNSTRING key, RECORD rec);
+static BOOLEAN checking_type(char ntype);
+static INT count_workers(void);
+static BOOLEAN errors_found(void);
 static BOOLEAN find_xref(CNSTRING key, NODE node, CNSTRING tag1, CNSTRING tag2);
 static void finish_and_delete_nameset(void);
 static void finish_and_delete_refnset(void);
+static void fix_ghosts(void);
 static void fix_nodes(void);
 static void free_namerefn(NAMEREFN_REC * rec);
 static BOOLEAN fix_bad_pointer(CNSTRING key, RECORD rec, NODE node);
@@ -152,12 +182,25 @@ static void print_usage(void);
 static void process_fam(RECORD rec);
 static void process_indi(RECORD rec);
 static void process_record(RECORD rec);
+static time_t read_checkpoint(void);
 static void report_error(INT err, STRING fmt, ...);
 static void report_fix(INT err, STRING fmt, ...);
 static void report_progress(STRING fmt, ...);
 static void report_results(void);
+#ifdef WORKER_PROCESSES
+static void read_results(FILE * fp);
+static void run_worker(INT first, INT last, FILE * out, FILE * res);
+static void run_workers(INT nworkers);
+#endif
+static void select_changed_leaves(void);
 static void validate_errs(void);
 static void vcrashlog(int newline, const char * fmt, va_list args);
+static void walk_leaves(INT first, INT last);
+static void write_checkpoint(time_t when);
+#ifdef WORKER_PROCESSES
+static void write_results(FILE * fp);
+static void write_seq_keys(FILE * fp, INDISEQ seq);
+#endif
 
 /*********************************************
  * local variables
@@ -172,7 +215,7 @@ enum {
 	, ERR_BADHUSBREF, ERR_BADWIFEREF, ERR_BADCHILDREF
 	, ERR_EXTRAHUSB, ERR_EXTRAWIFE, ERR_EXTRACHILD
 	, ERR_EMPTYFAM, ERR_SOLOFAM, ERR_BADPOINTER
-	, ERR_MISSINGREC, ERR_STALEBLOCKENTRY
+	, ERR_MISSINGREC, ERR_STALEBLOCKENTRY, ERR_FAMGRAPH
 };
 
 static struct errinfo errs[] = {
@@ -203,13 +246,22 @@ static struct errinfo errs[] = {
 	, { ERR_BADPOINTER, 0, 0, N_("Bad pointer") }
 	, { ERR_MISSINGREC, 0, 0, N_("Missing data records") }
 	, { ERR_STALEBLOCKENTRY, 0, 0, N_("Stale block directory entry") }
+	, { ERR_FAMGRAPH, 0, 0, N_("Family graph index mismatch") }
 };
 static struct work todo;
 static LIST tofix=0;
+static LIST namefix=0, refnfix=0; /* ghosts to remove */
 /* sequence of NAMEs or REFNs in the same block */
 static INDISEQ soundexseq=0;
 static BOOLEAN noisy=FALSE;
 static INDISEQ seq_indis, seq_fams, seq_sours, seq_evens, seq_othes;
+static struct leaf * leaves=0; /* data blocks to check, in key order */
+static INT nleaves=0, maxleaves=0;
+static BOOLEAN leaves_found=FALSE; /* check_btree has filled leaves */
+static BOOLEAN badtree=FALSE; /* structural error found in data blocks */
+static BOOLEAN fgcheck=FALSE; /* family graph index is there to check */
+static STRING recbuf=0; /* one record of block, zero terminated */
+static INT recbufsize=0;
 static STRING lineage_tags[] = {
 	  "FAMC"
 	, "FAMS"
@@ -255,6 +307,8 @@ print_usage (void)
 	printf(_("\t-M = Fix records missing data entries\n"));
 	printf(_("\t-D = Fix bad delete entries\n"));
 	printf(_("\t-B = Fix block splits with stale data\n"));
+	printf(_("\t-k = Check family graph index against records\n"));
+	printf(_("\t-c = Check only data blocks changed since last clean run of all checks\n"));
 	printf(_("\t-n = Noisy (echo every record processed)\n"));
 	printf(_("example: dbverify -ifsex \"%s\"\n"), fname);
 	printf("%s\n", verstr);
@@ -330,48 +384,24 @@ free_namerefn (NAMEREFN_REC * rec)
 	stdfree(rec);
 }
 /*==========================================
- * check_ghosts -- Process all names & refns
- *  checking (& optionally fixing) ghosts
- * Created: 2001/01/01, Perry Rapp
+ * fix_ghosts -- Remove ghost names & refns
+ *  found by check_leaves
  *=========================================*/
 static void
-check_ghosts (void)
+fix_ghosts (void)
 {
-	tofix = create_list();
-	soundexseq = create_indiseq_sval();
-	/* soundexseq is used inside cgn_callback, across calls */
-	traverse_names(cgn_callback, NULL);
-	finish_and_delete_nameset();
-
-	if (todo.fix_ghosts) {
-		NAMEREFN_REC * rec;
-		while (!is_empty_list(tofix)) {
-			rec = (NAMEREFN_REC *) dequeue_list(tofix);
-			remove_name(rec->namerefn, rec->key);
-			++errs[rec->err].fix_count;
-			free_namerefn(rec);
-		}
+	NAMEREFN_REC * rec;
+	while (!is_empty_list(namefix)) {
+		rec = (NAMEREFN_REC *) dequeue_list(namefix);
+		remove_name(rec->namerefn, rec->key);
+		++errs[rec->err].fix_count;
+		free_namerefn(rec);
 	}
-
-	ASSERT(is_empty_list(tofix));
-	ASSERT(!soundexseq);
-
-	soundexseq = create_indiseq_sval();
-	/* soundexseq is used inside cgr_callback, across calls */
-	traverse_refns(cgr_callback, NULL);
-	finish_and_delete_refnset();
-
-	if (todo.fix_ghosts) {
-		NAMEREFN_REC * rec;
-		while (!is_empty_list(tofix)) {
-			rec = (NAMEREFN_REC *) dequeue_list(tofix);
-			remove_refn(rec->namerefn, rec->key);
-			free_namerefn(rec);
-		}
+	while (!is_empty_list(refnfix)) {
+		rec = (NAMEREFN_REC *) dequeue_list(refnfix);
+		remove_refn(rec->namerefn, rec->key);
+		free_namerefn(rec);
 	}
-	
-	destroy_list(tofix);
-	tofix=0;
 }
 /*============================================
  * cgn_callback -- callback for name traversal
@@ -397,7 +427,8 @@ cgn_callback (TRAV_NAMES_FUNC_ARGS(key, name, newset, param))
 	indi = nztop(indi0);
 
 	if (newset) {
-		finish_and_delete_nameset();
+		if (soundexseq)
+			finish_and_delete_nameset();
 		soundexseq = create_indiseq_sval();
 	}
 
@@ -408,7 +439,7 @@ cgn_callback (TRAV_NAMES_FUNC_ARGS(key, name, newset, param))
 	if (!indi) {
 		report_error(ERR_ORPHANNAME, _("Orphaned name: %s"), name);
 		if (todo.fix_ghosts)
-			enqueue_list(tofix, (VPTR)alloc_namerefn(name, key, ERR_ORPHANNAME));
+			enqueue_list(namefix, (VPTR)alloc_namerefn(name, key, ERR_ORPHANNAME));
 	} else {
 		NODE node;
 		BOOLEAN found=FALSE;
@@ -422,7 +453,7 @@ cgn_callback (TRAV_NAMES_FUNC_ARGS(key, name, newset, param))
 		if (!found) {
 			report_error(ERR_GHOSTNAME, _("Ghost name: %s -> %s"), name, key);
 			if (todo.fix_ghosts)
-				enqueue_list(tofix, (VPTR)alloc_namerefn(name, key, ERR_GHOSTNAME));
+				enqueue_list(namefix, (VPTR)alloc_namerefn(name, key, ERR_GHOSTNAME));
 		}
 	}
 
@@ -444,7 +475,8 @@ cgr_callback (TRAV_REFNS_FUNC_ARGS(key, refn, newset, param))
 	NODE node = nztop(rec);
 
 	if (newset) {
-		finish_and_delete_refnset();
+		if (soundexseq)
+			finish_and_delete_refnset();
 		soundexseq = create_indiseq_sval();
 	}
 	append_indiseq_sval(soundexseq, strsave(key), NULL, strsave(refn)
@@ -453,7 +485,7 @@ cgr_callback (TRAV_REFNS_FUNC_ARGS(key, refn, newset, param))
 	if (!node) {
 		report_error(ERR_ORPHANNAME, _("Orphaned refn: %s"), refn);
 		if (todo.fix_ghosts)
-			enqueue_list(tofix, (VPTR)alloc_namerefn(refn, key, ERR_ORPHANNAME));
+			enqueue_list(refnfix, (VPTR)alloc_namerefn(refn, key, ERR_ORPHANNAME));
 	} else {
 	}
 	if (noisy)
@@ -549,13 +581,16 @@ check_nodes (void)
 	seq_sours = create_indiseq_null();
 	seq_evens = create_indiseq_null();
 	seq_othes = create_indiseq_null();
-	traverse_db_key_recs(nodes_callback, NULL);
+	check_leaves();
 	/* check what we saw against delete sets */
-	check_set(seq_indis, 'I');
-	check_set(seq_fams, 'F');
-	check_set(seq_sours, 'S');
-	check_set(seq_evens, 'E');
-	check_set(seq_othes, 'X');
+	/* (which needs every record, so not when incremental) */
+	if (!todo.incremental) {
+		if (todo.check_indis) check_set(seq_indis, 'I');
+		if (todo.check_fams) check_set(seq_fams, 'F');
+		if (todo.check_sours) check_set(seq_sours, 'S');
+		if (todo.check_evens) check_set(seq_evens, 'E');
+		if (todo.check_othes) check_set(seq_othes, 'X');
+	}
 	remove_indiseq(seq_indis);
 	remove_indiseq(seq_fams);
 	remove_indiseq(seq_sours);
@@ -569,11 +604,415 @@ static void
 check_and_fix_records (void)
 {
 	tofix = create_list();
+	namefix = create_list();
+	refnfix = create_list();
 	todo.pass = 1;
 	check_nodes();
+	fix_ghosts();
 	todo.pass = 2;
 	fix_nodes();
 	destroy_empty_list(tofix);
+	destroy_empty_list(namefix);
+	destroy_empty_list(refnfix);
+	tofix = namefix = refnfix = 0;
+}
+/*=================================
+ * check_leaves -- Run all checks of records & data
+ *  blocks, reading each data block once, split
+ *  across worker processes if possible
+ *================================*/
+static void
+check_leaves (void)
+{
+	INT nworkers;
+	fgcheck = todo.check_famgraph_index && famgraph_index_loaded();
+	if (todo.check_famgraph_index && !fgcheck && noisy)
+		report_progress("No current family graph index");
+	if (todo.incremental)
+		select_changed_leaves();
+	nworkers = count_workers();
+#ifdef WORKER_PROCESSES
+	if (nworkers > 1) {
+		run_workers(nworkers);
+		return;
+	}
+#endif
+	walk_leaves(0, nleaves);
+}
+/*=================================
+ * count_workers -- How many processes to check
+ *  data blocks with (DbverifyWorkers option,
+ *  default is one per processor)
+ *================================*/
+static INT
+count_workers (void)
+{
+	INT n = 1;
+#ifdef WORKER_PROCESSES
+	/* fixes are made while checking, so only by this process */
+	if (todo.fix_ghosts || todo.fix_alter_pointers || todo.fix_block_splits)
+		return 1;
+	n = getlloptint("DbverifyWorkers", 0);
+#ifdef _SC_NPROCESSORS_ONLN
+	if (n <= 0)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (n > nleaves)
+		n = nleaves;
+	if (n < 1)
+		n = 1;
+#endif
+	return n;
+}
+/*=================================
+ * walk_leaves -- Check data blocks first..last-1
+ *================================*/
+static void
+walk_leaves (INT first, INT last)
+{
+	INT i;
+	for (i=first; i<last; ++i)
+		check_leaf(&leaves[i]);
+}
+/*=================================
+ * check_leaf -- Check one data block & its records
+ *  reads block file just once, for all checks
+ *================================*/
+static void
+check_leaf (struct leaf * lf)
+{
+	char path[MAXPATHLEN];
+	FILE * fp;
+	STRING buf=0;
+	BLOCK block;
+	long size=0;
+	INT i, n;
+
+	snprintf(path, sizeof(path), "%s/%s", bbasedir(BTR), fkey2path(lf->fkey));
+	if (noisy)
+		report_progress("Checking File: %s", fkey2path(lf->fkey));
+	if (!(fp = fopen(path, LLREADBINARY))
+		|| fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < BUFLEN
+		|| fseek(fp, 0, SEEK_SET)) {
+		printf(_("Error loading data block %s\n"), fkey2path(lf->fkey));
+		badtree = TRUE;
+		goto exit;
+	}
+	buf = (STRING)stdalloc(size);
+	if (fread(buf, size, 1, fp) != 1) {
+		printf(_("Error loading data block %s\n"), fkey2path(lf->fkey));
+		badtree = TRUE;
+		goto exit;
+	}
+	block = (BLOCK)buf;
+	if (ixtype(block) != BTBLOCKTYPE || ixself(block) != lf->fkey) {
+		printf(_("Not a data block: %s\n"), fkey2path(lf->fkey));
+		badtree = TRUE;
+		goto exit;
+	}
+
+	if (todo.check_dbstructure || todo.check_block_splits) {
+		if (!check_block(BTR, block, lf->haslo ? &lf->lo : NULL
+			, lf->hashi ? &lf->hi : NULL)) {
+			printf(_("Index or block keys invalid\n"));
+			badtree = TRUE;
+		}
+	}
+
+	n = nkeys(block);
+	for (i=0; i<n; ++i) {
+		INT len = lens(block, i);
+		INT32 off = offs(block, i);
+		if (off < 0 || len < 0 || BUFLEN + off + len > size) {
+			printf(_("Record %s outside data block %s\n")
+				, rkey2str(rkeys(block, i)), fkey2path(lf->fkey));
+			badtree = TRUE;
+			continue;
+		}
+		if (len >= recbufsize) {
+			if (recbuf)
+				stdfree(recbuf);
+			recbufsize = len + 1;
+			recbuf = (STRING)stdalloc(recbufsize);
+		}
+		memcpy(recbuf, buf + BUFLEN + off, len);
+		recbuf[len] = 0;
+		check_entry(rkeys(block, i), recbuf, len);
+	}
+
+exit:
+	if (buf)
+		stdfree(buf);
+	if (fp)
+		fclose(fp);
+}
+/*=================================
+ * check_entry -- Check one record of a data block
+ *  name & refn records for ghosts, others as nodes
+ *  data: [IN]  raw record, zero terminated
+ *================================*/
+static void
+check_entry (RKEY rkey, STRING data, INT len)
+{
+	char key[MAXKEYWIDTH+1];
+	RECORD rec;
+
+	if (todo.find_ghosts || todo.fix_ghosts) {
+		/* soundexseq is used inside callbacks, across calls */
+		if (traverse_name_record(rkey.r_rkey, data, cgn_callback, NULL)) {
+			if (soundexseq)
+				finish_and_delete_nameset();
+			return;
+		}
+		if (traverse_refn_record(rkey.r_rkey, data, cgr_callback, NULL)) {
+			if (soundexseq)
+				finish_and_delete_refnset();
+			return;
+		}
+	}
+
+	llstrncpy(key, rkey2str(rkey), sizeof(key), uu8);
+	if (key[0]!='I' && key[0]!='F' && key[0]!='S' && key[0]!='E' && key[0]!='X')
+		return;
+
+	if (fgcheck && (key[0]=='I' || key[0]=='F')) {
+		if (noisy)
+			report_progress("Check Family Graph: %s", key);
+		if (!famgraph_index_matches(key, data, len))
+			report_error(ERR_FAMGRAPH, _("Family graph index mismatch (%s)"), key);
+	}
+
+	if (len == 5 && !strcmp(data, "DELE\n"))
+		return;
+	if (!checking_type(key[0]))
+		return;
+	rec = string_to_record(data, key, len);
+	nodes_callback(key, rec, NULL);
+	release_record(rec);
+}
+/*=================================
+ * checking_type -- Were records of this type
+ *  selected to be checked ?
+ *================================*/
+static BOOLEAN
+checking_type (char ntype)
+{
+	switch (ntype) {
+	case 'I': return todo.check_indis;
+	case 'F': return todo.check_fams;
+	case 'S': return todo.check_sours;
+	case 'E': return todo.check_evens;
+	case 'X': return todo.check_othes;
+	}
+	return FALSE;
+}
+#ifdef WORKER_PROCESSES
+/*=================================
+ * run_workers -- Check data blocks in worker processes
+ *  Each worker takes an equal run of blocks; their
+ *  output is replayed in block order, so it is the
+ *  same as if checked by this process alone.
+ *================================*/
+static void
+run_workers (INT nworkers)
+{
+	FILE ** outs = (FILE **)stdalloc(nworkers * sizeof(FILE *));
+	FILE ** results = (FILE **)stdalloc(nworkers * sizeof(FILE *));
+	pid_t * pids = (pid_t *)stdalloc(nworkers * sizeof(pid_t));
+	INT w;
+
+	fflush(stdout);
+	fflush(stderr);
+	for (w=0; w<nworkers; ++w) {
+		INT first = nleaves * w / nworkers;
+		INT last = nleaves * (w+1) / nworkers;
+		pids[w] = -1;
+		outs[w] = tmpfile();
+		results[w] = tmpfile();
+		if (outs[w] && results[w])
+			pids[w] = fork();
+		if (pids[w] == 0)
+			run_worker(first, last, outs[w], results[w]);
+	}
+	for (w=0; w<nworkers; ++w) {
+		INT first = nleaves * w / nworkers;
+		INT last = nleaves * (w+1) / nworkers;
+		int status=0;
+		char buffer[BUFSIZ];
+		size_t n;
+		if (pids[w] < 0) {
+			/* could not start worker, so do its share here */
+			walk_leaves(first, last);
+		} else {
+			waitpid(pids[w], &status, 0);
+			rewind(outs[w]);
+			while ((n = fread(buffer, 1, sizeof(buffer), outs[w])) > 0)
+				fwrite(buffer, 1, n, stdout);
+			if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+				read_results(results[w]);
+			} else {
+				printf(_("Worker checking data blocks %s to %s failed\n")
+					, fkey2path(leaves[first].fkey), fkey2path(leaves[last-1].fkey));
+				badtree = TRUE;
+			}
+		}
+		if (outs[w])
+			fclose(outs[w]);
+		if (results[w])
+			fclose(results[w]);
+	}
+	stdfree(outs);
+	stdfree(results);
+	stdfree(pids);
+}
+/*=================================
+ * run_worker -- Body of worker process
+ *  output goes to out, counts & keys seen to res
+ *  (does not return)
+ *================================*/
+static void
+run_worker (INT first, INT last, FILE * out, FILE * res)
+{
+	INT i;
+	dup2(fileno(out), fileno(stdout));
+	/* report only what this worker finds */
+	for (i=0; i<ARRSIZE(errs); ++i)
+		errs[i].err_count = errs[i].fix_count = 0;
+	walk_leaves(first, last);
+	write_results(res);
+	fflush(stdout);
+	fflush(res);
+	_exit(0);
+}
+/*=================================
+ * write_results -- Send worker findings to parent
+ *  E <err> <count> <fixcount> for error counts
+ *  B if structural error found
+ *  K <key> for each record seen (for check_set)
+ *================================*/
+static void
+write_results (FILE * fp)
+{
+	INT i;
+	for (i=0; i<ARRSIZE(errs); ++i) {
+		if (errs[i].err_count || errs[i].fix_count)
+			fprintf(fp, "E %d %d %d\n", (int)i, errs[i].err_count, errs[i].fix_count);
+	}
+	if (badtree)
+		fprintf(fp, "B\n");
+	write_seq_keys(fp, seq_indis);
+	write_seq_keys(fp, seq_fams);
+	write_seq_keys(fp, seq_sours);
+	write_seq_keys(fp, seq_evens);
+	write_seq_keys(fp, seq_othes);
+}
+/*=================================
+ * write_seq_keys -- Send keys of sequence to parent
+ *================================*/
+static void
+write_seq_keys (FILE * fp, INDISEQ seq)
+{
+	FORINDISEQ(seq, el, num)
+		fprintf(fp, "K %s\n", element_skey(el));
+	ENDINDISEQ
+}
+/*=================================
+ * read_results -- Add findings of one worker
+ *  (see write_results)
+ *================================*/
+static void
+read_results (FILE * fp)
+{
+	char line[MAXLINELEN];
+	rewind(fp);
+	while (fgets(line, sizeof(line), fp)) {
+		INT len = strlen(line);
+		int err, count, fixcount;
+		if (len && line[len-1] == '\n')
+			line[--len] = 0;
+		switch (line[0]) {
+		case 'E':
+			if (sscanf(line+2, "%d %d %d", &err, &count, &fixcount) == 3
+				&& err >= 0 && err < ARRSIZE(errs)) {
+				errs[err].err_count += count;
+				errs[err].fix_count += fixcount;
+			}
+			break;
+		case 'B':
+			badtree = TRUE;
+			break;
+		case 'K':
+			switch (line[2]) {
+			case 'I': append_indiseq_null(seq_indis, strsave(line+2), NULL, TRUE, TRUE); break;
+			case 'F': append_indiseq_null(seq_fams, strsave(line+2), NULL, TRUE, TRUE); break;
+			case 'S': append_indiseq_null(seq_sours, strsave(line+2), NULL, TRUE, TRUE); break;
+			case 'E': append_indiseq_null(seq_evens, strsave(line+2), NULL, TRUE, TRUE); break;
+			case 'X': append_indiseq_null(seq_othes, strsave(line+2), NULL, TRUE, TRUE); break;
+			}
+			break;
+		}
+	}
+}
+#endif /* WORKER_PROCESSES */
+/*=================================
+ * select_changed_leaves -- Keep only data blocks
+ *  written since last checkpoint (incremental mode)
+ *================================*/
+static void
+select_changed_leaves (void)
+{
+	time_t since = read_checkpoint();
+	INT i, total = nleaves;
+	if (!since) {
+		printf("%s\n", _("No verification checkpoint, checking all data blocks"));
+		todo.incremental = FALSE;
+		return;
+	}
+	nleaves = 0;
+	for (i=0; i<total; ++i) {
+		char path[MAXPATHLEN];
+		struct stat sbuf;
+		snprintf(path, sizeof(path), "%s/%s", bbasedir(BTR), fkey2path(leaves[i].fkey));
+		/* same second counts as changed, as mtime is coarse */
+		if (stat(path, &sbuf) || sbuf.st_mtime >= since)
+			leaves[nleaves++] = leaves[i];
+	}
+	printf(_("Checking %d of %d data blocks (changed since checkpoint)\n")
+		, (int)nleaves, (int)total);
+}
+/*=================================
+ * read_checkpoint -- Start time of last run of all
+ *  checks that found no errors (0 if none recorded)
+ *  Kept in file "verified" in database directory
+ *================================*/
+static time_t
+read_checkpoint (void)
+{
+	char path[MAXPATHLEN];
+	FILE * fp;
+	long when=0;
+	snprintf(path, sizeof(path), "%s/verified", bbasedir(BTR));
+	if (!(fp = fopen(path, LLREADTEXT)))
+		return 0;
+	if (fscanf(fp, "dbverify %ld", &when) != 1 || when < 0)
+		when = 0;
+	fclose(fp);
+	return (time_t)when;
+}
+/*=================================
+ * write_checkpoint -- Record clean run of all checks
+ *  when: [IN]  time run started
+ *================================*/
+static void
+write_checkpoint (time_t when)
+{
+	char path[MAXPATHLEN];
+	FILE * fp;
+	snprintf(path, sizeof(path), "%s/verified", bbasedir(BTR));
+	if (!(fp = fopen(path, LLWRITETEXT)))
+		return;
+	fprintf(fp, "dbverify %ld\n", (long)when);
+	fclose(fp);
 }
 /*=================================
  * fix_nodes -- Fix all nodes on fix list
@@ -1104,6 +1543,8 @@ check_set (INDISEQ seq, char ctype)
 }
 /*=========================================
  * check_btree -- Validate btree itself
+ *  and find all its data blocks (leaves), whose
+ *  own checks are left to check_leaf
  * Created: 2003/09/05, Perry Rapp
  *=======================================*/
 static BOOLEAN
@@ -1114,6 +1555,9 @@ check_btree (BTREE btr)
 	/* keep track of which files we've visited */
 	TABLE fkeytab = create_table_int();
 
+	nleaves = 0;
+	leaves_found = TRUE;
+
 	/* check that master index has its fkey correct */
 	INDEX index = bmaster(BTR);
 	FKEY mk1 = bkfile(btr).k_mkey;
@@ -1145,6 +1589,7 @@ check_index (BTREE btr, INDEX index, TABLE fkeytab, RKEY * lo, RKEY * hi)
 {
 	INT n = nkeys(index);
 	INT i;
+	BOOLEAN blocks = FALSE; /* children are data blocks */
 	if (!check_keys((BLOCK)index, lo, hi))
 		return FALSE;
 	for (i = 0; i <= n; i++) {
@@ -1152,6 +1597,7 @@ check_index (BTREE btr, INDEX index, TABLE fkeytab, RKEY * lo, RKEY * hi)
 		char scratch[200];
 		FKEY fkey = fkeys(index, i);
 		RKEY *lox, *hix;
+		BOOLEAN ok = TRUE;
 
 		get_index_file(scratch, sizeof(scratch), btr, fkey);
 		if (in_table(fkeytab, scratch)) {
@@ -1160,26 +1606,60 @@ check_index (BTREE btr, INDEX index, TABLE fkeytab, RKEY * lo, RKEY * hi)
 		} else {
 			insert_table_int(fkeytab, scratch, 1);
 		}
+		/* figure upper & lower bounds of what keys should be in the child */
+		lox = (i==0 ? lo : &rkeys(index, i));
+		hix = (i==n ? hi : &rkeys(index, i+1));
+		if (blocks) {
+			/* all leaves are at same depth, so no need to read this yet */
+			add_leaf(fkey, lox, hix);
+			continue;
+		}
 		newix = readindex(btr, fkey, TRUE);
 		if (!newix) {
 			printf(_("Error loading index at key"));
 			printf(FMT_INT "\n", i);
 			printblock((BLOCK)index);
+			return FALSE;
 		}
-		/* figure upper & lower bounds of what keys should be in the child */
-		lox = (i==0 ? lo : &rkeys(index, i));
-		hix = (i==n ? hi : &rkeys(index, i+1));
 		if (ixtype(newix) == BTINDEXTYPE) {
-			if (!check_index(btr, newix, fkeytab, lox, hix))
-				return FALSE;
+			ok = check_index(btr, newix, fkeytab, lox, hix);
 		} else {
-			if (!check_block(btr, (BLOCK)newix, lox, hix))
-				return FALSE;
+			blocks = TRUE;
+			add_leaf(fkey, lox, hix);
 		}
+		stdfree(newix);
+		if (!ok)
+			return FALSE;
 	}
 	/* TODO: use fkeytab */
 	return TRUE;
 }
+/*=========================================
+ * add_leaf -- Add data block to list for check_leaves
+ *=======================================*/
+static void
+add_leaf (FKEY fkey, RKEY * lo, RKEY * hi)
+{
+	struct leaf * lf;
+	if (nleaves == maxleaves) {
+		INT newmax = maxleaves ? 2 * maxleaves : 64;
+		struct leaf * newleaves = (struct leaf *)stdalloc(newmax * sizeof(struct leaf));
+		if (nleaves)
+			memcpy(newleaves, leaves, nleaves * sizeof(struct leaf));
+		if (leaves)
+			stdfree(leaves);
+		leaves = newleaves;
+		maxleaves = newmax;
+	}
+	lf = &leaves[nleaves++];
+	lf->fkey = fkey;
+	lf->haslo = (lo != NULL);
+	lf->hashi = (hi != NULL);
+	if (lo)
+		lf->lo = *lo;
+	if (hi)
+		lf->hi = *hi;
+}
 /*=========================================
  * check_block -- Validate one data block node of btree
  * Created: 2003/09/05, Perry Rapp
@@ -1382,6 +1862,19 @@ check_typed_missing_data_records (char ntype)
 		}
 	}
 }
+/*=========================================
+ * errors_found -- Were any errors reported ?
+ *=======================================*/
+static BOOLEAN
+errors_found (void)
+{
+	INT i;
+	for (i=0; i<ARRSIZE(errs); i++) {
+		if (errs[i].err_count)
+			return TRUE;
+	}
+	return FALSE;
+}
 /*===========================================
  * main -- Main procedure of dbverify command
  *=========================================*/
@@ -1395,10 +1888,12 @@ main (int argc, char **argv)
 	INT writ=1; /* request write access to database */
 	BOOLEAN immut=FALSE; /* immutable access to database */
 	BOOLEAN allchecks=FALSE; /* if user requested all checks */
+	BOOLEAN indexok=TRUE; /* btree index could be walked */
 	INT returnvalue=1;
 	STRING crashlog=NULL;
 	INT lldberrnum=0;
 	int i=0;
+	time_t started = time(NULL);
 
 	/* initialize all the low-level library code */
 	init_stdlib();
@@ -1460,6 +1955,8 @@ main (int argc, char **argv)
 		case 'D': todo.fix_deletes=TRUE; break;
 		case 'b': todo.check_block_splits=TRUE; break;
 		case 'B': todo.fix_block_splits=TRUE; break;
+		case 'k': todo.check_famgraph_index=TRUE; break;
+		case 'c': todo.incremental=TRUE; break;
 		case 'v': print_version("llexec"); goto done;
 		case 'h':
 		default: print_usage(); goto done;
@@ -1519,7 +2016,9 @@ main (int argc, char **argv)
 		todo.check_indis=todo.check_fams=todo.check_sours=TRUE;
 		todo.check_evens=todo.check_othes=TRUE;
 		todo.find_ghosts=TRUE;
+		todo.check_dbstructure=TRUE;
 		todo.check_block_splits=TRUE;
+		todo.check_famgraph_index=TRUE;
 	}
 
 	/* if database is not writable then disable fixes */
@@ -1529,27 +2028,38 @@ main (int argc, char **argv)
 		todo.fix_block_splits = FALSE;
 	}
 
-	if (todo.check_block_splits || todo.fix_block_splits)
-		check_btree(BTR);
-
-	if (todo.find_ghosts || todo.fix_ghosts)
-		check_ghosts();
-
-
-	if (todo.check_indis
+	/* all checks of data blocks & their records share one pass */
+	if (todo.check_dbstructure
+		|| todo.check_block_splits
+		|| todo.find_ghosts
+		|| todo.fix_ghosts
+		|| todo.check_indis
 		|| todo.check_fams
 		|| todo.check_sours
 		|| todo.check_evens
-		|| todo.check_othes) {
-		check_and_fix_records();
+		|| todo.check_othes
+		|| todo.check_famgraph_index) {
+		/* records are found by walking the index */
+		if (!leaves_found && !check_btree(BTR)) {
+			printf("%s\n", _("Records not checked, as btree index is invalid"));
+			indexok = FALSE;
+			badtree = TRUE;
+		} else {
+			check_and_fix_records();
+		}
 	}
 
-	if (todo.check_missing_data_records) {
+	/* lookups by key would fail on the same index */
+	if (todo.check_missing_data_records && indexok) {
 		check_missing_data_records();
 	}
 
 	report_results();
 
+	/* clean run of all checks is starting point for next -c */
+	if (allchecks && !badtree && !errors_found() && bwrite(BTR))
+		write_checkpoint(started);
+
 done:
 	closebtree(BTR);
 
@@ -1583,7 +2093,7 @@ report_results (void)
 			ct++;
 		}
 	}
-	if (!ct) {
+	if (!ct && !badtree) {
 		printf("%s\n", _("No errors found"));
 	}
 }
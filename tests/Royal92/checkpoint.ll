@@ -0,0 +1,12 @@
+/*
+@progname checkpoint.ll
+@author LifeLines developers
+@description Change one person, for dbverify -c to find
+*/
+
+proc main ()
+{
+  set(p, indi("I300"))
+  addnode(createnode("OCCU", "Checked"), root(p), 0)
+  key(p) " " d(writeindi(p)) nl()
+}
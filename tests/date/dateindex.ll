@@ -0,0 +1,54 @@
+/*
+@progname dateindex.ll
+@author LifeLines developers
+@description Find persons by event date through the date index
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  call keys("3 MAR 1822")
+  call keys("MAR 1822")
+  call keys("1822")
+  call keys("ABT 1890")
+  call keys("BEF 1880")
+  call keys("AFT 1875")
+  call keys("BET 1825 AND 1827")
+  call keys("FROM 1870 TO 1880")
+  call keys("1200 B.C.")
+  call keys("(in the spring)")
+  call keys("")
+  call find("BIRT", "1850", "1860")
+  call find("BIRT", "", "1830")
+  call find("BIRT", "1870", "")
+  call find("BIRT", "", "")
+  call find("DEAT", "1800", "1900")
+  call find("MARR", "1840", "1849")
+  call find("MARR", "1870", "1879")
+  call find("", "1861", "1861")
+  call find("RESI", "1860", "1890")
+  call find("CHR", "1862", "1870")
+  call find("NONE", "", "")
+  forindi(p, n) {
+    key(p) " birth " d(datekey(birth(p))) nl()
+  }
+  "Ending Test" nl()
+  /* tags longer than the index holds are an error */
+  call find("NOSUCHTAG", "", "")
+}
+
+proc keys (s)
+{
+  "datekey(\"" s "\") = " d(datekey(s)) nl()
+}
+
+proc find (tag, from, to)
+{
+  set(s, eventset(tag, from, to))
+  valuesort(s)
+  "eventset(\"" tag "\", \"" from "\", \"" to "\"):"
+  forindiset(s, p, v, n) {
+    " " key(p) "=" d(v)
+  }
+  nl()
+}
@@ -0,0 +1,39 @@
+/*
+@progname closure.ll
+@author LifeLines developers
+@description Test ancestorset and descendentset, with generation limits
+*/
+
+proc showset (title, s)
+{
+  title ":" nl()
+  forindiset(s, p, v, n) {
+    "  " key(p) " " name(p) " gen " d(v) nl()
+  }
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+
+  indiset(young)
+  addtoset(young, indi("I10"), 0)
+  addtoset(young, indi("I13"), 0)
+  call showset("ancestors of I10 I13", ancestorset(young))
+  call showset("ancestors of I10 I13, 1 generation", ancestorset(young, 1))
+  call showset("ancestors of I10 I13, 2 generations", ancestorset(young, 2))
+  call showset("ancestors of I10 I13, 0 = all generations", ancestorset(young, 0))
+
+  indiset(old)
+  addtoset(old, indi("I1"), 0)
+  call showset("descendents of I1", descendentset(old))
+  call showset("descendents of I1, 2 generations", descendantset(old, 2))
+
+  indiset(both)
+  addtoset(both, indi("I3"), 0)
+  addtoset(both, indi("I7"), 0)
+  call showset("descendents of I3 I7", descendentset(both))
+  call showset("ancestors of I3 I7", ancestorset(both))
+
+  "Ending Test" nl()
+}
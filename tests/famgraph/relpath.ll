@@ -0,0 +1,32 @@
+/*
+@progname relpath.ll
+@author LifeLines developers
+@description Test relationpath, with and without search limits
+*/
+
+proc showpath (from, to, s)
+{
+  from " to " to ": " d(length(s)) " persons" nl()
+  forindiset(s, p, v, n) {
+    "  " key(p) " " name(p)
+    if (strlen(v)) { " (" v ")" }
+    nl()
+  }
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+
+  call showpath("I10", "I13", relationpath(indi("I10"), indi("I13")))
+  call showpath("I13", "I1", relationpath(indi("I13"), indi("I1")))
+  call showpath("I9", "I6", relationpath(indi("I9"), indi("I6")))
+  call showpath("I12", "I4", relationpath(indi("I12"), indi("I4")))
+  call showpath("I15", "I16", relationpath(indi("I15"), indi("I16")))
+  call showpath("I1", "I1", relationpath(indi("I1"), indi("I1")))
+  call showpath("I1", "I14", relationpath(indi("I1"), indi("I14")))
+  call showpath("I10 (3 persons)", "I13", relationpath(indi("I10"), indi("I13"), 3))
+  call showpath("I10 (no limits)", "I13", relationpath(indi("I10"), indi("I13"), 0, 0))
+
+  "Ending Test" nl()
+}
@@ -0,0 +1,25 @@
+/*
+@progname closure.ll
+@author LifeLines developers
+@description Test gengedcom, gengedcomweak and gengedcomstrong closures
+*/
+
+proc main ()
+{
+  indiset(s)
+  addtoset(s, indi("I1"), 0)
+  addtoset(s, indi("I2"), 0)
+  addtoset(s, indi("I3"), 0)
+  "--- gengedcom" nl()
+  gengedcom(s)
+  "--- gengedcomweak" nl()
+  gengedcomweak(s)
+  "--- gengedcomstrong" nl()
+  gengedcomstrong(s)
+  indiset(t)
+  addtoset(t, indi("I2"), 0)
+  addtoset(t, indi("I4"), 0)
+  addtoset(t, indi("I5"), 0)
+  "--- gengedcomstrong (second set)" nl()
+  gengedcomstrong(t)
+}
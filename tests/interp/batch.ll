@@ -0,0 +1,17 @@
+/*
+@progname batch.ll
+@author LifeLines developers
+@description Print the JOB property and the persons, for llexec batch runs
+*/
+
+proc main ()
+{
+  set(job, getproperty("JOB"))
+  "Starting job "
+  if (job) { job } else { "none" }
+  nl()
+  forindi(p, n) {
+    key(p) " " name(p) nl()
+  }
+  "Ending job" nl()
+}
@@ -0,0 +1,71 @@
+/*
+@progname list.ll
+@author Perry Rapp
+@description Test list functions, used as arrays, queues and stacks
+*/
+
+proc show(l, label)
+{
+	label ":"
+	forlist(l, e, n) { " " d(e) }
+	" (" d(length(l)) ")" nl()
+}
+
+proc main()
+{
+	/* array access, growing by setel */
+	list(a)
+	setel(a, 3, 30)
+	call show(a, "setel 3")
+	setel(a, 1, 10)
+	setel(a, 2, 20)
+	call show(a, "setel 1,2")
+	"getel 2: " d(getel(a, 2)) nl()
+	"getel 0: " d(getel(a, 0)) nl()
+	"getel -1: " d(getel(a, -1)) nl()
+	/* queue & stack operations at both ends */
+	list(q)
+	set(i, 1)
+	while (le(i, 20)) { enqueue(q, i) incr(i) }
+	set(i, 1)
+	while (le(i, 15)) { set(j, dequeue(q)) incr(i) }
+	"last dequeued: " d(j) nl()
+	requeue(q, 100)
+	push(q, 200)
+	call show(q, "queue")
+	"pop: " d(pop(q)) nl()
+	"getel 1: " d(getel(q, 1)) nl()
+	"getel 6: " d(getel(q, 6)) nl()
+	/* wrap around: more cycles than the list ever holds */
+	set(i, 1)
+	while (le(i, 1000)) { enqueue(q, i) set(j, dequeue(q)) incr(i) }
+	call show(q, "cycled")
+	/* enqueue during forlist reaches the new elements */
+	list(b)
+	enqueue(b, 1)
+	forlist(b, e, n) {
+		if (lt(e, 5)) { enqueue(b, add(e, 1)) }
+	}
+	call show(b, "grown in forlist")
+	/* inlist, sort, dup */
+	"inlist 3: " d(inlist(b, 3)) nl()
+	"inlist 9: " d(inlist(b, 9)) nl()
+	list(s)
+	enqueue(s, 3) enqueue(s, 1) enqueue(s, 2)
+	sort(s)
+	call show(s, "sorted")
+	rsort(s)
+	call show(s, "rsorted")
+	set(c, dup(s))
+	setel(c, 1, 9)
+	call show(c, "dup changed")
+	call show(s, "original")
+	/* large array */
+	list(big)
+	set(i, 1)
+	while (le(i, 5000)) { setel(big, i, mul(i, 2)) incr(i) }
+	set(sum, 0)
+	set(i, 1)
+	while (le(i, 5000)) { set(sum, add(sum, getel(big, i))) incr(i) }
+	"sum: " d(sum) nl()
+}
@@ -0,0 +1,71 @@
+/*
+@progname namerefn.ll
+@author LifeLines developers
+@description Test name & refn lookups, also while writeindi updates them
+*/
+
+proc showset (s)
+{
+  s ":"
+  genindiset(s, set)
+  if (set) {
+    keysort(set)
+    forindiset(set, p, v, n) { " " key(p) }
+  }
+  nl()
+}
+
+proc showall ()
+{
+  call showset("John/Smith/")
+  call showset("Johnny/Smith/")
+  call showset("*/Smith/")
+  call showset("J*/Smith/")
+  call showset("J*/Smyth/")
+  call showset("Mary/Jones/")
+  call showset("Pete/Brown/")
+  call showset("smith1")
+  call showset("smith2")
+  call showset("jones1")
+  call showset("brown1")
+  call showset("I3")
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+  call showall()
+
+  /* rename each Smith in turn, looking up between the writes */
+  "rename" nl()
+  genindiset("*/Smith/", smiths)
+  keysort(smiths)
+  forindiset(smiths, p, v, n) {
+    set(r, root(p))
+    set(g, givens(p))
+    fornodes(r, nd) {
+      if (eqstr(tag(nd), "NAME")) {
+        if (index(value(nd), "/Smith/", 1)) { set(old, nd) }
+      }
+    }
+    detachnode(old)
+    addnode(createnode("NAME", concat(g, " /Smyth/")), r, 0)
+    key(p) " " d(writeindi(p)) nl()
+    call showset("*/Smith/")
+    call showset("*/Smyth/")
+  }
+
+  /* new refn, and a link given by refn, resolved while writing */
+  "refns" nl()
+  set(p, indi("I5"))
+  addnode(createnode("REFN", "brown1"), root(p), 0)
+  addnode(createnode("ALIA", "<jones1>"), root(p), 0)
+  "I5 " d(writeindi(p)) nl()
+  /* refn already held by another person is refused */
+  set(p, indi("I3"))
+  addnode(createnode("REFN", "smith1"), root(p), 0)
+  "I3 " d(writeindi(p)) nl()
+
+  call showall()
+  "Ending Test" nl()
+}
@@ -0,0 +1,67 @@
+/*
+@progname rptcache.ll
+@author the LifeLines developers
+@description Test parsed reports loaded back from the report cache
+  (rptcache.lines.src sets ReportCacheDir, rptcache.llscr runs this
+  report twice, so the second run is loaded from the cache)
+*/
+
+char_encoding("UTF-8")
+require("lifelines-reports.version:1.2")
+include("rptcache.li")
+global(total)
+
+proc main() {
+  set(calls, 0)
+  set(total, 0)
+  call before()
+  call after()
+  call loops(5)
+  call conds(-3)
+  call conds(0)
+  call conds(7)
+  "twice called " d(calls) " times, total " d(total) nl()
+  "float " f(div(7.5, 2.5), 2) " string \"q\"\tÅ" nl()
+}
+
+/* upper is not yet a user function here, so the builtin is called */
+proc before() {
+  "before " upper("abc") nl()
+}
+
+func upper(s) {
+  return(concat("<", s, ">"))
+}
+
+/* from here on upper is the user function */
+proc after() {
+  "after " upper("abc") nl()
+}
+
+proc loops(n) {
+  list(l)
+  set(i, 0)
+  while (1) {
+    incr(i)
+    if (gt(i, n)) { break() }
+    if (eq(i, 2)) { continue() }
+    enqueue(l, twice(i))
+  }
+  forlist (l, v, j) {
+    set(total, add(total, v))
+    "item " d(j) " " d(v) nl()
+  }
+  forindi (p, k) { "person " name(p) nl() }
+  forfam (f, k) { "family " key(f) nl() }
+  forsour (s, k) { "source " key(s) nl() }
+  foreven (e, k) { "event " key(e) nl() }
+  forothr (o, k) { "other " key(o) nl() }
+  indiset(iset)
+  forindiset (iset, p, val, k) { "set " name(p) nl() }
+}
+
+proc conds(x) {
+  if (lt(x, 0)) { "negative " d(x) nl() }
+  elsif (eq(x, 0)) { "zero" nl() }
+  else { "positive " d(x) nl() }
+}
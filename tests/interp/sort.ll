@@ -0,0 +1,56 @@
+/*
+@progname sort.ll
+@author LifeLines developers
+@description Test sort and rsort are stable, on string and integer keys
+*/
+
+proc check(v, k, what)
+{
+  set(prevk, "") set(prevv, -1) set(bad, 0) set(disorder, 0)
+  forlist(k, kk, n) {
+    set(vv, getel(v, n))
+    if (eqstr(kk, prevk)) {
+      if (lt(vv, prevv)) { incr(bad) }
+    } elsif (and(gt(n, 1), lt(strcmp(kk, prevk), 0))) {
+      incr(disorder)
+    }
+    set(prevk, kk) set(prevv, vv)
+  }
+  what ": " d(length(k)) " sorted, " d(disorder) " out of order, "
+  d(bad) " equal keys out of order" nl()
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+  list(v) list(k) list(n)
+  set(i, 1) set(x, 12345)
+  while (le(i, 2000)) {
+    set(x, mod(add(mul(x, 1103515245), 12345), 2147483648))
+    enqueue(k, concat("k", d(mod(x, 97))))
+    enqueue(n, mod(x, 97))
+    enqueue(v, i)
+    incr(i)
+  }
+  sort(v, k)
+  call check(v, k, "string keys")
+  "first: " getel(k, 1) " " d(getel(v, 1))
+  ", last: " getel(k, 2000) " " d(getel(v, 2000)) nl()
+
+  list(w) list(words)
+  forlist(v, vv, j) { enqueue(w, vv) }
+  enqueue(words, "pear") enqueue(words, "apple") enqueue(words, "fig")
+  enqueue(words, "apple") enqueue(words, "Zebra") enqueue(words, "éclair")
+  sort(words)
+  "words:" forlist(words, s, j) { " " s } nl()
+  rsort(words)
+  "reversed:" forlist(words, s, j) { " " s } nl()
+
+  list(v2)
+  set(i, 1)
+  while (le(i, 2000)) { enqueue(v2, i) incr(i) }
+  sort(v2, n)
+  "integer keys: first " d(getel(n, 1)) " " d(getel(v2, 1))
+  ", last " d(getel(n, 2000)) " " d(getel(v2, 2000)) nl()
+  "Ending Test" nl()
+}
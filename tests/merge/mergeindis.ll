@@ -0,0 +1,70 @@
+/*
+@progname mergeindis.ll
+@author LifeLines developers
+@description Test mergeindis, dry run then merge
+*/
+
+proc showrec (r)
+{
+  traverse(r, n, lev) {
+    d(lev)
+    if (xref(n)) { " " xref(n) }
+    " " tag(n)
+    if (value(n)) { " " value(n) }
+    nl()
+  }
+}
+
+proc showname (s)
+{
+  s ":"
+  genindiset(s, set)
+  if (set) {
+    keysort(set)
+    forindiset(set, p, v, n) { " " key(p) }
+  }
+  nl()
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+
+  list(drops)
+  list(keeps)
+  enqueue(drops, indi("I4"))  enqueue(keeps, indi("I1"))
+  enqueue(drops, "I5")        enqueue(keeps, "I2")
+  enqueue(drops, "I6")        enqueue(keeps, "@I3@")
+  enqueue(drops, "I7")        enqueue(keeps, "I4")
+  enqueue(drops, "I8")        enqueue(keeps, "I2")
+  enqueue(drops, "I9")        enqueue(keeps, "I9")
+  enqueue(drops, "I99")       enqueue(keeps, "I1")
+  enqueue(drops, "I4")        enqueue(keeps, "I3")
+  enqueue(drops, "I10")       enqueue(keeps, "I11")
+  enqueue(drops, "I11")       enqueue(keeps, "I10")
+
+  list(report)
+  set(n, mergeindis(drops, keeps, 1, report))
+  "dry run: " d(n) nl()
+  forlist(report, line, i) { "  " line nl() }
+  call showname("John/Smith/")
+
+  list(report)
+  set(n, mergeindis(drops, keeps, 0, report))
+  "merge: " d(n) nl()
+  forlist(report, line, i) { "  " line nl() }
+
+  call showrec(root(indi("I1")))
+  call showrec(root(indi("I2")))
+  call showrec(root(indi("I3")))
+  call showrec(root(fam("F1")))
+  call showrec(root(fam("F2")))
+  if (indi("I4")) { "I4 still there" nl() }
+  if (indi("I7")) { "I7 still there" nl() }
+  call showname("John/Smith/")
+  call showname("Johnny/Smith/")
+  call showname("Ann/Smith/")
+  call showname("Ruth/White/")
+
+  "Ending Test" nl()
+}
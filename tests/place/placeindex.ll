@@ -0,0 +1,49 @@
+/*
+@progname placeindex.ll
+@author LifeLines developers
+@description Find persons by event place through the place index
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  call find("Bristol", "")
+  call find("bristol, gloucestershire", "")
+  call find("Bristol, Rhode Island", "")
+  call find("Gloucestershire, England", "BIRT")
+  call find("England", "")
+  call find("England", "MARR")
+  call find("USA", "")
+  call find("Clifton", "")
+  call find("Paris", "")
+  call find("Second Place", "")
+  call find("Nowhere", "")
+  call find("", "")
+  call sub("")
+  call sub("England")
+  call sub("Gloucestershire")
+  call sub("Bristol")
+  call sub("Bristol, Gloucestershire, England")
+  call sub("Nowhere")
+  "Ending Test" nl()
+}
+
+proc find (place, tag)
+{
+  set(s, placeset(place, tag))
+  keysort(s)
+  "placeset(\"" place "\", \"" tag "\"):"
+  forindiset(s, p, v, n) {
+    " " key(p) "=" v
+  }
+  nl()
+}
+
+proc sub (place)
+{
+  "subplaces(\"" place "\"):"
+  forlist(subplaces(place), s, n) {
+    " [" s "]"
+  }
+  nl()
+}
@@ -0,0 +1,22 @@
+/*
+@progname shared.ll
+@author LifeLines developers
+@description Read every record, for runs with and without the shared record cache
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  forindi(p, n) {
+    key(p) " " name(p) " " sex(p) nl()
+    families(p, f, s, m) {
+      "  " key(f) " spouse " if (s) { key(s) } else { "none" }
+      " children " d(nchildren(f)) nl()
+    }
+  }
+  forfam(f, n) {
+    key(f) " " key(husband(f)) " " key(wife(f)) nl()
+    children(f, c, m) { "  " d(m) " " key(c) nl() }
+  }
+  "Ending Test" nl()
+}
@@ -0,0 +1,42 @@
+/*
+@progname scanrecords.ll
+@author LifeLines developers
+@description Test scanrecords across tag paths, record types and patterns
+*/
+
+proc showscan (path, pat, types)
+{
+  if (strlen(types)) {
+    set(l, scanrecords(path, pat, types))
+    path " " pat " (" types "):"
+  } else {
+    set(l, scanrecords(path, pat))
+    path " " pat ":"
+  }
+  forlist(l, k, n) { " " k }
+  nl()
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+
+  call showscan("SOUR.TITL", "*kent*", "S")
+  call showscan("SOUR.TITL", "*county*", "S")
+  call showscan("SOUR.AUTH", "canterbury*", "S")
+  call showscan("*.NOTE", "*mill*", "")
+  call showscan("*.NOTE", "*dover", "")
+  call showscan("NOTE", "*millbrook", "")
+  call showscan("NOTE", "before ????", "X")
+  call showscan("*.*.PLAC", "*, kent", "")
+  call showscan("*.*.PLAC", "*, kent", "IF")
+  call showscan("INDI.BIRT.DATE", "*18[0-2]?", "I")
+  call showscan("INDI.*.PLAC", "Millbrook*", "I")
+  call showscan("*.PLAC", "dover, kent", "")
+  call showscan("*.NAME", "*/miller/", "")
+  call showscan("*.NAME", "!*/miller/", "")
+  call showscan("*.TITL", "*parish*", "I")
+  call showscan("*.TITL", "*nowhere*", "")
+
+  "Ending Test" nl()
+}
@@ -0,0 +1,53 @@
+/*
+@progname tagindex.ll
+@author LifeLines developers
+@description Test secondary indexes on tag paths
+*/
+
+proc find (path, val, prefix)
+{
+  path " " val
+  if (prefix) { "*" }
+  ":"
+  forlist(indexkeys(path, val, prefix), k, n) { " " k }
+  nl()
+}
+
+proc main ()
+{
+  "Starting Test" nl()
+  if (not(createindex("INDI.OCCU"))) { "createindex failed" nl() }
+  if (not(createindex("sour.titl", "words"))) { "createindex failed" nl() }
+  if (not(createindex("INDI.BIRT.DATE", "year"))) { "createindex failed" nl() }
+  if (createindex("INDI.OCCU", "words")) { "createindex with other extractor" nl() }
+  if (createindex("INDI.NAME", "soundex")) { "createindex with bad extractor" nl() }
+
+  call find("INDI.OCCU", "farmer", 0)
+  call find("INDI.OCCU", "FARM", 1)
+  call find("INDI.OCCU", "Fa", 0)
+  call find("INDI.OCCU", "fa", 1)
+  call find("INDI.OCCU", "", 1)
+  call find("INDI.OCCU", "weaver", 0)
+  call find("SOUR.TITL", "kent", 0)
+  call find("SOUR.TITL", "1851", 0)
+  call find("SOUR.TITL", "Cen", 1)
+  call find("INDI.BIRT.DATE", "1822", 0)
+  call find("INDI.BIRT.DATE", "185", 1)
+  call find("INDI.NOTE", "x", 0)
+
+  /* stored records update their entries */
+  set(p, indi("I1"))
+  fornodes(inode(p), n) {
+    if (eqstr(tag(n), "OCCU")) { set(occu, n) }
+  }
+  detachnode(occu)
+  addnode(createnode("OCCU", "Weaver"), inode(p), 0)
+  if (not(writeindi(p))) { "writeindi failed" nl() }
+  call find("INDI.OCCU", "farmer", 0)
+  call find("INDI.OCCU", "weaver", 0)
+
+  if (not(dropindex("INDI.BIRT.DATE"))) { "dropindex failed" nl() }
+  if (dropindex("INDI.BIRT.DATE")) { "dropindex twice" nl() }
+  call find("INDI.BIRT.DATE", "1822", 0)
+  "Ending Test" nl()
+}
@@ -0,0 +1,21 @@
+/*
+@progname tagindex_2.ll
+@author LifeLines developers
+@description Test secondary indexes persist in the database
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  "farmer:"
+  forlist(indexkeys("INDI.OCCU", "farmer"), k, n) { " " k }
+  nl()
+  "weaver:"
+  forlist(indexkeys("INDI.OCCU", "weaver"), k, n) { " " k }
+  nl()
+  "kent:"
+  forlist(indexkeys("SOUR.TITL", "kent"), k, n) { " " k }
+  nl()
+  if (createindex("INDI.OCCU")) { "already declared" nl() }
+  "Ending Test" nl()
+}
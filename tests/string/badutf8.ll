@@ -0,0 +1,13 @@
+/*
+@progname badutf8.ll
+@description Check import of a file declared UTF-8 with a Latin-1 byte
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  forindi(i, n) {
+    key(i) " " surname(i) nl()
+  }
+  "Ending Test" nl()
+}
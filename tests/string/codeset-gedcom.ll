@@ -0,0 +1,15 @@
+/*
+@progname codeset-gedcom.ll
+@author LifeLines developers
+@description Show persons imported from a GEDCOM file in CP1252
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  forindi(p, n) {
+    key(p) " " name(p) nl()
+    fornotes(inode(p), s) { "  " s nl() }
+  }
+  "Ending Test" nl()
+}
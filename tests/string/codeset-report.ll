@@ -0,0 +1,22 @@
+/*
+@progname codeset-report.ll
+@author LifeLines developers
+@description Test conversion of report output to the report codeset
+*/
+
+proc main ()
+{
+  "Starting Test" nl()
+  "plain ASCII, converted unchanged" nl()
+  "Latin-1: Zoë Müller, Ångström, façade" nl()
+  "not in Latin-1: Łódź – €5" nl()
+  set(s, "")
+  set(i, 0)
+  while (lt(i, 40)) {
+    set(s, concat(s, "é"))
+    incr(i)
+  }
+  "long: " s nl()
+  "ASCII after: done" nl()
+  "Ending Test" nl()
+}